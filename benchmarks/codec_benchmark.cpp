@@ -0,0 +1,233 @@
+//
+// Codec benchmark for the wire encodings of the messages between client and server.
+//
+// Plays a game with 3 to 6 players and measures, for the messages that are exchanged most often, how long it takes
+// to encode and decode them as json text and with the binary_codec, how many bytes they need, and how long it takes to
+// turn the decoded json into objects (the game_state on the client, the client_request on the server). The messages
+// are measured in the first trick of the game and in the middle of a trick of the last round, where the hands are
+// largest and the current and the previous trick hold the most cards. Building the objects is also measured in heap
+// allocations per message.
+//
+// Usage: Wizard-bench-codec [--iterations=<n>]
+//
+// The full state is the view of a player who joins or resyncs (own hand visible), the diff is the state update
+// broadcast after a card was played, and the request is the play_card request of the client.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../src/common/game_state/game_state.h"
+#include "../src/common/network/requests/client_request.h"
+#include "../src/common/network/requests/play_card_request.h"
+#include "../src/common/network/responses/full_state_response.h"
+#include "../src/common/network/responses/state_diff_response.h"
+#include "../src/common/network/wire_format.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// every heap allocation of the process is counted
+static std::atomic<size_t> nof_allocations {0};
+
+void* operator new(size_t size) {
+    nof_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct codec_result {
+    size_t bytes;
+    double encode_ns;
+    double decode_ns;
+};
+
+// encodes and decodes 'json' 'iterations' times in the given encoding and returns the average time per message
+static codec_result measure(const rapidjson::Value& json, wire_format::encoding enc, size_t iterations) {
+    std::string encoded;
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        encoded = wire_format::encode(json, enc);
+    }
+    double encode_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / iterations;
+
+    start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        rapidjson::Document decoded;
+        wire_format::decode(encoded.data(), encoded.size(), enc, decoded);
+    }
+    double decode_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / iterations;
+
+    return codec_result {wire_format::make_frame(encoded, enc).size(), encode_ns, decode_ns};
+}
+
+struct objects_result {
+    double ns;
+    double allocations;
+};
+
+// turns 'json' into objects with 'decode' 'iterations' times and returns the average time and heap allocations
+template<typename F>
+static objects_result measure_objects(F decode, size_t iterations) {
+    const size_t allocations_before = nof_allocations.load(std::memory_order_relaxed);
+    const auto start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        decode();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / iterations;
+    const size_t allocations = nof_allocations.load(std::memory_order_relaxed) - allocations_before;
+    return objects_result {ns, static_cast<double>(allocations) / iterations};
+}
+
+static void print_row(const std::string& message, size_t nof_players, const rapidjson::Value& json,
+                      const objects_result& objects, size_t iterations) {
+    codec_result json_result = measure(json, wire_format::encoding::json, iterations);
+    codec_result binary_result = measure(json, wire_format::encoding::binary, iterations);
+    std::cout << std::left << std::setw(12) << message << std::right << std::setw(8) << nof_players
+              << std::setw(12) << json_result.bytes << std::setw(12) << binary_result.bytes
+              << std::setw(14) << json_result.encode_ns << std::setw(14) << binary_result.encode_ns
+              << std::setw(14) << json_result.decode_ns << std::setw(14) << binary_result.decode_ns
+              << std::setw(14) << objects.ns << std::setw(14) << objects.allocations << std::endl;
+}
+
+// lets every player estimate, the last player may have to avoid the estimate that matches the number of tricks
+static bool estimate_all(game_state& state, std::string& err) {
+    while (state.is_estimation_phase()) {
+        if (!state.estimate_tricks(state.get_current_player(), err, 0)
+            && !state.estimate_tricks(state.get_current_player(), err, 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// plays the first card of the current player that may be played
+static bool play_first_card(game_state& state, std::string& err) {
+    player* current = state.get_current_player();
+    const uint64_t playable = state.get_playable_mask();
+    for (const card* c : current->get_hand()->get_card_span()) {
+        if (card_mask::contains(playable, c->get_value(), c->get_color())) {
+            return state.play_card(current, c->get_id(), err);
+        }
+    }
+    return false;
+}
+
+static void delete_state(game_state* state) {
+    for (player* p : state->get_players()) {
+        delete p;
+    }
+    delete state;
+}
+
+// measures the messages of the current state of the game, in which the current player is about to play a card
+static bool print_rows(game_state& state, size_t nof_players, size_t iterations, std::string& err) {
+    player* viewer = state.get_current_player();
+    full_state_response full_state = full_state_response(state.get_id(), state);
+    rapidjson::Document* full_state_json = full_state.to_json();
+    // the state the viewer receives contains their own hand
+    rapidjson::Document view(rapidjson::kObjectType);
+    state.write_view_into_json(view, view.GetAllocator(), viewer);
+    (*full_state_json)["state_json"].CopyFrom(view, full_state_json->GetAllocator());
+    const objects_result full_state_objects = measure_objects([&view] { delete_state(game_state::from_json(view)); },
+                                                              iterations);
+
+    const std::string card_id = viewer->get_hand()->get_cards().front()->get_id();
+    rapidjson::Document* request_json = play_card_request(state.get_id(), viewer->get_id(), card_id).to_json();
+    const objects_result request_objects =
+            measure_objects([request_json] { delete client_request::from_json(*request_json); }, iterations);
+
+    state.clear_dirty();
+    if (!play_first_card(state, err)) {
+        return false;
+    }
+    // the json of the response refers to the strings of the response's diff, so the response has to outlive it
+    state_diff_response diff_response = state_diff_response(state.get_id(), state);
+    rapidjson::Document* diff_json = diff_response.to_json();
+    // the client applies the diff to the state it holds
+    game_state* client_state = game_state::from_json(view);
+    const rapidjson::Value& diff = (*diff_json)["diff_json"];
+    const objects_result diff_objects =
+            measure_objects([client_state, &diff] { client_state->apply_diff(diff); }, iterations);
+    delete_state(client_state);
+
+    print_row("full state", nof_players, *full_state_json, full_state_objects, iterations);
+    print_row("diff", nof_players, *diff_json, diff_objects, iterations);
+    print_row("request", nof_players, *request_json, request_objects, iterations);
+
+    delete full_state_json;
+    delete request_json;
+    delete diff_json;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 20000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--iterations=", 0) == 0) {
+            iterations = std::max<size_t>(1, std::stoul(arg.substr(13)));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--iterations=<n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    for (const std::string phase : {"first trick", "last round"}) {
+        std::cout << phase << std::endl << std::fixed << std::setprecision(0)
+                  << std::left << std::setw(12) << "message" << std::right << std::setw(8) << "players"
+                  << std::setw(12) << "json B" << std::setw(12) << "binary B"
+                  << std::setw(14) << "json enc ns" << std::setw(14) << "binary enc ns"
+                  << std::setw(14) << "json dec ns" << std::setw(14) << "binary dec ns"
+                  << std::setw(14) << "objects ns" << std::setw(14) << "objects allocs" << std::endl;
+
+        for (size_t nof_players = 3; nof_players <= 6; nof_players++) {
+            game_state state = game_state(nof_players);
+            std::string err;
+            for (size_t p = 0; p < nof_players; p++) {
+                state.add_player(new player("player" + std::to_string(p + 1)), err);
+            }
+            if (!state.start_game(err)) {
+                std::cerr << "Could not start the game: " << err << std::endl;
+                return 1;
+            }
+
+            bool ok = true;
+            if (phase == "last round") {
+                // play until the last round, then until all but one player played a card in its first trick
+                while (ok && state.get_round_number() + 1 < static_cast<int>(state.get_max_round_number())) {
+                    ok = estimate_all(state, err) && play_first_card(state, err);
+                }
+                ok = ok && estimate_all(state, err);
+                for (size_t p = 0; ok && p + 2 < nof_players; p++) {
+                    ok = play_first_card(state, err);
+                }
+            }
+            ok = ok && estimate_all(state, err) && print_rows(state, nof_players, iterations, err);
+            if (!ok) {
+                std::cerr << "Could not play the game: " << err << std::endl;
+                return 1;
+            }
+            for (player* p : state.get_players()) {
+                delete p;
+            }
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
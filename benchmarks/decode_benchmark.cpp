@@ -0,0 +1,129 @@
+//
+// Request decode benchmark of the Wizard-server.
+//
+// Measures the time and the number of heap allocations needed to turn the payload of a received frame into a request
+// the request_handler can work with: once with a fresh rapidjson document and a client_request created by
+// client_request::from_json(), and once with the request_decoder of a connection, which parses in situ into reused
+// memory pools and only creates a request_view.
+//
+// Usage: Wizard-bench-decode [--iterations=<n>]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../src/common/network/requests/estimate_tricks_request.h"
+#include "../src/common/network/requests/join_game_request.h"
+#include "../src/common/network/requests/play_card_request.h"
+#include "../src/common/network/wire_format.h"
+#include "../src/server/request_decoder.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// every heap allocation of the process is counted
+static std::atomic<size_t> nof_allocations {0};
+
+void* operator new(size_t size) {
+    nof_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct decode_result {
+    double ns;
+    double allocations;
+};
+
+// Decodes 'payload' 'iterations' times with 'decode', which gets a frame whose payload it may modify.
+template<typename decode_function>
+static decode_result measure(const std::string& payload, wire_format::encoding enc, size_t iterations,
+                             decode_function decode) {
+    // the payload is restored before every iteration, since json payloads are modified by parsing them in situ
+    std::vector<char> buffer(payload.size() + 1);
+    frame_reader::frame f {enc, buffer.data(), payload.size()};
+
+    // warm up, e.g. to let the memory pools allocate chunks that are kept
+    for (size_t i = 0; i < 100; i++) {
+        std::memcpy(buffer.data(), payload.data(), payload.size());
+        decode(f);
+    }
+
+    const size_t allocations_before = nof_allocations.load();
+    const auto start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        std::memcpy(buffer.data(), payload.data(), payload.size());
+        decode(f);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+    return decode_result {ns / iterations,
+                          static_cast<double>(nof_allocations.load() - allocations_before) / iterations};
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 200000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--iterations=", 0) == 0) {
+            iterations = std::max<size_t>(1, std::stoul(arg.substr(13)));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--iterations=<n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::string game_id = uuid_generator::generate_uuid_v4();
+    const std::string player_id = uuid_generator::generate_uuid_v4();
+    std::vector<std::pair<std::string, rapidjson::Document*>> requests = {
+            {"join_game", join_game_request(player_id, "player name").to_json()},
+            {"play_card", play_card_request(game_id, player_id, uuid_generator::generate_uuid_v4()).to_json()},
+            {"estimate", estimate_tricks_request(game_id, player_id, 2).to_json()}
+    };
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left << std::setw(12) << "request" << std::setw(10) << "encoding" << std::right
+              << std::setw(18) << "from_json ns" << std::setw(18) << "from_json allocs"
+              << std::setw(18) << "decoder ns" << std::setw(18) << "decoder allocs" << std::endl;
+
+    request_decoder decoder;
+    size_t checksum = 0;
+    for (const auto& [name, json] : requests) {
+        for (const auto enc : {wire_format::encoding::json, wire_format::encoding::binary}) {
+            const std::string payload = wire_format::encode(*json, enc);
+
+            const decode_result old_path = measure(payload, enc, iterations, [&checksum](frame_reader::frame& f) {
+                rapidjson::Document req_json;
+                wire_format::decode(f.data, f.size, f.encoding, req_json);
+                client_request* req = client_request::from_json(req_json);
+                checksum += req->get_player_id().size();
+                delete req;
+            });
+            const decode_result new_path = measure(payload, enc, iterations, [&](frame_reader::frame& f) {
+                checksum += decoder.decode(f).player_id.size();
+            });
+
+            std::cout << std::left << std::setw(12) << name
+                      << std::setw(10) << (enc == wire_format::encoding::json ? "json" : "binary") << std::right
+                      << std::setw(18) << old_path.ns << std::setw(18) << old_path.allocations
+                      << std::setw(18) << new_path.ns << std::setw(18) << new_path.allocations << std::endl;
+        }
+        delete json;
+    }
+    return checksum == 0 ? 1 : 0;
+}
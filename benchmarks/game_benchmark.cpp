@@ -0,0 +1,136 @@
+//
+// Game simulation benchmark of the Wizard-server.
+//
+// Plays complete games on the server's game_state without any network: every player estimates as few tricks as the
+// rules allow and plays the first card of their hand that may be played. Reports the simulated games and moves per
+// second and the number of heap allocations per game, once for the game logic alone and once with a state diff
+// created after every move, as the server does to update the clients.
+//
+// Usage: Wizard-bench-game [--games=<n>] [--players=<3-6>]
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../src/common/game_state/game_state.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// every heap allocation of the process is counted
+static std::atomic<size_t> nof_allocations {0};
+
+void* operator new(size_t size) {
+    nof_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+struct simulation_result {
+    double seconds;
+    size_t moves;
+    double allocations;
+};
+
+// Plays one game with 'nof_players' players and returns the number of moves (estimates and played cards).
+static size_t play_game(const int nof_players, const bool with_diffs) {
+    std::string err;
+    game_state state;
+    std::vector<player*> players;
+    for (int i = 0; i < nof_players; i++) {
+        players.push_back(new player(entity_id::generate(), "player " + std::to_string(i)));
+        state.add_player(players.back(), err);
+    }
+    state.start_game(err);
+
+    size_t moves = 0;
+    while (!state.is_finished()) {
+        player* current = state.get_current_player();
+        if (state.is_estimation_phase()) {
+            // the last player may not estimate a number of tricks that adds up to the number of cards
+            if (!state.estimate_tricks(current, err, 0)) {
+                state.estimate_tricks(current, err, 1);
+            }
+        } else {
+            const uint64_t playable = state.get_playable_mask();
+            for (const card* c : current->get_hand()->get_card_span()) {
+                if (card_mask::contains(playable, c->get_value(), c->get_color())) {
+                    state.play_card(current, c->get_id(), err);
+                    break;
+                }
+            }
+        }
+        moves++;
+
+        if (with_diffs) {
+            rapidjson::Document diff(rapidjson::kObjectType);
+            state.write_diff_into_json(diff, diff.GetAllocator());
+            state.clear_dirty();
+        }
+    }
+
+    for (const player* p : players) {
+        delete p;
+    }
+    return moves;
+}
+
+static simulation_result simulate(const size_t games, const int nof_players, const bool with_diffs) {
+    play_game(nof_players, with_diffs);     // warm up
+
+    size_t moves = 0;
+    const size_t allocations_before = nof_allocations.load();
+    const auto start = bench_clock::now();
+    for (size_t i = 0; i < games; i++) {
+        moves += play_game(nof_players, with_diffs);
+    }
+    const double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    return simulation_result {seconds, moves,
+                              static_cast<double>(nof_allocations.load() - allocations_before) / games};
+}
+
+int main(int argc, char* argv[]) {
+    size_t games = 2000;
+    int nof_players = 4;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--games=", 0) == 0) {
+            games = std::max<size_t>(1, std::stoul(arg.substr(8)));
+        } else if (arg.rfind("--players=", 0) == 0) {
+            nof_players = std::stoi(arg.substr(10));
+        } else {
+            nof_players = 0;
+        }
+        if (nof_players < 3 || nof_players > 6) {
+            std::cerr << "Usage: " << argv[0] << " [--games=<n>] [--players=<3-6>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left << std::setw(14) << "mode" << std::right
+              << std::setw(14) << "games/s" << std::setw(14) << "moves/s" << std::setw(18) << "allocs/game"
+              << std::endl;
+    for (const bool with_diffs : {false, true}) {
+        const simulation_result result = simulate(games, nof_players, with_diffs);
+        std::cout << std::left << std::setw(14) << (with_diffs ? "logic+diffs" : "logic") << std::right
+                  << std::setw(14) << games / result.seconds << std::setw(14) << result.moves / result.seconds
+                  << std::setw(18) << result.allocations << std::endl;
+    }
+    return 0;
+}
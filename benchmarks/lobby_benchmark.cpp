@@ -0,0 +1,232 @@
+//
+// Matchmaking benchmark of the Wizard-server.
+//
+// Registers many running games with the game_instance_manager (every game is joined by some players and started),
+// and then measures how many players per second can join a game while all those games stay registered. All players
+// send their requests to the request_handler, which executes them in the mailboxes of the games on the worker_pool,
+// exactly like requests from the network. Every thread waits for the response of its request before it sends the
+// next one.
+//
+// With --churn, the benchmark instead repeats cycles in which the games are registered and started, and all their
+// players leave again with leave requests. The resident memory after every cycle shows whether finished games and
+// departed players are reclaimed.
+//
+// Usage: Wizard-bench-lobby [--games=<n>] [--players=<3-6>] [--joins=<n>] [--threads=<n>] [--churn=<cycles>]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/common/serialization/uuid_generator.h"
+#include "../src/server/game_instance_manager.h"
+#include "../src/server/player_manager.h"
+#include "../src/server/request_handler.h"
+#include "../src/server/worker_pool.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// Drops everything written to it. Unlike a string stream, it can be written to by all workers at the same time.
+struct null_buffer : std::streambuf {
+    int overflow(int c) override { return c; }
+};
+
+// Sends a request of a player and waits for the response. Returns whether the request succeeded.
+static bool send_request(RequestType type, const std::string& player_id, const std::string& name = "") {
+    request_view req;
+    req.type = type;
+    req.req_id = player_id;
+    req.player_id = player_id;
+    req.player_name = name;
+    std::promise<bool> success;
+    request_handler::dispatch_request(req, [&success](const request_response& res) {
+        rapidjson::Document* json = res.to_json();
+        success.set_value((*json)["success"].GetBool());
+        delete json;
+    });
+    return success.get_future().get();
+}
+
+// Lets a new player join any game with a join request without a game id. Returns the joined game.
+static std::shared_ptr<game_instance> join_any_game(const std::string& name, entity_id* player_id = nullptr) {
+    std::shared_ptr<player> p;
+    std::shared_ptr<game_instance> game;
+    std::string err;
+    const entity_id id = entity_id::generate();
+    if (!send_request(RequestType::join_game, id.to_string(), name)
+        || !game_instance_manager::try_get_player_and_game_instance(id, p, game, err)) {
+        return nullptr;
+    }
+    if (player_id != nullptr) {
+        *player_id = id;
+    }
+    return game;
+}
+
+// Sends a join request without a game id for a new player. Returns whether a game was joined.
+static bool request_join(const std::string& name) {
+    return send_request(RequestType::join_game, uuid_generator::generate_uuid_v4(), name);
+}
+
+// Lets a player leave their game and the server with a leave request.
+static bool leave_server(const entity_id& player_id) {
+    return send_request(RequestType::leave_game, player_id.to_string());
+}
+
+static long read_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+// Registers and starts 'nof_games' games, then lets all their players leave. Returns false if a player could not
+// join or leave.
+static bool run_churn_cycle(size_t nof_games, int nof_players) {
+    std::vector<entity_id> player_ids(nof_players);
+    for (size_t g = 0; g < nof_games; g++) {
+        std::shared_ptr<game_instance> game;
+        for (int i = 0; i < nof_players; i++) {
+            game = join_any_game("player " + std::to_string(i), &player_ids[i]);
+            if (game == nullptr) {
+                return false;
+            }
+        }
+        send_request(RequestType::start_game, player_ids.front().to_string());
+        game.reset();
+        for (const entity_id& id : player_ids) {
+            if (!leave_server(id)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t nof_games = 100000;
+    int nof_players = 3;
+    size_t nof_joins = 30000;
+    unsigned int nof_threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t nof_churn_cycles = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--games=", 0) == 0) {
+            nof_games = std::stoul(arg.substr(8));
+        } else if (arg.rfind("--players=", 0) == 0) {
+            nof_players = std::clamp(std::stoi(arg.substr(10)), 3, 6);
+        } else if (arg.rfind("--joins=", 0) == 0) {
+            nof_joins = std::stoul(arg.substr(8));
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            nof_threads = std::max(1u, static_cast<unsigned int>(std::stoul(arg.substr(10))));
+        } else if (arg.rfind("--churn=", 0) == 0) {
+            nof_churn_cycles = std::stoul(arg.substr(8));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--games=<n>] [--players=<3-6>] [--joins=<n>] [--threads=<n>] [--churn=<cycles>]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    // the players have no connections, so the server's attempts to send them state updates only produce log output
+    null_buffer discarded;
+    std::streambuf* cout_buffer = std::cout.rdbuf(&discarded);
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(&discarded);
+
+    if (nof_churn_cycles > 0) {
+        const long rss_start_kb = read_rss_kb();
+        std::vector<long> rss_kb;
+        std::vector<size_t> registered_games;
+        auto churn_start = bench_clock::now();
+        for (size_t c = 0; c < nof_churn_cycles; c++) {
+            if (!run_churn_cycle(nof_games, nof_players)) {
+                std::cout.rdbuf(cout_buffer);
+                std::cerr.rdbuf(cerr_buffer);
+                std::cerr << "A player could not join or leave a game in cycle " << c << std::endl;
+                return 1;
+            }
+            rss_kb.push_back(read_rss_kb());
+            registered_games.push_back(game_instance_manager::get_nof_games());
+        }
+        double churn_seconds = std::chrono::duration<double>(bench_clock::now() - churn_start).count();
+
+        std::cout.rdbuf(cout_buffer);
+        std::cerr.rdbuf(cerr_buffer);
+        std::cout << "games per cycle:       " << nof_games << " with " << nof_players << " players" << std::endl
+                  << "cycles:                " << nof_churn_cycles << " ("
+                  << nof_churn_cycles * nof_games / churn_seconds << " games/s)" << std::endl
+                  << "RSS at start:          " << rss_start_kb << " kB" << std::endl;
+        for (size_t c = 0; c < rss_kb.size(); c++) {
+            std::cout << "RSS after cycle " << c + 1 << ":     " << rss_kb[c] << " kB (" << registered_games[c]
+                      << " games registered)" << std::endl;
+        }
+        return 0;
+    }
+
+    // register the running games
+    auto setup_start = bench_clock::now();
+    for (size_t g = 0; g < nof_games; g++) {
+        entity_id first;
+        for (int i = 0; i < nof_players; i++) {
+            join_any_game("player " + std::to_string(i), i == 0 ? &first : nullptr);
+        }
+        send_request(RequestType::start_game, first.to_string());
+    }
+    double setup_seconds = std::chrono::duration<double>(bench_clock::now() - setup_start).count();
+
+    // measure the joins of new players, the requests of all concurrent threads go through the same registries
+    std::vector<std::vector<double>> latencies(nof_threads);
+    std::vector<std::thread> threads;
+    auto join_start = bench_clock::now();
+    for (unsigned int t = 0; t < nof_threads; t++) {
+        threads.emplace_back([&, t]() {
+            const size_t begin = nof_joins * t / nof_threads;
+            const size_t end = nof_joins * (t + 1) / nof_threads;
+            for (size_t i = begin; i < end; i++) {
+                auto start = bench_clock::now();
+                if (!request_join("joining player")) {
+                    return;
+                }
+                latencies[t].push_back(std::chrono::duration<double, std::micro>(bench_clock::now() - start).count());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double join_seconds = std::chrono::duration<double>(bench_clock::now() - join_start).count();
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+
+    std::vector<double> all;
+    for (auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    if (all.size() != nof_joins) {
+        std::cerr << "Only " << all.size() << " of " << nof_joins << " players could join a game" << std::endl;
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) { return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))]; };
+
+    std::cout << "running games:         " << nof_games << " with " << nof_players << " players (registered in "
+              << setup_seconds << " s)" << std::endl
+              << "threads:               " << nof_threads << " (" << worker_pool::get_instance().get_nof_threads()
+              << " workers)" << std::endl
+              << "joins:                 " << nof_joins << " (" << nof_joins / join_seconds << " joins/s)" << std::endl
+              << "join latency p50:      " << percentile(0.50) << " us" << std::endl
+              << "join latency p99:      " << percentile(0.99) << " us" << std::endl;
+    return 0;
+}
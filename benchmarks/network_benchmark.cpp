@@ -0,0 +1,256 @@
+//
+// Network benchmark for the Wizard-server.
+//
+// Starts a Wizard-server in the requested I/O mode, opens many client connections which all join a game, and then
+// measures the round trip latency of requests while all connections stay open. The server's resident memory is
+// sampled before and after the connections were opened to estimate how many connections fit into one GB.
+//
+// Usage: Wizard-bench-network <path to Wizard-server> [--io=threads|reactor] [--io-threads=<n>]
+//                             [--connections=<n>] [--clients=<n>] [--rounds=<n>] [--encoding=binary|json]
+//                             [--request=estimate|resync]
+//
+// By default, the latency requests are trick estimates of -1, which the server always rejects without broadcasting a
+// state update, so the measurement only covers the network path and request dispatch of the server. With
+// --request=resync, every request asks for the full game state instead, which is served from the server's state cache
+// as long as the game does not change.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sockpp/tcp_connector.h"
+
+#include "../src/common/network/default.conf"
+#include "../src/common/network/frame_reader.h"
+#include "../src/common/network/wire_format.h"
+#include "../src/common/network/requests/join_game_request.h"
+#include "../src/common/network/requests/estimate_tricks_request.h"
+#include "../src/common/network/requests/resync_request.h"
+#include "../src/common/serialization/uuid_generator.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// A blocking client connection that speaks the framing of the server (see wire_format) in the given encoding.
+struct bench_connection {
+    sockpp::tcp_connector socket;
+    wire_format::encoding encoding = wire_format::encoding::binary;
+    std::string player_id;
+    std::string game_id;
+    frame_reader reader;
+
+    bool send_request(const client_request& req) {
+        rapidjson::Document* json = req.to_json();
+        std::string frame = wire_format::make_frame(wire_format::encode(*json, encoding), encoding);
+        delete json;
+        return socket.write(frame) == static_cast<ssize_t>(frame.size());
+    }
+
+    // the payload of the returned frame is valid until the next call
+    bool read_frame(frame_reader::frame& f) {
+        while (true) {
+            wire_format::frame_status status = reader.next_frame(f);
+            if (status != wire_format::frame_status::incomplete) {
+                return status == wire_format::frame_status::complete;
+            }
+            size_t available = 0;
+            char* buffer = reader.prepare(available);
+            ssize_t count = socket.read(buffer, available);
+            if (count <= 0) {
+                return false;
+            }
+            reader.commit(count);
+        }
+    }
+
+    // Reads frames until the response to the last request arrives. State broadcasts are skipped.
+    bool await_response(rapidjson::Document& response) {
+        frame_reader::frame f;
+        while (read_frame(f)) {
+            try {
+                wire_format::decode(f.data, f.size, f.encoding, response);
+            } catch (const std::exception&) {
+                return false;
+            }
+            if (response.IsObject() && response.HasMember("type")
+                && std::string(response["type"].GetString()) == "req_response") {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+static long read_rss_kb(pid_t pid) {
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return -1;
+}
+
+static bool connect_to_server(sockpp::tcp_connector& socket) {
+    return socket.connect(sockpp::inet_address(default_server_host, default_port));
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <path to Wizard-server> [--io=threads|reactor] [--io-threads=<n>] "
+                  << "[--connections=<n>] [--clients=<n>] [--rounds=<n>] [--encoding=binary|json] "
+                  << "[--request=estimate|resync]" << std::endl;
+        return 1;
+    }
+
+    std::string server_path = argv[1];
+    std::vector<std::string> server_args;
+    size_t nof_connections = 600;
+    size_t nof_clients = 4;
+    size_t nof_rounds = 20;
+    wire_format::encoding encoding = wire_format::encoding::binary;
+    bool resync = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--io", 0) == 0) {
+            server_args.push_back(arg);
+        } else if (arg.rfind("--connections=", 0) == 0) {
+            nof_connections = std::stoul(arg.substr(14));
+        } else if (arg.rfind("--clients=", 0) == 0) {
+            nof_clients = std::max<size_t>(1, std::stoul(arg.substr(10)));
+        } else if (arg.rfind("--rounds=", 0) == 0) {
+            nof_rounds = std::stoul(arg.substr(9));
+        } else if (arg == "--encoding=json" || arg == "--encoding=binary") {
+            encoding = arg == "--encoding=json" ? wire_format::encoding::json : wire_format::encoding::binary;
+        } else if (arg == "--request=estimate" || arg == "--request=resync") {
+            resync = arg == "--request=resync";
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    sockpp::socket_initializer socket_initializer;
+
+    // start the server with its console output discarded
+    pid_t server_pid = fork();
+    if (server_pid == 0) {
+        int dev_null = open("/dev/null", O_WRONLY);
+        dup2(dev_null, STDOUT_FILENO);
+        dup2(dev_null, STDERR_FILENO);
+        std::vector<char*> exec_args;
+        exec_args.push_back(server_path.data());
+        for (auto& arg : server_args) {
+            exec_args.push_back(arg.data());
+        }
+        exec_args.push_back(nullptr);
+        execv(server_path.c_str(), exec_args.data());
+        _exit(127);
+    }
+
+    // wait until the server accepts connections
+    bool server_up = false;
+    for (int attempt = 0; attempt < 100 && !server_up; attempt++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        sockpp::tcp_connector probe;
+        server_up = connect_to_server(probe);
+    }
+    if (!server_up) {
+        std::cerr << "Could not connect to the server" << std::endl;
+        kill(server_pid, SIGTERM);
+        waitpid(server_pid, nullptr, 0);
+        return 1;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    long rss_idle_kb = read_rss_kb(server_pid);
+
+    // open all connections and let every connection join a game
+    std::vector<bench_connection> connections(nof_connections);
+    auto join_start = bench_clock::now();
+    for (size_t i = 0; i < nof_connections; i++) {
+        bench_connection& conn = connections[i];
+        conn.encoding = encoding;
+        conn.player_id = uuid_generator::generate_uuid_v4();
+        rapidjson::Document response;
+        if (!connect_to_server(conn.socket)
+            || !conn.send_request(join_game_request(conn.player_id, "bench_" + std::to_string(i)))
+            || !conn.await_response(response)) {
+            std::cerr << "Connection " << i << " failed to join: " << conn.socket.last_error_str() << std::endl;
+            kill(server_pid, SIGTERM);
+            waitpid(server_pid, nullptr, 0);
+            return 1;
+        }
+        conn.game_id = response["game_id"].GetString();
+    }
+    double join_seconds = std::chrono::duration<double>(bench_clock::now() - join_start).count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    long rss_loaded_kb = read_rss_kb(server_pid);
+
+    // measure request latency with several concurrent client threads while all connections are open
+    std::vector<std::vector<double>> latencies(nof_clients);
+    std::vector<std::thread> clients;
+    auto latency_start = bench_clock::now();
+    for (size_t c = 0; c < nof_clients; c++) {
+        clients.emplace_back([&, c]() {
+            for (size_t round = 0; round < nof_rounds; round++) {
+                for (size_t i = c; i < nof_connections; i += nof_clients) {
+                    bench_connection& conn = connections[i];
+                    rapidjson::Document response;
+                    auto start = bench_clock::now();
+                    const bool sent = resync
+                            ? conn.send_request(resync_request(conn.game_id, conn.player_id))
+                            : conn.send_request(estimate_tricks_request(conn.game_id, conn.player_id, -1));
+                    if (!sent || !conn.await_response(response)) {
+                        return;
+                    }
+                    latencies[c].push_back(std::chrono::duration<double, std::micro>(bench_clock::now() - start).count());
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    double latency_seconds = std::chrono::duration<double>(bench_clock::now() - latency_start).count();
+
+    kill(server_pid, SIGTERM);
+    waitpid(server_pid, nullptr, 0);
+
+    std::vector<double> all;
+    for (auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    if (all.empty()) {
+        std::cerr << "No requests completed" << std::endl;
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](double p) { return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))]; };
+
+    double rss_per_connection_kb = static_cast<double>(rss_loaded_kb - rss_idle_kb) / nof_connections;
+    std::cout << "I/O mode:              " << (server_args.empty() ? "--io=threads" : server_args.front()) << std::endl
+              << "encoding:              " << (encoding == wire_format::encoding::json ? "json" : "binary") << std::endl
+              << "request:               " << (resync ? "resync" : "estimate") << std::endl
+              << "connections:           " << nof_connections << " (joined in " << join_seconds << " s)" << std::endl
+              << "server RSS idle:       " << rss_idle_kb << " kB" << std::endl
+              << "server RSS loaded:     " << rss_loaded_kb << " kB" << std::endl
+              << "RSS per connection:    " << rss_per_connection_kb << " kB" << std::endl
+              << "connections per GB:    "
+              << (rss_per_connection_kb > 0 ? static_cast<long>(1024.0 * 1024.0 / rss_per_connection_kb) : -1) << std::endl
+              << "requests:              " << all.size() << " (" << all.size() / latency_seconds << " req/s)" << std::endl
+              << "latency p50:           " << percentile(0.50) << " us" << std::endl
+              << "latency p99:           " << percentile(0.99) << " us" << std::endl
+              << "latency max:           " << all.back() << " us" << std::endl;
+    return 0;
+}
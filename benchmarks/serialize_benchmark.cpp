@@ -0,0 +1,157 @@
+//
+// Serialization benchmark of the Wizard-server.
+//
+// Plays a game with 3 to 6 players and measures, in the first trick and in the last round of the game, how long it
+// takes to turn the messages the server sends most often into json frames: once by building the json document of the
+// message (serializable::to_json()), printing it and prepending the frame header, and once by writing the message
+// straight into the frame with a json writer (wire_format::make_frame(), see serializable::write_into_writer()).
+// Both paths must produce the same bytes, otherwise the benchmark fails.
+//
+// The full state is the state sent to a player who joins or resyncs, the diff is the state update broadcast after a
+// card was played.
+//
+// Usage: Wizard-bench-serialize [--iterations=<n>]
+//
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/common/game_state/game_state.h"
+#include "../src/common/network/responses/full_state_response.h"
+#include "../src/common/network/responses/state_diff_response.h"
+#include "../src/common/network/wire_format.h"
+#include "../src/common/serialization/json_utils.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+// calls 'serialize' 'iterations' times and returns the average time
+template<typename F>
+static double measure(F serialize, size_t iterations) {
+    const auto start = bench_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        serialize();
+    }
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / iterations;
+}
+
+// measures both ways of serializing 'msg' and prints them, returns false if they produce different frames
+static bool print_row(const std::string& message, size_t nof_players, const server_response& msg,
+                      size_t iterations) {
+    const auto document_frame = [&msg] {
+        rapidjson::Document* json = msg.to_json();
+        std::string frame = wire_format::make_frame(json_utils::to_string(json), wire_format::encoding::json);
+        delete json;
+        return frame;
+    };
+    const auto writer_frame = [&msg] {
+        return wire_format::make_frame(msg, wire_format::encoding::json);
+    };
+    const std::string frame = writer_frame();
+    if (frame != document_frame()) {
+        std::cerr << "The json writer and the json document of the " << message << " differ" << std::endl;
+        return false;
+    }
+
+    size_t checksum = 0;
+    const double document_ns = measure([&] { checksum += document_frame().size(); }, iterations);
+    const double writer_ns = measure([&] { checksum += writer_frame().size(); }, iterations);
+    std::cout << std::left << std::setw(12) << message << std::right << std::setw(8) << nof_players
+              << std::setw(10) << frame.size() << std::setw(14) << document_ns << std::setw(14) << writer_ns
+              << std::setw(10) << std::setprecision(2) << document_ns / writer_ns << std::setprecision(0)
+              << std::endl;
+    return checksum == 2 * iterations * frame.size();
+}
+
+// lets every player estimate, the last player may have to avoid the estimate that matches the number of tricks
+static bool estimate_all(game_state& state, std::string& err) {
+    while (state.is_estimation_phase()) {
+        if (!state.estimate_tricks(state.get_current_player(), err, 0)
+            && !state.estimate_tricks(state.get_current_player(), err, 1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// plays the first card of the current player that may be played
+static bool play_first_card(game_state& state, std::string& err) {
+    player* current = state.get_current_player();
+    const uint64_t playable = state.get_playable_mask();
+    for (const card* c : current->get_hand()->get_card_span()) {
+        if (card_mask::contains(playable, c->get_value(), c->get_color())) {
+            return state.play_card(current, c->get_entity_id(), err);
+        }
+    }
+    return false;
+}
+
+// measures the messages of the current state of the game, in which the current player is about to play a card
+static bool print_rows(game_state& state, size_t nof_players, size_t iterations, std::string& err) {
+    state.clear_dirty();
+    const full_state_response full_state = full_state_response(state.get_id(), state);
+    if (!print_row("full state", nof_players, full_state, iterations)) {
+        return false;
+    }
+    if (!play_first_card(state, err)) {
+        return false;
+    }
+    const state_diff_response diff = state_diff_response(state.get_id(), state);
+    return print_row("diff", nof_players, diff, iterations);
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 20000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--iterations=", 0) == 0) {
+            iterations = std::max<size_t>(1, std::stoul(arg.substr(13)));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--iterations=<n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    for (const std::string phase : {"first trick", "last round"}) {
+        std::cout << phase << std::endl << std::fixed << std::setprecision(0)
+                  << std::left << std::setw(12) << "message" << std::right << std::setw(8) << "players"
+                  << std::setw(10) << "bytes" << std::setw(14) << "document ns" << std::setw(14) << "writer ns"
+                  << std::setw(10) << "speedup" << std::endl;
+
+        for (size_t nof_players = 3; nof_players <= 6; nof_players++) {
+            game_state state = game_state(nof_players);
+            std::string err;
+            for (size_t p = 0; p < nof_players; p++) {
+                state.add_player(new player("player" + std::to_string(p + 1)), err);
+            }
+            if (!state.start_game(err)) {
+                std::cerr << "Could not start the game: " << err << std::endl;
+                return 1;
+            }
+
+            bool ok = true;
+            if (phase == "last round") {
+                // play until the last round, then until all but one player played a card in its first trick
+                while (ok && state.get_round_number() + 1 < static_cast<int>(state.get_max_round_number())) {
+                    ok = estimate_all(state, err) && play_first_card(state, err);
+                }
+                ok = ok && estimate_all(state, err);
+                for (size_t p = 0; ok && p + 2 < nof_players; p++) {
+                    ok = play_first_card(state, err);
+                }
+            }
+            ok = ok && estimate_all(state, err) && print_rows(state, nof_players, iterations, err);
+            if (!ok) {
+                std::cerr << "Could not play the game: " << err << std::endl;
+                return 1;
+            }
+            for (player* p : state.get_players()) {
+                delete p;
+            }
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,186 @@
+//
+// Headless self-play simulator of the Wizard game.
+//
+// Plays complete games on the server's game state, without any network or client. Every seat is controlled by a
+// policy (see policy.h); the policies are assigned to the seats in the given order and repeated if there are more
+// seats than policies. Every worker thread plays its own, independent games. Reports the simulated games and moves
+// per second, the heap allocations per game, and the distribution of the final scores per seat. Runs with the same
+// seed play the same games.
+//
+// Usage: Wizard-sim [--games=<n>] [--players=<3-6>] [--threads=<n>] [--policies=<name>,...] [--seed=<n>]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulator.h"
+
+using sim_clock = std::chrono::steady_clock;
+
+// every heap allocation of the process is counted
+static std::atomic<size_t> nof_allocations {0};
+
+void* operator new(size_t size) {
+    nof_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// the results of the games played by one worker thread
+struct worker_result {
+    size_t moves = 0;
+    std::vector<std::vector<int>> seat_scores;
+    std::vector<size_t> seat_wins;
+    std::string err;
+};
+
+// plays the games [first_game, end_game); the seed of every game only depends on the run's seed and the game's number,
+// so a run gives the same results with any number of threads
+static void run_worker(const std::vector<std::string>& seat_policies, const uint64_t seed, const size_t first_game,
+                       const size_t end_game, worker_result& result) {
+    try {
+        simulator sim(seat_policies);
+        result.seat_scores.resize(seat_policies.size());
+        result.seat_wins.resize(seat_policies.size(), 0);
+        for (size_t i = first_game; i < end_game; i++) {
+            const game_result game = sim.play_game(random_generator(seed + i).next());
+            result.moves += game.moves;
+            const int best = *std::max_element(game.scores.begin(), game.scores.end());
+            for (size_t seat = 0; seat < game.scores.size(); seat++) {
+                result.seat_scores[seat].push_back(game.scores[seat]);
+                // ties count as a win for every best player
+                if (game.scores[seat] == best) {
+                    result.seat_wins[seat]++;
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        result.err = e.what();
+    }
+}
+
+static std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+int main(int argc, char* argv[]) {
+    size_t games = 10000;
+    int nof_players = 4;
+    unsigned int nof_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> policies = {"greedy"};
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--games=", 0) == 0) {
+            games = std::max<size_t>(1, std::stoul(arg.substr(8)));
+        } else if (arg.rfind("--players=", 0) == 0) {
+            nof_players = std::stoi(arg.substr(10));
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            nof_threads = std::max(1, std::stoi(arg.substr(10)));
+        } else if (arg.rfind("--policies=", 0) == 0) {
+            policies = split(arg.substr(11));
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::stoull(arg.substr(7));
+        } else {
+            nof_players = 0;
+        }
+        if (nof_players < 3 || nof_players > 6 || policies.empty()) {
+            std::cerr << "Usage: " << argv[0] << " [--games=<n>] [--players=<3-6>] [--threads=<n>]"
+                      << " [--policies=<name>,...] [--seed=<n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> seat_policies;
+    for (int seat = 0; seat < nof_players; seat++) {
+        seat_policies.push_back(policies[seat % policies.size()]);
+    }
+
+    // the games are split evenly among the threads
+    nof_threads = static_cast<unsigned int>(std::min<size_t>(nof_threads, games));
+    std::vector<worker_result> results(nof_threads);
+    std::vector<std::thread> workers;
+    const size_t allocations_before = nof_allocations.load();
+    const auto start = sim_clock::now();
+    for (unsigned int t = 0; t < nof_threads; t++) {
+        workers.emplace_back(run_worker, std::cref(seat_policies), seed, games * t / nof_threads,
+                             games * (t + 1) / nof_threads, std::ref(results[t]));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const double seconds = std::chrono::duration<double>(sim_clock::now() - start).count();
+    const size_t allocations = nof_allocations.load() - allocations_before;
+
+    size_t moves = 0;
+    std::vector<std::vector<int>> seat_scores(nof_players);
+    std::vector<size_t> seat_wins(nof_players, 0);
+    for (const worker_result& result : results) {
+        if (!result.err.empty()) {
+            std::cerr << "Simulation failed: " << result.err << std::endl;
+            return 1;
+        }
+        moves += result.moves;
+        for (int seat = 0; seat < nof_players; seat++) {
+            seat_scores[seat].insert(seat_scores[seat].end(),
+                                     result.seat_scores[seat].begin(), result.seat_scores[seat].end());
+            seat_wins[seat] += result.seat_wins[seat];
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << games << " games, " << nof_players << " players, " << nof_threads << " threads" << std::endl
+              << std::left << std::setw(14) << "games/s" << std::setw(14) << "moves/s" << std::setw(14)
+              << "allocs/game" << std::endl
+              << std::setw(14) << games / seconds << std::setw(14) << moves / seconds << std::setw(14)
+              << static_cast<double>(allocations) / games << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(6) << "seat" << std::setw(10) << "policy" << std::right
+              << std::setw(10) << "mean" << std::setw(10) << "stddev" << std::setw(8) << "min"
+              << std::setw(8) << "p50" << std::setw(8) << "max" << std::setw(10) << "wins %" << std::endl;
+    for (int seat = 0; seat < nof_players; seat++) {
+        std::vector<int>& scores = seat_scores[seat];
+        std::sort(scores.begin(), scores.end());
+        double mean = 0;
+        for (const int score : scores) {
+            mean += score;
+        }
+        mean /= scores.size();
+        double variance = 0;
+        for (const int score : scores) {
+            variance += (score - mean) * (score - mean);
+        }
+        variance /= scores.size();
+        std::cout << std::left << std::setw(6) << seat << std::setw(10) << seat_policies[seat] << std::right
+                  << std::setw(10) << mean << std::setw(10) << std::sqrt(variance)
+                  << std::setw(8) << scores.front() << std::setw(8) << scores[scores.size() / 2]
+                  << std::setw(8) << scores.back() << std::setw(10) << 100.0 * seat_wins[seat] / games << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+//
+// Policies that decide the moves of the players in simulated games.
+//
+
+#include "policy.h"
+
+std::unique_ptr<policy> policy::create(const std::string& name, const uint64_t seed) {
+    if (name == "first") {
+        return std::make_unique<first_policy>();
+    }
+    if (name == "random") {
+        return std::make_unique<random_policy>(seed);
+    }
+    if (name == "greedy") {
+        return std::make_unique<greedy_policy>();
+    }
+    return nullptr;
+}
+
+std::vector<std::string> policy::get_names() {
+    return {"first", "random", "greedy"};
+}
+
+// how likely a card wins a trick: wizards, then trumps, then the other cards, each by value; jesters never win
+static int get_strength(const card* c, const int trump_color) {
+    if (c->get_value() == card_mask::wizard_value) {
+        return 100;
+    }
+    if (c->get_value() == card_mask::jester_value) {
+        return 0;
+    }
+    return c->get_value() + (c->get_color() == trump_color ? 50 : 0);
+}
+
+static bool is_playable(const card* c, const uint64_t playable) {
+    return card_mask::contains(playable, c->get_value(), c->get_color());
+}
+
+
+// first policy
+int first_policy::estimate_tricks(const game_state& state, const player& self) {
+    return 0;
+}
+
+card* first_policy::choose_card(const game_state& state, const player& self, const uint64_t playable) {
+    for (card* c : self.get_hand()->get_card_span()) {
+        if (is_playable(c, playable)) {
+            return c;
+        }
+    }
+    return nullptr;
+}
+
+
+// random policy
+random_policy::random_policy(const uint64_t seed) : _rng(seed) { }
+
+int random_policy::estimate_tricks(const game_state& state, const player& self) {
+    return _rng.next_below(static_cast<int>(self.get_nof_cards()) + 1);
+}
+
+card* random_policy::choose_card(const game_state& state, const player& self, const uint64_t playable) {
+    // the n-th playable card of the hand, for a random n
+    int n = _rng.next_below(card_mask::size(playable));
+    for (card* c : self.get_hand()->get_card_span()) {
+        if (is_playable(c, playable) && n-- == 0) {
+            return c;
+        }
+    }
+    return nullptr;
+}
+
+
+// greedy policy
+int greedy_policy::estimate_tricks(const game_state& state, const player& self) {
+    int estimate = 0;
+    for (const card* c : self.get_hand()->get_card_span()) {
+        // wizards, trumps from 10 upwards (a trump is 50 stronger than its value) and aces of the other colors
+        const int strength = get_strength(c, state.get_trump_color());
+        if (strength >= 50 + 10 || strength == 13) {
+            estimate++;
+        }
+    }
+    return estimate;
+}
+
+card* greedy_policy::choose_card(const game_state& state, const player& self, const uint64_t playable) {
+    const bool wants_tricks = self.get_nof_tricks() < self.get_nof_predicted();
+    card* choice = nullptr;
+    int choice_strength = 0;
+    for (card* c : self.get_hand()->get_card_span()) {
+        if (!is_playable(c, playable)) {
+            continue;
+        }
+        const int strength = get_strength(c, state.get_trump_color());
+        if (choice == nullptr || (wants_tricks ? strength > choice_strength : strength < choice_strength)) {
+            choice = c;
+            choice_strength = strength;
+        }
+    }
+    return choice;
+}
@@ -0,0 +1,103 @@
+//
+// Policies that decide the moves of the players in simulated games.
+//
+
+#ifndef WIZARD_POLICY_H
+#define WIZARD_POLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/common/game_state/game_state.h"
+
+/**
+ * @class policy
+ * @brief Decides the moves of a player in a simulated game.
+ *
+ * A policy only looks at the game state and returns its decision; the simulator applies it to the game state. Every
+ * seat of a simulated game gets its own policy object, so policies may keep state across the moves of a game.
+ */
+class policy {
+
+public:
+    virtual ~policy() = default;
+
+    /**
+     * @brief Decides how many tricks the player estimates to win in the current round.
+     * @param state The game state.
+     * @param self The player who estimates.
+     * @return The trick estimate. If the estimate is not allowed, the simulator takes the closest allowed estimate.
+     */
+    virtual int estimate_tricks(const game_state& state, const player& self) = 0;
+
+    /**
+     * @brief Decides which card the player plays.
+     * @param state The game state.
+     * @param self The player who plays.
+     * @param playable The card mask (see card_mask.h) of the cards the player may play, never empty.
+     * @return A card of the player's hand that is contained in playable.
+     */
+    virtual card* choose_card(const game_state& state, const player& self, uint64_t playable) = 0;
+
+    /**
+     * @brief Creates a policy by its name.
+     * @param name The name of the policy (see get_names()).
+     * @param seed The seed of the policy's random numbers.
+     * @return The new policy, or nullptr if there is no policy with this name.
+     */
+    static std::unique_ptr<policy> create(const std::string& name, uint64_t seed);
+
+    /**
+     * @brief Gets the names of all policies.
+     * @return The names of all policies.
+     */
+    static std::vector<std::string> get_names();
+};
+
+/**
+ * @class first_policy
+ * @brief Estimates no tricks and plays the first playable card of the hand.
+ */
+class first_policy : public policy {
+
+public:
+    int estimate_tricks(const game_state& state, const player& self) override;
+
+    card* choose_card(const game_state& state, const player& self, uint64_t playable) override;
+};
+
+/**
+ * @class random_policy
+ * @brief Estimates a random number of tricks and plays a random playable card.
+ */
+class random_policy : public policy {
+
+private:
+    random_generator _rng;
+
+public:
+    explicit random_policy(uint64_t seed);
+
+    int estimate_tricks(const game_state& state, const player& self) override;
+
+    card* choose_card(const game_state& state, const player& self, uint64_t playable) override;
+};
+
+/**
+ * @class greedy_policy
+ * @brief Estimates its strong cards and plays to meet its estimate.
+ *
+ * The estimate is the number of wizards, high trumps and aces in the hand. As long as the player has won fewer
+ * tricks than estimated, the strongest playable card is played, otherwise the weakest one.
+ */
+class greedy_policy : public policy {
+
+public:
+    int estimate_tricks(const game_state& state, const player& self) override;
+
+    card* choose_card(const game_state& state, const player& self, uint64_t playable) override;
+};
+
+#endif //WIZARD_POLICY_H
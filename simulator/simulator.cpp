@@ -0,0 +1,68 @@
+//
+// Plays complete games on the server's game state, without any network.
+//
+
+#include "simulator.h"
+
+#include <algorithm>
+
+#include "../src/common/exceptions/WizardException.h"
+
+simulator::simulator(const std::vector<std::string>& policy_names)
+    : _policy_names(policy_names)
+{
+    if (policy_names.size() < 3 || policy_names.size() > 6) {
+        throw WizardException("A game needs 3 to 6 players, got " + std::to_string(policy_names.size()));
+    }
+    for (const std::string& name : policy_names) {
+        if (policy::create(name, 0) == nullptr) {
+            throw WizardException("Unknown policy: " + name);
+        }
+    }
+}
+
+int simulator::get_nof_seats() const noexcept {
+    return static_cast<int>(_policy_names.size());
+}
+
+game_result simulator::play_game(const uint64_t seed) {
+    std::string err;
+    game_state state(seed);
+    std::vector<player*> seats;
+    std::vector<std::unique_ptr<policy>> policies;
+    for (size_t i = 0; i < _policy_names.size(); i++) {
+        policies.push_back(policy::create(_policy_names[i], seed + i + 1));
+        seats.push_back(new player(entity_id::generate(), "seat " + std::to_string(i)));
+        state.add_player(seats.back(), err);
+    }
+    state.start_game(err);
+
+    game_result result {seed, {}, 0};
+    while (!state.is_finished()) {
+        player* current = state.get_current_player();
+        const size_t seat = std::find(seats.begin(), seats.end(), current) - seats.begin();
+        policy& seat_policy = *policies[seat];
+        if (state.is_estimation_phase()) {
+            const int max_estimate = state.get_round_number() + 1;
+            const int estimate = std::clamp(seat_policy.estimate_tricks(state, *current), 0, max_estimate);
+            // the last player may not estimate a number of tricks that adds up to the number of cards, so the
+            // closest other estimate is taken instead
+            if (!state.estimate_tricks(current, err, estimate)) {
+                state.estimate_tricks(current, err, estimate < max_estimate ? estimate + 1 : estimate - 1);
+            }
+        } else {
+            const card* choice = seat_policy.choose_card(state, *current, state.get_playable_mask());
+            if (choice == nullptr || !state.play_card(current, choice->get_id(), err)) {
+                throw WizardException("Policy " + _policy_names[seat] + " made an illegal move in the game with seed "
+                                      + std::to_string(seed));
+            }
+        }
+        result.moves++;
+    }
+
+    for (player* p : seats) {
+        result.scores.push_back(p->get_scores().empty() ? 0 : p->get_scores().back());
+        delete p;
+    }
+    return result;
+}
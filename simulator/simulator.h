@@ -0,0 +1,56 @@
+//
+// Plays complete games on the server's game state, without any network.
+//
+
+#ifndef WIZARD_SIMULATOR_H
+#define WIZARD_SIMULATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "policy.h"
+
+/**
+ * @struct game_result
+ * @brief The outcome of a simulated game.
+ */
+struct game_result {
+    uint64_t seed;              ///< The seed of the game, which replays it exactly with the same policies.
+    std::vector<int> scores;    ///< The final score of every seat.
+    size_t moves;               ///< The number of trick estimates and played cards.
+};
+
+/**
+ * @class simulator
+ * @brief Plays complete games with a fixed set of seats, each controlled by a policy.
+ *
+ * The policies of a game are created with seeds derived from the game's seed, so the game's seed alone replays it.
+ * A simulator is not thread-safe; every thread plays its games on its own simulator.
+ */
+class simulator {
+
+private:
+    std::vector<std::string> _policy_names;
+
+public:
+    /**
+     * @brief Creates a simulator with one seat per policy name.
+     * @param policy_names The policy of every seat, 3 to 6 seats.
+     * @throws WizardException If a policy does not exist or the number of seats is not allowed.
+     */
+    explicit simulator(const std::vector<std::string>& policy_names);
+
+    /**
+     * @brief Plays one complete game.
+     * @param seed The seed of the game.
+     * @return The seed and final scores of the game and the number of moves.
+     * @throws WizardException If a policy chooses a card that is not allowed.
+     */
+    game_result play_game(uint64_t seed);
+
+    [[nodiscard]] int get_nof_seats() const noexcept;
+};
+
+#endif //WIZARD_SIMULATOR_H
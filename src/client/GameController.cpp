@@ -4,8 +4,11 @@
 #include "../common/network/requests/play_card_request.h"
 #include "../common/network/requests/estimate_tricks_request.h"
 #include "../common/network/requests/leave_game_request.h"
+#include "../common/network/requests/resync_request.h"
 #include "../client/messageBoxes/ErrorDialog.h"
 #include "../client/messageBoxes/ScoreDialog.h"
+#include "../client/messageBoxes/ScoreBoardDialog.h"
+#include "uiElements/ImageCache.h"
 #include "network/ClientNetworkManager.h"
 
 
@@ -119,7 +122,7 @@ void GameController::updateGameState(game_state* newGameState) {
                 player* winner = oldGameState->get_trick()->get_winner();
                 // get player of oldGameState that has same id as winner (winner is player of current game state)
                 for (auto& player_ : oldGameState->get_players()) {
-                    if (player_->get_id() == winner->get_id()) {
+                    if (player_->get_entity_id() == winner->get_entity_id()) {
                         winner = player_;
                     }
                 }
@@ -129,7 +132,7 @@ void GameController::updateGameState(game_state* newGameState) {
                 // make sure that last card is removed from hand
                 const player* last_player = oldGameState->get_current_player();
                 std::string last_player_error = "Card of last player of trick could not be removed from hand";
-                last_player->get_hand()->remove_card(trick_to_show->get_cards_and_players().back().first->get_id(), last_player_error);
+                last_player->get_hand()->remove_card(trick_to_show->get_cards_and_players().back().first->get_entity_id(), last_player_error);
 
                 GameController::_gameWindow->showPanel(GameController::_mainGamePanelWizard);
                 GameController::_mainGamePanelWizard->buildGameState(oldGameState, GameController::_me);
@@ -162,6 +165,16 @@ void GameController::updateGameState(game_state* newGameState) {
 }
 
 
+void GameController::requestFullState() {
+    // updates that arrive before the full state after joining are already contained in that full state
+    if(GameController::_currentGameState == nullptr) {
+        return;
+    }
+    resync_request request = resync_request(GameController::_currentGameState->get_id(), GameController::_me->get_id());
+    ClientNetworkManager::sendRequest(request);
+}
+
+
 void GameController::startGame() {
     start_game_request request = start_game_request(GameController::_currentGameState->get_id(), GameController::_me->get_id());
     ClientNetworkManager::sendRequest(request);
@@ -179,7 +192,7 @@ void GameController::estimateTricks(int nof_tricks) {
     ClientNetworkManager::sendRequest(request);
 }
 
-void GameController::playCard(card* cardToPlay) {
+void GameController::playCard(const card* cardToPlay) {
     play_card_request request = play_card_request(GameController::_currentGameState->get_id(), GameController::_me->get_id(), cardToPlay->get_id());
     ClientNetworkManager::sendRequest(request);
 }
@@ -216,7 +229,8 @@ void GameController::showError(const std::string& title, const std::string& mess
     // Load a custom image for the error dialog
     wxString fullpath = "assets/error.png";
 
-    wxBitmap errorImage(fullpath, wxBITMAP_TYPE_ANY);
+    // the image is only loaded once, the dialog shows it in 100x100
+    const wxBitmap& errorImage = ImageCache::getBitmap(fullpath, wxBITMAP_TYPE_ANY, wxSize(100, 100));
     // Create and show the custom error dialog
     ErrorDialog errorDialog(nullptr, title, message, errorImage);
     errorDialog.ShowModal();
@@ -239,14 +253,14 @@ void GameController::showNewRoundMessage(game_state* oldGameState, game_state* n
         player* oldPlayerState = oldGameState->get_players().at(i);
         player* newPlayerState = newGameState->get_players().at(i);
 
-        int scoreDelta = newPlayerState->get_scores().back()->get_value() - oldPlayerState->get_scores().back()->get_value();
+        int scoreDelta = newPlayerState->get_scores().back() - oldPlayerState->get_scores().back();
         std::string scoreText = std::to_string(scoreDelta);
         if(scoreDelta > 0) {
             scoreText = "+" + scoreText;
         }
 
         std::string playerName = newPlayerState->get_player_name();
-        if(newPlayerState->get_id() == GameController::_me->get_id()) {
+        if(newPlayerState->get_entity_id() == GameController::_me->get_entity_id()) {
             playerName = "You";
         }
         message += "\n" + playerName + ":     " + scoreText;
@@ -257,6 +271,12 @@ void GameController::showNewRoundMessage(game_state* oldGameState, game_state* n
     dialog->ShowModal();
 }
 
+void GameController::showScoreBoard()
+{
+    ScoreBoardDialog scoreBoard(nullptr, "ScoreBoard", "Here will be the scoreboard", GameController::_currentGameState);
+    scoreBoard.ShowModal();
+}
+
 void GameController::showTrickOverMessage(const player* winner)
 {
     std::string title = "Trick Completed";
@@ -275,32 +295,32 @@ void GameController::showGameOverMessage() {
     // sort players by score
     std::vector<player*> players = GameController::_currentGameState->get_players();
     std::sort(players.begin(), players.end(), [](const player* a, const player* b) -> bool {
-        return a->get_scores().back()->get_value() > b->get_scores().back()->get_value();
+        return a->get_scores().back() > b->get_scores().back();
     });
 
-    int max_score = players.front()->get_scores().back()->get_value();
+    int max_score = players.front()->get_scores().back();
 
     // list all players
     for(int i = 0; i < players.size(); i++) {
 
         player* playerState = players.at(i);
-        std::string scoreText = std::to_string(playerState->get_scores().back()->get_value());
+        std::string scoreText = std::to_string(playerState->get_scores().back());
 
         // first entry is the winner
         std::string winnerText = "";
         if(i == 0) {
             winnerText = "     Winner!";
         }
-        else if(players[i]->get_scores().back()->get_value() == max_score)
+        else if(players[i]->get_scores().back() == max_score)
         {
             winnerText = "     Winner!";
         }
 
         std::string playerName = playerState->get_player_name();
-        if(playerState->get_id() == GameController::_me->get_id()) {
+        if(playerState->get_entity_id() == GameController::_me->get_entity_id()) {
             playerName = "You";
 
-            if(i == 0 || players[i]->get_scores().back()->get_value() == max_score) {
+            if(i == 0 || players[i]->get_scores().back() == max_score) {
                 winnerText = "     You won!!!";
             }
         }
@@ -35,6 +35,11 @@ public:
      * @param newGameState The new game state send from the server.
      */
     static void updateGameState(game_state* newGameState);
+
+    /**
+     * @brief Send out 'resync' request to server, after an update of the game state was missed.
+     */
+    static void requestFullState();
     /**
      * @brief Send out 'start game' request to server.
      */
@@ -57,7 +62,7 @@ public:
      * @param cardToPlay Pointer to card that user chooses to play.
      */
 
-    static void playCard(card* cardToPlay);
+    static void playCard(const card* cardToPlay);
 
     /**
      * @brief Finds event handler for main thread.
@@ -81,6 +86,10 @@ public:
      * @param newGameState Updated game state of new round.
      */
     static void showNewRoundMessage(game_state* oldGameState, game_state* newGameState);
+    /**
+     * @brief Shows the score board with the scores of the current game state.
+     */
+    static void showScoreBoard();
     /**
      * @brief Shows message at the end of each trick stating which player won the trick.
      * @param winner Winner of the trick.
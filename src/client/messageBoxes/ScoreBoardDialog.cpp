@@ -9,7 +9,7 @@ ScoreBoardDialog::ScoreBoardDialog(wxWindow* parent, const std::string& title, c
     // put all player scores in a vector
     std::vector<player*> players = gameState->get_players();
     int numberOfPlayers = players.size();
-    std::vector<std::vector<serializable_value<int>*>> tableData(numberOfPlayers);
+    std::vector<std::vector<int>> tableData(numberOfPlayers);
     std::vector<std::string> playerNames(numberOfPlayers);
 
     // add playernames to vector
@@ -21,7 +21,7 @@ ScoreBoardDialog::ScoreBoardDialog(wxWindow* parent, const std::string& title, c
     std::vector<int> currentScores(numberOfPlayers);
     for (int i = 0; i < numberOfPlayers; i++)
     {
-        currentScores[i] = players.at(i)->get_scores().back()->get_value();
+        currentScores[i] = players.at(i)->get_scores().back();
     }
 
     // determine current winners
@@ -51,7 +51,7 @@ ScoreBoardDialog::ScoreBoardDialog(wxWindow* parent, const std::string& title, c
     // avoid showing scores that are initialized with 0 but not actual scores yet
     if (numRows >= 1) {
         for (int i = 0; i < numberOfPlayers; i++) {
-            auto scores = players.at(i)->get_scores();
+            const auto& scores = players.at(i)->get_scores();
             tableData[i].insert(
                     tableData[i].end(),             // Insert starting at the end of tableData[i]
                     scores.begin()+1,                 // Start of scores
@@ -77,7 +77,7 @@ ScoreBoardDialog::ScoreBoardDialog(wxWindow* parent, const std::string& title, c
         // Populate the grid with data
         for (int row = 0; row < numRows; ++row) {
             for (int col = 0; col < numCols; ++col) {
-                grid->SetCellValue(row, col, wxString::Format("%d", tableData[col][row]->get_value()));
+                grid->SetCellValue(row, col, wxString::Format("%d", tableData[col][row]));
                 if (maxIndices.size() != numberOfPlayers) // do not mark anything if all players have the same score
                 {
                     for (auto i: maxIndices) // mark all leaders
@@ -2,13 +2,21 @@
 
 
 #include "../GameController.h"
-#include "../../common/network/responses/server_response.h"
 #include <sockpp/exception.h>
 
 
 // initialize static members
 sockpp::tcp_connector* ClientNetworkManager::_connection = nullptr;
 
+#ifdef USE_JSON_WIRE_FORMAT
+const wire_format::encoding ClientNetworkManager::_encoding = wire_format::encoding::json;
+#else
+const wire_format::encoding ClientNetworkManager::_encoding = wire_format::encoding::binary;
+#endif
+
+update_coalescer ClientNetworkManager::_pendingUpdates;
+bool ClientNetworkManager::_isProcessingUpdates = false;
+
 bool ClientNetworkManager::_connectionSuccess = false;
 bool ClientNetworkManager::_failedToConnect = false;
 
@@ -87,21 +95,19 @@ void ClientNetworkManager::sendRequest(const client_request &request) {
 
     if(ClientNetworkManager::_connectionSuccess && ClientNetworkManager::_connection->is_connected()) {
 
-        // serialize request into JSON string
+        // serialize request into JSON
         rapidjson::Document* jsonDocument = request.to_json();
-        std::string message = json_utils::to_string(jsonDocument);
-        delete jsonDocument;
-
-        // turn message into stream and prepend message length
-        std::stringstream messageStream;
-        messageStream << std::to_string(message.size()) << ':' << message;
-        message = messageStream.str();
 
         // output message for debugging purposes
 #ifdef PRINT_NETWORK_MESSAGES
-        std::cout << "Sending request : " << message << std::endl;
+        std::cout << "Sending request : " << json_utils::to_string(jsonDocument) << std::endl;
 #endif
 
+        // encode the message and prepend the frame header with the message length
+        std::string message = wire_format::make_frame(wire_format::encode(*jsonDocument, ClientNetworkManager::_encoding),
+                                                      ClientNetworkManager::_encoding);
+        delete jsonDocument;
+
         // send message to server
         ssize_t bytesSent = ClientNetworkManager::_connection->write(message);
 
@@ -116,21 +122,51 @@ void ClientNetworkManager::sendRequest(const client_request &request) {
 }
 
 
-void ClientNetworkManager::parseResponse(const std::string& message) {
+void ClientNetworkManager::queueUpdate(response_decoder::update update) {
 
-    // output message for debugging purposes
-#ifdef PRINT_NETWORK_MESSAGES
-    std::cout << "Received response : " << message << std::endl;
-#endif
+    // the main thread is only notified if nothing was queued, otherwise it is still busy with the queued responses
+    if (ClientNetworkManager::_pendingUpdates.push(std::move(update))) {
+        GameController::getMainThreadEventHandler()->CallAfter([]{
+            ClientNetworkManager::processUpdates();
+        });
+    }
+}
 
-    rapidjson::Document json = rapidjson::Document(rapidjson::kObjectType);
-    json.Parse(message.c_str());
 
-    try {
-        server_response* res = server_response::from_json(json);
-        res->Process();
+void ClientNetworkManager::processUpdates() {
 
-    } catch (std::exception e) {
-        GameController::showError("JSON parsing error", "Failed to parse message from server:\n" + message + "\n" + (std::string) e.what());
+    // The dialogs at the end of a trick or round run their own event loop, which calls this function again for the
+    // responses received in the meantime. They stay queued (so the states of one trick are coalesced) until the
+    // dialog was closed.
+    if (ClientNetworkManager::_isProcessingUpdates) {
+        return;
     }
-}
\ No newline at end of file
+
+    // only one response is applied at a time, so that the window is repainted and user input is handled in between
+    response_decoder::update update;
+    if (ClientNetworkManager::_pendingUpdates.pop(update)) {
+        ClientNetworkManager::_isProcessingUpdates = true;
+        ClientNetworkManager::processUpdate(update);
+        ClientNetworkManager::_isProcessingUpdates = false;
+    }
+
+    if (ClientNetworkManager::_pendingUpdates.get_nof_pending() > 0) {
+        GameController::getMainThreadEventHandler()->CallAfter([]{
+            ClientNetworkManager::processUpdates();
+        });
+    }
+}
+
+
+void ClientNetworkManager::processUpdate(const response_decoder::update& update) {
+
+    if (update.state != nullptr) {
+        GameController::updateGameState(update.state);
+    }
+    if (update.resync) {
+        GameController::requestFullState();
+    }
+    if (!update.error.empty()) {
+        GameController::showError("Not possible", update.error);
+    }
+}
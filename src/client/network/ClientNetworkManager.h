@@ -5,6 +5,8 @@
 #include <string>
 #include "ResponseListenerThread.h"
 #include "../../common/network/requests/client_request.h"
+#include "../../common/network/update_coalescer.h"
+#include "../../common/network/wire_format.h"
 
 
 class ClientNetworkManager {
@@ -14,7 +16,11 @@ public:
 
     static void sendRequest(const client_request& request);
 
-    static void parseResponse(const std::string& message);
+    // queues a response decoded by the ResponseListenerThread for the main thread
+    static void queueUpdate(response_decoder::update update);
+
+    // applies the queued responses, called on the main thread
+    static void processUpdates();
 
 private:
     static bool connect(const std::string& host, const uint16_t port);
@@ -22,6 +28,15 @@ private:
 
     static sockpp::tcp_connector* _connection;
 
+    // the encoding of all requests, the server answers in the same encoding
+    static const wire_format::encoding _encoding;
+
+    // the responses decoded by the ResponseListenerThread that were not applied yet
+    static update_coalescer _pendingUpdates;
+    static bool _isProcessingUpdates;
+
+    static void processUpdate(const response_decoder::update& update);
+
     static bool _connectionSuccess;
     static bool _failedToConnect;
 
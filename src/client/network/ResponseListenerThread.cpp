@@ -2,9 +2,13 @@
 
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include "../GameController.h"
 #include "ClientNetworkManager.h"
+#include "../../common/network/frame_reader.h"
+#include "../../common/network/response_decoder.h"
+#include "../../common/serialization/json_utils.h"
 
 
 ResponseListenerThread::ResponseListenerThread(sockpp::tcp_connector* connection) {
@@ -19,49 +23,45 @@ ResponseListenerThread::~ResponseListenerThread() {
 
 wxThread::ExitCode ResponseListenerThread::Entry() {
     try {
-        char buffer[512]; // 512 bytes
+        frame_reader reader;
+        // responses are decoded on this thread, the main thread is only handed the resulting game states (the decoder
+        // is allocated on the heap, since its buffers are rather large for the stack of a thread)
+        auto decoder = std::make_unique<response_decoder>();
         ssize_t count = 0;
 
-        while ((count = this->_connection->read(buffer, sizeof(buffer))) > 0) {
-            try {
-                int pos = 0;
-
-                // extract length of message in bytes (which is sent at the start of the message, and is separated by a ":")
-                std::stringstream messageLengthStream;
-                while (buffer[pos] != ':' && pos < count) {
-                    messageLengthStream << buffer[pos];
-                    pos++;
-                }
-                ssize_t messageLength = std::stoi(messageLengthStream.str());
-
-                // initialize a stream for the message
-                std::stringstream messageStream;
-
-                // copy everything following the message length declaration into a stringstream
-                messageStream.write(&buffer[pos + 1], count - (pos + 1));
-                ssize_t bytesReadSoFar = count - (pos + 1);
-
-                // read remaining packages until full message length is reached
-                while (bytesReadSoFar < messageLength && count != 0) {
-                    count = this->_connection->read(buffer, sizeof(buffer));
-                    messageStream.write(buffer, count);
-                    bytesReadSoFar += count;
+        while (true) {
+            size_t available = 0;
+            char* buffer = reader.prepare(available); // read directly into the reader's buffer
+            if ((count = this->_connection->read(buffer, available)) <= 0) {
+                break;
+            }
+            reader.commit(count);
+
+            // process all complete frames, a read may contain several frames or only a part of one
+            frame_reader::frame frame;
+            wire_format::frame_status status;
+            while ((status = reader.next_frame(frame)) == wire_format::frame_status::complete) {
+                response_decoder::update update;
+                try {
+                    update = decoder->decode(frame);
+
+                    // output message for debugging purposes
+#ifdef PRINT_NETWORK_MESSAGES
+                    std::cout << "Received response : " << json_utils::to_string(&decoder->get_json()) << std::endl;
+#endif
+                } catch (const std::exception& e) {
+                    this->outputError("JSON parsing error", "Failed to parse message from server:\n" + (std::string) e.what());
+                    continue;
                 }
 
-                // process message (if we've received entire message)
-                if (bytesReadSoFar == messageLength) {
-                    std::string message = messageStream.str();
-                    GameController::getMainThreadEventHandler()->CallAfter([message]{
-                        ClientNetworkManager::parseResponse(message);
-                    });
-
-                } else {
-                    this->outputError("Network error", "Could not read entire message. TCP stream ended early. Difference is " + std::to_string(messageLength - bytesReadSoFar) + " bytes");
+                if (!update.is_empty()) {
+                    ClientNetworkManager::queueUpdate(std::move(update));
                 }
-
-            } catch (std::exception& e) {
-                // Make sure the connection isn't terminated only because of a read error
-                this->outputError("Network error", "Error while reading message: " + (std::string) e.what());
+            }
+            if (status == wire_format::frame_status::malformed) {
+                // the stream cannot be resynchronized
+                this->outputError("Network error", "Received malformed message header");
+                break;
             }
         }
 
@@ -1,9 +1,10 @@
 #include "MainGamePanelWizard.h"
 #include "../GameController.h"
 #include "../uiElements/ImagePanel.h"
+#include "TableCanvas.h"
+#include <functional>
 #include <wx/gbsizer.h>
 #include <wx/grid.h>
-#include "../messageBoxes/ScoreBoardDialog.h"
 
 
 
@@ -26,8 +27,102 @@ MainGamePanelWizard::MainGamePanelWizard(wxWindow* parent) : wxPanel(parent, wxI
 
 void MainGamePanelWizard::buildGameState(game_state* gameState, player* me)
 {
-    this->DestroyChildren();
+    std::vector<player*> players = gameState->get_players();
+
+    // find our player in the list of players
+    std::vector<player*>::iterator it = std::find_if(players.begin(), players.end(), [me](const player* x) {
+       return x->get_entity_id() == me->get_entity_id();
+    });
+    if (it < players.end()) {
+        me = *it;
+    }
+    else if (me->has_left_game() == true)
+    {
+        GameController::closeGameWindow();
+        return;
+    }
+    else {
+        GameController::showError("Game state error", "Could not find this player among players of server game.");
+        return;
+    }
+#ifdef USE_TABLE_CANVAS
+    // the whole table is drawn by a single canvas, only the buttons are separate windows
+    this->showOnCanvas(TableView::of(gameState, me));
+#else
+    int myPosition = it - players.begin();
+
+    // the grid is only built for the first game state, afterwards only the parts of the panel are built again whose
+    // data changed (see TableView)
+    bool isFirstBuild = this->_grid == nullptr;
+    if (isFirstBuild) {
+        this->buildGrid();
+    }
+    wxGridBagSizer* sizer = this->_grid;
+    TableView view = TableView::of(gameState, me);
+    const TableView& shown = this->_shownView;
+
+    bool changed = false;
+    auto rebuild = [this, isFirstBuild, &changed](bool partChanged, const std::vector<wxGBPosition>& positions,
+                                                  const std::function<void()>& build) {
+        if (isFirstBuild || partChanged) {
+            for (const wxGBPosition& position : positions) {
+                this->clearGridPanel(position);
+            }
+            build();
+            for (const wxGBPosition& position : positions) {
+                this->getGridPanel(position)->Layout();
+            }
+            changed = true;
+        }
+    };
+
+    // show whose turn it is
+    rebuild(view.isStarted != shown.isStarted || view.currentPlayerName != shown.currentPlayerName
+            || view.me.isCurrent != shown.me.isCurrent,
+            {wxGBPosition(2,0)}, [&] { this->buildTurnIndicator(sizer, gameState, me); });
+
+    //show the played cards
+    rebuild(view.isStarted != shown.isStarted || view.trickCards != shown.trickCards,
+            {wxGBPosition(1,1)}, [&] { this->buildTrickPile(sizer, gameState, me); });
+
+    // show trump card
+    rebuild(view.isStarted != shown.isStarted || view.trumpColor != shown.trumpColor
+            || view.trumpCardValue != shown.trumpCardValue,
+            {wxGBPosition(3,0)}, [&] { this->buildTrumpCard(sizer, gameState); });
+
+    // show player
+    rebuild(view.isStarted != shown.isStarted || view.me != shown.me || view.nofPlayers != shown.nofPlayers,
+            {wxGBPosition(3,2)}, [&] { this->buildThisPlayer(sizer, gameState, me); });
+
+    // show the cards in our hand
+    changed = this->updateHand(view) || changed;
+
+    //show other Players
+    rebuild(view.isStarted != shown.isStarted || view.others != shown.others,
+            MainGamePanelWizard::otherPlayerPositions,
+            [&] { this->buildOtherPlayers(sizer, gameState, me, myPosition); });
+
+    // show button to display score board
+    rebuild(view.isStarted != shown.isStarted,
+            {wxGBPosition(3,3)}, [&] { this->buildScoreLeaveButtons(sizer, gameState); });
+
+    // show round number and trick estimate sum
+    rebuild(view.isStarted != shown.isStarted || view.roundNumber != shown.roundNumber
+            || view.trickEstimateSum != shown.trickEstimateSum,
+            {wxGBPosition(0,0)}, [&] { this->buildRoundDisplay(sizer, gameState); });
 
+    this->_shownView = std::move(view);
+
+    // update Layout
+    if (changed) {
+        this->Layout();
+    }
+#endif
+}
+
+
+void MainGamePanelWizard::buildGrid()
+{
     // make new sizer
     auto mainSizer = new wxBoxSizer(wxVERTICAL);
     // child panel
@@ -56,29 +151,6 @@ void MainGamePanelWizard::buildGameState(game_state* gameState, player* me)
         {{4,0}, {1,5}}
     };
 
-    // Add other players
-    std::vector<player*> players = gameState->get_players();
-    int numberOfPlayers = players.size();
-    int myPosition = -1;
-
-    // find our player in the list of players
-    std::vector<player*>::iterator it = std::find_if(players.begin(), players.end(), [me](const player* x) {
-       return x->get_id() == me->get_id();
-    });
-    if (it < players.end()) {
-        me = *it;
-        myPosition = it - players.begin();
-    }
-    else if (me->has_left_game() == true)
-    {
-        GameController::closeGameWindow();
-        return;
-    }
-    else {
-        GameController::showError("Game state error", "Could not find this player among players of server game.");
-        return;
-    }
-
     // specify minimum size of the panels
     int minWidth = MainGamePanelWizard::panelSize.GetWidth()/5 - 10;
     int minHeight = MainGamePanelWizard::panelSize.GetHeight()/5 - 10;
@@ -114,31 +186,102 @@ void MainGamePanelWizard::buildGameState(game_state* gameState, player* me)
     //assign sizer to MainGamewindow
     this->SetSizer(mainSizer);
 
-    // show whose turn it is
-    this->buildTurnIndicator(sizer, gameState, me);
+    this->_grid = sizer;
+}
 
-    //show the played cards
-    this->buildTrickPile(sizer, gameState, me);
 
-    // show trump card
-    this->buildTrumpCard(sizer, gameState);
+wxPanel* MainGamePanelWizard::getGridPanel(wxGBPosition position)
+{
+    return dynamic_cast<wxPanel*>(this->_grid->FindItemAtPosition(position)->GetWindow());
+}
 
-    // show player
-    this->buildThisPlayer(sizer, gameState, me);
 
-    //show other Players
-    this->buildOtherPlayers(sizer, gameState, me, myPosition);
+wxPanel* MainGamePanelWizard::clearGridPanel(wxGBPosition position)
+{
+    wxPanel* panel = this->getGridPanel(position);
+    panel->DestroyChildren();
+    panel->SetSizer(nullptr); // deletes the old sizer
+    panel->SetBackgroundColour(wxColour(102,0,51));
+    panel->Refresh();
+    return panel;
+}
 
-    // show button to display score board
-    this->buildScoreLeaveButtons(sizer, gameState);
 
-    // show round number and trick estimate sum
-    this->buildRoundDisplay(sizer, gameState);
+void MainGamePanelWizard::showOnCanvas(const TableView& view)
+{
+    bool isFirstBuild = this->_canvas == nullptr;
+    if (isFirstBuild)
+    {
+        this->SetBackgroundColour(wxColour(102,0,51));
+        this->SetMinSize(wxSize(1200, 850));
+
+        auto mainSizer = new wxBoxSizer(wxVERTICAL);
+        this->_canvas = new TableCanvas(this);
+        mainSizer->Add(this->_canvas, 1, wxEXPAND);
+        this->_buttonBar = new wxPanel(this, wxID_ANY);
+        this->_buttonBar->SetBackgroundColour(wxColour(102,0,51));
+        mainSizer->Add(this->_buttonBar, 0, wxEXPAND);
+        this->SetSizer(mainSizer);
+    }
+    this->_canvas->showView(view);
 
-    // update Layout
-    this->Layout();
+    // the buttons only change when the game starts, or when enough players joined to start it
+    if (isFirstBuild || view.isStarted != this->_shownView.isStarted || view.nofPlayers != this->_shownView.nofPlayers)
+    {
+        this->_buttonBar->DestroyChildren();
+        this->buildCanvasButtons(view);
+        this->Layout();
+    }
+    this->_shownView = view;
 }
 
+
+void MainGamePanelWizard::buildCanvasButtons(const TableView& view)
+{
+    auto buttonSizer = new wxBoxSizer(wxHORIZONTAL);
+    this->_buttonBar->SetSizer(buttonSizer); // deletes the old sizer
+
+    if (!view.isStarted)
+    {
+        // show button that allows our player to start the game
+        wxButton* startGameButton = new wxButton(this->_buttonBar, wxID_ANY, "Start Game!", wxDefaultPosition, wxSize(110, 43));
+        startGameButton->SetFont(magicalFont);
+        startGameButton->Bind(wxEVT_BUTTON, [](wxCommandEvent& event) {
+            GameController::startGame();
+        });
+
+        // change color of the button as soon as there are 3 players
+        if (view.nofPlayers >= 3) {
+            startGameButton->SetForegroundColour(wxColour(225, 225, 225));
+            startGameButton->SetBackgroundColour(wxColour(50, 0, 51));
+        }
+        buttonSizer->Add(startGameButton, 0, wxALL, 5);
+    }
+    else
+    {
+        wxButton *scoreBoardButton = new wxButton(this->_buttonBar, wxID_ANY, "ScoreBoard");
+        scoreBoardButton->SetMinSize(wxSize(110, 43));
+        scoreBoardButton->SetFont(magicalFont);
+        scoreBoardButton->SetForegroundColour(wxColour(225, 225, 225));
+        scoreBoardButton->SetBackgroundColour(wxColour(50, 0, 51));
+        scoreBoardButton->Bind(wxEVT_BUTTON, [](wxCommandEvent &event) {
+            GameController::showScoreBoard();
+        });
+        buttonSizer->Add(scoreBoardButton, 0, wxALL, 5);
+    }
+
+    wxButton *leaveGameButton = new wxButton(this->_buttonBar, wxID_ANY, "Leave Game");
+    leaveGameButton->SetMinSize(wxSize(110, 43));
+    leaveGameButton->SetFont(magicalFont);
+    leaveGameButton->SetBackgroundColour(wxColour(50,0,51));
+    leaveGameButton->SetForegroundColour(*wxWHITE);
+    leaveGameButton->Bind(wxEVT_BUTTON, [](wxCommandEvent &event) {
+        GameController::leaveGame();
+    });
+    buttonSizer->Add(leaveGameButton, 0, wxALL, 5);
+}
+
+
 // shows current round number and total estimated tricks in the current round
 void MainGamePanelWizard::buildRoundDisplay(wxGridBagSizer* sizer, game_state* gameState)
 {
@@ -186,9 +329,9 @@ void MainGamePanelWizard::buildScoreLeaveButtons(wxGridBagSizer *sizer, game_sta
         scoreBoardButton->SetForegroundColour(wxColour(225, 225, 225)); // Set button text color
         scoreBoardButton->SetBackgroundColour(wxColour(50, 0, 51)); //same shade of purple as start game button and estimation panel
 
-        scoreBoardButton->Bind(wxEVT_BUTTON, [gameState](wxCommandEvent &event) {
-            ScoreBoardDialog scoreBoard(nullptr, "ScoreBoard", "Here will be the scoreboard", gameState);
-            scoreBoard.ShowModal();
+        // the button is kept for later game states, so it shows the scores of the current game state when clicked
+        scoreBoardButton->Bind(wxEVT_BUTTON, [](wxCommandEvent &event) {
+            GameController::showScoreBoard();
         });
     }
         wxButton *leaveGameButton = new wxButton(panel, wxID_ANY, "Leave Game");
@@ -199,7 +342,7 @@ void MainGamePanelWizard::buildScoreLeaveButtons(wxGridBagSizer *sizer, game_sta
         leaveGameButton->SetBackgroundColour(wxColour(50,0,51));  // Set background color to blue
         leaveGameButton->SetForegroundColour(*wxWHITE);
 
-        leaveGameButton->Bind(wxEVT_BUTTON, [gameState](wxCommandEvent &event) {
+        leaveGameButton->Bind(wxEVT_BUTTON, [](wxCommandEvent &event) {
             GameController::leaveGame();
         });
 }
@@ -434,69 +577,138 @@ void MainGamePanelWizard::buildThisPlayer(wxGridBagSizer* sizer, game_state* gam
         playerScore->SetForegroundColour(*wxWHITE);
         playerScore->SetFont(regularFont);
         meSizer->Add(playerScore, 0, wxALIGN_CENTER);
+    }
+
+    mePanel->SetSizer(meSizer_hor);
+}
 
-        // display our hand
 
-        int numberOfCards = me->get_nof_cards();
+bool MainGamePanelWizard::updateHand(const TableView& view)
+{
+    wxGBPosition handPosition = wxGBPosition(4,0);
 
-        if (numberOfCards > 0)
+    // no cards are shown in the lobby or between the rounds
+    if (!view.isStarted || view.hand.empty())
+    {
+        if (this->_handSizer == nullptr)
         {
-            wxGBSizerItem* cardItem = sizer->FindItemAtPosition(wxGBPosition(4,0));
-            wxPanel* cardPanel = dynamic_cast<wxPanel*>(cardItem->GetWindow());
+            return false;
+        }
+        this->clearGridPanel(handPosition);
+        this->_handSizer = nullptr;
+        this->_handCards.clear();
+        return true;
+    }
 
-            wxSize scaledCardSize = wxSize(MainGamePanelWizard::cardSize.GetWidth()*0.9, MainGamePanelWizard::cardSize.GetHeight()*0.9);
+    wxPanel* cardPanel = this->getGridPanel(handPosition);
+    bool changed = false;
 
-            // define two new sizers to be able to center the cards
-            auto cardPanelSizer_vert = new wxBoxSizer(wxVERTICAL);
-            cardPanel->SetSizer(cardPanelSizer_vert);
-            auto cardPanelSizer_hor = new wxBoxSizer(wxHORIZONTAL);
-            cardPanelSizer_vert->Add(cardPanelSizer_hor, 1, wxALIGN_CENTER);
+    int numberOfCards = view.hand.size();
+    wxSize scaledCardSize = wxSize(MainGamePanelWizard::cardSize.GetWidth()*0.9, MainGamePanelWizard::cardSize.GetHeight()*0.9);
+    if (numberOfCards * (MainGamePanelWizard::cardSize.GetWidth() + 8) > MainGamePanelWizard::panelSize.GetWidth())
+    {
+        int scaledCardWidth = panelSize.GetWidth() / numberOfCards - 8;
+        double cardAspectRatio = (double) cardSize.GetHeight() / (double) cardSize.GetWidth();
+        int scaledCardHeight = (int) ((double) scaledCardWidth * cardAspectRatio);
+        scaledCardSize = wxSize(scaledCardWidth, scaledCardHeight);
+    }
 
-            if (numberOfCards * (MainGamePanelWizard::cardSize.GetWidth() + 8) > MainGamePanelWizard::panelSize.GetWidth())
-            {
-                int scaledCardWidth = panelSize.GetWidth() / numberOfCards - 8;
-                double cardAspectRatio = (double) cardSize.GetHeight() / (double) cardSize.GetWidth();
-                int scaledCardHeight = (int) ((double) scaledCardWidth * cardAspectRatio);
-                scaledCardSize = wxSize(scaledCardWidth, scaledCardHeight);
-            }
+    // all cards are shown again if their size changes
+    if (this->_handSizer == nullptr || scaledCardSize != this->_handCardSize)
+    {
+        this->clearGridPanel(handPosition);
+        this->_handCards.clear();
+
+        // define two new sizers to be able to center the cards
+        auto cardPanelSizer_vert = new wxBoxSizer(wxVERTICAL);
+        cardPanel->SetSizer(cardPanelSizer_vert);
+        this->_handSizer = new wxBoxSizer(wxHORIZONTAL);
+        cardPanelSizer_vert->Add(this->_handSizer, 1, wxALIGN_CENTER);
+        this->_handCardSize = scaledCardSize;
+        changed = true;
+    }
+
+    // remove the cards that were played (destroyed windows are detached from their sizer)
+    for (auto it = this->_handCards.begin(); it != this->_handCards.end();)
+    {
+        if (std::find(view.hand.begin(), view.hand.end(), it->first) == view.hand.end())
+        {
+            it->second->Destroy();
+            it = this->_handCards.erase(it);
+            changed = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
 
-            // Show all cards
-            for (int i = 0; i < me->get_hand()->get_cards().size(); i++) {
+    // add the cards that are not shown yet at their place in the hand
+    for (int i = 0; i < numberOfCards; i++)
+    {
+        const card* handCard = view.hand.at(i);
+        if (i < this->_handCards.size() && this->_handCards.at(i).first == handCard)
+        {
+            continue;
+        }
 
-                card *handCard = me->get_hand()->get_cards().at(i);
+        std::string cardFile = "assets/card_" + std::to_string(handCard->get_value()) + "_" + std::to_string(handCard->get_color())  + ".png";
+        ImagePanel *cardButton = new ImagePanel(cardPanel, cardFile, wxBITMAP_TYPE_ANY, wxDefaultPosition, scaledCardSize);
 
-                std::string cardFile = "assets/card_" + std::to_string(handCard->get_value()) + "_" + std::to_string(handCard->get_color())  + ".png";
+        // Bind hover events for size change -> just these two
+        cardButton->Bind(wxEVT_ENTER_WINDOW, [cardButton, scaledCardSize](wxMouseEvent& event) {
+            cardButton->SetMinSize(wxSize(scaledCardSize.GetWidth() * 1.2, scaledCardSize.GetHeight() * 1.2));
+            cardButton->Refresh();
+            cardButton->Update();
+            cardButton->GetParent()->Layout();
+        });
 
-                ImagePanel *cardButton = new ImagePanel(cardPanel, cardFile, wxBITMAP_TYPE_ANY, wxDefaultPosition, scaledCardSize);
+        cardButton->Bind(wxEVT_LEAVE_WINDOW, [cardButton, scaledCardSize](wxMouseEvent& event) {
+            cardButton->SetMinSize(scaledCardSize);
+            cardButton->Refresh();
+            cardButton->Update();
+            cardButton->GetParent()->Layout();
+        });
 
-                // Bind hover events for size change -> just these two
-                cardButton->Bind(wxEVT_ENTER_WINDOW, [cardButton, scaledCardSize](wxMouseEvent& event) {
-                    cardButton->SetMinSize(wxSize(scaledCardSize.GetWidth() * 1.2, scaledCardSize.GetHeight() * 1.2));
-                    cardButton->Refresh();
-                    cardButton->Update();
-                    cardButton->GetParent()->Layout();
-                });
+        // the card stays in the hand for several game states, so whether it can be played is checked when clicked
+        cardButton->Bind(wxEVT_LEFT_UP, [this, handCard](wxMouseEvent& event) {
+            if (this->_shownView.canPlayCard) {
+                GameController::playCard(handCard);
+            }
+        });
 
-                cardButton->Bind(wxEVT_LEAVE_WINDOW, [cardButton, scaledCardSize](wxMouseEvent& event) {
-                    cardButton->SetMinSize(scaledCardSize);
-                    cardButton->Refresh();
-                    cardButton->Update();
-                    cardButton->GetParent()->Layout();
-                });
+        this->_handSizer->Insert(i, cardButton, 0, wxALIGN_CENTER | wxRIGHT | wxLEFT, 4);
+        this->_handCards.insert(this->_handCards.begin() + i, std::make_pair(handCard, cardButton));
+        changed = true;
+    }
 
+    // cards that moved to another place are still shown after the hand
+    while (this->_handCards.size() > numberOfCards)
+    {
+        this->_handCards.back().second->Destroy();
+        this->_handCards.pop_back();
+    }
 
-                if (gameState->get_current_player() == me && gameState->is_estimation_phase() == false) {
-                    cardButton->SetToolTip("Play card");
-                    cardButton->SetCursor(wxCursor(wxCURSOR_HAND));
-                    cardButton->Bind(wxEVT_LEFT_UP, [handCard](wxMouseEvent& event) {
-                        GameController::playCard(handCard);
-                    });
-                }
-                cardPanelSizer_hor->Add(cardButton, 0, wxALIGN_CENTER | wxRIGHT | wxLEFT, 4);
+    if (changed || view.canPlayCard != this->_shownView.canPlayCard)
+    {
+        for (const auto& handCard : this->_handCards)
+        {
+            if (view.canPlayCard)
+            {
+                handCard.second->SetToolTip("Play card");
+                handCard.second->SetCursor(wxCursor(wxCURSOR_HAND));
+            }
+            else
+            {
+                handCard.second->UnsetToolTip();
+                handCard.second->SetCursor(wxNullCursor);
             }
         }
-
     }
 
-    mePanel->SetSizer(meSizer_hor);
-}
\ No newline at end of file
+    if (changed)
+    {
+        cardPanel->Layout();
+    }
+    return changed;
+}
@@ -4,6 +4,10 @@
 #include <wx/wx.h>
 #include <wx/gbsizer.h>
 #include "../../common/game_state/game_state.h"
+#include "../uiElements/ImagePanel.h"
+#include "TableView.h"
+
+class TableCanvas;
 
 /**
  * @class MainGamePanelWizard
@@ -25,12 +29,46 @@ public:
     /**
      * @brief Shows the game state in the GUI the client gets from the server.
      * This function is called by the game controller to update the shown game state.
+     * Only the parts of the panel whose data differs from the shown game state are built again.
      * @param gameState New game state to show.
      * @param me Player to show the game state for (me).
      */
     void buildGameState(game_state* gameState, player* me);
 
 private:
+    /**
+     * @brief Builds the grid of panels that partitions the game panel, which is kept for all game states.
+     */
+    void buildGrid();
+    /**
+     * @brief Gets the panel of the grid at a position.
+     * @param position Position of the panel in the grid.
+     * @return The panel.
+     */
+    wxPanel* getGridPanel(wxGBPosition position);
+    /**
+     * @brief Removes the content of a panel of the grid, so that it can be built again.
+     * @param position Position of the panel in the grid.
+     * @return The cleared panel.
+     */
+    wxPanel* clearGridPanel(wxGBPosition position);
+    /**
+     * @brief Updates the cards shown in the hand of the player of the user (me).
+     * Only the cards that were played are removed and only the new cards are added, all others are kept.
+     * @param view View of the new game state.
+     * @return Whether the shown cards changed.
+     */
+    bool updateHand(const TableView& view);
+    /**
+     * @brief Shows the game state on a single canvas instead of the grid (if USE_TABLE_CANVAS is defined).
+     * @param view View of the game state.
+     */
+    void showOnCanvas(const TableView& view);
+    /**
+     * @brief Builds the buttons below the canvas (start game or score board, and leave game).
+     * @param view View of the shown game state.
+     */
+    void buildCanvasButtons(const TableView& view);
     /**
      * @brief Used by buildGameState to build the area of the panel that concerns the player of the user (me).
      * @param sizer Sizer which states the position of the player of the user.
@@ -82,6 +120,19 @@ private:
     // also set in the constructor implementation
     wxSize const panelSize = wxSize(960, 680); ///< Size of the panel.
     wxSize const cardSize = wxSize(85, 131); ///< Size of the shown cards.
+
+    /// Positions of the panels that may show other players, depending on the number of players.
+    inline static const std::vector<wxGBPosition> otherPlayerPositions = {
+        wxGBPosition(0, 1), wxGBPosition(0, 2), wxGBPosition(0, 3), wxGBPosition(1, 0), wxGBPosition(1, 4)
+    };
+
+    wxGridBagSizer* _grid = nullptr; ///< Grid of the panels, built for the first game state.
+    TableView _shownView; ///< View of the shown game state.
+    wxBoxSizer* _handSizer = nullptr; ///< Sizer of the cards in the hand, nullptr if no cards are shown.
+    wxSize _handCardSize; ///< Size of the cards in the hand.
+    std::vector<std::pair<const card*, ImagePanel*>> _handCards; ///< The shown cards in the hand, in their order.
+    TableCanvas* _canvas = nullptr; ///< Canvas that draws the table instead of the grid, nullptr if not used.
+    wxPanel* _buttonBar = nullptr; ///< Panel of the buttons below the canvas.
 };
 
 #endif //MAINGAMEPANELWIZARD_H
@@ -0,0 +1,305 @@
+#include "TableCanvas.h"
+#include "../GameController.h"
+#include "../uiElements/ImageCache.h"
+#include <wx/dcbuffer.h>
+
+
+wxFont magicalFontCanvas = wxFont(wxFontInfo(20).FaceName("Magic School One"));
+wxFont regularFontCanvas = wxFont(wxFontInfo(12).FaceName("Junicode"));
+wxFont regularFontCanvasBig = wxFont(wxFontInfo(16).FaceName("Junicode"));
+
+
+// same places as the panels of the other players in the grid of the main game panel
+static std::vector<std::pair<int, int>> getOtherPlayerCells(int numberOfPlayers)
+{
+    switch (numberOfPlayers) {
+        case 2: return {{0, 2}};
+        case 3: return {{0, 1}, {0, 3}};
+        case 4: return {{1, 0}, {0, 2}, {1, 4}};
+        case 5: return {{1, 0}, {0, 1}, {0, 3}, {1, 4}};
+        case 6: return {{1, 0}, {0, 1}, {0, 2}, {0, 3}, {1, 4}};
+        default: return {};
+    }
+}
+
+
+static std::string getCardFile(int value, int color)
+{
+    return "assets/card_" + std::to_string(value) + "_" + std::to_string(color) + ".png";
+}
+
+
+static std::string getTricksText(const PlayerView& shownPlayer)
+{
+    return std::to_string(shownPlayer.nofTricks) + "/" + std::to_string(shownPlayer.nofPredicted) + " Tricks";
+}
+
+
+TableCanvas::TableCanvas(wxWindow* parent) :
+        wxPanel(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxFULL_REPAINT_ON_RESIZE)
+{
+    // the paint event draws the whole canvas, so the background must not be erased before (which would flicker)
+    this->SetBackgroundStyle(wxBG_STYLE_PAINT);
+
+    this->Bind(wxEVT_PAINT, &TableCanvas::paintEvent, this);
+    this->Bind(wxEVT_SIZE, &TableCanvas::onSize, this);
+    this->Bind(wxEVT_MOTION, &TableCanvas::onMouseMove, this);
+    this->Bind(wxEVT_LEAVE_WINDOW, &TableCanvas::onMouseLeave, this);
+    this->Bind(wxEVT_LEFT_UP, &TableCanvas::onLeftUp, this);
+}
+
+
+void TableCanvas::showView(const TableView& view)
+{
+    if (view == this->_view) {
+        return;
+    }
+    this->_view = view;
+
+    // the hovered card may have been played, so it is found again
+    this->_hoveredCard = -1;
+    this->layoutHand();
+    this->setHoveredCard(this->hitTest(this->ScreenToClient(wxGetMousePosition())));
+    this->Refresh();
+}
+
+
+wxRect TableCanvas::getCell(int row, int col, int rowSpan, int colSpan) const
+{
+    wxSize size = this->GetClientSize();
+    int cellWidth = size.GetWidth() / 5;
+    int cellHeight = size.GetHeight() / 5;
+    return wxRect(col * cellWidth, row * cellHeight, colSpan * cellWidth, rowSpan * cellHeight);
+}
+
+
+void TableCanvas::layoutHand()
+{
+    this->_handCards.clear();
+    if (!this->_view.isStarted || this->_view.hand.empty()) {
+        return;
+    }
+
+    // same size of the cards as in the hand of the main game panel
+    wxRect handArea = this->getCell(4, 0, 1, 5);
+    int numberOfCards = this->_view.hand.size();
+    int cardWidth = cardSize.GetWidth() * 0.9;
+    int cardHeight = cardSize.GetHeight() * 0.9;
+    if (numberOfCards * (cardSize.GetWidth() + 8) > handArea.GetWidth())
+    {
+        cardWidth = handArea.GetWidth() / numberOfCards - 8;
+        double cardAspectRatio = (double) cardSize.GetHeight() / (double) cardSize.GetWidth();
+        cardHeight = (int) ((double) cardWidth * cardAspectRatio);
+    }
+
+    int x = handArea.GetX() + (handArea.GetWidth() - numberOfCards * (cardWidth + 8)) / 2 + 4;
+    int y = handArea.GetY() + (handArea.GetHeight() - cardHeight) / 2;
+    for (int i = 0; i < numberOfCards; i++)
+    {
+        wxRect cardArea = wxRect(x + i * (cardWidth + 8), y, cardWidth, cardHeight);
+        if (i == this->_hoveredCard)
+        {
+            // enlarged around its center, like the hovered cards of the main game panel
+            int hoveredWidth = cardWidth * 1.2;
+            int hoveredHeight = cardHeight * 1.2;
+            cardArea = wxRect(cardArea.GetX() - (hoveredWidth - cardWidth) / 2, cardArea.GetY() - (hoveredHeight - cardHeight) / 2,
+                              hoveredWidth, hoveredHeight);
+        }
+        this->_handCards.push_back(std::make_pair(cardArea, this->_view.hand.at(i)));
+    }
+}
+
+
+int TableCanvas::hitTest(const wxPoint& position) const
+{
+    // the hovered card is drawn on top of its neighbours
+    if (this->_hoveredCard >= 0 && this->_handCards.at(this->_hoveredCard).first.Contains(position))
+    {
+        return this->_hoveredCard;
+    }
+    for (int i = 0; i < this->_handCards.size(); i++)
+    {
+        if (this->_handCards.at(i).first.Contains(position))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+void TableCanvas::setHoveredCard(int hoveredCard)
+{
+    if (hoveredCard != this->_hoveredCard)
+    {
+        this->_hoveredCard = hoveredCard;
+        this->layoutHand();
+        this->Refresh();
+    }
+
+    bool canPlayHoveredCard = hoveredCard >= 0 && this->_view.canPlayCard;
+    if (canPlayHoveredCard != this->_canPlayHoveredCard)
+    {
+        this->_canPlayHoveredCard = canPlayHoveredCard;
+        if (canPlayHoveredCard)
+        {
+            this->SetToolTip("Play card");
+            this->SetCursor(wxCursor(wxCURSOR_HAND));
+        }
+        else
+        {
+            this->UnsetToolTip();
+            this->SetCursor(wxNullCursor);
+        }
+    }
+}
+
+
+void TableCanvas::onSize(wxSizeEvent& event)
+{
+    this->layoutHand();
+    this->Refresh();
+    event.Skip();
+}
+
+
+void TableCanvas::onMouseMove(wxMouseEvent& event)
+{
+    this->setHoveredCard(this->hitTest(event.GetPosition()));
+    event.Skip();
+}
+
+
+void TableCanvas::onMouseLeave(wxMouseEvent& event)
+{
+    this->setHoveredCard(-1);
+    event.Skip();
+}
+
+
+void TableCanvas::onLeftUp(wxMouseEvent& event)
+{
+    int clickedCard = this->hitTest(event.GetPosition());
+    if (clickedCard >= 0 && this->_view.canPlayCard)
+    {
+        GameController::playCard(this->_handCards.at(clickedCard).second);
+    }
+    event.Skip();
+}
+
+
+void TableCanvas::paintEvent(wxPaintEvent& event)
+{
+    // everything is drawn into a bitmap first, which is then copied to the window at once
+    wxBufferedPaintDC dc(this);
+    dc.SetBackground(wxBrush(wxColour(102,0,51)));
+    dc.Clear();
+
+    const TableView& view = this->_view;
+
+    // other players
+    std::vector<std::pair<int, int>> otherPlayerCells = getOtherPlayerCells(view.others.size() + 1);
+    for (int i = 0; i < otherPlayerCells.size(); i++)
+    {
+        const PlayerView& otherPlayer = view.others.at(i);
+        std::string status = view.isStarted ? getTricksText(otherPlayer) : "waiting...";
+        this->drawPlayer(dc, otherPlayer, status, this->getCell(otherPlayerCells.at(i).first, otherPlayerCells.at(i).second));
+    }
+
+    // this player
+    std::string myStatus = view.isStarted ? getTricksText(view.me) : "Waiting for the game to start";
+    this->drawPlayer(dc, view.me, myStatus, this->getCell(3, 2));
+
+    wxRect trickArea = this->getCell(1, 1, 1, 3);
+
+    // if game has not started yet display picture in the lobby
+    if (!view.isStarted)
+    {
+        wxRect logoArea = wxRect(trickArea.GetX() + (trickArea.GetWidth() - 130) / 2, trickArea.GetY() + trickArea.GetHeight() - 116, 130, 116);
+        this->drawImage(dc, "assets/Wizard_round.png", logoArea);
+        return;
+    }
+
+    // round number and trick estimate sum
+    wxRect roundArea = this->getCell(0, 0);
+    std::string nofRoundCards = std::to_string(view.roundNumber + 1);
+    this->drawText(dc, "Round " + nofRoundCards, magicalFontCanvas,
+                   wxRect(roundArea.GetX(), roundArea.GetY() + 5, roundArea.GetWidth(), 35));
+    this->drawText(dc, "Predicted trick sum " + std::to_string(view.trickEstimateSum) + " / " + nofRoundCards, regularFontCanvas,
+                   wxRect(roundArea.GetX(), roundArea.GetY() + 45, roundArea.GetWidth(), 35));
+
+    // whose turn it is
+    std::string turnText = view.me.isCurrent ? "It is your turn!" : "It is " + view.currentPlayerName + "'s turn!";
+    this->drawText(dc, turnText, regularFontCanvasBig, this->getCell(2, 0, 1, 5));
+
+    // the cards of the trick overlap, like in the trick pile of the main game panel
+    int numberOfTrickCards = view.trickCards.size();
+    int trickCardStep = cardSize.GetWidth() - 20;
+    int trickWidth = numberOfTrickCards > 0 ? (numberOfTrickCards - 1) * trickCardStep + cardSize.GetWidth() : 0;
+    int trickX = trickArea.GetX() + (trickArea.GetWidth() - trickWidth) / 2;
+    int trickY = trickArea.GetY() + (trickArea.GetHeight() - cardSize.GetHeight()) / 2;
+    for (int i = 0; i < numberOfTrickCards; i++)
+    {
+        this->drawCard(dc, view.trickCards.at(i), wxRect(wxPoint(trickX + i * trickCardStep, trickY), cardSize));
+    }
+
+    // trump card
+    wxRect trumpArea = this->getCell(3, 0);
+    this->drawText(dc, "TRUMP CARD", regularFontCanvas, wxRect(trumpArea.GetX(), trumpArea.GetY(), trumpArea.GetWidth(), 35));
+    this->drawImage(dc, getCardFile(view.trumpCardValue, view.trumpColor),
+                    wxRect(wxPoint(trumpArea.GetX() + (trumpArea.GetWidth() - cardSize.GetWidth()) / 2, trumpArea.GetY() + 35), cardSize));
+
+    // our hand, the hovered card is drawn last to be on top
+    for (int i = 0; i < this->_handCards.size(); i++)
+    {
+        if (i != this->_hoveredCard)
+        {
+            this->drawCard(dc, this->_handCards.at(i).second, this->_handCards.at(i).first);
+        }
+    }
+    if (this->_hoveredCard >= 0)
+    {
+        this->drawCard(dc, this->_handCards.at(this->_hoveredCard).second, this->_handCards.at(this->_hoveredCard).first);
+    }
+}
+
+
+void TableCanvas::drawCard(wxDC& dc, const card* shownCard, const wxRect& area)
+{
+    this->drawImage(dc, getCardFile(shownCard->get_value(), shownCard->get_color()), area);
+}
+
+
+void TableCanvas::drawImage(wxDC& dc, const std::string& file, const wxRect& area)
+{
+    const wxBitmap& bitmap = ImageCache::getBitmap(file, wxBITMAP_TYPE_ANY, area.GetSize());
+    if (bitmap.IsOk())
+    {
+        dc.DrawBitmap(bitmap, area.GetX(), area.GetY(), true);
+    }
+}
+
+
+void TableCanvas::drawPlayer(wxDC& dc, const PlayerView& shownPlayer, const std::string& status, const wxRect& area)
+{
+    // the player whose turn it is is highlighted
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(wxBrush(shownPlayer.isCurrent ? wxColour(50,0,51) : wxColour(120,0,51)));
+    dc.DrawRectangle(wxRect(area.GetX() + 1, area.GetY() + 1, area.GetWidth() - 2, area.GetHeight() - 2));
+
+    this->drawText(dc, shownPlayer.name, regularFontCanvasBig, wxRect(area.GetX(), area.GetY() + 5, area.GetWidth(), 35));
+    this->drawText(dc, status, regularFontCanvas, wxRect(area.GetX(), area.GetY() + 40, area.GetWidth(), 20));
+    if (shownPlayer.isStarting)
+    {
+        this->drawText(dc, "Starting Player", regularFontCanvas, wxRect(area.GetX(), area.GetY() + 60, area.GetWidth(), 35));
+    }
+}
+
+
+void TableCanvas::drawText(wxDC& dc, const std::string& text, const wxFont& font, const wxRect& area)
+{
+    dc.SetFont(font);
+    dc.SetTextForeground(*wxWHITE);
+    dc.DrawLabel(text, area, wxALIGN_CENTER);
+}
+
@@ -0,0 +1,74 @@
+#ifndef WIZARDUI_TABLECANVAS_H
+#define WIZARDUI_TABLECANVAS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <wx/wx.h>
+#include "TableView.h"
+
+/**
+ * @class TableCanvas
+ * @brief Draws the whole game table (players, trick pile, trump card and hand) into a single window.
+ *
+ * Instead of a window for every card and player, the canvas paints the TableView it shows with a wxBufferedPaintDC,
+ * using the bitmaps of the ImageCache. It uses the same partition of the table as the grid of the MainGamePanelWizard
+ * (five columns, and a row for the hand at the bottom).
+ * Clicks on the cards in the hand are found by testing the mouse position against the area every card is drawn in.
+ */
+class TableCanvas : public wxPanel {
+
+public:
+    /**
+     * @brief Constructs the canvas.
+     * @param parent The panel the canvas is put onto.
+     */
+    TableCanvas(wxWindow* parent);
+
+    /**
+     * @brief Shows a game state. The canvas is only redrawn if the view differs from the shown one.
+     * @param view View of the game state to show.
+     */
+    void showView(const TableView& view);
+
+private:
+    TableView _view; ///< View of the shown game state.
+    std::vector<std::pair<wxRect, const card*>> _handCards; ///< Area of every card in the hand, in the order of the hand.
+    int _hoveredCard = -1; ///< Index of the card in the hand the mouse is on, -1 if none.
+    bool _canPlayHoveredCard = false; ///< Whether the hovered card is shown as playable (cursor and tool tip).
+
+    wxSize const cardSize = wxSize(85, 131); ///< Size of the cards in the trick pile and of the trump card.
+
+    void paintEvent(wxPaintEvent& event);
+    void onSize(wxSizeEvent& event);
+    void onMouseMove(wxMouseEvent& event);
+    void onMouseLeave(wxMouseEvent& event);
+    void onLeftUp(wxMouseEvent& event);
+
+    /**
+     * @brief Gets the area of a part of the table, in the five columns and five rows the table is partitioned into.
+     */
+    wxRect getCell(int row, int col, int rowSpan = 1, int colSpan = 1) const;
+    /**
+     * @brief Computes the area of every card in the hand, the hovered card is enlarged.
+     */
+    void layoutHand();
+    /**
+     * @brief Finds the card in the hand at a position.
+     * @param position Position in the canvas.
+     * @return Index of the card, -1 if there is no card at the position.
+     */
+    int hitTest(const wxPoint& position) const;
+    /**
+     * @brief Shows the hovered card enlarged, and whether it can be played.
+     * @param hoveredCard Index of the hovered card, -1 if none.
+     */
+    void setHoveredCard(int hoveredCard);
+
+    void drawCard(wxDC& dc, const card* shownCard, const wxRect& area);
+    void drawImage(wxDC& dc, const std::string& file, const wxRect& area);
+    void drawPlayer(wxDC& dc, const PlayerView& shownPlayer, const std::string& status, const wxRect& area);
+    void drawText(wxDC& dc, const std::string& text, const wxFont& font, const wxRect& area);
+};
+
+#endif //WIZARDUI_TABLECANVAS_H
@@ -0,0 +1,49 @@
+#include "TableView.h"
+
+#include <algorithm>
+
+
+static PlayerView viewOf(game_state* gameState, const player* p) {
+    PlayerView view;
+    view.name = p->get_player_name();
+    view.nofTricks = p->get_nof_tricks();
+    view.nofPredicted = p->get_nof_predicted();
+    view.isCurrent = gameState->is_started() && p == gameState->get_current_player();
+    view.isStarting = gameState->is_started() && p == gameState->get_starting_player();
+    return view;
+}
+
+
+TableView TableView::of(game_state* gameState, player* me) {
+    TableView view;
+    view.isStarted = gameState->is_started();
+    view.isEstimationPhase = gameState->is_estimation_phase();
+    view.roundNumber = gameState->get_round_number();
+    view.trickEstimateSum = gameState->get_trick_estimate_sum();
+    view.trumpColor = gameState->get_trump_color();
+    view.trumpCardValue = gameState->get_trump_card_value();
+
+    std::vector<player*>& players = gameState->get_players();
+    view.nofPlayers = players.size();
+    if(view.isStarted) {
+        view.currentPlayerName = gameState->get_current_player()->get_player_name();
+    }
+
+    view.me = viewOf(gameState, me);
+    int myPosition = std::find(players.begin(), players.end(), me) - players.begin();
+    for(int i = 1; i < view.nofPlayers; i++) {
+        view.others.push_back(viewOf(gameState, players.at((myPosition + i) % view.nofPlayers)));
+    }
+
+    if(view.isStarted) {
+        for(const auto& cardAndPlayer : gameState->get_trick()->get_cards_and_players()) {
+            view.trickCards.push_back(cardAndPlayer.first);
+        }
+    }
+    for(const card* handCard : me->get_hand()->get_cards()) {
+        view.hand.push_back(handCard);
+    }
+    view.canPlayCard = view.isStarted && view.me.isCurrent && !view.isEstimationPhase;
+
+    return view;
+}
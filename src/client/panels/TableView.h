@@ -0,0 +1,58 @@
+#ifndef WIZARDUI_TABLEVIEW_H
+#define WIZARDUI_TABLEVIEW_H
+
+#include <string>
+#include <vector>
+#include "../../common/game_state/game_state.h"
+
+/**
+ * @struct PlayerView
+ * @brief What the panels show of a player.
+ */
+struct PlayerView {
+    std::string name;           ///< The name of the player.
+    int nofTricks = 0;          ///< The number of tricks the player won in the current round.
+    int nofPredicted = -1;      ///< The number of tricks the player predicted, -1 if not predicted yet.
+    bool isCurrent = false;     ///< Whether it is the player's turn.
+    bool isStarting = false;    ///< Whether the player started the current trick.
+
+    bool operator==(const PlayerView& other) const = default;
+};
+
+/**
+ * @struct TableView
+ * @brief The part of a game state that the game panels show, as seen by one player (me).
+ *
+ * The panels keep the view of the game state they show. For a new game state, they compare its view with the shown one
+ * and only rebuild the widgets of the parts of the panel whose data differs (e.g. only the trick pile and the turn
+ * indicator when another player played a card), instead of rebuilding the whole panel.
+ *
+ * Cards are compared by address, which identifies them since all game states share the cards of the card table (see card::get_card()).
+ */
+struct TableView {
+    bool isStarted = false;                 ///< Whether the game has started (otherwise the lobby is shown).
+    bool isEstimationPhase = false;         ///< Whether the players estimate their tricks.
+    int roundNumber = 0;                    ///< The number of the current round, starting at 0.
+    int trickEstimateSum = 0;               ///< The sum of the tricks predicted in the current round.
+    int trumpColor = 0;                     ///< The color of the trump card.
+    int trumpCardValue = 0;                 ///< The value of the trump card.
+    int nofPlayers = 0;                     ///< The number of players in the game.
+    std::string currentPlayerName;          ///< The name of the player whose turn it is.
+    PlayerView me;                          ///< The player of the user.
+    std::vector<PlayerView> others;         ///< All other players, in the order they sit after me.
+    std::vector<const card*> trickCards;    ///< The cards in the current trick.
+    std::vector<const card*> hand;          ///< The cards in my hand.
+    bool canPlayCard = false;               ///< Whether I can play one of my cards.
+
+    bool operator==(const TableView& other) const = default;
+
+    /**
+     * @brief Creates the view of a game state.
+     * @param gameState The game state.
+     * @param me The player of the user, one of the players of the game state.
+     * @return The view of the game state for me.
+     */
+    static TableView of(game_state* gameState, player* me);
+};
+
+#endif //WIZARDUI_TABLEVIEW_H
@@ -1,7 +1,7 @@
 #include "TrickEstimationPanel.h"
 #include "../uiElements/ImagePanel.h"
 #include "../GameController.h"
-#include "../messageBoxes/ScoreBoardDialog.h"
+#include <functional>
 
 wxFont magicalFontTrick = wxFont(wxFontInfo(20).FaceName("Magic School One"));
 wxFont regularFontTrick = wxFont(wxFontInfo(12).FaceName("Junicode"));
@@ -20,8 +20,74 @@ TrickEstimationPanel::~TrickEstimationPanel()
 
 void TrickEstimationPanel::buildGameState(game_state* gameState, player* me)
 {
-    this->DestroyChildren();
+    std::vector<player*> players = gameState->get_players();
+
+    // find our player in vector of players
+    std::vector<player*>::iterator it = std::find_if(players.begin(), players.end(), [me](const player* x) {
+       return x->get_entity_id() == me->get_entity_id();
+    });
+
+    if (it < players.end()) {
+        me = *it;
+    } else {
+        GameController::showError("Game state error", "Could not find this player among players of server game.");
+        return;
+    }
+    int myPosition = it - players.begin();
+
+    // the grid is only built for the first game state, afterwards only the parts of the panel are built again whose
+    // data changed (see TableView)
+    bool isFirstBuild = this->_grid == nullptr;
+    if (isFirstBuild) {
+        this->buildGrid();
+    }
+    wxGridBagSizer* sizer = this->_grid;
+    TableView view = TableView::of(gameState, me);
+    const TableView& shown = this->_shownView;
+
+    bool changed = false;
+    auto rebuild = [this, isFirstBuild, &changed](bool partChanged, const std::vector<wxGBPosition>& positions,
+                                                  const std::function<void()>& build) {
+        if (isFirstBuild || partChanged) {
+            for (const wxGBPosition& position : positions) {
+                this->clearGridPanel(position);
+            }
+            build();
+            for (const wxGBPosition& position : positions) {
+                this->getGridPanel(position)->Layout();
+            }
+            changed = true;
+        }
+    };
+
+    rebuild(view.roundNumber != shown.roundNumber || view.trickEstimateSum != shown.trickEstimateSum,
+            {wxGBPosition(1,1)}, [&] { this->buildCenter(sizer, gameState); });
+
+    // the input field is kept while the other players estimate their tricks
+    rebuild(view.me != shown.me,
+            {wxGBPosition(2,1)}, [&] { this->buildThisPlayer(sizer, gameState, me); });
+
+    rebuild(view.others != shown.others,
+            TrickEstimationPanel::otherPlayerPositions, [&] { this->buildOtherPlayers(sizer, gameState, myPosition); });
+
+    rebuild(view.hand != shown.hand || view.canPlayCard != shown.canPlayCard,
+            {wxGBPosition(3,0)}, [&] { this->buildHand(sizer, gameState, me); });
+
+    rebuild(view.trumpColor != shown.trumpColor || view.trumpCardValue != shown.trumpCardValue,
+            {wxGBPosition(2,0)}, [&] { this->buildTrumpColor(sizer, gameState); });
+
+    rebuild(false, {wxGBPosition(2,2)}, [&] { this->buildScoreLeaveButtons(sizer, gameState); });
+
+    this->_shownView = std::move(view);
+
+    if (changed) {
+        this->Layout();
+    }
+}
+
 
+void TrickEstimationPanel::buildGrid()
+{
     // make new sizer
     auto mainSizer = new wxBoxSizer(wxVERTICAL);
     // child panel
@@ -45,24 +111,6 @@ void TrickEstimationPanel::buildGameState(game_state* gameState, player* me)
         {{3,0}, {1,3}}
     };
 
-    // Add other players
-    std::vector<player*> players = gameState->get_players();
-    int myPosition = -1;
-
-    // find our player in vector of players
-    std::vector<player*>::iterator it = std::find_if(players.begin(), players.end(), [me](const player* x) {
-       return x->get_id() == me->get_id();
-    });
-
-    if (it < players.end()) {
-        me = *it;
-        myPosition = it - players.begin();
-    } else {
-        GameController::showError("Game state error", "Could not find this player among players of server game.");
-        return;
-    }
-
-
     // specify minimum size of the panels
     int minWidth = TrickEstimationPanel::panelSize.GetWidth()/3-30;
     int minHeight = TrickEstimationPanel::panelSize.GetHeight()/4-30;
@@ -96,19 +144,28 @@ void TrickEstimationPanel::buildGameState(game_state* gameState, player* me)
     //assign sizer to MainGamewindow
     this->SetSizer(mainSizer);
 
-    this->buildCenter(sizer, gameState);
-
-    this->buildThisPlayer(sizer, gameState, me);
-
-    this->buildOtherPlayers(sizer, gameState, myPosition);
+    this->_grid = sizer;
+}
 
-    this->buildHand(sizer, gameState, me);
 
-    this->buildTrumpColor(sizer, gameState);
+wxPanel* TrickEstimationPanel::getGridPanel(wxGBPosition position)
+{
+    return dynamic_cast<wxPanel*>(this->_grid->FindItemAtPosition(position)->GetWindow());
+}
 
-    this->buildScoreLeaveButtons(sizer, gameState);
 
-    this->Layout();
+wxPanel* TrickEstimationPanel::clearGridPanel(wxGBPosition position)
+{
+    wxPanel* panel = this->getGridPanel(position);
+    if (this->_trickEstimateField != nullptr && this->_trickEstimateField->GetParent() == panel)
+    {
+        this->_trickEstimateField = nullptr;
+    }
+    panel->DestroyChildren();
+    panel->SetSizer(nullptr); // deletes the old sizer
+    panel->SetBackgroundColour(wxColour(102,0,51));
+    panel->Refresh();
+    return panel;
 }
 
 
@@ -129,9 +186,9 @@ void TrickEstimationPanel::buildScoreLeaveButtons(wxGridBagSizer *sizer, game_st
     scoreBoardButton->SetForegroundColour(wxColour(225, 225, 225)); // Set button text color
     scoreBoardButton->SetBackgroundColour(wxColour(50, 0, 51));    //make button same purple as estimation panel once clickable
 
-    scoreBoardButton->Bind(wxEVT_BUTTON, [gameState](wxCommandEvent& event) {
-        ScoreBoardDialog scoreBoard(nullptr, "ScoreBoard", "Here will be the scoreboard", gameState);
-        scoreBoard.ShowModal();
+    // the button is kept for later game states, so it shows the scores of the current game state when clicked
+    scoreBoardButton->Bind(wxEVT_BUTTON, [](wxCommandEvent& event) {
+        GameController::showScoreBoard();
     });
 
     wxButton *leaveGameButton = new wxButton(panel, wxID_ANY, "Leave Game");
@@ -142,7 +199,7 @@ void TrickEstimationPanel::buildScoreLeaveButtons(wxGridBagSizer *sizer, game_st
     leaveGameButton->SetBackgroundColour(wxColour(50,0,51));  // Set background color to blue
     leaveGameButton->SetForegroundColour(*wxWHITE);
 
-    leaveGameButton->Bind(wxEVT_BUTTON, [gameState](wxCommandEvent &event) {
+    leaveGameButton->Bind(wxEVT_BUTTON, [](wxCommandEvent &event) {
         GameController::leaveGame();
     });
 
@@ -390,5 +447,9 @@ void TrickEstimationPanel::buildOtherPlayers(wxGridBagSizer* sizer, game_state*
 
 wxString TrickEstimationPanel::getTrickEstimate()
 {
+    if (this->_trickEstimateField == nullptr)
+    {
+        return "";
+    }
     return this->_trickEstimateField->getValue();
 }
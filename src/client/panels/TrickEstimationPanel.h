@@ -7,6 +7,7 @@
 
 #include "../../common/game_state/game_state.h"
 #include "../uiElements/InputField.h"
+#include "TableView.h"
 #include <wx/wx.h>
 #include <wx/gbsizer.h>
 
@@ -33,6 +34,7 @@ public:
     wxString getTrickEstimate();
     /**
       * @brief Builds the game state for the trick estimation phase.
+      * Only the parts of the panel whose data differs from the shown game state are built again.
       * @param gameState Pointer to the current game state.
       * @param me Pointer to the player being the current user.
       */
@@ -41,6 +43,28 @@ private:
     wxSize const panelSize = wxSize(1200, 850); ///< panel size used for layout calculations
     wxSize const cardSize = wxSize(85, 131); ///< size of displayed cards
 
+    /// positions of the panels that may show other players, depending on the number of players
+    inline static const std::vector<wxGBPosition> otherPlayerPositions = {
+        wxGBPosition(0, 0), wxGBPosition(0, 1), wxGBPosition(0, 2), wxGBPosition(1, 0), wxGBPosition(1, 2)
+    };
+
+    /**
+     * @brief Builds the grid of panels that partitions the panel, which is kept for all game states
+     */
+    void buildGrid();
+    /**
+     * @brief Gets the panel of the grid at a position
+     * @param position Position of the panel in the grid
+     * @return The panel
+     */
+    wxPanel* getGridPanel(wxGBPosition position);
+    /**
+     * @brief Removes the content of a panel of the grid, so that it can be built again
+     * @param position Position of the panel in the grid
+     * @return The cleared panel
+     */
+    wxPanel* clearGridPanel(wxGBPosition position);
+
     /**
      * @brief builds center panel showing round number and prediction sum
      * @param sizer Pointer to the grid bag sizer used for the layout
@@ -81,7 +105,9 @@ private:
      */
     void buildScoreLeaveButtons(wxGridBagSizer* sizer, game_state* gameState);
 
-    InputField* _trickEstimateField; ///< input field for entering trick estimates
+    InputField* _trickEstimateField = nullptr; ///< input field for entering trick estimates, nullptr if not shown
+    wxGridBagSizer* _grid = nullptr; ///< grid of the panels, built for the first game state
+    TableView _shownView; ///< view of the shown game state
 };
 
 #endif //TRICKESTIMATIONPANEL_H
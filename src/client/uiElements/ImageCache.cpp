@@ -0,0 +1,60 @@
+#include "ImageCache.h"
+
+
+std::unordered_map<std::string, wxImage> ImageCache::_images;
+std::map<ImageCache::BitmapKey, wxBitmap> ImageCache::_bitmaps;
+long long ImageCache::_cachedPixels = 0;
+
+
+const wxImage& ImageCache::getImage(const wxString& file, wxBitmapType format) {
+    std::string key = file.ToStdString();
+
+    auto it = ImageCache::_images.find(key);
+    if(it != ImageCache::_images.end()) {
+        return it->second;
+    }
+
+    // files that cannot be loaded are cached as invalid images, so they are not tried (and reported) again
+    wxImage& image = ImageCache::_images[key];
+    if(!wxFileExists(file)) {
+        wxMessageBox("Could not find file: " + file, "File error", wxICON_ERROR);
+    } else if(!image.LoadFile(file, format)) {
+        wxMessageBox("Could not load file: " + file, "File error", wxICON_ERROR);
+    }
+    return image;
+}
+
+
+const wxBitmap& ImageCache::getBitmap(const wxString& file, wxBitmapType format, const wxSize& size, double rotation) {
+    BitmapKey key = BitmapKey(file.ToStdString(), size.GetWidth(), size.GetHeight(), rotation);
+
+    auto it = ImageCache::_bitmaps.find(key);
+    if(it != ImageCache::_bitmaps.end()) {
+        return it->second;
+    }
+
+    const wxImage& image = ImageCache::getImage(file, format);
+    if(!image.IsOk() || size.GetWidth() <= 0 || size.GetHeight() <= 0) {
+        static const wxBitmap invalidBitmap;
+        return invalidBitmap;
+    }
+
+    wxImage transformed;
+    if(rotation == 0.0) {
+        transformed = image.Scale(size.GetWidth(), size.GetHeight(), wxIMAGE_QUALITY_HIGH);
+
+    } else {
+        wxPoint centerOfRotation = wxPoint(image.GetWidth() / 2, image.GetHeight() / 2);
+        transformed = image.Rotate(rotation, centerOfRotation, true);
+        transformed = transformed.Scale(size.GetWidth(), size.GetHeight(), wxIMAGE_QUALITY_BILINEAR);
+    }
+
+    long long pixels = (long long) size.GetWidth() * size.GetHeight();
+    if(ImageCache::_cachedPixels + pixels > ImageCache::maxCachedPixels) {
+        ImageCache::_bitmaps.clear();
+        ImageCache::_cachedPixels = 0;
+    }
+    ImageCache::_cachedPixels += pixels;
+
+    return ImageCache::_bitmaps.emplace(key, wxBitmap(transformed)).first->second;
+}
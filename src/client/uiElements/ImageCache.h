@@ -0,0 +1,36 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <wx/wx.h>
+
+// Process-wide cache of the images shown by the client. Every image file is read from disk and decoded only once, and
+// every size and rotation it is drawn in is computed only once, so building the panels for a new game state does not
+// load or transform any image that was shown before. Like all wxWidgets drawing, it is only used on the main thread.
+class ImageCache {
+
+public:
+    // Returns the decoded image of the file. The image is invalid if the file could not be loaded, which is reported
+    // to the user once.
+    static const wxImage& getImage(const wxString& file, wxBitmapType format);
+
+    // Returns the image of the file rotated by <rotation> (in radian) and scaled to <size>. The bitmap is invalid if
+    // the file could not be loaded.
+    static const wxBitmap& getBitmap(const wxString& file, wxBitmapType format, const wxSize& size, double rotation = 0.0);
+
+private:
+    // file, width, height and rotation of a transformed image
+    using BitmapKey = std::tuple<std::string, int, int, double>;
+
+    // the transformed images are dropped once they hold more pixels than this (e.g. after resizing the window often)
+    static constexpr long long maxCachedPixels = 16 * 1024 * 1024;
+
+    static std::unordered_map<std::string, wxImage> _images;
+    static std::map<BitmapKey, wxBitmap> _bitmaps;
+    static long long _cachedPixels;
+};
+
+#endif // IMAGECACHE_H
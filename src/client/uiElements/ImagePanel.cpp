@@ -1,19 +1,17 @@
 #include "ImagePanel.h"
+#include "ImageCache.h"
 
 
 ImagePanel::ImagePanel(wxWindow* parent, wxString file, wxBitmapType format, wxPoint position, wxSize size, double rotation) :
         wxPanel(parent, wxID_ANY, position, size)
 {
-    if(!wxFileExists(file)) {
-        wxMessageBox("Could not find file: " + file, "File error", wxICON_ERROR);
-        return;
-    }
-
-    if(!this->_image.LoadFile(file, format)) {
-        wxMessageBox("Could not load file: " + file, "File error", wxICON_ERROR);
+    // loads the image, if it was not loaded before (errors are reported by the cache)
+    if(!ImageCache::getImage(file, format).IsOk()) {
         return;
     }
 
+    this->_file = file;
+    this->_format = format;
     this->_rotation = rotation;
 
     this->_width = -1;
@@ -27,10 +25,6 @@ ImagePanel::ImagePanel(wxWindow* parent, wxString file, wxBitmapType format, wxP
 void ImagePanel::paintEvent(wxPaintEvent& event) {
     // this code is called when the system requests this panel to be redrawn.
 
-    if(!this->_image.IsOk()) {
-        return;
-    }
-
     wxPaintDC deviceContext = wxPaintDC(this);
 
     int newWidth;
@@ -38,23 +32,13 @@ void ImagePanel::paintEvent(wxPaintEvent& event) {
     deviceContext.GetSize(&newWidth, &newHeight);
 
     if(newWidth != this->_width || newHeight != this->_height) {
+        // the bitmap is shared with all other panels that show the same image in the same size
+        this->_bitmap = ImageCache::getBitmap(this->_file, this->_format, wxSize(newWidth, newHeight), this->_rotation);
+        this->_width = newWidth;
+        this->_height = newHeight;
+    }
 
-        wxImage transformed;
-
-        if(this->_rotation == 0.0) {
-            transformed = this->_image.Scale(newWidth, newHeight, wxIMAGE_QUALITY_HIGH);
-
-        } else {
-            wxPoint centerOfRotation = wxPoint(this->_image.GetWidth() / 2, this->_image.GetHeight() / 2);
-            transformed = this->_image.Rotate(this->_rotation, centerOfRotation, true);
-            transformed = transformed.Scale(newWidth, newHeight, wxIMAGE_QUALITY_BILINEAR);
-        }
-        this->_bitmap = wxBitmap(transformed);
-        this->_width = transformed.GetWidth();
-        this->_height = transformed.GetHeight();
-
-        deviceContext.DrawBitmap(this->_bitmap, 0, 0, false);
-    } else {
+    if(this->_bitmap.IsOk()) {
         deviceContext.DrawBitmap(this->_bitmap, 0, 0, false);
     }
 }
@@ -67,4 +51,4 @@ void ImagePanel::onSize(wxSizeEvent& event) {
 
     // skip any other effects of this event.
     event.Skip();
-}
\ No newline at end of file
+}
@@ -5,9 +5,11 @@
 #include <wx/sizer.h>
 
 // This class can be used to display an image. It can be scaled with parameter <size> and rotated with <rotation> (in radian)
+// The image is taken from the ImageCache, so it is only loaded and transformed once for all panels that show it.
 class ImagePanel : public wxPanel
 {
-    wxImage _image;
+    wxString _file;
+    wxBitmapType _format;
     wxBitmap _bitmap;
 
     double _rotation;
@@ -1,67 +1,143 @@
 #include "card.h"
+
+#include <array>
+#include <vector>
+
 #include "../../exceptions/WizardException.h"
+#include "../../serialization/schema.h"
+
+// packs the value and color of a card into one byte (see header file for more details)
+static constexpr uint8_t pack(const int value, const int color)
+{
+    return static_cast<uint8_t>((value & 0x0f) | (color << 4));
+}
+
+// the value and color of every card of the card table, in the order of a new deck
+static constexpr std::array<uint8_t, card::nof_cards> card_table_kinds = [] {
+    std::array<uint8_t, card::nof_cards> kinds {};
+    size_t i = 0;
+    // 52 regular cards with values 1-13 for each of the 4 colors
+    for (int value = 1; value <= 13; ++value) {
+        for (int color = 1; color <= 4; ++color) {
+            kinds[i++] = pack(value, color);
+        }
+    }
+    // 4 wizards (value 14 and color 0) and 4 jesters (value 0 and color 0)
+    for (int j = 0; j < 4; ++j) {
+        kinds[i++] = pack(14, 0);
+    }
+    for (int j = 0; j < 4; ++j) {
+        kinds[i++] = pack(0, 0);
+    }
+    return kinds;
+}();
+
+// the cards of the card table, created on first use and never deleted
+// (decks of static objects, e.g. the games of the server, may still refer to it when the program exits)
+static std::vector<card>& get_card_table()
+{
+    static std::vector<card>* table = [] {
+        auto* cards = new std::vector<card>();
+        cards->reserve(card::nof_cards);
+        for (unsigned int i = 0; i < card::nof_cards; ++i) {
+            cards->emplace_back(entity_id::from_index(i), card_table_kinds[i] & 0x0f, card_table_kinds[i] >> 4);
+        }
+        return cards;
+    }();
+    return *table;
+}
 
 // constructors (from_diff and deserialization)
 card::card(const std::string& id) : unique_serializable(id) { }
 
-card::card(const std::string& id, serializable_value<int>* value, serializable_value<int>* color)
-        : unique_serializable(id), _value(value), _color(color)
+card::card(const std::string& id, const int value, const int color)
+        : unique_serializable(id), _value_and_color(pack(value, color))
 { }
 
 // constructor
-card::card(const int value, const int color) : unique_serializable()
+card::card(const int value, const int color) : unique_serializable(), _value_and_color(pack(value, color))
+{ }
+
+card::card(const entity_id id, const int value, const int color)
+        : unique_serializable(id), _value_and_color(pack(value, color))
+{ }
+
+// destructor
+card::~card() = default;
+
+// card table
+card* card::get_card(const unsigned int index)
 {
-    _value = new serializable_value<int>(value);
-    _color = new serializable_value<int>(color);
+    return &get_card_table()[index];
 }
 
-// destructor
-card::~card() {
-    delete _value;
-    delete _color;
+int card::get_index() const
+{
+    // the id of a card of the table is its index
+    if (!_id.is_index() || _id.get_index() >= nof_cards || get_card(_id.get_index()) != this) {
+        return -1;
+    }
+    return static_cast<int>(_id.get_index());
 }
 
 // getter functions, return the value of the card or its color
 // (see header file for more details)
 int card::get_value() const noexcept
 {
-    return _value->get_value();
+    return _value_and_color & 0x0f;
 }
 int card::get_color() const noexcept
 {
-    return _color->get_value();
+    return _value_and_color >> 4;
 }
 
 // serializable interface
 void card::write_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType& allocator) const {
     unique_serializable::write_into_json(json, allocator);
+    json.AddMember("value", get_value(), allocator);
+    json.AddMember("color", get_color(), allocator);
+}
 
-    rapidjson::Value value(rapidjson::kObjectType);
-    _value->write_into_json(value, allocator);
-    json.AddMember("value", value, allocator);
-
-    rapidjson::Value color(rapidjson::kObjectType);
-    _color->write_into_json(color, allocator);
-    json.AddMember("color", color, allocator);
+void card::write_into_writer(json_writer& writer) const {
+    writer.StartObject();
+    write_id_into_writer(writer);
+    writer.Key("value");
+    writer.Int(get_value());
+    writer.Key("color");
+    writer.Int(get_color());
+    writer.EndObject();
 }
 
 card* card::from_json(const rapidjson::Value &json) {
-    if (json.HasMember("id") &&
-        json.HasMember("value") &&
-        json.HasMember("color"))
-    {
-        const auto value = serializable_value<int>::from_json(json["value"].GetObject());
-        const auto color = serializable_value<int>::from_json(json["color"].GetObject());
-        return new card(json["id"].GetString(), value, color);
+    const rapidjson::Value* id = nullptr;
+    const rapidjson::Value* value = nullptr;
+    const rapidjson::Value* color = nullptr;
+    for (const auto& member : schema::get_object(json, "card")) {
+        const std::string_view name = schema::name_of(member);
+        if (name == "id") {
+            id = &member.value;
+        } else if (name == "value") {
+            value = &member.value;
+        } else if (name == "color") {
+            color = &member.value;
+        }
+    }
+    if (!id || !value || !color) {
+        throw WizardException("Could not parse json of card. Was missing 'id', 'value', or 'color'.");
+    }
+    if (!id->IsString() || !value->IsInt() || !color->IsInt()) {
+        throw WizardException("Could not parse json of card. 'id', 'value', or 'color' has the wrong type.");
     }
-    throw WizardException("Could not parse json of card. Was missing 'id', 'value', or 'color'.");
-}
-
-
-
-
-
-
-
-
 
+    // every card of a game is one of the card table, the deck, hands and tricks never own the cards they read
+    entity_id card_id;
+    if (!entity_id::try_parse({id->GetString(), id->GetStringLength()}, card_id) || !card_id.is_index()
+        || card_id.get_index() >= nof_cards) {
+        throw WizardException("Could not parse json of card. Its id is not the id of a card of the card table.");
+    }
+    card* table_card = get_card(card_id.get_index());
+    if (table_card->get_value() != value->GetInt() || table_card->get_color() != color->GetInt()) {
+        throw WizardException("Could not parse json of card. Its value or color does not match its id.");
+    }
+    return table_card;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef WIZARD_CARD_H
 #define WIZARD_CARD_H
 
+#include <cstdint>
 #include "../../serialization/unique_serializable.h"
 #include "../../serialization/serializable_value.h"
 #include "../../../../rapidjson/include/rapidjson/document.h"
@@ -11,12 +12,20 @@
  *
  * This class encapsulates all information about a card,
  * including its value and color.
+ *
+ * Cards never change, so their value and color are packed into a single byte (value in the low four bits, color in
+ * the high four bits) instead of being stored as separate serializable values.
+ *
+ * Since the cards never change, each of the 60 cards of the game exists only once, in the shared card table (see
+ * get_card()). The decks, hands and tricks of all games, on the server and on the client, refer to the cards of the
+ * table, whose ids are their indices in the table. A deserialized card is looked up in the table by its id.
  */
 class card : public unique_serializable {
 private:
 
-    serializable_value<int>* _value{}; ///< The card's value (value between 1 and 13, or jester (0) / wizard (14)).
-    serializable_value<int>* _color{}; ///< The card's color ( 0 : no color, 1: yellow, 2: red, 3: green, 4: yellow)
+    /// The card's value (value between 1 and 13, or jester (0) / wizard (14)) in the low four bits and the card's
+    /// color (0 : no color, 1: yellow, 2: red, 3: green, 4: yellow) in the high four bits.
+    uint8_t _value_and_color = 0;
 
     /**
      * @brief Constructs a new card object (from_diff).
@@ -30,7 +39,7 @@ private:
      * @param value The card's value.
      * @param color The card's color.
      */
-    card(const std::string& id, serializable_value<int>* value, serializable_value<int>* color);
+    card(const std::string& id, int value, int color);
 
 public:
 
@@ -42,11 +51,39 @@ public:
      */
     card(int value, int color);
 
+    /**
+     * @brief Constructs a new card object with a given id (used for the cards of the card table).
+     * @param id The card's id.
+     * @param value The card's value.
+     * @param color The card's color.
+     */
+    card(entity_id id, int value, int color);
+
     /**
      * @brief Destructs a card object.
      */
     ~card() override;
 
+// card table
+    /// The number of cards of the game, which is the size of the card table.
+    static constexpr unsigned int nof_cards = 60;
+
+    /**
+     * @brief Gets a card of the shared card table.
+     * @param index The card's index in the table (0 to nof_cards - 1).
+     * @return The card, which is never deleted.
+     *
+     * The table is ordered like a new deck: 52 regular cards (values 1 to 13, each in all 4 colors), 4 wizards and
+     * 4 jesters. The id of every card is its index (see entity_id::from_index()).
+     */
+    static card* get_card(unsigned int index);
+
+    /**
+     * @brief Gets the index of the card in the card table.
+     * @return The index, or -1 if the card is not part of the table (i.e. it was created with the public constructor).
+     */
+    [[nodiscard]] int get_index() const;
+
 // accessors
     /**
      * @brief Gets the card's value.
@@ -68,10 +105,18 @@ public:
      */
     void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
 
+    /**
+     * @brief Writes the same json as write_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_into_writer(json_writer& writer) const override;
+
     /**
      * @brief Deserializes a card object from a json object.
      * @param json The json object containing the card information.
-     * @return A pointer to a new card object created from the given json object.
+     * @return A pointer to the card of the card table with the given id, without any allocation.
+     * @throws WizardException If the id is not the id of a card of the card table, or the value or color of the card
+     * do not match it.
      */
     static card* from_json(const rapidjson::Value& json);
 
@@ -0,0 +1,71 @@
+//
+// Sets of cards as 64-bit masks with one bit per card of the deck.
+//
+// The colored cards take bits 0-51, 13 consecutive bits per color (bit (color - 1) * 13 + value - 1), so all cards of
+// a color are selected by one mask and are ordered by value. The four wizards take bits 52-55 and the four jesters
+// bits 56-59. Wizards and jesters are interchangeable, so a set holding n wizards (jesters) uses the lowest n bits of
+// their range.
+
+#ifndef WIZARD_CARD_MASK_H
+#define WIZARD_CARD_MASK_H
+
+#include <bit>
+#include <cstdint>
+
+namespace card_mask {
+
+    constexpr int wizard_value = 14;
+    constexpr int jester_value = 0;
+
+    constexpr uint64_t wizards = uint64_t{0xf} << 52;
+    constexpr uint64_t jesters = uint64_t{0xf} << 56;
+    constexpr uint64_t all = (uint64_t{1} << 60) - 1;
+
+    // All cards of a color (1-4); no cards for any other color, e.g. 0 (no color) or -1 (set by a wizard)
+    constexpr uint64_t of_color(const int color) {
+        return color >= 1 && color <= 4 ? uint64_t{0x1fff} << (color - 1) * 13 : 0;
+    }
+
+    // The bits a card with the given value and color can take: one bit for a colored card, the whole range for a
+    // wizard or jester
+    constexpr uint64_t of_kind(const int value, const int color) {
+        if (value == wizard_value) {
+            return wizards;
+        }
+        if (value == jester_value) {
+            return jesters;
+        }
+        return uint64_t{1} << ((color - 1) * 13 + value - 1);
+    }
+
+    // Adds a card with the given value and color to a set
+    constexpr uint64_t add(const uint64_t mask, const int value, const int color) {
+        const uint64_t free = of_kind(value, color) & ~mask;
+        return mask | (free & (~free + 1));
+    }
+
+    // Removes a card with the given value and color from a set
+    constexpr uint64_t remove(const uint64_t mask, const int value, const int color) {
+        const uint64_t kind = of_kind(value, color);
+        const uint64_t used = mask & kind;
+        return (mask & ~kind) | (used & (used - 1));
+    }
+
+    // Whether a set holds a card with the given value and color
+    constexpr bool contains(const uint64_t mask, const int value, const int color) {
+        return (mask & of_kind(value, color)) != 0;
+    }
+
+    // The cards of a set that may be played in a trick with the given trick color (0 if no card was played yet, -1 if
+    // a wizard was played first): wizards and jesters always, and cards of the trick color if there are any
+    constexpr uint64_t playable(const uint64_t mask, const int trick_color) {
+        const uint64_t same_color = mask & of_color(trick_color);
+        return same_color != 0 ? same_color | (mask & (wizards | jesters)) : mask;
+    }
+
+    constexpr int size(const uint64_t mask) {
+        return std::popcount(mask);
+    }
+}
+
+#endif //WIZARD_CARD_MASK_H
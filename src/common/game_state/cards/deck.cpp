@@ -3,9 +3,11 @@
 //
 
 #include "deck.h"
-#include <random>
+
+#include <algorithm>
 #include "../../serialization/vector_utils.h"
 #include "../../exceptions/WizardException.h"
+#include "../../serialization/schema.h"
 
 // deserialization constructor
 deck::deck(const std::string& id, const std::vector<card*> &all_cards, const std::vector<card*> &remaining_cards)
@@ -23,40 +25,39 @@ deck::deck(const std::vector<card*> &cards)
         : unique_serializable(), _all_cards(cards)
 { }
 
-deck::deck() : unique_serializable()
+deck::deck(const deck& other)
+        : unique_serializable(other._id),
+          _all_cards(other._all_cards),
+          _remaining_cards(other._remaining_cards)
 {
-    // this is the main constructor used by the game state to create an object of class deck
-    // it initializes the deck object with all wizard cards in the _all_cards vector
-    _all_cards = std::vector<card*>();
-
-    // create 52 regular cards with values 1-13 for each of the 4 colors
-    for (int i = 1; i <= 13; ++i)
-    {
-        for (int j = 1; j <= 4; ++j)
-        {
-            _all_cards.push_back(new card(i, j));
+    for (card* & _card : _all_cards) {
+        if (_card->get_index() < 0) {
+            card* own_card = new card(_card->get_entity_id(), _card->get_value(), _card->get_color());
+            std::replace(_remaining_cards.begin(), _remaining_cards.end(), _card, own_card);
+            _card = own_card;
         }
     }
+}
 
-    // create 4 wizards (value 14 and color 0)
-    for (int i = 0; i < 4; ++i)
-    {
-        _all_cards.push_back(new card(14, 0));
-    }
-
-    // create 4 jesters (value 0 and color 0)
-    for (int i = 0; i < 4; ++i)
+deck::deck() : unique_serializable()
+{
+    // this is the main constructor used by the game state to create an object of class deck
+    // it initializes the deck object with all wizard cards in the _all_cards vector, i.e. with the cards of the
+    // shared card table: 52 regular cards, 4 wizards and 4 jesters
+    _all_cards.reserve(card::nof_cards);
+    for (unsigned int i = 0; i < card::nof_cards; ++i)
     {
-        _all_cards.push_back(new card(0, 0));
+        _all_cards.push_back(card::get_card(i));
     }
-
     _remaining_cards = _all_cards;
 }
 
 deck::~deck() {
-    // delete _all_cards vector
+    // delete the cards that are not part of the card table (e.g. cards given to the deck by tests)
     for (card* & _card : _all_cards) {
-        delete _card;
+        if (_card->get_index() < 0) {
+            delete _card;
+        }
     }
     _all_cards.clear();
     // delete _remaining_cards_vector
@@ -77,9 +78,13 @@ unsigned int deck::get_number_of_remaining_cards() const noexcept
 
 #ifdef WIZARD_SERVER
 // state update functions
-void deck::setup_round()
+void deck::setup_round(random_generator& rng)
 {
     _remaining_cards = _all_cards;
+    // Fisher-Yates shuffle
+    for (int i = static_cast<int>(_remaining_cards.size()) - 1; i > 0; --i) {
+        std::swap(_remaining_cards[i], _remaining_cards[rng.next_below(i + 1)]);
+    }
 }
 
 bool deck::draw_cards(const player* player, const int round_number, std::string& err)
@@ -95,24 +100,19 @@ bool deck::draw_cards(const player* player, const int round_number, std::string&
         err = "Invalid number of rounds to draw.";
         return false;
     }
-    // random device and generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
     // get player hand
     hand* hand = player->get_hand();
     for (int i = 0; i < round_number; ++i) {
-        // randomly select an index from remaining_cards
-        std::uniform_int_distribution<> dist(0, _remaining_cards.size() - 1);
-        const int random_index = dist(gen);
+        // the remaining cards are shuffled, so the last one is a random card
         // try to add card to player's hand
-        if (!hand->add_card(_remaining_cards[random_index], err))
+        if (!hand->add_card(_remaining_cards.back(), err))
         {
             // card could not be placed into hand
             err = "Could not place a new card into the player's hand";
             return false;
         }
         // remove card from remaining_cards
-        _remaining_cards.erase(_remaining_cards.begin() + random_index);
+        _remaining_cards.pop_back();
     }
 
 
@@ -124,17 +124,8 @@ card* deck::draw_trump() const
     // if all cards has been dealt return nullptr, this should never be the case
     if (_remaining_cards.empty()) return nullptr;
 
-    // if there are still cards left, one card is randomly drawn as trump from _remaining_cards
-    // random device and generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    // distribution to select a random index within the range of _remaining_cards
-    std::uniform_int_distribution<> dis(0, _remaining_cards.size() - 1);
-
-    // draw a single random index and return that card as trump
-    const int random_index = dis(gen);
-    return _remaining_cards[random_index];
+    // if there are still cards left, the next card of the shuffled remaining cards is the trump
+    return _remaining_cards.back();
 }
 #endif
 
@@ -149,26 +140,51 @@ void deck::write_into_json(rapidjson::Value& json, rapidjson::Document::Allocato
     json.AddMember("remaining_cards", vector_utils::serialize_vector(_remaining_cards, allocator), allocator);
 }
 
-deck* deck::from_json(const rapidjson::Value& json)
+void deck::write_into_writer(json_writer& writer) const
 {
-    if (json.HasMember("id") &&
-        json.HasMember("all_cards") &&
-        json.HasMember("remaining_cards"))
+    writer.StartObject();
+    write_id_into_writer(writer);
+
+    writer.Key("all_cards");
+    vector_utils::write_vector(_all_cards, writer);
+
+    writer.Key("remaining_cards");
+    vector_utils::write_vector(_remaining_cards, writer);
+    writer.EndObject();
+}
+
+// reads an array of cards
+static std::vector<card*> cards_from_json(const rapidjson::Value& json)
+{
+    const auto serialized_cards = schema::get_array(json, "cards");
+    std::vector<card*> cards;
+    cards.reserve(serialized_cards.Size());
+    for (auto &serialized_card : serialized_cards)
     {
-        // deserialize all_cards
-        auto des_all_cards = std::vector<card*>();
-        for (auto &serialized_card : json["all_cards"].GetArray())
-        {
-            des_all_cards.push_back(card::from_json(serialized_card.GetObject()));
-        }
+        cards.push_back(card::from_json(serialized_card));
+    }
+    return cards;
+}
 
-        // deserialize remaining_cards
-        auto des_remaining_cards = std::vector<card*>();
-        for (auto &serialized_card : json["remaining_cards"].GetArray())
-        {
-            des_remaining_cards.push_back(card::from_json(serialized_card.GetObject()));
+deck* deck::from_json(const rapidjson::Value& json)
+{
+    const rapidjson::Value* id = nullptr;
+    const rapidjson::Value* all_cards = nullptr;
+    const rapidjson::Value* remaining_cards = nullptr;
+    for (const auto& member : schema::get_object(json, "deck"))
+    {
+        const std::string_view name = schema::name_of(member);
+        if (name == "id") {
+            id = &member.value;
+        } else if (name == "all_cards") {
+            all_cards = &member.value;
+        } else if (name == "remaining_cards") {
+            remaining_cards = &member.value;
         }
-        return new deck(json["id"].GetString(), des_all_cards, des_remaining_cards);
+    }
+    if (id && all_cards && remaining_cards)
+    {
+        return new deck(schema::get<const char*>(*id, "id"), cards_from_json(*all_cards), cards_from_json(*remaining_cards));
     }
     throw WizardException("Could not parse draw_pile from json. 'id' or 'cards' were missing.");
 }
@@ -7,6 +7,7 @@
 
 #include "card.h"
 #include "../player/player.h"
+#include "../random_generator.h"
 #include <vector>
 #include "../../serialization/unique_serializable.h"
 #include "../../serialization/serializable_value.h"
@@ -23,6 +24,9 @@
  * holds pointers to these cards that are not changed once created and are used to update the _remaining_cards
  * member of the deck class when a new round is set up. The _remaining_cards member helps to keep track of which
  * cards are already dealt and which can still be dealt and used to draw a trump.
+ *
+ * The cards are the cards of the shared card table (see card::get_card()), so creating a deck does not create any
+ * card, and the decks of all games (also deserialized ones) refer to the same cards.
  */
 class deck : public unique_serializable
 {
@@ -51,9 +55,9 @@ public:
      * @brief Constructs a new deck object.
      *
      * This is the main constructor of the deck class used by the game_state to create a deck for a game.
-     * When this constructor is called, all possible cards in Wizard are created and added to the deck. This is the
-     * only time actual card objects are created, every card only exists exactly once. In all other instances where
-     * cards are removed or added somewhere (e.g., to a player's hand), actually only pointers are added or removed.
+     * When this constructor is called, all possible cards in Wizard are added to the deck. Every card only exists
+     * exactly once, in the card table. In all other instances where cards are removed or added somewhere (e.g., to a
+     * player's hand), actually only pointers are added or removed.
      */
     deck();
 
@@ -63,11 +67,19 @@ public:
      */
     explicit deck(const std::vector<card*>& cards);
 
+    /**
+     * @brief Constructs a new deck object as a copy of another deck object, with the same id.
+     * @param other The deck it is copied from.
+     *
+     * The copy refers to the same cards of the card table. Other cards are owned by the deck, so they are copied.
+     */
+    deck(const deck& other);
+
     /**
      * @brief Destructs a deck object.
      *
-     * As explained for the deck's main constructor, the deck creates the actual card objects, and thus this is the
-     * only place where the actual cards are deleted, and not only pointers.
+     * The cards of the card table are never deleted. Other cards given to the deck (see the constructor above) are
+     * owned by the deck, and thus this is the only place where these cards are deleted, and not only pointers.
      */
     ~deck() override;
 
@@ -90,10 +102,12 @@ public:
 // state update functions
     /**
      * @brief Sets up the deck for a new round.
+     * @param rng The game's random number generator used to shuffle the deck.
      *
-     * Setting up a deck for a new round is done by refreshing the remaining cards from all cards.
+     * Setting up a deck for a new round is done by refreshing the remaining cards from all cards and shuffling them
+     * once (Fisher-Yates). Cards are then drawn from the end of the shuffled remaining cards.
      */
-    void setup_round();
+    void setup_round(random_generator& rng);
 
     /**
      * @brief Draws a number of random cards based on the current round number and places them into a player's hand.
@@ -102,10 +116,10 @@ public:
      * @param err The error message updated in case something does not work.
      * @return A boolean indicated if drawing the cards worked or not.
      *
-     * This function is used to place cards into the players' hands at the start of each round. The cards are randomly
-     * drawn from the remaining cards, added to a player's hand, and then are removed from the remaining cards. The
-     * number of cards to be drawn should be the current round number (if round number 0-indexed, the round_number
-     * parameter must be the round number + 1).
+     * This function is used to place cards into the players' hands at the start of each round. The cards are taken
+     * from the end of the remaining cards (shuffled by setup_round), added to a player's hand, and then are removed
+     * from the remaining cards. The number of cards to be drawn should be the current round number (if round number
+     * 0-indexed, the round_number parameter must be the round number + 1).
      */
     bool draw_cards(const player* player, int round_number, std::string& err);
 
@@ -113,7 +127,7 @@ public:
      * @brief Draws a random trump card from the remaining cards.
      * @return The card used as trump.
      *
-     * This function randomly draws one card from the remaining cards, which is then used as the trump for a round.
+     * This function returns the next card of the shuffled remaining cards, which is then used as the trump for a round.
      * In the last round, there are no more remaining cards after dealing. In this case, a nullptr is returned. The
      * logic to handle this case further is implemented in the game_state class.
      */
@@ -129,6 +143,12 @@ public:
      */
     void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
 
+    /**
+     * @brief Writes the same json as write_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_into_writer(json_writer& writer) const override;
+
     /**
      * @brief Deserializes a deck object from a json object.
      * @param json The json object containing the deck information.
@@ -3,51 +3,48 @@
 //
 
 #include "trick.h"
+#include <algorithm>
+#include <memory>
+#include <span>
 #include "../../serialization/vector_utils.h"
 #include "../../exceptions/WizardException.h"
 
 // constructors and destructor
-trick::trick() : unique_serializable()
-{
-        this->_trick_color = new serializable_value<int>(0);
-        this->_trump_color = new serializable_value<int>(0);
-}
+trick::trick() : unique_serializable() { }
 
-trick::trick(const std::string& id) : unique_serializable(id)
-{
-        this->_trick_color = new serializable_value<int>(0);
-        this->_trump_color = new serializable_value<int>(0);
-}
+trick::trick(const std::string& id) : unique_serializable(id) { }
 
 trick::trick(const std::string& id, const std::vector<std::pair<card*, player*>> &cards,
-             serializable_value<int>* trick_color, serializable_value<int>* trump_color)
-    : unique_serializable(id), _cards(cards)
-{
-        this->_trick_color = trick_color;
-        this->_trump_color = trump_color;
-}
+             const int trick_color, const int trump_color)
+    : unique_serializable(id), _trick_color(trick_color), _trump_color(trump_color), _cards(cards)
+{ }
 
-trick::trick(const int trump) : unique_serializable()
-{
-        this->_trick_color = new serializable_value<int>(0);
-        this->_trump_color = new serializable_value<int>(0);
-        *_trump_color = trump;
-}
+trick::trick(const int trump) : unique_serializable(), _trump_color(trump) { }
 
 trick::trick(const trick &other)
-        : unique_serializable() {
-        // shallow copy
-        _cards = other._cards;
-        // deep copy
-        _trick_color = new serializable_value<int>(*other._trick_color);
-        _trump_color = new serializable_value<int>(*other._trump_color);
+        : unique_serializable(),
+          // the copy is a new trick, so all of its values are dirty
+          _trick_color(other._trick_color.get_value()),
+          _trump_color(other._trump_color.get_value()),
+          // shallow copy
+          _cards(other._cards)
+{ }
+
+
+trick::trick(const trick &other, const std::vector<player*>& players)
+        : unique_serializable(other._id),
+          _trick_color(other._trick_color),
+          _trump_color(other._trump_color),
+          _cards(other._cards),
+          _cards_dirty(other._cards_dirty),
+          _nof_clean_cards(other._nof_clean_cards)
+{
+        replace_players(players);
 }
 
 
 trick::~trick()
 {
-        delete _trick_color;
-        delete _trump_color;
         _cards.clear();
 }
 
@@ -55,12 +52,12 @@ trick::~trick()
 // accessors
 int trick::get_trick_color() const
 {
-        return this->_trick_color->get_value();
+        return this->_trick_color.get_value();
 }
 
 int trick::get_trump_color() const
 {
-        return this->_trump_color->get_value();
+        return this->_trump_color.get_value();
 }
 
 std::vector<std::pair<card*, player*>> trick::get_cards_and_players() const
@@ -81,7 +78,7 @@ player* trick::get_winner() const
                 }
         }
         // all joker check
-        if (_trick_color->get_value() == 0)
+        if (_trick_color.get_value() == 0)
         {
                 return winner; // would be first joker player
         }
@@ -89,7 +86,7 @@ player* trick::get_winner() const
         bool trump_present = false;
         int highest_trump = 0;
         for (auto & _card : _cards) {
-                if (_card.first->get_color() == _trump_color->get_value())
+                if (_card.first->get_color() == _trump_color.get_value())
                 {
                         trump_present = true;
                         if (_card.first->get_value() > highest_trump)
@@ -106,7 +103,7 @@ player* trick::get_winner() const
         int winner_idx = -1; // use a non joker idx;
         for (int i = 0; i < _cards.size(); i++) {
                 //check if played card color matches trick color
-                if (_cards[i].first->get_color() == _trick_color->get_value())
+                if (_cards[i].first->get_color() == _trick_color.get_value())
                         if (winner_idx == -1 ||
                                 _cards[i].first->get_value()
                                 > _cards[winner_idx].first->get_value()) {
@@ -127,70 +124,26 @@ void trick::set_up_round(int trump, std::string& err)
 {
         // remove all cards (if any)
         _cards.clear();
-        *_trump_color = trump;
-        *_trick_color = 0;
+        _cards_dirty = true;
+        _nof_clean_cards = 0;
+        _trump_color = trump;
+        _trick_color = 0;
 }
 
 player* trick::wrap_up_trick(std::string& err) const
 {
-        player* winner = _cards[0].second; // base winner is first player, in case of 4 jokers
-
-        // Determine and return winner
-        // wizard check
-        for (auto & _card : _cards) {
-                if (_card.first->get_value() == 14)
-                {
-                        return _card.second;
-                }
-        }
-        // all joker check
-        if (_trick_color->get_value() == 0)
-        {
-                return winner; // would be first joker player
-        }
-        // trump check
-        bool trump_present = false;
-        int highest_trump = 0;
-        for (auto & _card : _cards) {
-                if (_card.first->get_color() == _trump_color->get_value())
-                {
-                        trump_present = true;
-                        if (_card.first->get_value() > highest_trump)
-                        {
-                                highest_trump = _card.first->get_value();
-                                winner = _card.second;
-                        }
-                }
-        }
-        if (trump_present) {
-                return winner;
-        }
-        // highest card of trick color check
-        int winner_idx = -1; // use a non joker idx;
-        for (int i = 0; i < _cards.size(); i++) {
-                //check if played card color matches trick color
-                if (_cards[i].first->get_color() == _trick_color->get_value())
-                        if (winner_idx == -1 ||
-                                _cards[i].first->get_value()
-                                > _cards[winner_idx].first->get_value()) {
-                        winner_idx = i;
-                }
-        }
-        if (winner_idx != -1) {
-                winner = _cards[winner_idx].second;
-        }
-
-        return winner;
+        return get_winner();
 }
 
 bool trick::add_card(card* played_card, player* current_player, std::string& err) {
         if (played_card) {
                 _cards.emplace_back(played_card, current_player);
+                _cards_dirty = true;
                 // set trick color
-                if(_trick_color->get_value() == 0){
-                        _trick_color->set_value(played_card->get_color());
+                if(_trick_color.get_value() == 0){
+                        _trick_color.set_value(played_card->get_color());
                         if(played_card->get_value() == 14) { //if wizard sets trick color to -1
-                                _trick_color->set_value(-1);
+                                _trick_color.set_value(-1);
                         }
                 }
                 return true;
@@ -199,39 +152,144 @@ bool trick::add_card(card* played_card, player* current_player, std::string& err
         return false;
 }
 
+void trick::copy_from(const trick& other) {
+        _cards = other._cards;
+        _cards_dirty = true;
+        _nof_clean_cards = 0;
+        _trick_color.set_value(other._trick_color.get_value());
+        _trump_color.set_value(other._trump_color.get_value());
+}
+
 
 // server setter
-void trick::set_trick_color(int color) const
+void trick::set_trick_color(const int color)
 {
-        *_trick_color = color;
+        _trick_color = color;
 }
 #endif
 
-// serialization interface
-trick* trick::from_json(const rapidjson::Value &json) {
-        if (json.HasMember("id")
-                && json.HasMember("cards")
-                && json.HasMember("trump_color")
-                && json.HasMember("trick_color")) {
-
-                auto deserialized_cards = std::vector<std::pair<card*, player*>>();
-                for (auto &serialized_card : json["cards"].GetArray()) {
-                        // Deserialize the card
-                        card* deserialized_card = card::from_json(serialized_card["card"]);
-
-                        // Deserialize the player
-                        player* deserialized_player = player::from_json(serialized_card["player"]);
-
-                        // Add the pair to the vector
-                        deserialized_cards.emplace_back(deserialized_card, deserialized_player);
+player* trick::find_player(const std::vector<player*>& players, const entity_id& player_id)
+{
+        for (player* p : players) {
+                if (p->get_entity_id() == player_id) {
+                        return p;
+                }
+        }
+        throw WizardException("Could not parse trick from json. The card was played by an unknown player.");
+}
+
+void trick::replace_players(const std::vector<player*>& players)
+{
+        for (auto & _card : _cards) {
+                _card.second = find_player(players, _card.second->get_entity_id());
+        }
+}
+
+// state diffs
+bool trick::is_dirty() const
+{
+        return _cards_dirty || value_fields.is_dirty(*this);
+}
+
+void trick::clear_dirty()
+{
+        _cards_dirty = false;
+        _nof_clean_cards = _cards.size();
+        value_fields.clear_dirty(*this);
+}
+
+void trick::write_diff_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType &allocator) const
+{
+        unique_serializable::write_into_json(json, allocator);
+
+        if (_cards_dirty) {
+                const size_t cards_from = std::min(_nof_clean_cards, _cards.size());
+                const std::vector<std::pair<card*, player*>> new_cards(_cards.begin() + cards_from, _cards.end());
+                json.AddMember("cards_from", static_cast<uint64_t>(cards_from), allocator);
+                json.AddMember("cards", vector_utils::serialize_cards_vector(new_cards, allocator), allocator);
+        }
+        value_fields.write_dirty_into_json(*this, json, allocator);
+}
+
+void trick::write_diff_into_writer(json_writer& writer) const
+{
+        writer.StartObject();
+        write_id_into_writer(writer);
+
+        if (_cards_dirty) {
+                // the new cards are written in place, without copying them like write_diff_into_json()
+                const size_t cards_from = std::min(_nof_clean_cards, _cards.size());
+                writer.Key("cards_from");
+                writer.Uint64(cards_from);
+                writer.Key("cards");
+                vector_utils::write_cards_vector(std::span(_cards).subspan(cards_from), writer);
+        }
+        value_fields.write_dirty_into_writer(*this, writer);
+        writer.EndObject();
+}
+
+void trick::append_cards_from_json(const rapidjson::Value &json, const std::vector<player*>& players)
+{
+        const auto serialized_cards = schema::get_array(json, "cards");
+        _cards.reserve(_cards.size() + serialized_cards.Size());
+        for (auto &serialized_card : serialized_cards) {
+                // the card is looked up in the card table, the player who played it among the players of the game
+                const char* player_id = schema::get<const char*>(schema::get_member(serialized_card, "player_id"), "player_id");
+                _cards.emplace_back(card::from_json(schema::get_member(serialized_card, "card")),
+                                    find_player(players, entity_id::from_string(player_id)));
+        }
+}
+
+void trick::apply_diff(const rapidjson::Value &json, const std::vector<player*>& players)
+{
+        auto reader = value_fields.reader(*this);
+        const rapidjson::Value* cards_from = nullptr;
+        const rapidjson::Value* cards = nullptr;
+        for (const auto& member : schema::get_object(json, "trick")) {
+                if (reader.read(member)) {
+                        continue;
                 }
-                auto trump_color = serializable_value<int>::from_json(json["trump_color"].GetObject());
-                auto trick_color = serializable_value<int>::from_json(json["trick_color"].GetObject());
+                const std::string_view name = schema::name_of(member);
+                if (name == "id") {
+                        _id = entity_id::from_string(schema::get<const char*>(member.value, "id"));
+                } else if (name == "cards_from") {
+                        cards_from = &member.value;
+                } else if (name == "cards") {
+                        cards = &member.value;
+                }
+        }
+        if (cards_from && cards) {
+                const uint64_t nof_kept_cards = schema::get<uint64_t>(*cards_from, "cards_from");
+                if (nof_kept_cards < _cards.size()) {
+                        _cards.resize(nof_kept_cards);
+                }
+                append_cards_from_json(*cards, players);
+        }
+}
 
-                return new trick(json["id"].GetString(), deserialized_cards, trick_color, trump_color);
-        } else {
+// serialization interface
+trick* trick::from_json(const rapidjson::Value &json, const std::vector<player*>& players) {
+        auto deserialized_trick = std::make_unique<trick>(std::string());
+        auto reader = value_fields.reader(*deserialized_trick);
+        const rapidjson::Value* id = nullptr;
+        const rapidjson::Value* cards = nullptr;
+        for (const auto& member : schema::get_object(json, "trick")) {
+                if (reader.read(member)) {
+                        continue;
+                }
+                const std::string_view name = schema::name_of(member);
+                if (name == "id") {
+                        id = &member.value;
+                } else if (name == "cards") {
+                        cards = &member.value;
+                }
+        }
+        if (!id || !cards || !reader.has_read_all()) {
                 throw WizardException("Could not parse trick from json. 'id' or 'cards' were missing.");
         }
+        deserialized_trick->_id = entity_id::from_string(schema::get<const char*>(*id, "id"));
+        deserialized_trick->append_cards_from_json(*cards, players);
+        return deserialized_trick.release();
 }
 
 void trick::write_into_json(rapidjson::Value &json,
@@ -240,11 +298,16 @@ void trick::write_into_json(rapidjson::Value &json,
 
         json.AddMember("cards", vector_utils::serialize_cards_vector(_cards, allocator), allocator);
 
-        rapidjson::Value trump_color(rapidjson::kObjectType);
-        _trump_color->write_into_json(trump_color, allocator);
-        json.AddMember("trump_color", trump_color, allocator);
+        value_fields.write_into_json(*this, json, allocator);
+}
+
+void trick::write_into_writer(json_writer& writer) const {
+        writer.StartObject();
+        write_id_into_writer(writer);
+
+        writer.Key("cards");
+        vector_utils::write_cards_vector(_cards, writer);
 
-        rapidjson::Value trick_color(rapidjson::kObjectType);
-        _trick_color->write_into_json(trick_color, allocator);
-        json.AddMember("trick_color", trick_color, allocator);
+        value_fields.write_into_writer(*this, writer);
+        writer.EndObject();
 }
@@ -10,6 +10,7 @@
 #include "../player/player.h"
 #include "../../serialization/unique_serializable.h"
 #include "../../serialization/serializable_value.h"
+#include "../../serialization/schema.h"
 #include "../../../../rapidjson/include/rapidjson/document.h"
 
 /**
@@ -28,9 +29,32 @@
 class trick : public unique_serializable {
 private:
 
-    serializable_value<int>* _trick_color;              ///< The tricks color (suit).
-    serializable_value<int>* _trump_color;              ///< The rounds trump color.
+    serializable_value<int> _trick_color = 0;           ///< The tricks color (suit).
+    serializable_value<int> _trump_color = 0;           ///< The rounds trump color.
     std::vector<std::pair<card*, player*>> _cards;      ///< The cards played during the current trick and the players who played them.
+    bool _cards_dirty = true;                           ///< Whether the played cards changed since the last state diff.
+    size_t _nof_clean_cards = 0;                        ///< The number of played cards that were already sent in a state diff.
+
+    /// The scalar members of the trick, from which their serialization is generated (see schema.h).
+    static constexpr schema::fields value_fields {
+            schema::value_field {"trump_color", &trick::_trump_color},
+            schema::value_field {"trick_color", &trick::_trick_color}};
+
+    /**
+     * @brief Appends played cards read from json to the trick.
+     * @param json The json array of the played cards (see vector_utils::serialize_cards_vector()).
+     * @param players The players of the game, who the players of the cards are resolved against.
+     */
+    void append_cards_from_json(const rapidjson::Value& json, const std::vector<player*>& players);
+
+    /**
+     * @brief Finds the player with the given id.
+     * @param players The players to search.
+     * @param player_id The id of the player.
+     * @return The player with the given id.
+     * @throws WizardException If none of the players has the given id.
+     */
+    static player* find_player(const std::vector<player*>& players, const entity_id& player_id);
 
 public:
 // constructor and destructors
@@ -45,6 +69,14 @@ public:
      */
     trick(const trick &other);
 
+    /**
+     * @brief Constructs a new trick object as a copy of a trick of another game state, with the same id.
+     * @param other The trick it is copied from.
+     * @param players The players of the copied game state, which replace the players of the other trick.
+     * @throws WizardException If a player of the other trick is not among the players.
+     */
+    trick(const trick &other, const std::vector<player*>& players);
+
     /**
      * @brief Constructs a new trick object (from_diff).
      * @param id The trick's id.
@@ -60,8 +92,8 @@ public:
      */
     trick(const std::string& id,
           const std::vector<std::pair<card*, player*>> &cards,
-          serializable_value<int>* trick_color,
-          serializable_value<int>* trump_color);
+          int trick_color,
+          int trump_color);
 
     /**
      * @brief Constructs a new trick object.
@@ -102,6 +134,50 @@ public:
      */
     [[nodiscard]] player* get_winner() const;
 
+// state diffs
+    /**
+     * @brief Checks if the trick changed since the last call to clear_dirty().
+     * @return A boolean indicating whether the trick changed.
+     */
+    [[nodiscard]] bool is_dirty() const;
+
+    /**
+     * @brief Marks the trick as unchanged, after its changes were sent to the clients in a state diff.
+     */
+    void clear_dirty();
+
+    /**
+     * @brief Serializes the changes of the trick since the last call to clear_dirty() into a json object.
+     * @param json The json object for serializing the diff.
+     * @param allocator The json allocator for serializing the diff.
+     *
+     * The diff always contains the trick's id and only contains the trick and trump color if they changed. Since cards
+     * are only ever appended to a trick or removed all at once, changed cards are sent as the index 'cards_from' from
+     * which on the played cards changed, followed by all cards from that index on.
+     */
+    void write_diff_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const;
+
+    /**
+     * @brief Writes the same json as write_diff_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_diff_into_writer(json_writer& writer) const;
+
+    /**
+     * @brief Applies a diff created by write_diff_into_json() to this trick.
+     * @param json The json object containing the diff.
+     * @param players The players of the game, who the players of newly played cards are resolved against.
+     */
+    void apply_diff(const rapidjson::Value& json, const std::vector<player*>& players);
+
+    /**
+     * @brief Replaces the players of the played cards by the players with the same ids.
+     * @param players The players that replace the current ones.
+     *
+     * Used by the client when the game state receives a new list of players, before the old players are deleted.
+     */
+    void replace_players(const std::vector<player*>& players);
+
 #ifdef WIZARD_SERVER
 // state update functions
     /**
@@ -140,12 +216,20 @@ public:
      */
     bool add_card(card* played_card, player* current_player, std::string& err);
 
+    /**
+     * @brief Replaces the cards and colors of this trick by the ones of another trick, keeping this trick's id.
+     * @param other The trick whose cards and colors are copied.
+     *
+     * The game state keeps the previous trick this way, instead of creating a new trick object after every trick.
+     */
+    void copy_from(const trick& other);
+
 // server setter
     /**
      * @brief Sets the trick color.
      * @param color The trick color to be set.
      */
-    void set_trick_color(int color) const;
+    void set_trick_color(int color);
 #endif
 
 // serializable interface
@@ -156,12 +240,21 @@ public:
      */
     void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
 
+    /**
+     * @brief Writes the same json as write_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_into_writer(json_writer& writer) const override;
+
     /**
      * @brief Deserializes a trick object from a json object.
      * @param json The json object containing the trick information.
+     * @param players The players of the game. The played cards only hold the ids of their players, which are resolved
+     * against these players instead of creating new player objects.
      * @return A pointer to a new trick object created from the given json object.
+     * @throws WizardException If the json object is not a trick or a card was played by an unknown player.
      */
-    static trick* from_json(const rapidjson::Value& json);
+    static trick* from_json(const rapidjson::Value& json, const std::vector<player*>& players);
 
 };
 
@@ -1,78 +1,35 @@
 #include "game_state.h"
+#include <algorithm>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
 #include "../exceptions/WizardException.h"
 #include "../serialization/vector_utils.h"
 
-// from_diff constructor
-game_state::game_state(const std::string& id) : unique_serializable(id) {
+// deserialization constructor
+game_state::game_state(const entity_id id)
+        : unique_serializable(id), _deck(nullptr), _trick(nullptr), _last_trick(nullptr)
+{ }
+
+// public constructor
+game_state::game_state() : unique_serializable()
+{
     _players = std::vector<player*>();
     _deck = new deck();
     _trick = new trick();
     _last_trick = new trick();
-
-    _is_started = new serializable_value<bool>(false);
-    _is_finished = new serializable_value<bool>(false);
-    _is_estimation_phase = new serializable_value<bool>(true);
-
-    _round_number = new serializable_value<int>(0);
-    _trick_number = new serializable_value<int>(0);
-    _starting_player_idx = new serializable_value<int>(0);
-    _trick_starting_player_idx = new serializable_value<int>(0);
-    _current_player_idx = new serializable_value<int>(0);
-    _trump_color = new serializable_value<int>(0);
-    _trump_card_value = new serializable_value<int>(0);
-    _trick_estimate_sum = new serializable_value<int>(0);
 }
 
-// deserialization constructor
-game_state::game_state(const std::string& id, const std::vector<player*>& players, deck* deck, trick* current_trick,
-                       trick* last_trick, serializable_value<bool>* is_started, serializable_value<bool>* is_finished,
-                       serializable_value<bool>* is_estimation_phase, serializable_value<int>* round_number,
-                       serializable_value<int>* trick_number, serializable_value<int>* starting_player_idx,
-                       serializable_value<int>* trick_starting_player_idx, serializable_value<int>* current_player_idx,
-                       serializable_value<int>* trump_color, serializable_value<int>* trump_card_value, serializable_value<int>* trick_estimate_sum)
-        : unique_serializable(id),
-          _players(players),
-          _deck(deck),
-          _trick(current_trick),
-          _last_trick(last_trick),
-
-          _is_started(is_started),
-          _is_finished(is_finished),
-          _is_estimation_phase(is_estimation_phase),
-
-          _round_number(round_number),
-          _trick_number(trick_number),
-          _starting_player_idx(starting_player_idx),
-          _trick_starting_player_idx(trick_starting_player_idx),
-          _current_player_idx(current_player_idx),
-          _trump_color(trump_color),
-          _trump_card_value(trump_card_value),
-          _trick_estimate_sum(trick_estimate_sum){}
-
-// public constructor
-game_state::game_state() : unique_serializable()
+#ifdef WIZARD_SERVER
+game_state::game_state(const uint64_t seed) : unique_serializable(), _seed(seed), _rng(seed)
 {
     _players = std::vector<player*>();
     _deck = new deck();
     _trick = new trick();
     _last_trick = new trick();
-
-    _is_started = new serializable_value<bool>(false);
-    _is_finished = new serializable_value<bool>(false);
-    _is_estimation_phase = new serializable_value<bool>(true);
-
-    _round_number = new serializable_value<int>(0);
-    _trick_number = new serializable_value<int>(0);
-    _starting_player_idx = new serializable_value<int>(0);
-    _trick_starting_player_idx = new serializable_value<int>(0);
-    _current_player_idx = new serializable_value<int>(0);
-    _trump_color = new serializable_value<int>(0);
-    _trump_card_value = new serializable_value<int>(0);
-    _trick_estimate_sum = new serializable_value<int>(0);
 }
+#endif
 
 // destructor
 game_state::~game_state()
@@ -82,75 +39,90 @@ game_state::~game_state()
     delete _trick;
     delete _last_trick;
 
-    delete _is_started;
-    delete _is_finished;
-    delete _is_estimation_phase;
-
-    delete _round_number;
-    delete _trick_number;
-    delete _starting_player_idx;
-    delete _trick_starting_player_idx;
-    delete _current_player_idx;
-    delete _trump_color;
-    delete _trump_card_value;
-    delete _trick_estimate_sum;
-
     _deck = nullptr;
     _trick = nullptr;
     _last_trick = nullptr;
+}
 
-    _is_started = nullptr;
-    _is_finished = nullptr;
-    _is_estimation_phase = nullptr;
+game_state* game_state::copy() const
+{
+    auto copied_state = std::unique_ptr<game_state>(new game_state(_id));
+    std::vector<player*>& players = copied_state->_players;
+    try {
+        players.reserve(_players.size());
+        for (const player* p : _players) {
+            players.push_back(new player(*p));
+        }
+        copied_state->_deck = new deck(*_deck);
+        // the tricks refer to the copied players
+        copied_state->_trick = new trick(*_trick, players);
+        copied_state->_last_trick = new trick(*_last_trick, players);
+    } catch (...) {
+        // the game state does not own its players (see ~game_state())
+        for (auto & player : players) {
+            delete player;
+        }
+        throw;
+    }
 
-    _round_number = nullptr;
-    _trick_number = nullptr;
-    _starting_player_idx = nullptr;
-    _trick_starting_player_idx = nullptr;
-    _current_player_idx = nullptr;
-    _trump_color = nullptr;
-    _trump_card_value = nullptr;
-    _trick_estimate_sum = nullptr;
+    copied_state->_is_started = _is_started;
+    copied_state->_is_finished = _is_finished;
+    copied_state->_is_estimation_phase = _is_estimation_phase;
+    copied_state->_round_number = _round_number;
+    copied_state->_trick_number = _trick_number;
+    copied_state->_starting_player_idx = _starting_player_idx;
+    copied_state->_trick_starting_player_idx = _trick_starting_player_idx;
+    copied_state->_current_player_idx = _current_player_idx;
+    copied_state->_trump_color = _trump_color;
+    copied_state->_trump_card_value = _trump_card_value;
+    copied_state->_trick_estimate_sum = _trick_estimate_sum;
+    copied_state->_players_dirty = _players_dirty;
+    copied_state->_version = _version;
+#ifdef WIZARD_SERVER
+    copied_state->_seed = _seed;
+    copied_state->_rng = _rng;
+#endif
+    return copied_state.release();
 }
 
 // accessors
 player* game_state::get_current_player() const
 {
-    if(_current_player_idx == nullptr || _players.empty()) {
+    if(_players.empty()) {
         return nullptr;
     }
-    return _players[_current_player_idx->get_value()];
+    return _players[_current_player_idx.get_value()];
 }
 
 bool game_state::is_estimation_phase() const
 {
-    return _is_estimation_phase->get_value();
+    return _is_estimation_phase.get_value();
 }
 
 int game_state::get_trump_color() const
 {
-    return _trump_color->get_value();
+    return _trump_color.get_value();
 }
 
 int game_state::get_trump_card_value() const
 {
-    return _trump_card_value->get_value();
+    return _trump_card_value.get_value();
 }
 
 player* game_state::get_trick_starting_player() const
 {
-    if(_trick_starting_player_idx == nullptr || _players.empty()) {
+    if(_players.empty()) {
         return nullptr;
     }
-    return _players[_trick_starting_player_idx->get_value()];
+    return _players[_trick_starting_player_idx.get_value()];
 }
 
 player* game_state::get_starting_player() const
 {
-    if(_starting_player_idx == nullptr || _players.empty()) {
+    if(_players.empty()) {
         return nullptr;
     }
-    return _players[_starting_player_idx->get_value()];
+    return _players[_starting_player_idx.get_value()];
 }
 
 trick* game_state::get_trick() const
@@ -170,27 +142,27 @@ bool game_state::is_full() const
 
 bool game_state::is_started() const
 {
-    return _is_started->get_value();
+    return _is_started.get_value();
 }
 
 bool game_state::is_finished() const
 {
-    return _is_finished->get_value();
+    return _is_finished.get_value();
 }
 
 int game_state::get_round_number() const
 {
-    return _round_number->get_value();
+    return _round_number.get_value();
 }
 
 int game_state::get_trick_number() const
 {
-    return _trick_number->get_value();
+    return _trick_number.get_value();
 }
 
 int game_state::get_trick_estimate_sum() const
 {
-    return _trick_estimate_sum->get_value();
+    return _trick_estimate_sum.get_value();
 }
 
 unsigned int game_state::get_max_round_number() const
@@ -227,28 +199,25 @@ int game_state::get_player_index(player *player) const
     }
 }
 
-void game_state::determine_trump_color() const
+void game_state::determine_trump_color()
 {
-    if((_round_number->get_value() + 1) * _players.size() == 60) {
-        _trump_color->set_value(0); // there is no trump since it is the last round
-        _trump_card_value->set_value(0);
+    if((_round_number.get_value() + 1) * _players.size() == 60) {
+        _trump_color.set_value(0); // there is no trump since it is the last round
+        _trump_card_value.set_value(0);
     } else {
         card* trump_card = _deck->draw_trump();
         if (trump_card->get_color() != 0){
-            _trump_color->set_value(trump_card->get_color());
-            _trump_card_value->set_value(trump_card->get_value());
+            _trump_color.set_value(trump_card->get_color());
+            _trump_card_value.set_value(trump_card->get_value());
         }
         else if (trump_card->get_value() == 0) {	//jester
-            _trump_color->set_value(0);
-            _trump_card_value->set_value(0);
+            _trump_color.set_value(0);
+            _trump_card_value.set_value(0);
         }
         else if (trump_card->get_value() == 14){	//wizard
             // for now: just randomly generates number
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> distrib(1, 4);
-            _trump_color->set_value(distrib(gen));
-            _trump_card_value->set_value(15);
+            _trump_color.set_value(1 + _rng.next_below(4));
+            _trump_card_value.set_value(15);
         }
     }
 }
@@ -259,37 +228,13 @@ void game_state::determine_trump_color() const
 // it the card has the same color as the trick color, it can be played
 // if the card does not have the same color as the trick color, it can only be played if no other card
 // on the players hand has the same color as the trick color
+// (all of this is decided on the card mask of the hand, see hand::get_playable_mask)
 bool game_state::can_be_played(player* player, const card* card, std::string& err) const noexcept
 {
-    // get trick color -> if 0, card can be played
-    int trick_color = _trick->get_trick_color();
-    int card_value = card->get_value();
-    int card_color = card->get_color();
-
-    // everything can be played if no trick color yet or a wizard has set the trick color
-    if (trick_color == 0 || trick_color == -1) {
-        return true;
-    }
-
-    // check if card is wizard or jester -> if yes, card can be played
-    if (card_value == 0 || card_value == 14) {
-        return true;
-    }
-
-    // compare card color with trick color -> if same, can be played
-    if (card_color == trick_color) {
-        return true;
-    }
-
-    // if card does not have trick color, check other cards on hand
-    auto cards = player->get_hand()->get_cards();
-    for (const auto & c : cards) {
-        if (c->get_color() == trick_color && c->get_value() != card_value) {
-            err = "You can't play this card because you have another card which fits the trick color";
-            return false;
-        }
+    if (!player->get_hand()->can_play(card, _trick->get_trick_color())) {
+        err = "You can't play this card because you have another card which fits the trick color";
+        return false;
     }
-
     return true;
 }
 
@@ -297,60 +242,57 @@ unsigned int game_state::get_number_of_turns() const
 {
     const unsigned int nof_players = this->_players.size();
 
-    if (this->_current_player_idx->get_value() >= this->_starting_player_idx->get_value()) {
-        return (this->_current_player_idx->get_value() - this->_starting_player_idx->get_value() + 1); //in first round 0
+    if (this->_current_player_idx.get_value() >= this->_starting_player_idx.get_value()) {
+        return (this->_current_player_idx.get_value() - this->_starting_player_idx.get_value() + 1); //in first round 0
     }
     else{
-        return (this->_current_player_idx->get_value() - this->_starting_player_idx->get_value() + nof_players) % nof_players + 1;
+        return (this->_current_player_idx.get_value() - this->_starting_player_idx.get_value() + nof_players) % nof_players + 1;
     }
 }
 
 // state modification functions without diff
 void game_state::wrap_up_round(std::string& err)
 {
-    _starting_player_idx->set_value((_starting_player_idx->get_value() + 1) % _players.size());
+    _starting_player_idx.set_value((_starting_player_idx.get_value() + 1) % _players.size());
 
     for (const auto & player : _players) {
       player->wrap_up_round();
     }
-    if (_round_number->get_value() == get_max_round_number() - 1) {
+    if (_round_number.get_value() == get_max_round_number() - 1) {
       finish_game(err);
     }
 }
 
 bool game_state::update_current_player(std::string& err)
 {
-    _current_player_idx->set_value((_current_player_idx->get_value() + 1) % _players.size());
+    _current_player_idx.set_value((_current_player_idx.get_value() + 1) % _players.size());
 
     //if current player is last player of round, switch from estimation to playing or end round and send callback to game_state
-    if (_current_player_idx->get_value() == _trick_starting_player_idx->get_value()) {
-        if (_is_estimation_phase->get_value() == true) {
-            _is_estimation_phase->set_value(false);
+    if (_current_player_idx.get_value() == _trick_starting_player_idx.get_value()) {
+        if (_is_estimation_phase.get_value() == true) {
+            _is_estimation_phase.set_value(false);
         } else {
             //determine trick winner
             player* winner = _trick->wrap_up_trick(err);
             winner->set_nof_tricks(winner->get_nof_tricks() + 1);
 
             // round has not ended yet
-            if (_trick_number->get_value() < _round_number->get_value()){
-                _trick_number->set_value(_trick_number->get_value() + 1);
-                if (_trick != nullptr) {
-                    delete _last_trick;
-                    _last_trick = new trick(*_trick);
-                }
-      	        _trick->set_up_round(_trump_color->get_value(), err);
+            if (_trick_number.get_value() < _round_number.get_value()){
+                _trick_number.set_value(_trick_number.get_value() + 1);
+                _last_trick->copy_from(*_trick);
+      	        _trick->set_up_round(_trump_color.get_value(), err);
 
                 // winner of trick is starting player of next trick
                 if(const int winner_index = get_player_index(winner); winner_index == -1){
                   err = "Player is not part of the game!";
                   return false;
                 } else {
-                  _trick_starting_player_idx->set_value(winner_index);
-                  _current_player_idx->set_value(winner_index);
+                  _trick_starting_player_idx.set_value(winner_index);
+                  _current_player_idx.set_value(winner_index);
                 }
             } else {
               wrap_up_round(err);
-              _round_number->set_value(_round_number->get_value() + 1);
+              _round_number.set_value(_round_number.get_value() + 1);
               setup_round(err);
             }
         }
@@ -362,23 +304,20 @@ bool game_state::update_current_player(std::string& err)
 void game_state::setup_round(std::string &err)
 {
 
-    _trick_estimate_sum->set_value(0);
-    _is_estimation_phase->set_value(true);
-    _trick_number->set_value(0); //tricks numbers start by 0
-    _trick_starting_player_idx->set_value(_starting_player_idx->get_value());
-    _current_player_idx->set_value(_starting_player_idx->get_value());
+    _trick_estimate_sum.set_value(0);
+    _is_estimation_phase.set_value(true);
+    _trick_number.set_value(0); //tricks numbers start by 0
+    _trick_starting_player_idx.set_value(_starting_player_idx.get_value());
+    _current_player_idx.set_value(_starting_player_idx.get_value());
 
-    _deck->setup_round();
+    _deck->setup_round(_rng);
     for (auto & player : _players) {
         player->setup_round();
-        _deck->draw_cards(player, _round_number->get_value() + 1, err);
+        _deck->draw_cards(player, _round_number.get_value() + 1, err);
     }
     determine_trump_color();
-    if (_trick != nullptr) {
-        delete _last_trick;
-        _last_trick = new trick(*_trick);
-    }
-    _trick->set_up_round(_trump_color->get_value(), err);
+    _last_trick->copy_from(*_trick);
+    _trick->set_up_round(_trump_color.get_value(), err);
 }
 
 bool game_state::start_game(std::string &err)
@@ -387,8 +326,8 @@ bool game_state::start_game(std::string &err)
         err = "You need at least " + std::to_string(_min_nof_players) + " players to start the game.";
         return false;
     }
-    if (!_is_started->get_value()) {
-        _is_started->set_value(true);
+    if (!_is_started.get_value()) {
+        _is_started.set_value(true);
         setup_round(err);
         return true;
     } else {
@@ -397,7 +336,7 @@ bool game_state::start_game(std::string &err)
     }
 }
 
-bool game_state::estimate_tricks(const player *player, std::string &err, const int trick_estimate)
+bool game_state::estimate_tricks(player *player, std::string &err, const int trick_estimate)
 {
     if (trick_estimate > get_round_number() + 1) {
         err = "Trick estimate is too big. You can't win more tricks than cards in your hand.";
@@ -408,18 +347,18 @@ bool game_state::estimate_tricks(const player *player, std::string &err, const i
         return false;
     }
     if(get_number_of_turns() == this->_players.size() &&
-       trick_estimate + _trick_estimate_sum->get_value() == _round_number->get_value() + 1) {
+       trick_estimate + _trick_estimate_sum.get_value() == _round_number.get_value() + 1) {
         err = "The tricks can't add up to the exact number of cards in the round. Please either choose a higher or lower number of tricks.";
         return false;
     }
 
     player->set_nof_predicted(trick_estimate);
-    _trick_estimate_sum->set_value(trick_estimate + _trick_estimate_sum->get_value());
+    _trick_estimate_sum.set_value(trick_estimate + _trick_estimate_sum.get_value());
     return update_current_player(err); //handles logic to switch from estimation to playing round etc.
 }
 
 
-bool game_state::play_card(player* player, const std::string& card_id, std::string& err)
+bool game_state::play_card(player* player, const entity_id& card_id, std::string& err)
 {
     card* card = nullptr;
     if (player->get_hand()->try_get_card(card_id, card) == false) { //also gives us card pointer
@@ -440,17 +379,42 @@ bool game_state::play_card(player* player, const std::string& card_id, std::stri
     return true;
 }
 
+bool game_state::play_card(player* player, const std::string& card_id, std::string& err)
+{
+    entity_id id;
+    if (!entity_id::try_parse(card_id, id)) {
+        err = "This card is not in your hand.";
+        return false;
+    }
+    return play_card(player, id, err);
+}
+
+uint64_t game_state::get_seed() const noexcept
+{
+    return _seed;
+}
+
+uint64_t game_state::get_playable_mask() const
+{
+    const player* current = get_current_player();
+    if (current == nullptr || _is_estimation_phase.get_value()) {
+        return 0;
+    }
+    return current->get_hand()->get_playable_mask(_trick->get_trick_color());
+}
+
 bool game_state::remove_player(player *player_ptr, std::string &err)
 {
     if (const int idx = get_player_index(player_ptr); idx != -1) {
         // Case 1: Game has not been started yet.
-        if (_is_started->get_value() == false) {
-            if (idx < _current_player_idx->get_value()) {
+        if (_is_started.get_value() == false) {
+            if (idx < _current_player_idx.get_value()) {
                 // reduce current_player_idx if the player who left had a lower index
-                _current_player_idx->set_value(_current_player_idx->get_value() - 1);
+                _current_player_idx.set_value(_current_player_idx.get_value() - 1);
             }
             player_ptr->set_has_left_game(true);
             _players.erase(_players.begin() + idx);
+            _players_dirty = true;
             return true;
         } else {
             return finish_game(err);
@@ -463,11 +427,11 @@ bool game_state::remove_player(player *player_ptr, std::string &err)
 
 bool game_state::add_player(player* player_, std::string& err)
 {
-    if (_is_started->get_value()) {
+    if (_is_started.get_value()) {
         err = "Could not join game, because the requested game is already started.";
         return false;
     }
-    if (_is_finished->get_value()) {
+    if (_is_finished.get_value()) {
         err = "Could not join game, because the requested game is already finished.";
         return false;
     }
@@ -481,6 +445,7 @@ bool game_state::add_player(player* player_, std::string& err)
     }
 
     _players.push_back(player_);
+    _players_dirty = true;
 
     //checks if all player names are unique. if not, add _1, _2 etc. to the duplicate names
     std::unordered_map<std::string, int> name_counts; // track occurrences of names
@@ -505,23 +470,255 @@ bool game_state::add_player(player* player_, std::string& err)
     return true;
 }
 
-bool game_state::finish_game(std::string &err) const
+bool game_state::finish_game(std::string &err)
 {
-    _is_finished->set_value(true);
+    _is_finished.set_value(true);
     return true;
 }
 #endif
 
+// state diffs
+int game_state::get_version() const
+{
+    return _version;
+}
+
+void game_state::clear_dirty()
+{
+    _players_dirty = false;
+    for (auto & player : _players) {
+        player->clear_dirty();
+    }
+    _trick->clear_dirty();
+    _last_trick->clear_dirty();
+
+    value_fields.clear_dirty(*this);
+
+    _version++;
+}
+
+// how much of the hand of 'p' is serialized for 'viewer', who only sees their own cards in a view
+static player::hand_visibility get_hand_visibility(const player* p, bool is_view, const player* viewer)
+{
+    if (is_view && p != viewer) {
+        return player::hand_visibility::redacted;
+    }
+    return player::hand_visibility::visible;
+}
+
+// serializes the players, as seen by 'viewer' if 'is_view' is set
+static rapidjson::Value serialize_players(const std::vector<player*>& players, bool is_view, const player* viewer,
+                                          rapidjson::Document::AllocatorType& allocator)
+{
+    rapidjson::Value players_val(rapidjson::kArrayType);
+    for (const auto & player : players) {
+        rapidjson::Value player_val(rapidjson::kObjectType);
+        player->write_view_into_json(player_val, allocator, get_hand_visibility(player, is_view, viewer));
+        players_val.PushBack(player_val, allocator);
+    }
+    return players_val;
+}
+
+// writes the players, as seen by 'viewer' if 'is_view' is set
+static void write_players(const std::vector<player*>& players, bool is_view, const player* viewer,
+                          json_writer& writer)
+{
+    writer.StartArray();
+    for (const auto & player : players) {
+        player->write_view_into_writer(writer, get_hand_visibility(player, is_view, viewer));
+    }
+    writer.EndArray();
+}
+
+void game_state::write_diff_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType &allocator) const
+{
+    write_changes_into_json(json, allocator, false, nullptr);
+}
+
+void game_state::write_diff_view_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType &allocator,
+                                           const player* viewer) const
+{
+    write_changes_into_json(json, allocator, true, viewer);
+}
+
+void game_state::write_changes_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType &allocator,
+                                         const bool is_view, const player* viewer) const
+{
+    unique_serializable::write_into_json(json, allocator);
+    json.AddMember("base_version", _version, allocator);
+    json.AddMember("version", _version + 1, allocator);
+
+    if (_players_dirty) {
+        json.AddMember("players", serialize_players(_players, is_view, viewer, allocator), allocator);
+    } else {
+        rapidjson::Value player_diffs(rapidjson::kArrayType);
+        for (const auto & player : _players) {
+            if (player->is_dirty()) {
+                rapidjson::Value player_diff(rapidjson::kObjectType);
+                player->write_diff_into_json(player_diff, allocator, get_hand_visibility(player, is_view, viewer));
+                player_diffs.PushBack(player_diff, allocator);
+            }
+        }
+        if (!player_diffs.Empty()) {
+            json.AddMember("player_diffs", player_diffs, allocator);
+        }
+    }
+
+    if (_trick->is_dirty()) {
+        rapidjson::Value trick_val(rapidjson::kObjectType);
+        _trick->write_diff_into_json(trick_val, allocator);
+        json.AddMember("trick", trick_val, allocator);
+    }
+    if (_last_trick->is_dirty()) {
+        rapidjson::Value last_trick_val(rapidjson::kObjectType);
+        _last_trick->write_diff_into_json(last_trick_val, allocator);
+        json.AddMember("last_trick", last_trick_val, allocator);
+    }
+
+    value_fields.write_dirty_into_json(*this, json, allocator);
+}
+
+void game_state::write_diff_into_writer(json_writer& writer) const
+{
+    write_changes_into_writer(writer, false, nullptr);
+}
+
+void game_state::write_diff_view_into_writer(json_writer& writer, const player* viewer) const
+{
+    write_changes_into_writer(writer, true, viewer);
+}
+
+void game_state::write_changes_into_writer(json_writer& writer, const bool is_view, const player* viewer) const
+{
+    writer.StartObject();
+    write_id_into_writer(writer);
+    writer.Key("base_version");
+    writer.Int(_version);
+    writer.Key("version");
+    writer.Int(_version + 1);
+
+    if (_players_dirty) {
+        writer.Key("players");
+        write_players(_players, is_view, viewer, writer);
+    } else if (std::ranges::any_of(_players, [](const player* p) { return p->is_dirty(); })) {
+        writer.Key("player_diffs");
+        writer.StartArray();
+        for (const auto & player : _players) {
+            if (player->is_dirty()) {
+                player->write_diff_into_writer(writer, get_hand_visibility(player, is_view, viewer));
+            }
+        }
+        writer.EndArray();
+    }
+
+    if (_trick->is_dirty()) {
+        writer.Key("trick");
+        _trick->write_diff_into_writer(writer);
+    }
+    if (_last_trick->is_dirty()) {
+        writer.Key("last_trick");
+        _last_trick->write_diff_into_writer(writer);
+    }
+
+    value_fields.write_dirty_into_writer(*this, writer);
+    writer.EndObject();
+}
+
+// reads the players of a game state
+static std::vector<player*> players_from_json(const rapidjson::Value& json)
+{
+    const auto serialized_players = schema::get_array(json, "players");
+    std::vector<player*> players;
+    players.reserve(serialized_players.Size());
+    try {
+        for (auto &serialized_player : serialized_players) {
+            players.push_back(player::from_json(serialized_player));
+        }
+    } catch (...) {
+        for (auto & player : players) {
+            delete player;
+        }
+        throw;
+    }
+    return players;
+}
+
+void game_state::apply_diff(const rapidjson::Value &json)
+{
+    auto reader = value_fields.reader(*this);
+    const rapidjson::Value* player_diffs = nullptr;
+    const rapidjson::Value* trick_diff = nullptr;
+    const rapidjson::Value* last_trick_diff = nullptr;
+    for (const auto& member : schema::get_object(json, "game_state")) {
+        if (reader.read(member)) {
+            continue;
+        }
+        const std::string_view name = schema::name_of(member);
+        if (name == "players") {
+            std::vector<player*> new_players = players_from_json(member.value);
+            // the tricks refer to the players, so they are moved to the new players before the old ones are deleted
+            _trick->replace_players(new_players);
+            _last_trick->replace_players(new_players);
+            for (auto & player : _players) {
+                delete player;
+            }
+            _players = new_players;
+        } else if (name == "player_diffs") {
+            player_diffs = &member.value;
+        } else if (name == "trick") {
+            trick_diff = &member.value;
+        } else if (name == "last_trick") {
+            last_trick_diff = &member.value;
+        } else if (name == "version") {
+            _version = schema::get<int>(member.value, "version");
+        }
+    }
+
+    // the diffs of the players and tricks refer to the players, which may have been replaced above
+    if (player_diffs) {
+        for (auto &player_diff : schema::get_array(*player_diffs, "player_diffs")) {
+            const entity_id player_id = entity_id::from_string(
+                    schema::get<const char*>(schema::get_member(player_diff, "id"), "id"));
+            for (auto & player : _players) {
+                if (player->get_entity_id() == player_id) {
+                    player->apply_diff(player_diff);
+                }
+            }
+        }
+    }
+    if (trick_diff) {
+        _trick->apply_diff(*trick_diff, _players);
+    }
+    if (last_trick_diff) {
+        _last_trick->apply_diff(*last_trick_diff, _players);
+    }
+}
+
 // serializable interface
 void game_state::write_into_json(rapidjson::Value &json,
                                  rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> &allocator) const {
+    write_state_into_json(json, allocator, false, nullptr);
+}
+
+void game_state::write_view_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType &allocator,
+                                      const player* viewer) const {
+    write_state_into_json(json, allocator, true, viewer);
+}
+
+void game_state::write_state_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType &allocator,
+                                       const bool is_view, const player* viewer) const {
     unique_serializable::write_into_json(json, allocator);
 
-    json.AddMember("players", vector_utils::serialize_vector(_players, allocator), allocator);
+    json.AddMember("version", _version, allocator);
 
-    rapidjson::Value deck_val(rapidjson::kObjectType);
-    _deck->write_into_json(deck_val, allocator);
-    json.AddMember("deck", deck_val, allocator);
+    json.AddMember("players", serialize_players(_players, is_view, viewer, allocator), allocator);
+
+    // the deck is only needed by the server
+    if (!is_view) {
+        rapidjson::Value deck_val(rapidjson::kObjectType);
+        _deck->write_into_json(deck_val, allocator);
+        json.AddMember("deck", deck_val, allocator);
+    }
 
     rapidjson::Value trick_val(rapidjson::kObjectType);
     _trick->write_into_json(trick_val, allocator);
@@ -531,98 +728,90 @@ void game_state::write_into_json(rapidjson::Value &json,
     _last_trick->write_into_json(last_trick_val, allocator);
     json.AddMember("last_trick", last_trick_val, allocator);
 
+    value_fields.write_into_json(*this, json, allocator);
+}
 
+void game_state::write_into_writer(json_writer& writer) const {
+    write_state_into_writer(writer, false, nullptr);
+}
 
-    rapidjson::Value is_finished_val(rapidjson::kObjectType);
-    _is_finished->write_into_json(is_finished_val, allocator);
-    json.AddMember("is_finished", is_finished_val, allocator);
-
-    rapidjson::Value is_started_val(rapidjson::kObjectType);
-    _is_started->write_into_json(is_started_val, allocator);
-    json.AddMember("is_started", is_started_val, allocator);
-
-    rapidjson::Value is_estimation_phase_val(rapidjson::kObjectType);
-    _is_estimation_phase->write_into_json(is_estimation_phase_val, allocator);
-    json.AddMember("is_estimation_phase", is_estimation_phase_val, allocator);
-
-
-
-    rapidjson::Value round_number_val(rapidjson::kObjectType);
-    _round_number->write_into_json(round_number_val, allocator);
-    json.AddMember("round_number", round_number_val, allocator);
-
-    rapidjson::Value trick_number_val(rapidjson::kObjectType);
-    _trick_number->write_into_json(trick_number_val, allocator);
-    json.AddMember("trick_number", trick_number_val, allocator);
+void game_state::write_view_into_writer(json_writer& writer, const player* viewer) const {
+    write_state_into_writer(writer, true, viewer);
+}
 
-    rapidjson::Value starting_player_idx_val(rapidjson::kObjectType);
-    _starting_player_idx->write_into_json(starting_player_idx_val, allocator);
-    json.AddMember("starting_player_idx", starting_player_idx_val, allocator);
+void game_state::write_state_into_writer(json_writer& writer, const bool is_view, const player* viewer) const {
+    writer.StartObject();
+    write_id_into_writer(writer);
 
-    rapidjson::Value trick_starting_player_idx_val(rapidjson::kObjectType);
-    _trick_starting_player_idx->write_into_json(trick_starting_player_idx_val, allocator);
-    json.AddMember("trick_starting_player_idx", trick_starting_player_idx_val, allocator);
+    writer.Key("version");
+    writer.Int(_version);
 
-    rapidjson::Value current_player_idx_val(rapidjson::kObjectType);
-    _current_player_idx->write_into_json(current_player_idx_val, allocator);
-    json.AddMember("current_player_idx", current_player_idx_val, allocator);
+    writer.Key("players");
+    write_players(_players, is_view, viewer, writer);
 
-    rapidjson::Value trump_color_val(rapidjson::kObjectType);
-    _trump_color->write_into_json(trump_color_val, allocator);
-    json.AddMember("trump_color", trump_color_val, allocator);
+    // the deck is only needed by the server
+    if (!is_view) {
+        writer.Key("deck");
+        _deck->write_into_writer(writer);
+    }
 
-    rapidjson::Value trump_card_value_val(rapidjson::kObjectType);
-    _trump_card_value->write_into_json(trump_card_value_val, allocator);
-    json.AddMember("trump_card_value", trump_card_value_val, allocator);
+    writer.Key("trick");
+    _trick->write_into_writer(writer);
 
-    rapidjson::Value trick_estimate_sum_val(rapidjson::kObjectType);
-    _trick_estimate_sum->write_into_json(trick_estimate_sum_val, allocator);
-    json.AddMember("trick_estimate_sum", trick_estimate_sum_val, allocator);
+    writer.Key("last_trick");
+    _last_trick->write_into_writer(writer);
 
+    value_fields.write_into_writer(*this, writer);
+    writer.EndObject();
 }
 
 game_state* game_state::from_json(const rapidjson::Value &json) {
-    if (json.HasMember("id")
-        && json.HasMember("players")
-        && json.HasMember("deck")
-        && json.HasMember("trick")
-        && json.HasMember("last_trick")
-
-        && json.HasMember("is_finished")
-        && json.HasMember("is_started")
-        && json.HasMember("is_estimation_phase")
-
-        && json.HasMember("round_number")
-        && json.HasMember("trick_number")
-        && json.HasMember("starting_player_idx")
-        && json.HasMember("trick_starting_player_idx")
-        && json.HasMember("current_player_idx")
-        && json.HasMember("trump_color")
-        && json.HasMember("trump_card_value")
-        && json.HasMember("trick_estimate_sum"))
-    {
-        std::vector<player*> deserialized_players;
-        for (auto &serialized_player : json["players"].GetArray()) {
-            deserialized_players.push_back(player::from_json(serialized_player.GetObject()));
+    auto deserialized_state = std::unique_ptr<game_state>(new game_state(entity_id()));
+    std::vector<player*>& players = deserialized_state->_players;
+    try {
+        auto reader = value_fields.reader(*deserialized_state);
+        bool has_id = false;
+        bool has_players = false;
+        const rapidjson::Value* deck_json = nullptr;
+        const rapidjson::Value* trick_json = nullptr;
+        const rapidjson::Value* last_trick_json = nullptr;
+        for (const auto& member : schema::get_object(json, "game_state")) {
+            if (reader.read(member)) {
+                continue;
+            }
+            const std::string_view name = schema::name_of(member);
+            if (name == "id") {
+                deserialized_state->_id = entity_id::from_string(schema::get<const char*>(member.value, "id"));
+                has_id = true;
+            } else if (name == "version") {
+                // the version is optional, states without a version are treated as the initial version
+                deserialized_state->_version = schema::get<int>(member.value, "version");
+            } else if (name == "players" && !has_players) {
+                players = players_from_json(member.value);
+                has_players = true;
+            } else if (name == "deck") {
+                deck_json = &member.value;
+            } else if (name == "trick") {
+                trick_json = &member.value;
+            } else if (name == "last_trick") {
+                last_trick_json = &member.value;
+            }
+        }
+        if (!has_id || !has_players || !trick_json || !last_trick_json || !reader.has_read_all()) {
+            throw WizardException("Failed to deserialize game_state. Required entries were missing.");
         }
-        return new game_state(json["id"].GetString(),
-                              deserialized_players,
-                              deck::from_json(json["deck"].GetObject()),
-                              trick::from_json(json["trick"].GetObject()),
-                              trick::from_json(json["last_trick"].GetObject()),
-
-                              serializable_value<bool>::from_json(json["is_started"].GetObject()),
-                              serializable_value<bool>::from_json(json["is_finished"].GetObject()),
-                              serializable_value<bool>::from_json((json["is_estimation_phase"].GetObject())),
-
-                              serializable_value<int>::from_json(json["round_number"].GetObject()),
-                              serializable_value<int>::from_json(json["trick_number"].GetObject()),
-                              serializable_value<int>::from_json(json["starting_player_idx"].GetObject()),
-                              serializable_value<int>::from_json(json["trick_starting_player_idx"].GetObject()),
-                              serializable_value<int>::from_json(json["current_player_idx"].GetObject()),
-                              serializable_value<int>::from_json(json["trump_color"].GetObject()),
-                              serializable_value<int>::from_json(json["trump_card_value"].GetObject()),
-                              serializable_value<int>::from_json(json["trick_estimate_sum"].GetObject()));
-    }
-    throw WizardException("Failed to deserialize game_state. Required entries were missing.");
-}
\ No newline at end of file
+
+        // views of the game state sent to the clients do not contain the deck
+        deserialized_state->_deck = deck_json ? deck::from_json(*deck_json) : new deck(std::vector<card*>());
+        // the played cards of the tricks refer to the players, so the tricks are read once all players are known
+        deserialized_state->_trick = trick::from_json(*trick_json, players);
+        deserialized_state->_last_trick = trick::from_json(*last_trick_json, players);
+    } catch (...) {
+        // the game state does not own its players (see ~game_state())
+        for (auto & player : players) {
+            delete player;
+        }
+        throw;
+    }
+    return deserialized_state.release();
+}
@@ -8,8 +8,10 @@
 #include "cards/deck.h"
 #include "cards/card.h"
 #include "cards/trick.h"
+#include "random_generator.h"
 #include "../serialization/serializable_value.h"
 #include "../serialization/unique_serializable.h"
+#include "../serialization/schema.h"
 
 /**
  * @class game_state
@@ -35,66 +37,87 @@ private:
     trick* _trick;                                          ///< The current trick of the game.
     trick* _last_trick;                                     ///< The previous trick.
 
-    serializable_value<bool>* _is_started;                  ///< A boolean indicating whether the game is started.
-    serializable_value<bool>* _is_finished;                 ///< A boolean indicating whether the game is finished.
-    serializable_value<bool>* _is_estimation_phase;         ///< A boolean indicating whether the game is in estimation phase.
+    serializable_value<bool> _is_started = false;           ///< A boolean indicating whether the game is started.
+    serializable_value<bool> _is_finished = false;          ///< A boolean indicating whether the game is finished.
+    serializable_value<bool> _is_estimation_phase = true;   ///< A boolean indicating whether the game is in estimation phase.
     //TODO: add boolean _determine_trump_color that can be used to tell player to decide on a trump color
 
-    serializable_value<int>* _round_number;                 ///< The current round number.
-    serializable_value<int>* _trick_number;                 ///< The current trick number.
-    serializable_value<int>* _starting_player_idx;          ///< The index of the player that started the current round.
-    serializable_value<int>* _trick_starting_player_idx;    ///< The index of the player that started the current trick.
-    serializable_value<int>* _current_player_idx;           ///< The index of the player that is currently playing.
-    serializable_value<int>* _trump_color;                  ///< The trump color of the current round.
-    serializable_value<int>* _trump_card_value;             ///< Value of the trump card to show in GUI.
-    serializable_value<int>* _trick_estimate_sum;           ///< The sum of trick estimates.
+    serializable_value<int> _round_number = 0;              ///< The current round number.
+    serializable_value<int> _trick_number = 0;              ///< The current trick number.
+    serializable_value<int> _starting_player_idx = 0;       ///< The index of the player that started the current round.
+    serializable_value<int> _trick_starting_player_idx = 0; ///< The index of the player that started the current trick.
+    serializable_value<int> _current_player_idx = 0;        ///< The index of the player that is currently playing.
+    serializable_value<int> _trump_color = 0;               ///< The trump color of the current round.
+    serializable_value<int> _trump_card_value = 0;          ///< Value of the trump card to show in GUI.
+    serializable_value<int> _trick_estimate_sum = 0;        ///< The sum of trick estimates.
+
+    bool _players_dirty = true;                             ///< Whether players joined or left since the last state diff.
+    int _version = 0;                                       ///< The number of state diffs created for this game state.
+
+    /// The scalar members of the game state, from which their serialization is generated (see schema.h).
+    static constexpr schema::fields value_fields {
+            schema::value_field {"is_finished", &game_state::_is_finished},
+            schema::value_field {"is_started", &game_state::_is_started},
+            schema::value_field {"is_estimation_phase", &game_state::_is_estimation_phase},
+            schema::value_field {"round_number", &game_state::_round_number},
+            schema::value_field {"trick_number", &game_state::_trick_number},
+            schema::value_field {"starting_player_idx", &game_state::_starting_player_idx},
+            schema::value_field {"trick_starting_player_idx", &game_state::_trick_starting_player_idx},
+            schema::value_field {"current_player_idx", &game_state::_current_player_idx},
+            schema::value_field {"trump_color", &game_state::_trump_color},
+            schema::value_field {"trump_card_value", &game_state::_trump_card_value},
+            schema::value_field {"trick_estimate_sum", &game_state::_trick_estimate_sum}};
 
-// constructors
+#ifdef WIZARD_SERVER
+    uint64_t _seed = random_generator::random_seed();       ///< The seed of the game's random numbers (never sent to clients).
+    random_generator _rng {_seed};                          ///< The game's random numbers (shuffling the deck, trump color).
+#endif
+
+// serialization helpers
     /**
-     * @brief Constructs a new game_state object (from_diff).
-     * @param id The game state's id.
+     * @brief Serializes the game state into a json object (see write_into_json() and write_view_into_json()).
+     * @param json The json object for serializing the game_state.
+     * @param allocator The json allocator for serializing the game_state.
+     * @param is_view Whether the deck is left out and the hands of all players except the viewer are redacted.
+     * @param viewer The player whose hand is not redacted in a view (may be nullptr).
+     */
+    void write_state_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                               bool is_view, const player* viewer) const;
+
+    /**
+     * @brief Serializes the changes of the game state into a json object (see write_diff_into_json() and
+     * write_diff_view_into_json()).
+     * @param json The json object for serializing the diff.
+     * @param allocator The json allocator for serializing the diff.
+     * @param is_view Whether the hands of all players except the viewer are redacted.
+     * @param viewer The player whose hand is not redacted in a view (may be nullptr).
      */
-    explicit game_state(const std::string& id);
+    void write_changes_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                                 bool is_view, const player* viewer) const;
 
     /**
-     * @brief Constructs a new game_state object during deserialization.
+     * @brief Writes the same json as write_state_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     * @param is_view Whether the deck is left out and the hands of all players except the viewer are redacted.
+     * @param viewer The player whose hand is not redacted in a view (may be nullptr).
+     */
+    void write_state_into_writer(json_writer& writer, bool is_view, const player* viewer) const;
+
+    /**
+     * @brief Writes the same json as write_changes_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     * @param is_view Whether the hands of all players except the viewer are redacted.
+     * @param viewer The player whose hand is not redacted in a view (may be nullptr).
+     */
+    void write_changes_into_writer(json_writer& writer, bool is_view, const player* viewer) const;
+
+// constructors
+    /**
+     * @brief Constructs a new game_state object without deck and tricks during deserialization, whose members are
+     * then read from json (see from_json()).
      * @param id The game state's id.
-     * @param players The game state's players.
-     * @param deck The game state's deck.
-     * @param current_trick The game state's current trick.
-     * @param last_trick The game state's previous trick.
-     * @param is_started A boolean indicating whether the game is started.
-     * @param is_finished A boolean indicating whether the game is finished.
-     * @param is_estimation_phase A boolean indicating whether the game is in estimation phase.
-     * @param round_number The round number.
-     * @param trick_number The trick number.
-     * @param starting_player_idx The round starting player's index.
-     * @param trick_starting_player_idx The trick starting player's index.
-     * @param current_player_idx The current player's index.
-     * @param trump_color The trump color.
-     * @param trump_card_value The value of the trump card to show in GUI.
-     * @param trick_estimate_sum The sum of trick estimates.
-     */
-    game_state(
-            const std::string& id,
-            const std::vector<player*>& players,
-            deck* deck,
-            trick* current_trick,
-            trick* last_trick,
-
-            serializable_value<bool>* is_started,
-            serializable_value<bool>* is_finished,
-            serializable_value<bool>* is_estimation_phase,
-
-            serializable_value<int>* round_number,
-            serializable_value<int>* trick_number,
-            serializable_value<int>* starting_player_idx,
-            serializable_value<int>* trick_starting_player_idx,
-            serializable_value<int>* current_player_idx,
-            serializable_value<int>* trump_color,
-            serializable_value<int>* trump_card_value,
-            serializable_value<int>* trick_estimate_sum
-            );
+     */
+    explicit game_state(entity_id id);
 
 #ifdef WIZARD_SERVER
 // private functions (only used by game_state member functions)
@@ -122,9 +145,10 @@ private:
      * This function determines the trump color of a round by calling the draw_trump function from deck after the cards
      * have been dealt. If the drawn card is a jester, the trump color is set to no color (0) for this round. If the
      * drawn card is a wizard, in the real game the starting player can choose a trump color. This is not implemented
-     * yet in our game, in this case we randomly select one of the four colors so far.
+     * yet in our game, in this case we randomly select one of the four colors so far (drawn from the game's random
+     * numbers).
      */
-    void determine_trump_color() const;
+    void determine_trump_color();
 
     /**
      * @brief Checks if a given card can be played by a given player.
@@ -151,11 +175,28 @@ public:
      */
     game_state();
 
+#ifdef WIZARD_SERVER
+    /**
+     * @brief Constructs a new game_state object whose random numbers are drawn from the given seed.
+     * @param seed The seed of the game's random numbers.
+     *
+     * Two games with the same seed and the same moves of the players deal the same cards and trump colors, so a game
+     * can be replayed exactly from its seed (see get_seed()).
+     */
+    explicit game_state(uint64_t seed);
+#endif
+
     /**
      * Destructs a trick object.
      */
     ~game_state() override;
 
+    /**
+     * @brief Creates a deep copy of the game state, including copies of its players.
+     * @return The copy. Like the game states created by from_json(), it does not own its players (see ~game_state()).
+     */
+    [[nodiscard]] game_state* copy() const;
+
 // accessors
     /**
      * @brief Checks if the game is full.
@@ -310,7 +351,7 @@ public:
      *
      * This function finishes the game by setting _is_finished to true.
      */
-    bool finish_game(std::string& err) const;
+    bool finish_game(std::string& err);
 
     /**
      * @brief Sets up a round.
@@ -345,7 +386,7 @@ public:
      * is not equal to the round number. If all of these checks pass, the players trick estimate is updated. Afterward,
      * the game proceeds by calling update_current_player (see below).
      */
-    bool estimate_tricks(const player *player, std::string &err, int trick_estimate);
+    bool estimate_tricks(player *player, std::string &err, int trick_estimate);
 
     /**
      * @brief Plays a card.
@@ -358,8 +399,30 @@ public:
      * be played (see can_be_played method of game_state), the card is added to the trick and removed from the player's
      * hand. Afterward, the game proceeds by calling update_current_player (see below).
      */
+    bool play_card(player* player, const entity_id& card_id, std::string& err);
+
+    /**
+     * @brief Plays a card, given the text of its id (see play_card() above).
+     * @param player The player that plays the card.
+     * @param card_id The text of the id of the card that is played.
+     * @param err The error message updated in case something does not work.
+     * @return A boolean indicating whether the card could be played or not.
+     */
     bool play_card(player* player, const std::string& card_id, std::string& err);
 
+    /**
+     * @brief Gets the seed of the game's random numbers.
+     * @return The seed the game was created with.
+     */
+    [[nodiscard]] uint64_t get_seed() const noexcept;
+
+    /**
+     * @brief Gets the cards the current player may play.
+     * @return The card mask (see card_mask.h) of the cards in the current player's hand that may be played in the
+     * current trick. Empty during the estimation phase.
+     */
+    [[nodiscard]] uint64_t get_playable_mask() const;
+
     /**
      * @brief Updates the current player after estimating tricks or playing cards.
      * @param err The error message updated in case something does not work.
@@ -374,6 +437,68 @@ public:
     bool update_current_player(std::string& err);
 #endif
 
+// state diffs
+    /**
+     * @brief Gets the version of the game state.
+     * @return The number of state diffs that were created for this game state.
+     *
+     * Clients use the version to check that a state diff applies to the game state they hold.
+     */
+    [[nodiscard]] int get_version() const;
+
+    /**
+     * @brief Marks all changes as sent to the clients and advances the version of the game state.
+     *
+     * This function is called after the diff created by write_diff_into_json() was broadcast to the players.
+     */
+    void clear_dirty();
+
+    /**
+     * @brief Serializes all changes since the last call to clear_dirty() into a json object.
+     * @param json The json object for serializing the diff.
+     * @param allocator The json allocator for serializing the diff.
+     *
+     * The diff contains the game state's id, the version it applies to ('base_version') and the version after applying
+     * it ('version'). Of all other entries, only the ones that changed are contained: if players joined or left the
+     * game, all players are sent, otherwise only the changes of the players that changed are sent as 'player_diffs'.
+     * The trick and the previous trick are sent as trick diffs. The deck is never part of a diff, since clients do not
+     * use it.
+     */
+    void write_diff_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const;
+
+    /**
+     * @brief Serializes all changes since the last call to clear_dirty() into a json object, as seen by a player.
+     * @param json The json object for serializing the diff.
+     * @param allocator The json allocator for serializing the diff.
+     * @param viewer The player the diff is sent to, or nullptr to redact the hands of all players.
+     *
+     * Same as write_diff_into_json(), except that the hands of all players other than the viewer are redacted, i.e.
+     * only their number of cards is sent.
+     */
+    void write_diff_view_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                                   const player* viewer) const;
+
+    /**
+     * @brief Writes the same json as write_diff_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_diff_into_writer(json_writer& writer) const;
+
+    /**
+     * @brief Writes the same json as write_diff_view_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     * @param viewer The player the diff is sent to, or nullptr to redact the hands of all players.
+     */
+    void write_diff_view_into_writer(json_writer& writer, const player* viewer) const;
+
+    /**
+     * @brief Applies a diff created by write_diff_into_json() to this game state.
+     * @param json The json object containing the diff.
+     *
+     * The caller has to make sure that the diff's 'base_version' matches the version of this game state.
+     */
+    void apply_diff(const rapidjson::Value& json);
+
 // serializable interface
     /**
      * @brief Serializes a game_state object into a json object.
@@ -382,10 +507,37 @@ public:
      */
     void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
 
+    /**
+     * @brief Serializes a game_state object into a json object, as seen by a player.
+     * @param json The json object for serializing the game_state.
+     * @param allocator The json allocator for serializing the game_state.
+     * @param viewer The player the game state is sent to, or nullptr to redact the hands of all players.
+     *
+     * The view does not contain the deck, and the hands of all players other than the viewer are redacted, i.e. only
+     * their number of cards is sent. This way, clients cannot find out about cards they must not know.
+     */
+    void write_view_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                              const player* viewer) const;
+
+    /**
+     * @brief Writes the same json as write_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_into_writer(json_writer& writer) const override;
+
+    /**
+     * @brief Writes the same json as write_view_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     * @param viewer The player the game state is sent to, or nullptr to redact the hands of all players.
+     */
+    void write_view_into_writer(json_writer& writer, const player* viewer) const;
+
     /**
      * @brief Deserializes a game_state object from a json object.
      * @param json The json object containing the game_state information.
      * @return A pointer to a new game_state object created from the given json object.
+     *
+     * Views created by write_view_into_json() can be deserialized as well, the game state then gets an empty deck.
      */
     static game_state* from_json(const rapidjson::Value& json);
 
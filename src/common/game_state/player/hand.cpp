@@ -1,7 +1,8 @@
 #include "hand.h"
+#include <algorithm>
 #include <ranges>
 #include "../../exceptions/WizardException.h"
-#include "../../serialization/vector_utils.h"
+#include "../../serialization/schema.h"
 
 // constructor
 hand::hand() : unique_serializable() { }
@@ -9,91 +10,209 @@ hand::hand() : unique_serializable() { }
 // from_diff constructor
 hand::hand(const std::string& id) : unique_serializable(id) { }
 
+// deserialization constructor for redacted hands
+hand::hand(const std::string& id, const unsigned int nof_hidden_cards) :
+        unique_serializable(id),
+        _is_redacted(true),
+        _nof_hidden_cards(nof_hidden_cards)
+{ }
+
 // deserialization constructor
 hand::hand(const std::string& id, const std::vector<card*>& cards) : unique_serializable(id) {
-    this->_cards = cards;
+    if (cards.size() > max_nof_cards) {
+        throw WizardException("Could not create hand, as it holds more than " + std::to_string(max_nof_cards)
+                              + " cards.");
+    }
+    std::ranges::copy(cards, _cards.begin());
+    _nof_cards = cards.size();
+    for (const card* c : cards) {
+        _mask = card_mask::add(_mask, c->get_value(), c->get_color());
+    }
 }
 
-// destructor
-hand::~hand() {
-    _cards.clear();
-}
+// destructor (the cards are owned by the deck)
+hand::~hand() = default;
 
 // accessors
 unsigned int hand::get_nof_cards() const {
-    return _cards.size();
+    return _nof_cards + _nof_hidden_cards;
 }
 
 std::vector<card*> hand::get_cards() const {
-    return _cards;
+    return {_cards.begin(), _cards.begin() + _nof_cards};
+}
+
+std::span<card* const> hand::get_card_span() const {
+    return {_cards.data(), _nof_cards};
+}
+
+uint64_t hand::get_mask() const {
+    return _mask;
+}
+
+bool hand::has_color(const int color) const {
+    return (_mask & card_mask::of_color(color)) != 0;
+}
+
+uint64_t hand::get_playable_mask(const int trick_color) const {
+    return card_mask::playable(_mask, trick_color);
+}
+
+bool hand::can_play(const card* card, const int trick_color) const {
+    return (get_playable_mask(trick_color) & card_mask::of_kind(card->get_value(), card->get_color())) != 0;
 }
 
 // this function searches for a given card in the hand, and returns whether the card was found or not;
 // if the card was found, the variable hand_card (given as reference) is updated
-bool hand::try_get_card(const std::string &card_id, card *&hand_card) const {
-    const auto it = std::ranges::find_if(_cards,
-                                         [&card_id](const card* x) { return x->get_id() == card_id;});
-    if (it < _cards.end()) {
-        hand_card = *it;
-        return true;
+bool hand::try_get_card(const entity_id& card_id, card *&hand_card) const {
+    for (card* c : get_card_span()) {
+        if (c->get_entity_id() == card_id) {
+            hand_card = c;
+            return true;
+        }
     }
     return false;
 }
 
+bool hand::try_get_card(const std::string &card_id, card *&hand_card) const {
+    entity_id id;
+    return entity_id::try_parse(card_id, id) && try_get_card(id, hand_card);
+}
+
 // remove card functions
 card* hand::remove_card(const int idx) {
-    return remove_card(_cards.begin() + idx);
+    if (idx < 0 || idx >= static_cast<int>(_nof_cards)) {
+        return nullptr;
+    }
+    card* res = _cards[idx];
+    _mask = card_mask::remove(_mask, res->get_value(), res->get_color());
+    // the remaining cards keep their order
+    std::copy(_cards.begin() + idx + 1, _cards.begin() + _nof_cards, _cards.begin() + idx);
+    _nof_cards--;
+    _dirty = true;
+    return res;
 }
 
 card* hand::remove_card(card* card) {
-    const auto pos = std::ranges::find(_cards, card);
-    return remove_card(pos);
+    const auto cards = get_card_span();
+    return remove_card(static_cast<int>(std::ranges::find(cards, card) - cards.begin()));
 }
 
-card* hand::remove_card(const std::vector<card*>::iterator pos) {
-    if (pos >= _cards.begin() && pos < _cards.end()) {
-        card* res = *pos;
-        _cards.erase(pos);
-        return res;
+bool hand::remove_card(const entity_id& card_id, std::string &err) {
+    const auto cards = get_card_span();
+    const auto it = std::ranges::find_if(cards, [&card_id](const card* x) { return x->get_entity_id() == card_id;});
+    if (it < cards.end()) {
+        remove_card(static_cast<int>(it - cards.begin()));
+        return true;
+    } else {
+        err = "Could not play card, as the requested card was not on the player's hand.";
+        return false;
     }
-    return nullptr;
 }
 
-bool hand::remove_card(std::string card_id, std::string &err) {
-    const auto it = std::ranges::find_if(_cards,
-                                         [&card_id](const card* x) { return x->get_id() == card_id;});
-    if (it < _cards.end()) {
-        remove_card(it);
-        return true;
-    } else {
+bool hand::remove_card(const std::string& card_id, std::string &err) {
+    entity_id id;
+    if (!entity_id::try_parse(card_id, id)) {
         err = "Could not play card, as the requested card was not on the player's hand.";
         return false;
     }
+    return remove_card(id, err);
+}
+
+// dirty tracking for state diffs
+bool hand::is_dirty() const {
+    return _dirty;
+}
+
+void hand::clear_dirty() {
+    _dirty = false;
 }
 
 #ifdef WIZARD_SERVER
 // state update functions
 bool hand::add_card(card* card, std::string &err) {
-    _cards.push_back(card);
+    if (_nof_cards == max_nof_cards) {
+        err = "Could not add card, as the hand already holds " + std::to_string(max_nof_cards) + " cards.";
+        return false;
+    }
+    _cards[_nof_cards++] = card;
+    _mask = card_mask::add(_mask, card->get_value(), card->get_color());
+    _dirty = true;
     return true;
 }
 #endif
 
 // serialization interface
 void hand::write_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType& allocator) const {
+    if (_is_redacted) {
+        // the cards of this hand are not known, so it can only be passed on redacted
+        write_redacted_into_json(json, allocator);
+        return;
+    }
     unique_serializable::write_into_json(json, allocator);
-    json.AddMember("cards", vector_utils::serialize_vector(_cards, allocator), allocator);
+    rapidjson::Value cards(rapidjson::kArrayType);
+    for (const card* c : get_card_span()) {
+        rapidjson::Value card_val(rapidjson::kObjectType);
+        c->write_into_json(card_val, allocator);
+        cards.PushBack(card_val, allocator);
+    }
+    json.AddMember("cards", cards, allocator);
+}
+
+void hand::write_redacted_into_json(rapidjson::Value &json, rapidjson::Document::AllocatorType& allocator) const {
+    unique_serializable::write_into_json(json, allocator);
+    json.AddMember("nof_cards", get_nof_cards(), allocator);
+}
+
+void hand::write_into_writer(json_writer& writer) const {
+    if (_is_redacted) {
+        write_redacted_into_writer(writer);
+        return;
+    }
+    writer.StartObject();
+    write_id_into_writer(writer);
+    writer.Key("cards");
+    writer.StartArray();
+    for (const card* c : get_card_span()) {
+        c->write_into_writer(writer);
+    }
+    writer.EndArray();
+    writer.EndObject();
+}
+
+void hand::write_redacted_into_writer(json_writer& writer) const {
+    writer.StartObject();
+    write_id_into_writer(writer);
+    writer.Key("nof_cards");
+    writer.Uint(get_nof_cards());
+    writer.EndObject();
 }
 
 hand* hand::from_json(const rapidjson::Value &json) {
-    if (json.HasMember("id") &&
-        json.HasMember("cards"))
-    {
-        std::vector<card*> deserialized_cards = std::vector<card*>();
-        for (auto &serialized_card : json["cards"].GetArray()) {
-            deserialized_cards.push_back(card::from_json(serialized_card.GetObject()));
+    const rapidjson::Value* id = nullptr;
+    const rapidjson::Value* cards = nullptr;
+    const rapidjson::Value* nof_cards = nullptr;
+    for (const auto& member : schema::get_object(json, "hand")) {
+        const std::string_view name = schema::name_of(member);
+        if (name == "id") {
+            id = &member.value;
+        } else if (name == "cards") {
+            cards = &member.value;
+        } else if (name == "nof_cards") {
+            nof_cards = &member.value;
         }
-        return new hand(json["id"].GetString(), deserialized_cards);
+    }
+    if (id && cards) {
+        const auto serialized_cards = schema::get_array(*cards, "cards");
+        std::vector<card*> deserialized_cards;
+        deserialized_cards.reserve(serialized_cards.Size());
+        for (auto &serialized_card : serialized_cards) {
+            deserialized_cards.push_back(card::from_json(serialized_card));
+        }
+        return new hand(schema::get<const char*>(*id, "id"), deserialized_cards);
+    }
+    if (id && nof_cards) {
+        return new hand(schema::get<const char*>(*id, "id"), schema::get<unsigned>(*nof_cards, "nof_cards"));
     }
     throw WizardException("Could not parse hand from json. 'cards' were missing.");
 }
@@ -1,9 +1,12 @@
 #ifndef WIZARD_HAND_H
 #define WIZARD_HAND_H
 
+#include <array>
+#include <span>
 #include <vector>
 #include "../../../../rapidjson/include/rapidjson/document.h"
 #include "../cards/card.h"
+#include "../cards/card_mask.h"
 
 /**
  * @class hand
@@ -11,23 +14,28 @@
  *
  * This class encapsulates all information about a player's hand,
  * including the cards a player holds.
+ *
+ * A hand can never hold more than the 60 cards of the deck, so the cards are kept in a fixed-capacity array inside the
+ * hand instead of a separately allocated vector. Alongside, the hand keeps its cards as a card mask (see card_mask.h),
+ * which answers which cards may be played without looking at the cards themselves.
  */
 class hand : public unique_serializable {
-private:
+public:
+    static constexpr unsigned int max_nof_cards = 60;  ///< The maximum number of cards a hand can hold (the whole deck).
 
-    std::vector<card*> _cards; ///< The cards a player holds in their hand.
+private:
 
-    /**
-     * @brief Removes a card from the hand.
-     * @param pos An iterator pointing to the position of the card that should be removed.
-     * @return A pointer to the removed card.
-     */
-    card* remove_card(std::vector<card*>::iterator pos);
+    std::array<card*, max_nof_cards> _cards {}; ///< The cards a player holds in their hand.
+    unsigned int _nof_cards = 0;        ///< The number of cards in _cards.
+    uint64_t _mask = 0;                 ///< The cards in _cards as a card mask.
+    bool _is_redacted = false;          ///< Whether this is a redacted hand, whose cards are not known.
+    unsigned int _nof_hidden_cards = 0; ///< The number of cards of a redacted hand.
+    bool _dirty = true;        ///< Whether cards were added or removed since the last state diff.
 
     /**
      * @brief Removes a card from the hand.
      * @param idx The index of the card that should be removed.
-     * @return A pointer to the removed card.
+     * @return A pointer to the removed card, or nullptr if the index is out of range.
      */
     card* remove_card(int idx);
 
@@ -51,6 +59,8 @@ public:
      * @brief Constructs a new hand object during deserialization.
      * @param id The hand's id.
      * @param cards The hand's cards.
+     *
+     * Throws a WizardException if there are more than max_nof_cards cards.
      */
     hand(const std::string& id, const std::vector<card*>& cards);
 
@@ -60,6 +70,13 @@ public:
      */
     explicit hand(const std::string& id);
 
+    /**
+     * @brief Constructs a new redacted hand object during deserialization.
+     * @param id The hand's id.
+     * @param nof_hidden_cards The number of cards in the hand, which are not known.
+     */
+    hand(const std::string& id, unsigned int nof_hidden_cards);
+
     /**
      * @brief Destructs a hand object.
      */
@@ -69,6 +86,8 @@ public:
     /**
      * @brief Gets the number of cards in the hand.
      * @return The number of cards.
+     *
+     * For redacted hands (hands of other players on the client), this is the number of hidden cards.
      */
     [[nodiscard]] unsigned int get_nof_cards() const;
 
@@ -78,6 +97,43 @@ public:
      */
     [[nodiscard]] std::vector<card*> get_cards() const;
 
+    /**
+     * @brief Gets the cards in the hand without copying them.
+     * @return The cards in the hand, valid until cards are added to or removed from the hand.
+     */
+    [[nodiscard]] std::span<card* const> get_card_span() const;
+
+    /**
+     * @brief Gets the cards in the hand as a card mask (see card_mask.h).
+     * @return The card mask of the hand. Empty for redacted hands.
+     */
+    [[nodiscard]] uint64_t get_mask() const;
+
+    /**
+     * @brief Checks if the hand holds a card of the given color.
+     * @param color The color (1-4).
+     * @return A boolean indicating whether the hand holds a card of the color.
+     */
+    [[nodiscard]] bool has_color(int color) const;
+
+    /**
+     * @brief Gets the cards of the hand that may be played in a trick.
+     * @param trick_color The trick color (0 if no card was played yet, -1 if a wizard was played first).
+     * @return The card mask of the playable cards.
+     *
+     * Wizards and jesters can always be played. If the hand holds cards of the trick color, only those can be played
+     * besides them, otherwise all cards can be played.
+     */
+    [[nodiscard]] uint64_t get_playable_mask(int trick_color) const;
+
+    /**
+     * @brief Checks if a card of the hand may be played in a trick (see get_playable_mask()).
+     * @param card The card, which has to be in the hand.
+     * @param trick_color The trick color (0 if no card was played yet, -1 if a wizard was played first).
+     * @return A boolean indicating whether the card may be played.
+     */
+    [[nodiscard]] bool can_play(const card* card, int trick_color) const;
+
     /**
      * @brief Tries to get a specific card from the hand.
      * @param card_id The card's id.
@@ -87,6 +143,14 @@ public:
      * This function tries to find a card in the hand given a provided card id. If the card is found, the given
      * pointer reference will be updated to point to that card and true is returned, otherwise false is returned.
      */
+    bool try_get_card(const entity_id& card_id, card*& hand_card) const;
+
+    /**
+     * @brief Tries to get a specific card from the hand, given the text of its id (see try_get_card()).
+     * @param card_id The text of the card's id.
+     * @param hand_card Pointer that will point to the card if found.
+     * @return A boolean indicating whether getting the card worked or not.
+     */
     bool try_get_card(const std::string& card_id, card*& hand_card) const;
 
     /**
@@ -95,7 +159,26 @@ public:
     * @param err The error message updated in case something does not work.
     * @return A boolean indicating whether removing the card worked or not.
     */
-    bool remove_card(std::string card_id, std::string& err);
+    bool remove_card(const entity_id& card_id, std::string& err);
+
+    /**
+    * @brief Removes a card from the hand, given the text of its id (see remove_card()).
+    * @param card_id The text of the id of the card that should be removed.
+    * @param err The error message updated in case something does not work.
+    * @return A boolean indicating whether removing the card worked or not.
+    */
+    bool remove_card(const std::string& card_id, std::string& err);
+
+    /**
+     * @brief Checks if cards were added or removed since the last call to clear_dirty().
+     * @return A boolean indicating whether the hand changed.
+     */
+    [[nodiscard]] bool is_dirty() const;
+
+    /**
+     * @brief Marks the hand as unchanged, after its changes were sent to the clients in a state diff.
+     */
+    void clear_dirty();
 
 #ifdef WIZARD_SERVER
 // state update functions
@@ -103,7 +186,7 @@ public:
      * @brief Adds a card to the hand.
      * @param card The card to be added.
      * @param err The error message updated in case something does not work.
-     * @return A boolean indicating whether adding the card worked or not.
+     * @return A boolean indicating whether adding the card worked or not, which fails if the hand is full.
      */
     bool add_card(card* card, std::string& err);
 
@@ -117,10 +200,34 @@ public:
      */
     void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
 
+    /**
+     * @brief Writes the same json as write_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_into_writer(json_writer& writer) const override;
+
+    /**
+     * @brief Serializes a hand object into a json object that only contains the number of cards.
+     * @param json The json object for serializing the hand.
+     * @param allocator The json allocator for serializing the hand.
+     *
+     * This is used to send a player's hand to the other players, who must not see the cards.
+     */
+    void write_redacted_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const;
+
+    /**
+     * @brief Writes the same json as write_redacted_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_redacted_into_writer(json_writer& writer) const;
+
     /**
      * @brief Deserializes a hand object from a json object.
      * @param json The json object containing the hand information.
      * @return A pointer to a new hand object created from the given json object.
+     *
+     * Redacted hands (see write_redacted_into_json()) are deserialized into a hand without cards that only knows
+     * its number of cards.
      */
     static hand* from_json(const rapidjson::Value& json);
 
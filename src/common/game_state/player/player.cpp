@@ -1,129 +1,111 @@
 #include "player.h"
+#include <memory>
 #include "../../exceptions/WizardException.h"
-#include "../../serialization/vector_utils.h"
 
 // constructor for client
-player::player(const std::string& name) : unique_serializable() {
-    this->_player_name = new serializable_value<std::string>(name);
-    this->_nof_predicted = new serializable_value<int>(-1);
-    this->_nof_tricks = new serializable_value<int>(0);
-    this->_scores = std::vector<serializable_value<int>*>(0);
-    this->_has_left_game = new serializable_value<bool>(false);
-    this->_hand = new hand();
-}
+player::player(const std::string& name) : unique_serializable(), _player_name(name), _hand(new hand()) { }
 
 // deserialization constructor
-player::player(const std::string& id, serializable_value<std::string>* name,
-               serializable_value<int>* nof_tricks,
-               serializable_value<int>* nof_predicted,
-               const std::vector<serializable_value<int>*>& scores,
-               serializable_value<bool>* player_has_left_game, hand *hand) :
-        unique_serializable(id),
-        _player_name(name),
-        _nof_tricks(nof_tricks),
-        _nof_predicted(nof_predicted),
-        _scores(scores),
-        _has_left_game(player_has_left_game),
-        _hand(hand)
+player::player(const entity_id id) : unique_serializable(id), _player_name(std::string()), _hand(nullptr) { }
+
+// copy constructor
+player::player(const player& other) :
+        unique_serializable(other._id),
+        _player_name(other._player_name),
+        _nof_tricks(other._nof_tricks),
+        _nof_predicted(other._nof_predicted),
+        _scores(other._scores),
+        _has_left_game(other._has_left_game),
+        _hand(new hand(*other._hand)),
+        _scores_dirty(other._scores_dirty)
+#ifdef WIZARD_SERVER
+        , _game_id(other._game_id)
+#endif
 { }
 
 // deconstructor
 player::~player() {
-    if (_player_name != nullptr) {
-        delete _hand;
-        delete _player_name;
-        delete _nof_predicted;
-        delete _nof_tricks;
-        delete _has_left_game;
-
-        _hand = nullptr;
-        _player_name = nullptr;
-        _nof_predicted = nullptr;
-        _nof_tricks = nullptr;
-        _has_left_game = nullptr;
-    }
+    delete _hand;
+    _hand = nullptr;
 }
 
 #ifdef WIZARD_SERVER
 // constructor for server
-player::player(const std::string& id, const std::string& name) :
-        unique_serializable(id)
-{
-    this->_player_name = new serializable_value<std::string>(name);
-    this->_scores = std::vector<serializable_value<int>*>(1, new serializable_value<int>(0));
-    this->_hand = new hand();
-    this->_nof_predicted = new serializable_value<int>(-1);
-    this->_nof_tricks = new serializable_value<int>(0);
-    this->_has_left_game = new serializable_value<bool>(false);
-}
+player::player(const entity_id id, const std::string& name) :
+        unique_serializable(id),
+        _player_name(name),
+        _scores(1, 0),
+        _hand(new hand())
+{ }
 
 // server accessors
-std::string player::get_game_id()
+const entity_id& player::get_game_id() const
 {
     return _game_id;
 }
 
-void player::set_game_id(const std::string& game_id)
+void player::set_game_id(const entity_id& game_id)
 {
     _game_id = game_id;
 }
 #endif
 
 // getter and setter for scores
-std::vector<serializable_value<int>*> player::get_scores() const noexcept
+const std::vector<int>& player::get_scores() const noexcept
 {
     return _scores;
 }
 
 void player::set_scores(const int score)
 {
-    _scores.push_back(new serializable_value<int>(score));
+    _scores.push_back(score);
+    _scores_dirty = true;
 }
 
 
 // getter and setter for number of won tricks
 int player::get_nof_tricks() const noexcept
 {
-    return _nof_tricks->get_value();
+    return _nof_tricks.get_value();
 }
 
-void player::set_nof_tricks(const int nof_tricks) const
+void player::set_nof_tricks(const int nof_tricks)
 {
-    _nof_tricks->set_value(nof_tricks);
+    _nof_tricks.set_value(nof_tricks);
 }
 
 bool player::has_left_game() const
 {
-    return _has_left_game->get_value();
+    return _has_left_game.get_value();
 }
 
 void player::set_has_left_game(bool has_left_game)
 {
-    _has_left_game->set_value(has_left_game);
+    _has_left_game.set_value(has_left_game);
 }
 
 
 // getter and setter for number of predicted tricks
 int player::get_nof_predicted() const noexcept
 {
-    return _nof_predicted->get_value();
+    return _nof_predicted.get_value();
 }
 
-void player::set_nof_predicted(const int nof_predicted) const
+void player::set_nof_predicted(const int nof_predicted)
 {
-    _nof_predicted->set_value(nof_predicted);
+    _nof_predicted.set_value(nof_predicted);
 }
 
 
 // getter and setter for player name
 std::string player::get_player_name() const noexcept
 {
-    return this->_player_name->get_value();
+    return _player_name.get_value();
 }
 
 void player::set_player_name(const std::string& new_name)
 {
-    _player_name->set_value(new_name);
+    _player_name.set_value(new_name);
 }
 
 // other getters
@@ -144,83 +126,213 @@ bool player::add_card(card *card, std::string &err) const
     return _hand->add_card(card, err);
 }
 
-void player::setup_round() const
+void player::setup_round()
 {
-    _nof_predicted->set_value(-1);
-    _nof_tricks->set_value(0);
+    _nof_predicted.set_value(-1);
+    _nof_tricks.set_value(0);
 }
 
 void player::wrap_up_round() {
     int new_score = 0;
     if (!_scores.empty())
     {
-        new_score = _scores.back()->get_value();
+        new_score = _scores.back();
     }
 
-    if (_nof_predicted->get_value() == _nof_tricks->get_value())
+    if (_nof_predicted.get_value() == _nof_tricks.get_value())
     {
-        new_score += 20 + (10 * _nof_predicted->get_value());
+        new_score += 20 + (10 * _nof_predicted.get_value());
     }
     else
     {
-        new_score -= std::abs(_nof_predicted->get_value() - _nof_tricks->get_value()) * 10;
+        new_score -= std::abs(_nof_predicted.get_value() - _nof_tricks.get_value()) * 10;
     }
-    _scores.push_back(new serializable_value<int>(new_score));
+    _scores.push_back(new_score);
+    _scores_dirty = true;
 }
 #endif
 
-// serialization interface
-void player::write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const {
+// the scores are serialized as an array of numbers
+static rapidjson::Value serialize_scores(const std::vector<int>& scores, rapidjson::Document::AllocatorType& allocator)
+{
+    rapidjson::Value scores_val(rapidjson::kArrayType);
+    scores_val.Reserve(static_cast<rapidjson::SizeType>(scores.size()), allocator);
+    for (const int score : scores) {
+        scores_val.PushBack(score, allocator);
+    }
+    return scores_val;
+}
+
+static void write_scores(const std::vector<int>& scores, json_writer& writer)
+{
+    writer.StartArray();
+    for (const int score : scores) {
+        writer.Int(score);
+    }
+    writer.EndArray();
+}
+
+static std::vector<int> scores_from_json(const rapidjson::Value& json)
+{
+    const auto serialized_scores = schema::get_array(json, "scores");
+    std::vector<int> scores;
+    scores.reserve(serialized_scores.Size());
+    for (auto &serialized_score : serialized_scores) {
+        if (!serialized_score.IsInt()) {
+            throw WizardException("Failed to deserialize player from json. A score is not a number.");
+        }
+        scores.push_back(serialized_score.GetInt());
+    }
+    return scores;
+}
+
+// state diffs
+bool player::is_dirty() const
+{
+    return value_fields.is_dirty(*this) || _scores_dirty || _hand->is_dirty();
+}
+
+void player::clear_dirty()
+{
+    value_fields.clear_dirty(*this);
+    _scores_dirty = false;
+    _hand->clear_dirty();
+}
+
+void player::write_diff_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                                  const hand_visibility visibility) const
+{
     unique_serializable::write_into_json(json, allocator);
 
-    rapidjson::Value id_val(_id.c_str(), allocator);
-    json.AddMember("id", id_val, allocator);
+    value_fields.write_dirty_into_json(*this, json, allocator);
+    if (_scores_dirty) {
+        json.AddMember("scores", serialize_scores(_scores, allocator), allocator);
+    }
+    if (_hand->is_dirty() && visibility != hand_visibility::omitted) {
+        rapidjson::Value hand_val(rapidjson::kObjectType);
+        if (visibility == hand_visibility::redacted) {
+            _hand->write_redacted_into_json(hand_val, allocator);
+        } else {
+            _hand->write_into_json(hand_val, allocator);
+        }
+        json.AddMember("hand", hand_val, allocator);
+    }
+}
+
+void player::write_diff_into_writer(json_writer& writer, const hand_visibility visibility) const
+{
+    writer.StartObject();
+    write_id_into_writer(writer);
+
+    value_fields.write_dirty_into_writer(*this, writer);
+    if (_scores_dirty) {
+        writer.Key("scores");
+        write_scores(_scores, writer);
+    }
+    if (_hand->is_dirty() && visibility != hand_visibility::omitted) {
+        writer.Key("hand");
+        if (visibility == hand_visibility::redacted) {
+            _hand->write_redacted_into_writer(writer);
+        } else {
+            _hand->write_into_writer(writer);
+        }
+    }
+    writer.EndObject();
+}
 
-    rapidjson::Value name_val(rapidjson::kObjectType);
-    _player_name->write_into_json(name_val, allocator);
-    json.AddMember("player_name", name_val, allocator);
+void player::apply_diff(const rapidjson::Value& json)
+{
+    auto reader = value_fields.reader(*this);
+    for (const auto& member : schema::get_object(json, "player")) {
+        if (reader.read(member)) {
+            continue;
+        }
+        const std::string_view name = schema::name_of(member);
+        if (name == "scores") {
+            _scores = scores_from_json(member.value);
+        } else if (name == "hand") {
+            hand* new_hand = hand::from_json(member.value);
+            delete _hand;
+            _hand = new_hand;
+        }
+    }
+}
 
-    rapidjson::Value nof_tricks_val(rapidjson::kObjectType);
-    _nof_tricks->write_into_json(nof_tricks_val, allocator);
-    json.AddMember("nof_tricks", nof_tricks_val, allocator);
+// serialization interface
+void player::write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const {
+    write_view_into_json(json, allocator, hand_visibility::visible);
+}
 
-    rapidjson::Value nof_predicted_val(rapidjson::kObjectType);
-    _nof_predicted->write_into_json(nof_predicted_val, allocator);
-    json.AddMember("nof_predicted", nof_predicted_val, allocator);
+void player::write_view_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                                  const hand_visibility visibility) const {
+    unique_serializable::write_into_json(json, allocator);
 
-    json.AddMember("scores", vector_utils::serialize_vector(_scores, allocator), allocator);
+    value_fields.write_into_json(*this, json, allocator);
 
-    rapidjson::Value has_left_game_val(rapidjson::kObjectType);
-    _has_left_game->write_into_json(has_left_game_val, allocator);
-    json.AddMember("has_left_game", has_left_game_val, allocator);
+    json.AddMember("scores", serialize_scores(_scores, allocator), allocator);
 
+    if (visibility == hand_visibility::omitted) {
+        return;
+    }
     rapidjson::Value hand_val(rapidjson::kObjectType);
-    _hand->write_into_json(hand_val, allocator);
+    if (visibility == hand_visibility::redacted) {
+        _hand->write_redacted_into_json(hand_val, allocator);
+    } else {
+        _hand->write_into_json(hand_val, allocator);
+    }
     json.AddMember("hand", hand_val, allocator);
 }
 
+void player::write_into_writer(json_writer& writer) const {
+    write_view_into_writer(writer, hand_visibility::visible);
+}
+
+void player::write_view_into_writer(json_writer& writer, const hand_visibility visibility) const {
+    writer.StartObject();
+    write_id_into_writer(writer);
+
+    value_fields.write_into_writer(*this, writer);
+
+    writer.Key("scores");
+    write_scores(_scores, writer);
+
+    if (visibility != hand_visibility::omitted) {
+        writer.Key("hand");
+        if (visibility == hand_visibility::redacted) {
+            _hand->write_redacted_into_writer(writer);
+        } else {
+            _hand->write_into_writer(writer);
+        }
+    }
+    writer.EndObject();
+}
+
 player* player::from_json(const rapidjson::Value &json) {
-    if (json.HasMember("id")
-        && json.HasMember("nof_predicted")
-        && json.HasMember("nof_tricks")
-        && json.HasMember("player_name")
-        && json.HasMember("scores")
-        && json.HasMember("has_left_game")
-        && json.HasMember("hand"))
-    {
-        std::vector<serializable_value<int>*> deserialized_scores;
-        for (auto &serialized_score : json["scores"].GetArray()) {
-            deserialized_scores.push_back(serializable_value<int>::from_json(serialized_score.GetObject()));
+    auto deserialized_player = std::unique_ptr<player>(new player(entity_id()));
+    auto reader = value_fields.reader(*deserialized_player);
+    bool has_id = false;
+    bool has_scores = false;
+    for (const auto& member : schema::get_object(json, "player")) {
+        if (reader.read(member)) {
+            continue;
         }
-        return new player(
-                json["id"].GetString(),
-                serializable_value<std::string>::from_json(json["player_name"].GetObject()),
-                serializable_value<int>::from_json(json["nof_tricks"].GetObject()),
-                serializable_value<int>::from_json(json["nof_predicted"].GetObject()),
-                deserialized_scores,
-                serializable_value<bool>::from_json(json["has_left_game"].GetObject()),
-                hand::from_json(json["hand"].GetObject()));
-    } else {
+        const std::string_view name = schema::name_of(member);
+        if (name == "id") {
+            deserialized_player->_id = entity_id::from_string(schema::get<const char*>(member.value, "id"));
+            has_id = true;
+        } else if (name == "scores") {
+            deserialized_player->_scores = scores_from_json(member.value);
+            has_scores = true;
+        } else if (name == "hand") {
+            deserialized_player->_hand = hand::from_json(member.value);
+        }
+    }
+    if (!has_id || !has_scores || !reader.has_read_all()) {
         throw WizardException("Failed to deserialize player from json. Required json entries were missing.");
     }
+    // views of players in tricks contain no hand (see hand_visibility::omitted)
+    if (!deserialized_player->_hand) {
+        deserialized_player->_hand = new hand();
+    }
+    return deserialized_player.release();
 }
@@ -7,6 +7,7 @@
 #include "../../../../rapidjson/include/rapidjson/document.h"
 #include "../../serialization/unique_serializable.h"
 #include "../../serialization/serializable_value.h"
+#include "../../serialization/schema.h"
 
 /**
  * @class player
@@ -16,36 +17,47 @@
  * including the player's name, scores, hand, and the number of tricks they predicted and won.
  */
 class player : public unique_serializable {
+public:
+
+    /**
+     * @brief Describes how much of the player's hand is serialized.
+     *
+     * Players only see their own cards. The hands of the other players are sent redacted, i.e. only their number of
+     * cards. The players stored in tricks are sent without their hand.
+     */
+    enum class hand_visibility {
+        visible,
+        redacted,
+        omitted
+    };
+
 private:
 
-    serializable_value<std::string>* _player_name;  ///< The player's name chosen by the player.
-    serializable_value<int>* _nof_tricks;           ///< The number of tricks won in the current round.
-    serializable_value<int>* _nof_predicted;        ///< The number of predicted tricks in the current round.
-    std::vector<serializable_value<int>*> _scores;  ///< The scores of the player (total game score, current and past ones).
-    serializable_value<bool>* _has_left_game;       ///< Boolean whether player has left the game.
-    hand* _hand;                                    ///< The player's hand holding the player's cards.
+    serializable_value<std::string> _player_name;       ///< The player's name chosen by the player.
+    serializable_value<int> _nof_tricks = 0;            ///< The number of tricks won in the current round.
+    serializable_value<int> _nof_predicted = -1;        ///< The number of predicted tricks in the current round.
+    std::vector<int> _scores;                           ///< The scores of the player (total game score, current and past ones).
+    serializable_value<bool> _has_left_game = false;    ///< Boolean whether player has left the game.
+    hand* _hand;                                        ///< The player's hand holding the player's cards.
+    bool _scores_dirty = true;                          ///< Whether scores were added since the last state diff.
 
 #ifdef WIZARD_SERVER
-    std::string _game_id;                           ///< The ID of the game the player has joint.
+    entity_id _game_id;                                 ///< The ID of the game the player has joint (nil if none).
 #endif
 
+    /// The scalar members of the player, from which their serialization is generated (see schema.h).
+    static constexpr schema::fields value_fields {
+            schema::value_field {"player_name", &player::_player_name},
+            schema::value_field {"nof_tricks", &player::_nof_tricks},
+            schema::value_field {"nof_predicted", &player::_nof_predicted},
+            schema::value_field {"has_left_game", &player::_has_left_game}};
+
     /**
-     * @brief Constructs a new player object during deserialization.
-     * @param id The player's is.
-     * @param name The player's name.
-     * @param nof_tricks The number of tricks won by the player in the current round.
-     * @param nof_predicted The number of tricks predicted to be won by the player in the current round.
-     * @param scores The player's scores.
-     * @param has_left_game Boolean whether player has left the game.
-     * @param hand The player's hand.
-     */
-    player(const std::string& id,
-           serializable_value<std::string>* name,
-           serializable_value<int>* nof_tricks,
-           serializable_value<int>* nof_predicted,
-           const std::vector<serializable_value<int>*>& scores,
-           serializable_value<bool>* has_left_game,
-           hand* hand);
+     * @brief Constructs a new player object without a hand during deserialization, whose members are then read from
+     * json.
+     * @param id The player's id.
+     */
+    explicit player(entity_id id);
 
 public:
 
@@ -56,6 +68,12 @@ public:
      */
     explicit player(const std::string& name);
 
+    /**
+     * @brief Constructs a new player object as a deep copy of another player object, with the same id.
+     * @param other The player it is copied from.
+     */
+    player(const player& other);
+
     /**
      * @brief Destructs a player object.
      */
@@ -67,19 +85,19 @@ public:
      * @param id The player's id.
      * @param name The player's name.
      */
-    player(const std::string& id, const std::string& name);
+    player(entity_id id, const std::string& name);
 
     /**
      * @brief Gets the game id of the game the player has joint.
-     * @return The game id of the game the player has joint.
+     * @return The game id of the game the player has joint, or the nil id if the player has not joint any game.
      */
-    std::string get_game_id();
+    [[nodiscard]] const entity_id& get_game_id() const;
 
     /**
      * @brief Sets the game id of the player.
      * @param game_id The game id of the game the player has joint.
      */
-    void set_game_id(const std::string& game_id);
+    void set_game_id(const entity_id& game_id);
 #endif
 
 // accessors
@@ -87,7 +105,7 @@ public:
      * @brief Gets the scores of the player.
      * @return The scores of the player as a vector.
      */
-    [[nodiscard]] std::vector<serializable_value<int>*> get_scores() const noexcept;
+    [[nodiscard]] const std::vector<int>& get_scores() const noexcept;
 
     /**
      * @brief Sets the player's scores to the given scores.
@@ -107,7 +125,7 @@ public:
      *
      * This function is used to update the player's won number of tricks in case a player wins a trick.
      */
-    void set_nof_tricks(int nof_tricks) const;
+    void set_nof_tricks(int nof_tricks);
 
     /**
      * @brief State whether player has left the game.
@@ -134,7 +152,7 @@ public:
      * This function is used to update the player's predicted number of tricks during the estimation
      * phase of the game.
      */
-    void set_nof_predicted(int nof_predicted) const;
+    void set_nof_predicted(int nof_predicted);
 
     /**
      * @brief Gets the number of cards in the player's hand.
@@ -164,6 +182,44 @@ public:
 
     void set_player_name(const std::string& new_name);
 
+// state diffs
+    /**
+     * @brief Checks if the player (including their hand) changed since the last call to clear_dirty().
+     * @return A boolean indicating whether the player changed.
+     */
+    [[nodiscard]] bool is_dirty() const;
+
+    /**
+     * @brief Marks the player and their hand as unchanged, after the changes were sent to the clients in a state diff.
+     */
+    void clear_dirty();
+
+    /**
+     * @brief Serializes the changes of the player since the last call to clear_dirty() into a json object.
+     * @param json The json object for serializing the diff.
+     * @param allocator The json allocator for serializing the diff.
+     *
+     * @param visibility How much of a changed hand is serialized.
+     *
+     * The diff always contains the player's id and only contains the values that changed. Changed scores and a changed
+     * hand are sent completely.
+     */
+    void write_diff_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                              hand_visibility visibility) const;
+
+    /**
+     * @brief Writes the same json as write_diff_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     * @param visibility How much of a changed hand is written.
+     */
+    void write_diff_into_writer(json_writer& writer, hand_visibility visibility) const;
+
+    /**
+     * @brief Applies a diff created by write_diff_into_json() to this player.
+     * @param json The json object containing the diff.
+     */
+    void apply_diff(const rapidjson::Value& json);
+
 #ifdef WIZARD_SERVER
 // state update functions
     /**
@@ -180,7 +236,7 @@ public:
      * Sets the number of predicted tricks to -1 to show that no predictions have been made yet by the player
      * and sets the number of won tricks to zero. This sets up the player for the next round.
      */
-    void setup_round() const;
+    void setup_round();
 
     /**
      * @brief Calculates the new score of the player.
@@ -199,10 +255,34 @@ public:
      */
     void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
 
+    /**
+     * @brief Serializes a player object into a json object, as it is seen by the players of the game.
+     * @param json The json object for serializing the player.
+     * @param allocator The json allocator for serializing the player.
+     * @param visibility How much of the hand is serialized.
+     */
+    void write_view_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator,
+                              hand_visibility visibility) const;
+
+    /**
+     * @brief Writes the same json as write_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     */
+    void write_into_writer(json_writer& writer) const override;
+
+    /**
+     * @brief Writes the same json as write_view_into_json() to a json writer, without building a json object.
+     * @param writer The json writer.
+     * @param visibility How much of the hand is written.
+     */
+    void write_view_into_writer(json_writer& writer, hand_visibility visibility) const;
+
     /**
      * @brief Deserializes a player object from a json object.
      * @param json The json object containing the player information.
      * @return A pointer to a new player object created from the given json object.
+     *
+     * If the json object contains no hand (see hand_visibility::omitted), the player gets an empty hand.
      */
     static player* from_json(const rapidjson::Value& json);
 };
@@ -0,0 +1,73 @@
+//
+// Fast, seedable pseudo-random numbers (xoshiro256**, see https://prng.di.unimi.it/).
+//
+// Every game owns its own generator, so a game is reproduced exactly from its seed: the numbers drawn only depend on
+// the seed, not on the platform or standard library (unlike the std:: distributions). Seeds are expanded with
+// splitmix64, so consecutive seeds give unrelated sequences.
+
+#ifndef WIZARD_RANDOM_GENERATOR_H
+#define WIZARD_RANDOM_GENERATOR_H
+
+#include <cstdint>
+#include <random>
+
+class random_generator {
+
+private:
+    uint64_t _state[4];
+
+    static constexpr uint64_t rotl(const uint64_t x, const int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    explicit random_generator(uint64_t seed) {
+        // splitmix64
+        for (uint64_t& word : _state) {
+            seed += 0x9e3779b97f4a7c15;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    // A seed from the operating system's entropy source, for games that do not need to be reproduced
+    static uint64_t random_seed() {
+        std::random_device rd;
+        return (uint64_t{rd()} << 32) ^ rd();
+    }
+
+    uint64_t next() {
+        const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+        const uint64_t t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotl(_state[3], 45);
+        return result;
+    }
+
+    // A uniformly distributed number in [0, bound), bound > 0 (Lemire's multiply-and-reject method)
+    int next_below(const int bound) {
+        const auto range = static_cast<uint32_t>(bound);
+        uint64_t product = (next() >> 32) * range;
+        if (static_cast<uint32_t>(product) < range) {
+            const uint32_t threshold = -range % range;
+            while (static_cast<uint32_t>(product) < threshold) {
+                product = (next() >> 32) * range;
+            }
+        }
+        return static_cast<int>(product >> 32);
+    }
+
+    // The generator of the calling thread for numbers that need not be reproducible (e.g. ids), seeded on first use
+    static random_generator& thread_instance() {
+        thread_local random_generator instance(random_seed());
+        return instance;
+    }
+};
+
+#endif //WIZARD_RANDOM_GENERATOR_H
@@ -0,0 +1,93 @@
+//
+// Splits the byte stream of a connection into frames (see wire_format).
+//
+
+#include "frame_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // minimum free space offered to a read, smaller reads would mean more system calls than necessary
+    constexpr size_t min_read_size = 1024;
+}
+
+frame_reader::frame_reader(size_t initial_capacity) :
+        _buffer(std::max(initial_capacity, min_read_size) + 1)
+{ }
+
+void frame_reader::restore_terminated_byte() {
+    if (_is_terminated) {
+        _buffer[_terminator_pos] = _terminated_byte;
+        _is_terminated = false;
+    }
+}
+
+char* frame_reader::prepare(size_t& available) {
+    restore_terminated_byte();
+
+    const size_t pending = _write_pos - _read_pos;
+    const size_t required = std::max(_pending_frame_size, pending + min_read_size);
+
+    if (get_capacity() - _read_pos < required) {
+        // move the incomplete frame to the front, and grow the buffer if it does not fit the whole frame
+        if (pending > 0) {
+            std::memmove(_buffer.data(), _buffer.data() + _read_pos, pending);
+        }
+        _read_pos = 0;
+        _write_pos = pending;
+        if (get_capacity() < required) {
+            _buffer.resize(std::max(required, 2 * get_capacity()) + 1);
+        }
+    }
+
+    available = get_capacity() - _write_pos;
+    return _buffer.data() + _write_pos;
+}
+
+void frame_reader::commit(size_t count) {
+    _write_pos = std::min(_write_pos + count, get_capacity());
+}
+
+wire_format::frame_status frame_reader::next_frame(frame& f) {
+    restore_terminated_byte();
+
+    size_t payload_offset = 0;
+    size_t payload_size = 0;
+    const wire_format::frame_status status = wire_format::find_frame(_buffer.data() + _read_pos,
+                                                                     _write_pos - _read_pos, f.encoding,
+                                                                     payload_offset, payload_size);
+    if (status == wire_format::frame_status::incomplete) {
+        // the header may already be complete, so the size of the frame is known
+        _pending_frame_size = payload_offset > 0 ? payload_offset + payload_size : 0;
+        return status;
+    }
+    if (status == wire_format::frame_status::malformed) {
+        return status;
+    }
+
+    f.data = _buffer.data() + _read_pos + payload_offset;
+    f.size = payload_size;
+    _read_pos += payload_offset + payload_size;
+    _pending_frame_size = 0;
+
+    // terminate the payload, the overwritten byte (the start of the next frame) is restored before it is read
+    _terminator_pos = _read_pos;
+    _terminated_byte = _buffer[_terminator_pos];
+    _buffer[_terminator_pos] = '\0';
+    _is_terminated = true;
+    if (_read_pos == _write_pos) {
+        // everything was consumed, the next read starts at the front again
+        _read_pos = 0;
+        _write_pos = 0;
+    }
+    return status;
+}
+
+size_t frame_reader::get_nof_pending_bytes() const {
+    return _write_pos - _read_pos;
+}
+
+size_t frame_reader::get_capacity() const {
+    return _buffer.size() - 1;
+}
@@ -0,0 +1,65 @@
+//
+// Splits the byte stream of a connection into frames (see wire_format).
+//
+// Bytes are read from the socket directly into the free space of the reader's buffer. Complete frames are handed out
+// as views into that buffer, so a payload is never copied between the socket and the parser. Every payload handed out
+// is followed by a '\0' and may be modified in place, so json payloads can be parsed in situ. The buffer is used like
+// a ring buffer whose unread bytes are always contiguous: once all frames are consumed, reading starts over at the
+// front, and only the bytes of an incomplete frame are moved to the front when the end of the buffer is reached.
+// The buffer grows if a single frame does not fit into it.
+//
+// A frame_reader is used by a single thread.
+
+#ifndef WIZARD_FRAME_READER_H
+#define WIZARD_FRAME_READER_H
+
+#include <string_view>
+#include <vector>
+
+#include "wire_format.h"
+
+class frame_reader {
+public:
+    struct frame {
+        wire_format::encoding encoding;
+        char* data;                     // the payload, valid until the next call of prepare() or next_frame()
+        size_t size;
+
+        [[nodiscard]] std::string_view payload() const { return {data, size}; }
+    };
+
+    static constexpr size_t default_capacity = 4096;
+
+    explicit frame_reader(size_t initial_capacity = default_capacity);
+
+    // Returns the free space at the end of the buffer, which is at least large enough for the rest of the frame that
+    // is currently being received (or a sensible minimum). Invalidates the payload handed out before.
+    char* prepare(size_t& available);
+
+    // marks 'count' bytes written into the space returned by prepare() as received
+    void commit(size_t count);
+
+    // Takes the next complete frame from the buffer. Returns frame_status::incomplete if more bytes are needed and
+    // frame_status::malformed if the stream does not contain a valid frame header (the connection should be closed).
+    // Invalidates the payload handed out before.
+    wire_format::frame_status next_frame(frame& f);
+
+    // the number of received bytes that were not handed out as a frame yet
+    [[nodiscard]] size_t get_nof_pending_bytes() const;
+
+    [[nodiscard]] size_t get_capacity() const;
+
+private:
+    // restores the byte that was overwritten by the '\0' after the last payload
+    void restore_terminated_byte();
+
+    std::vector<char> _buffer;      // the last byte is reserved for the '\0' after a payload that ends the buffer
+    size_t _read_pos = 0;           // start of the first byte that was not handed out yet
+    size_t _write_pos = 0;          // end of the received bytes
+    size_t _pending_frame_size = 0; // size of the incomplete frame at _read_pos including its header, if known
+    size_t _terminator_pos = 0;     // position of the '\0' after the last payload
+    char _terminated_byte = 0;      // the byte at _terminator_pos before it was overwritten
+    bool _is_terminated = false;
+};
+
+#endif //WIZARD_FRAME_READER_H
@@ -8,6 +8,7 @@
 #include "join_game_request.h"
 #include "start_game_request.h"
 #include "leave_game_request.h"
+#include "resync_request.h"
 
 #include <iostream>
 
@@ -17,7 +18,8 @@ const std::unordered_map<std::string, RequestType> client_request::_string_to_re
         {"start_game", RequestType::start_game},
         {"play_card", RequestType::play_card},
         {"estimate_tricks", RequestType::estimate_tricks},
-        {"leave_game", RequestType::leave_game}
+        {"leave_game", RequestType::leave_game},
+        {"resync", RequestType::resync}
 };
 // for serialization
 const std::unordered_map<RequestType, std::string> client_request::_request_type_to_string = {
@@ -25,7 +27,8 @@ const std::unordered_map<RequestType, std::string> client_request::_request_type
         { RequestType::start_game, "start_game"},
         { RequestType::play_card, "play_card"},
         {RequestType::estimate_tricks, "estimate_tricks"},
-        {RequestType::leave_game, "leave_game"}
+        {RequestType::leave_game, "leave_game"},
+        {RequestType::resync, "resync"}
 
 };
 
@@ -108,6 +111,9 @@ client_request* client_request::from_json(const rapidjson::Value &json) {
         else if (request_type == RequestType::leave_game) {
             return leave_game_request::from_json(json);
         }
+        else if (request_type == RequestType::resync) {
+            return resync_request::from_json(json);
+        }
         else {
             throw WizardException("Encountered unknown ClientRequest type " + type);
         }
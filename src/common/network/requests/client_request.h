@@ -23,7 +23,8 @@ enum RequestType {
     start_game,
     play_card,
     estimate_tricks,
-    leave_game
+    leave_game,
+    resync
 };
 
 class client_request : public serializable {
@@ -0,0 +1,74 @@
+//
+// request_view is a lightweight alternative to the client_request classes for the server's request dispatch.
+//
+
+#include "request_view.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace {
+    // the same names as in client_request::_string_to_request_type, looked up without creating a std::string
+    constexpr std::array<std::pair<std::string_view, RequestType>, 6> request_types = {{
+            {"join_game", RequestType::join_game},
+            {"start_game", RequestType::start_game},
+            {"play_card", RequestType::play_card},
+            {"estimate_tricks", RequestType::estimate_tricks},
+            {"leave_game", RequestType::leave_game},
+            {"resync", RequestType::resync}
+    }};
+
+    // returns the string member 'name' of 'json', or throws if it is missing
+    std::string_view get_string(const rapidjson::Value& json, const char* name, const char* error) {
+        const auto it = json.FindMember(name);
+        if (it == json.MemberEnd() || !it->value.IsString()) {
+            throw WizardException(error);
+        }
+        return {it->value.GetString(), it->value.GetStringLength()};
+    }
+}
+
+void request_view::from_json(const rapidjson::Value& json, request_view& view) {
+    if (!json.IsObject()) {
+        throw WizardException("Could not determine type of ClientRequest.");
+    }
+    const std::string_view type = get_string(json, "type", "Could not determine type of ClientRequest.");
+    const auto it = std::find_if(request_types.begin(), request_types.end(),
+                                 [type](const auto& entry) { return entry.first == type; });
+    if (it == request_types.end()) {
+        throw WizardException("Encountered unknown ClientRequest type " + std::string(type));
+    }
+
+    view.type = it->second;
+    view.player_id = get_string(json, "player_id", "Client Request did not contain player_id or game_id");
+    view.game_id = get_string(json, "game_id", "Client Request did not contain player_id or game_id");
+    view.req_id = get_string(json, "req_id", "Client Request did not contain player_id or game_id");
+    view.player_name = {};
+    view.card_id = {};
+    view.trick_estimate = 0;
+
+    switch (view.type) {
+        case RequestType::join_game:
+            view.player_name = get_string(json, "player_name",
+                                          "Could not parse join_game_request from json. player_name is missing.");
+            break;
+        case RequestType::leave_game:
+            view.player_name = get_string(json, "player_name",
+                                          "Could not parse leave_game_request from json. player_name is missing.");
+            break;
+        case RequestType::play_card:
+            view.card_id = get_string(json, "card_id", "Could not find 'card_id' or 'value' in play_card_request");
+            break;
+        case RequestType::estimate_tricks: {
+            const auto estimate = json.FindMember("estimate_tricks");
+            if (estimate == json.MemberEnd() || !estimate->value.IsInt()) {
+                throw WizardException("Could not find 'estimate_tricks' in estimate_tricks_request");
+            }
+            view.trick_estimate = estimate->value.GetInt();
+            break;
+        }
+        default:
+            break;
+    }
+}
@@ -0,0 +1,28 @@
+//
+// request_view is a lightweight alternative to the client_request classes for the server's request dispatch.
+// Instead of copying the fields of a request into std::string members of a heap allocated client_request subclass,
+// it only refers to the strings of the json document the request was parsed from, so creating it never allocates.
+
+#ifndef WIZARD_REQUEST_VIEW_H
+#define WIZARD_REQUEST_VIEW_H
+
+#include <string_view>
+
+#include "client_request.h"
+
+struct request_view {
+    RequestType type = RequestType::join_game;
+    std::string_view req_id;
+    std::string_view player_id;
+    std::string_view game_id;
+
+    std::string_view player_name;   // join_game and leave_game
+    std::string_view card_id;       // play_card
+    int trick_estimate = 0;         // estimate_tricks
+
+    // Fills 'view' with the fields of the request in 'json', which must outlive the view.
+    // Throws a WizardException if the json is not a valid client_request.
+    static void from_json(const rapidjson::Value& json, request_view& view);
+};
+
+#endif //WIZARD_REQUEST_VIEW_H
@@ -0,0 +1,24 @@
+//
+// Sent by a client that missed a state update (e.g. received a state diff that does not apply to its game state).
+// The server answers with the full game state.
+
+#include "resync_request.h"
+
+// Public constructor
+resync_request::resync_request(std::string game_id, std::string player_id)
+        : client_request( client_request::create_base_class_properties(RequestType::resync, uuid_generator::generate_uuid_v4(), player_id, game_id) )
+{ }
+
+// private constructor for deserialization
+resync_request::resync_request(client_request::base_class_properties props) :
+        client_request(props)
+{ }
+
+resync_request* resync_request::from_json(const rapidjson::Value& json) {
+    return new resync_request(client_request::extract_base_class_properties(json));
+}
+
+void resync_request::write_into_json(rapidjson::Value &json,
+                                     rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> &allocator) const {
+    client_request::write_into_json(json, allocator);
+}
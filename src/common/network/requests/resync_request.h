@@ -0,0 +1,28 @@
+//
+// Sent by a client that missed a state update (e.g. received a state diff that does not apply to its game state).
+// The server answers with the full game state.
+
+#ifndef WIZARD_RESYNC_REQUEST_H
+#define WIZARD_RESYNC_REQUEST_H
+
+
+#include <string>
+#include "client_request.h"
+#include "../../../../rapidjson/include/rapidjson/document.h"
+
+class resync_request : public client_request{
+
+private:
+
+    /*
+     * Private constructor for deserialization
+     */
+    explicit resync_request(base_class_properties);
+
+public:
+    resync_request(std::string game_id, std::string player_id);
+    virtual void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
+    static resync_request* from_json(const rapidjson::Value& json);
+};
+
+#endif //WIZARD_RESYNC_REQUEST_H
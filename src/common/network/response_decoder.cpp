@@ -0,0 +1,144 @@
+//
+// The response_decoder turns the payloads of the frames a client receives into the game states shown by its GUI.
+//
+
+#include "response_decoder.h"
+
+#include "responses/server_response.h"
+#include "../exceptions/WizardException.h"
+#include "../serialization/binary_codec.h"
+#include "../serialization/schema.h"
+
+response_decoder::response_decoder() :
+        _value_allocator(_value_buffer, value_buffer_size),
+        _parse_allocator(_parse_buffer, parse_buffer_size),
+        _document(&_value_allocator, parse_buffer_size / 2, &_parse_allocator)
+{ }
+
+response_decoder::~response_decoder() {
+    delete_state(_state);
+}
+
+void response_decoder::delete_state(game_state* state) {
+    if (state != nullptr) {
+        // the game state does not own its players (see ~game_state())
+        for (const player* p : state->get_players()) {
+            delete p;
+        }
+        delete state;
+    }
+}
+
+response_decoder::update response_decoder::decode(const frame_reader::frame& f) {
+    // nothing in the pools is referenced anymore once the document is reset
+    _document.SetNull();
+    _value_allocator.Clear();
+    _parse_allocator.Clear();
+
+    if (f.encoding == wire_format::encoding::binary) {
+        binary_codec::decode(f.data, f.size, _document, _document.GetAllocator());
+    } else {
+        _document.ParseInsitu(f.data);
+        if (_document.HasParseError() || !_document.IsObject()) {
+            throw WizardException("Failed to parse json message");
+        }
+    }
+
+    update result;
+    switch (server_response::type_of(_document)) {
+        case ResponseType::full_state_msg: {
+            const auto state_json = _document.FindMember("state_json");
+            if (state_json == _document.MemberEnd()) {
+                throw WizardException("Could not parse full_state_response from json. state is missing.");
+            }
+            replace_state(state_json->value, result);
+            break;
+        }
+        case ResponseType::state_diff_msg: {
+            const auto diff_json = _document.FindMember("diff_json");
+            if (diff_json == _document.MemberEnd()) {
+                throw WizardException("Could not parse state_diff_response from json. diff is missing.");
+            }
+            apply_diff(diff_json->value, result);
+            break;
+        }
+        case ResponseType::req_response: {
+            const auto success = _document.FindMember("success");
+            const auto err = _document.FindMember("err");
+            if (success == _document.MemberEnd() || err == _document.MemberEnd()) {
+                throw WizardException("Could not parse request_response from json. err or success is missing.");
+            }
+            if (!schema::get<bool>(success->value, "success")) {
+                result.error = schema::get<const char*>(err->value, "err");
+            } else {
+                // only leaving returns the full state, the changes caused by all other requests are sent to every
+                // player of the game as state_diff_response
+                const auto state_json = _document.FindMember("state_json");
+                if (state_json != _document.MemberEnd()) {
+                    replace_state(state_json->value, result);
+                }
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+void response_decoder::replace_state(const rapidjson::Value& state_json, update& result) {
+    game_state* state = game_state::from_json(state_json);
+    try {
+        result.state = state->copy();
+    } catch (...) {
+        delete_state(state);
+        throw;
+    }
+    delete_state(_state);
+    _state = state;
+}
+
+void response_decoder::apply_diff(const rapidjson::Value& diff_json, update& result) {
+    // diffs that arrive before the full state (after joining, or after a resync was requested) are already contained
+    // in that full state
+    if (_state == nullptr) {
+        return;
+    }
+
+    const int version = schema::get<int>(schema::get_member(diff_json, "version"), "version");
+    const int base_version = schema::get<int>(schema::get_member(diff_json, "base_version"), "base_version");
+    const char* id = schema::get<const char*>(schema::get_member(diff_json, "id"), "id");
+
+    // ignore diffs that are already contained in the game state
+    if (version <= _state->get_version()) {
+        return;
+    }
+
+    // an update was missed, so the full game state has to be requested instead (only once, the following diffs are
+    // ignored until it arrives)
+    if (id != _state->get_id() || base_version != _state->get_version()) {
+        delete_state(_state);
+        _state = nullptr;
+        result.resync = true;
+        return;
+    }
+
+    try {
+        _state->apply_diff(diff_json);
+    } catch (const std::exception&) {
+        // the game state may have been changed partially, so it is replaced by the full state
+        delete_state(_state);
+        _state = nullptr;
+        result.resync = true;
+        return;
+    }
+
+    // the receiver gets a copy, so that it can compare (and change) the game state it showed before
+    result.state = _state->copy();
+}
+
+const response_decoder::pooled_document& response_decoder::get_json() const {
+    return _document;
+}
+
+const game_state* response_decoder::get_state() const {
+    return _state;
+}
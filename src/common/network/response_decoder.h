@@ -0,0 +1,96 @@
+//
+// The response_decoder turns the payloads of the frames a client receives into the game states shown by its GUI.
+//
+
+#ifndef WIZARD_RESPONSE_DECODER_H
+#define WIZARD_RESPONSE_DECODER_H
+
+#include <string>
+
+#include "frame_reader.h"
+#include "../game_state/game_state.h"
+
+/**
+ * @class response_decoder
+ * @brief Decodes the responses of the server on the thread that receives them, so the GUI only has to show the result.
+ *
+ * The decoder keeps its own copy of the game state the client holds: full states replace it and state diffs are
+ * applied to it. For every change, a separate game state is created and handed out, which the receiver owns and may
+ * change, so the copy of the decoder is never shared between threads.
+ *
+ * Like the request_decoder of the server, payloads are decoded into memory pools whose first chunk is a buffer inside
+ * the decoder, and json payloads are parsed in situ. The responses are read from the decoded document directly, without
+ * creating a server_response that copies the state or diff out of it.
+ *
+ * A response_decoder is used by a single thread.
+ */
+class response_decoder {
+
+public:
+    /// A json document that also takes rapidjson's parse stack from a memory pool.
+    using pooled_document = rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>,
+                                                       rapidjson::MemoryPoolAllocator<>>;
+
+    /// What the client has to do after a response was decoded.
+    struct update {
+        game_state* state = nullptr;    ///< The new game state to show, owned by the receiver. nullptr if unchanged.
+        bool resync = false;            ///< An update was missed, so the full game state has to be requested.
+        std::string error;              ///< The error of a request of the client that failed, empty otherwise.
+
+        [[nodiscard]] bool is_empty() const { return state == nullptr && !resync && error.empty(); }
+    };
+
+private:
+    static constexpr size_t value_buffer_size = 32 * 1024;  ///< Values and (binary encoded) strings of a full state.
+    static constexpr size_t parse_buffer_size = 4 * 1024;   ///< The parse stack of rapidjson.
+
+    alignas(8) char _value_buffer[value_buffer_size];
+    alignas(8) char _parse_buffer[parse_buffer_size];
+    rapidjson::MemoryPoolAllocator<> _value_allocator;
+    rapidjson::MemoryPoolAllocator<> _parse_allocator;
+    pooled_document _document;
+
+    game_state* _state = nullptr;   ///< The game state the client holds, as far as the decoder knows.
+
+    void replace_state(const rapidjson::Value& state_json, update& result);
+    void apply_diff(const rapidjson::Value& diff_json, update& result);
+
+public:
+    response_decoder();
+    ~response_decoder();
+
+    response_decoder(const response_decoder&) = delete;
+    response_decoder& operator=(const response_decoder&) = delete;
+
+    /**
+     * @brief Decodes the response contained in a frame and applies it to the game state of the decoder.
+     * @param f The received frame. Its payload may be modified.
+     * @return What the client has to do. Throws a WizardException if the payload is not a valid response.
+     *
+     * State diffs that are already contained in the game state (or arrive before the first full state) are ignored.
+     * If a diff does not apply to the game state because an update was missed, the update asks for a resync instead.
+     * The game state is dropped then, so the diffs that arrive before the requested full state are ignored and the
+     * resync is only asked for once.
+     */
+    update decode(const frame_reader::frame& f);
+
+    /**
+     * @brief Gets the json document of the last decoded response.
+     * @return The json document, valid until the next call of decode().
+     */
+    [[nodiscard]] const pooled_document& get_json() const;
+
+    /**
+     * @brief Gets the game state of the decoder.
+     * @return The game state after the last decoded response, nullptr if no full state was received yet.
+     */
+    [[nodiscard]] const game_state* get_state() const;
+
+    /**
+     * @brief Deletes a game state handed out by the decoder, together with its players.
+     * @param state The game state, may be nullptr.
+     */
+    static void delete_state(game_state* state);
+};
+
+#endif //WIZARD_RESPONSE_DECODER_H
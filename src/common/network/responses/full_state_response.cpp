@@ -7,26 +7,41 @@
 #include "../../exceptions/WizardException.h"
 #include "../../serialization/json_utils.h"
 
-#ifdef WIZARD_CLIENT
-#include "../../../client/GameController.h"
-#endif
-
-full_state_response::full_state_response(server_response::base_class_properties props, rapidjson::Value* state_json) :
+full_state_response::full_state_response(server_response::base_class_properties props, rapidjson::Document* state_json) :
         server_response(props),
         _state_json(state_json)
 { }
 
 full_state_response::full_state_response(std::string game_id, const game_state& state) :
-        server_response(server_response::create_base_class_properties(ResponseType::full_state_msg, game_id))
-{
-    this->_state_json = state.to_json();
-}
+        server_response(server_response::create_base_class_properties(ResponseType::full_state_msg, game_id)),
+        _state(&state)
+{ }
 
 
 void full_state_response::write_into_json(rapidjson::Value &json,
                                        rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> &allocator) const {
     server_response::write_into_json(json, allocator);
-    json.AddMember("state_json", *_state_json, allocator);
+    if (_state != nullptr) {
+        // the hands of all players are redacted, the server splices in the receiving player's hand (see state_view)
+        rapidjson::Value state_val(rapidjson::kObjectType);
+        _state->write_view_into_json(state_val, allocator, nullptr);
+        json.AddMember("state_json", state_val, allocator);
+    } else {
+        rapidjson::Value state_val(*_state_json, allocator);
+        json.AddMember("state_json", state_val, allocator);
+    }
+}
+
+void full_state_response::write_into_writer(json_writer& writer) const {
+    writer.StartObject();
+    write_properties_into_writer(writer);
+    writer.Key("state_json");
+    if (_state != nullptr) {
+        _state->write_view_into_writer(writer, nullptr);
+    } else {
+        _state_json->Accept(writer);
+    }
+    writer.EndObject();
 }
 
 full_state_response *full_state_response::from_json(const rapidjson::Value& json) {
@@ -48,18 +63,3 @@ full_state_response::~full_state_response() {
 rapidjson::Value* full_state_response::get_state_json() const {
     return _state_json;
 }
-
-#ifdef WIZARD_CLIENT
-
-void full_state_response::Process() const {
-    try {
-        game_state* state = game_state::from_json(*_state_json);
-        GameController::updateGameState(state);
-
-    } catch(std::exception& e) {
-        std::cerr << "Failed to extract game_state from full_state_response" << std::endl
-                  << e.what() << std::endl;
-    }
-}
-
-#endif
@@ -10,26 +10,29 @@
 
 class full_state_response : public server_response {
 private:
-    rapidjson::Value* _state_json;
+    rapidjson::Document* _state_json = nullptr;     // the deserialized state
+    const game_state* _state = nullptr;             // the state to serialize (on the server)
 
     /*
      * Private constructor for deserialization
      */
-    full_state_response(base_class_properties props, rapidjson::Value* state_json);
+    full_state_response(base_class_properties props, rapidjson::Document* state_json);
 
 public:
 
+    /*
+     * Creates a view of 'state' in which the hands of all players are redacted and the deck is left out. The state is
+     * only serialized when the response is, so it must not change until then.
+     */
     full_state_response(std::string game_id, const game_state& state);
     ~full_state_response();
 
+    // the deserialized state, nullptr if the response was created from a game_state
     rapidjson::Value* get_state_json() const;
 
     virtual void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
+    void write_into_writer(json_writer& writer) const override;
     static full_state_response* from_json(const rapidjson::Value& json);
-
-#ifdef WIZARD_CLIENT
-    virtual void Process() const override;
-#endif
 };
 
 
@@ -7,12 +7,8 @@
 #include "../../exceptions/WizardException.h"
 #include "../../game_state/game_state.h"
 
-#ifdef WIZARD_CLIENT
-#include "../../../client/GameController.h"
-#endif
 
-
-request_response::request_response(server_response::base_class_properties props, std::string req_id, bool success, rapidjson::Value* state_json, std::string &err) :
+request_response::request_response(server_response::base_class_properties props, std::string req_id, bool success, rapidjson::Document* state_json, std::string &err) :
     server_response(props),
     _req_id(req_id),
     _state_json(state_json),
@@ -20,7 +16,7 @@ request_response::request_response(server_response::base_class_properties props,
     _err(err)
 { }
 
-request_response::request_response(std::string game_id, std::string req_id, bool success, rapidjson::Value* state_json, std::string err):
+request_response::request_response(std::string game_id, std::string req_id, bool success, rapidjson::Document* state_json, std::string err):
     server_response(server_response::create_base_class_properties(ResponseType::req_response, game_id)),
     _req_id(req_id),
     _state_json(state_json),
@@ -49,8 +45,30 @@ void request_response::write_into_json(rapidjson::Value &json,
     json.AddMember("success", _success, allocator);
 
     if (_state_json != nullptr) {
-        json.AddMember("state_json", *_state_json, allocator);
+        // copied, so that the response can be serialized more than once (e.g. for the json writer)
+        rapidjson::Value state_val(*_state_json, allocator);
+        json.AddMember("state_json", state_val, allocator);
+    }
+}
+
+void request_response::write_into_writer(json_writer& writer) const {
+    writer.StartObject();
+    write_properties_into_writer(writer);
+
+    writer.Key("err");
+    writer.String(_err.c_str());
+
+    writer.Key("req_id");
+    writer.String(_req_id.c_str());
+
+    writer.Key("success");
+    writer.Bool(_success);
+
+    if (_state_json != nullptr) {
+        writer.Key("state_json");
+        _state_json->Accept(writer);
     }
+    writer.EndObject();
 }
 
 
@@ -58,7 +76,7 @@ request_response *request_response::from_json(const rapidjson::Value& json) {
     if (json.HasMember("err") && json.HasMember("success")) {
         std::string err = json["err"].GetString();
 
-        rapidjson::Value* state_json = nullptr;
+        rapidjson::Document* state_json = nullptr;
         if (json.HasMember("state_json")) {
             state_json = json_utils::clone_value(json["state_json"].GetObject());
         }
@@ -72,22 +90,3 @@ request_response *request_response::from_json(const rapidjson::Value& json) {
         throw WizardException("Could not parse request_response from json. err or success is missing.");
     }
 }
-
-#ifdef WIZARD_CLIENT
-
-void request_response::Process() const {
-    if (_success) {
-        if (this->_state_json != nullptr) {
-            game_state* state = game_state::from_json(*_state_json);
-            GameController::updateGameState(state);
-
-        } else {
-            GameController::showError("Network error", "Expected a state as JSON inside the request_response. But there was none.");
-        }
-    } else {
-        GameController::showError("Not possible", _err);
-    }
-
-}
-
-#endif
@@ -5,6 +5,7 @@
 #include "server_response.h"
 #include "request_response.h"
 #include "full_state_response.h"
+#include "state_diff_response.h"
 
 #include "../../exceptions/WizardException.h"
 
@@ -58,22 +59,30 @@ server_response::base_class_properties server_response::extract_base_class_prope
 }
 
 
+ResponseType server_response::type_of(const rapidjson::Value& json) {
+    if (json.HasMember("type") && json["type"].IsString()) {
+        const auto it = server_response::_string_to_response_type.find(json["type"].GetString());
+        if (it != server_response::_string_to_response_type.end()) {
+            return it->second;
+        }
+        throw WizardException("Encountered unknown ServerResponse type " + std::string(json["type"].GetString()));
+    }
+    throw WizardException("Could not determine type of ServerResponse");
+}
+
 server_response *server_response::from_json(const rapidjson::Value& json) {
 
-    if (json.HasMember("type") && json["type"].IsString()) {
-        std::string type = json["type"].GetString();
-        ResponseType response_type = server_response::_string_to_response_type.at(type);
+    ResponseType response_type = server_response::type_of(json);
 
-        if (response_type == ResponseType::req_response) {
-            return request_response::from_json(json);
-        }
-        else if (response_type == ResponseType::full_state_msg) {
-            return full_state_response::from_json(json);
-        } else {
-            throw WizardException("Encountered unknown ServerResponse type " + std::to_string(response_type));
-        }
+    if (response_type == ResponseType::req_response) {
+        return request_response::from_json(json);
+    }
+    else if (response_type == ResponseType::full_state_msg) {
+        return full_state_response::from_json(json);
+    }
+    else {
+        return state_diff_response::from_json(json);
     }
-    throw WizardException("Could not determine type of ClientRequest");
 }
 
 void server_response::write_into_json(rapidjson::Value &json,
@@ -85,5 +94,13 @@ void server_response::write_into_json(rapidjson::Value &json,
     json.AddMember("game_id", game_id_val, allocator);
 }
 
+void server_response::write_properties_into_writer(json_writer& writer) const {
+    writer.Key("type");
+    writer.String(_response_type_to_string.at(this->_type).c_str());
+
+    writer.Key("game_id");
+    writer.String(_game_id.c_str());
+}
+
 
 
@@ -42,20 +42,23 @@ protected:
     static base_class_properties create_base_class_properties(ResponseType type, const std::string& game_id);
     static base_class_properties extract_base_class_properties(const rapidjson::Value& json);
 
+    // writes the members written by write_into_json() to an object that is being written to 'writer'
+    void write_properties_into_writer(json_writer& writer) const;
+
 public:
     ResponseType get_type() const;
     std::string get_game_id() const;
 
+    // Gets the type of the server_response serialized in the provided json.
+    // Throws exception if the type is missing or unknown.
+    static ResponseType type_of(const rapidjson::Value& json);
+
     // Tries to create the specific server_response from the provided json.
     // Throws exception if parsing fails -> Use only inside "try{ }catch()" block
     static server_response* from_json(const rapidjson::Value& json);
 
     // Serializes the server_response into a json object that can be sent over the network
     virtual void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
-
-#ifdef WIZARD_CLIENT
-    virtual void Process() const = 0;
-#endif
 };
 
 
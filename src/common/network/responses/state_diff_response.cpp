@@ -0,0 +1,65 @@
+//
+// A state_diff_response carries only the changes of a game_state since the previous state update of that game.
+// Clients apply it to the game_state they currently hold (see game_state::apply_diff()).
+
+#include "state_diff_response.h"
+
+#include "../../exceptions/WizardException.h"
+#include "../../serialization/json_utils.h"
+
+state_diff_response::state_diff_response(server_response::base_class_properties props, rapidjson::Document* diff_json) :
+        server_response(props),
+        _diff_json(diff_json)
+{ }
+
+state_diff_response::state_diff_response(std::string game_id, const game_state& state) :
+        server_response(server_response::create_base_class_properties(ResponseType::state_diff_msg, game_id)),
+        _state(&state)
+{ }
+
+
+void state_diff_response::write_into_json(rapidjson::Value &json,
+                                          rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> &allocator) const {
+    server_response::write_into_json(json, allocator);
+    if (_state != nullptr) {
+        // the hands of all players are redacted, the server splices in the receiving player's hand (see state_view)
+        rapidjson::Value diff_val(rapidjson::kObjectType);
+        _state->write_diff_view_into_json(diff_val, allocator, nullptr);
+        json.AddMember("diff_json", diff_val, allocator);
+    } else {
+        rapidjson::Value diff_val(*_diff_json, allocator);
+        json.AddMember("diff_json", diff_val, allocator);
+    }
+}
+
+void state_diff_response::write_into_writer(json_writer& writer) const {
+    writer.StartObject();
+    write_properties_into_writer(writer);
+    writer.Key("diff_json");
+    if (_state != nullptr) {
+        _state->write_diff_view_into_writer(writer, nullptr);
+    } else {
+        _diff_json->Accept(writer);
+    }
+    writer.EndObject();
+}
+
+state_diff_response *state_diff_response::from_json(const rapidjson::Value& json) {
+    if (json.HasMember("diff_json")) {
+        return new state_diff_response(server_response::extract_base_class_properties(json),
+                                       json_utils::clone_value(json["diff_json"].GetObject()));
+    } else {
+        throw WizardException("Could not parse state_diff_response from json. diff is missing.");
+    }
+}
+
+state_diff_response::~state_diff_response() {
+    if (_diff_json != nullptr) {
+        delete _diff_json;
+        _diff_json = nullptr;
+    }
+}
+
+rapidjson::Value* state_diff_response::get_diff_json() const {
+    return _diff_json;
+}
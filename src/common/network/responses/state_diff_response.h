@@ -0,0 +1,40 @@
+//
+// A state_diff_response carries only the changes of a game_state since the previous state update of that game.
+// Clients apply it to the game_state they currently hold (see game_state::apply_diff()).
+
+#ifndef WIZARD_STATE_DIFF_RESPONSE_H
+#define WIZARD_STATE_DIFF_RESPONSE_H
+
+#include "server_response.h"
+#include "../../game_state/game_state.h"
+
+class state_diff_response : public server_response {
+private:
+    rapidjson::Document* _diff_json = nullptr;      // the deserialized diff
+    const game_state* _state = nullptr;             // the state whose changes are serialized (on the server)
+
+    /*
+     * Private constructor for deserialization
+     */
+    state_diff_response(base_class_properties props, rapidjson::Document* diff_json);
+
+public:
+
+    /*
+     * Creates the diff of all changes of 'state' since its last call to game_state::clear_dirty(). The hands of all
+     * players are redacted in the diff. The diff is only serialized when the response is, so 'state' must not change
+     * until then.
+     */
+    state_diff_response(std::string game_id, const game_state& state);
+    ~state_diff_response();
+
+    // the deserialized diff, nullptr if the response was created from a game_state
+    rapidjson::Value* get_diff_json() const;
+
+    virtual void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override;
+    void write_into_writer(json_writer& writer) const override;
+    static state_diff_response* from_json(const rapidjson::Value& json);
+};
+
+
+#endif //WIZARD_STATE_DIFF_RESPONSE_H
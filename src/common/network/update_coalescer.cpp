@@ -0,0 +1,54 @@
+//
+// The update_coalescer hands the updates decoded by the network thread of a client to its GUI thread.
+//
+
+#include "update_coalescer.h"
+
+update_coalescer::~update_coalescer() {
+    for (const response_decoder::update& pending : _pending) {
+        response_decoder::delete_state(pending.state);
+    }
+}
+
+bool update_coalescer::can_replace(const response_decoder::update& pending, const response_decoder::update& next) {
+    if (pending.state == nullptr || pending.resync || !pending.error.empty()
+        || next.state == nullptr || next.resync || !next.error.empty()) {
+        return false;
+    }
+    return pending.state->get_id() == next.state->get_id()
+           && pending.state->get_round_number() == next.state->get_round_number()
+           && pending.state->get_trick_number() == next.state->get_trick_number();
+}
+
+bool update_coalescer::push(response_decoder::update next) {
+    game_state* replaced = nullptr;
+    bool was_empty;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        was_empty = _pending.empty();
+        if (!was_empty && can_replace(_pending.back(), next)) {
+            replaced = _pending.back().state;
+            _pending.back().state = next.state;
+        } else {
+            _pending.push_back(std::move(next));
+        }
+    }
+    // the replaced state is deleted outside the lock, so that popping never waits for it
+    response_decoder::delete_state(replaced);
+    return was_empty;
+}
+
+bool update_coalescer::pop(response_decoder::update& next) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pending.empty()) {
+        return false;
+    }
+    next = std::move(_pending.front());
+    _pending.pop_front();
+    return true;
+}
+
+size_t update_coalescer::get_nof_pending() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending.size();
+}
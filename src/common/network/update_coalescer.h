@@ -0,0 +1,63 @@
+//
+// The update_coalescer hands the updates decoded by the network thread of a client to its GUI thread.
+//
+
+#ifndef WIZARD_UPDATE_COALESCER_H
+#define WIZARD_UPDATE_COALESCER_H
+
+#include <deque>
+#include <mutex>
+
+#include "response_decoder.h"
+
+/**
+ * @class update_coalescer
+ * @brief Queues the updates of the client's game state until the GUI shows them, keeping only the latest of a trick.
+ *
+ * If game states arrive faster than the GUI shows them (e.g. when bots play, or while the GUI shows a dialog), a new
+ * game state replaces the pending one instead of being queued behind it, so the GUI only builds its panels for the
+ * latest state. The GUI derives the dialogs at the end of a trick or round from the state it shows and the next one
+ * (see GameController::updateGameState()), so states are only replaced within the same trick of the same round: the
+ * last state of every trick is always shown, followed by a state of the next trick, whose last trick is the completed
+ * one. Updates that ask for a resync or carry an error are never replaced.
+ *
+ * One thread pushes the updates, another one pops them.
+ */
+class update_coalescer {
+
+private:
+    std::mutex _mutex;
+    std::deque<response_decoder::update> _pending;
+
+    // whether 'next' may replace 'pending' instead of being queued behind it
+    static bool can_replace(const response_decoder::update& pending, const response_decoder::update& next);
+
+public:
+    update_coalescer() = default;
+    ~update_coalescer();
+
+    update_coalescer(const update_coalescer&) = delete;
+    update_coalescer& operator=(const update_coalescer&) = delete;
+
+    /**
+     * @brief Queues an update, or replaces the pending state with the state of the update.
+     * @param next The update. The coalescer owns its state until it is popped.
+     * @return Whether no updates were pending before, i.e. whether the GUI has to be told about them.
+     */
+    bool push(response_decoder::update next);
+
+    /**
+     * @brief Takes the oldest pending update.
+     * @param next Set to the update, whose state is then owned by the caller.
+     * @return Whether an update was pending.
+     */
+    bool pop(response_decoder::update& next);
+
+    /**
+     * @brief Gets the number of pending updates.
+     * @return The number of updates that were pushed but not popped yet, after replacing states.
+     */
+    size_t get_nof_pending();
+};
+
+#endif //WIZARD_UPDATE_COALESCER_H
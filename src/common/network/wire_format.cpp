@@ -0,0 +1,113 @@
+//
+// Framing of the messages exchanged between client and server.
+//
+
+#include "wire_format.h"
+
+#include "../exceptions/WizardException.h"
+#include "../serialization/binary_codec.h"
+#include "../serialization/json_utils.h"
+
+std::string wire_format::encode(const rapidjson::Value& json, encoding enc) {
+    if (enc == encoding::binary) {
+        return binary_codec::encode(json);
+    }
+    return json_utils::to_string(&json);
+}
+
+void wire_format::decode(const char* payload, size_t size, encoding enc, rapidjson::Document& json) {
+    if (enc == encoding::binary) {
+        binary_codec::decode(payload, size, json);
+        return;
+    }
+    json.Parse(payload, size);
+    if (json.HasParseError()) {
+        throw WizardException("Failed to parse json message");
+    }
+}
+
+std::string wire_format::make_frame(const std::string& payload, encoding enc) {
+    std::string frame;
+    frame.reserve(max_header_size + payload.size());
+    append_header(frame, payload.size(), enc);
+    frame.append(payload);
+    return frame;
+}
+
+std::string wire_format::make_frame(const serializable& obj, encoding enc) {
+    if (enc == encoding::binary) {
+        // the binary_codec builds its string table from the whole message, so it needs the document
+        rapidjson::Document* json = obj.to_json();
+        std::string frame = make_frame(binary_codec::encode(*json), enc);
+        delete json;
+        return frame;
+    }
+    thread_local rapidjson::StringBuffer buffer;
+    buffer.Clear();
+    json_writer writer(buffer);
+    obj.write_into_writer(writer);
+
+    std::string frame;
+    frame.reserve(max_header_size + buffer.GetSize());
+    append_header(frame, buffer.GetSize(), enc);
+    frame.append(buffer.GetString(), buffer.GetSize());
+    return frame;
+}
+
+void wire_format::append_header(std::string& frame, size_t payload_size, encoding enc) {
+    if (enc == encoding::binary) {
+        frame.push_back(static_cast<char>(binary_marker));
+        const auto size = static_cast<uint32_t>(payload_size);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            frame.push_back(static_cast<char>((size >> shift) & 0xff));
+        }
+    } else {
+        frame.append(std::to_string(payload_size));
+        frame.push_back(':');
+    }
+}
+
+wire_format::frame_status wire_format::find_frame(const char* data, size_t size, encoding& enc,
+                                                  size_t& payload_offset, size_t& payload_size) {
+    if (size == 0) {
+        return frame_status::incomplete;
+    }
+
+    if (static_cast<unsigned char>(data[0]) == binary_marker) {
+        if (size < binary_header_size) {
+            return frame_status::incomplete;
+        }
+        uint32_t length = 0;
+        for (size_t i = 1; i < binary_header_size; i++) {
+            length = (length << 8) | static_cast<unsigned char>(data[i]);
+        }
+        if (length > max_payload_size) {
+            return frame_status::malformed;
+        }
+        enc = encoding::binary;
+        payload_offset = binary_header_size;
+        payload_size = length;
+        return size - binary_header_size >= length ? frame_status::complete : frame_status::incomplete;
+    }
+
+    // json frame: decimal length followed by ':'
+    size_t length = 0;
+    size_t pos = 0;
+    while (pos < size && data[pos] != ':') {
+        if (data[pos] < '0' || data[pos] > '9' || pos >= 10) {
+            return frame_status::malformed;
+        }
+        length = length * 10 + (data[pos] - '0');
+        pos++;
+    }
+    if (pos == size) {
+        return frame_status::incomplete;
+    }
+    if (pos == 0 || length > max_payload_size) {
+        return frame_status::malformed;
+    }
+    enc = encoding::json;
+    payload_offset = pos + 1;
+    payload_size = length;
+    return size - payload_offset >= length ? frame_status::complete : frame_status::incomplete;
+}
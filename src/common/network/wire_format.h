@@ -0,0 +1,58 @@
+//
+// Framing of the messages exchanged between client and server.
+//
+// Two encodings are supported on the same port:
+//   - json:   "<length>:<json>", where the length is written in decimal digits (easy to read while debugging)
+//   - binary: a marker byte, the payload length as 4 byte big endian integer, and the payload encoded by binary_codec
+// The encoding is negotiated implicitly: the server detects it from the first byte of every frame and answers every
+// client in the encoding of the client's requests.
+
+#ifndef WIZARD_WIRE_FORMAT_H
+#define WIZARD_WIRE_FORMAT_H
+
+#include <string>
+
+#include "../../rapidjson/include/rapidjson/document.h"
+#include "../serialization/serializable.h"
+
+class wire_format {
+public:
+    enum class encoding {
+        json,
+        binary
+    };
+
+    enum class frame_status {
+        complete,
+        incomplete,     // more bytes are needed to read the frame
+        malformed
+    };
+
+    static constexpr unsigned char binary_marker = 0xB1;        // never a decimal digit, which starts json frames
+    static constexpr size_t binary_header_size = 5;
+    static constexpr size_t max_header_size = 12;               // room reserved for the header of a frame
+    static constexpr size_t max_payload_size = 64 * 1024 * 1024;
+
+    // serializes 'json' in the given encoding (without frame header)
+    static std::string encode(const rapidjson::Value& json, encoding enc);
+
+    // parses a payload in the given encoding, throws a WizardException if it is invalid
+    static void decode(const char* payload, size_t size, encoding enc, rapidjson::Document& json);
+
+    // prepends the frame header for the given encoding to 'payload'
+    static std::string make_frame(const std::string& payload, encoding enc);
+
+    // Serializes 'obj' into a frame in the given encoding. Json frames are written straight from the object into a
+    // reused buffer of the calling thread (see serializable::write_into_writer()), without building a document first.
+    static std::string make_frame(const serializable& obj, encoding enc);
+
+    // appends the frame header for a payload of 'payload_size' bytes in the given encoding to 'frame'
+    static void append_header(std::string& frame, size_t payload_size, encoding enc);
+
+    // Looks for a frame at the start of 'data'. If a complete frame is found, 'enc' is set to its encoding, and the
+    // payload starts at 'payload_offset' and is 'payload_size' bytes long.
+    static frame_status find_frame(const char* data, size_t size, encoding& enc,
+                                   size_t& payload_offset, size_t& payload_size);
+};
+
+#endif //WIZARD_WIRE_FORMAT_H
@@ -0,0 +1,485 @@
+//
+// Compact binary encoding of the json messages exchanged between client and server.
+//
+
+#include "binary_codec.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+
+#include "../exceptions/WizardException.h"
+
+namespace {
+
+    // Type tags of encoded values. Tags from 'small_int_tag' on encode the integers 0 to 127 directly.
+    enum tag : uint8_t {
+        null_tag = 0,
+        false_tag,
+        true_tag,
+        int_tag,            // zigzag varint
+        uint64_tag,         // varint, only for integers that do not fit into int64_t
+        double_tag,         // 8 bytes, little endian
+        string_tag,         // varint length, bytes
+        uuid_tag,           // 16 bytes
+        table_string_tag,   // varint index into the string table of the message
+        known_string_tag,   // varint index into the known strings
+        object_tag,         // varint number of members, (key, value) pairs
+        array_tag,          // varint number of elements, values
+        value_object_tag,   // {"value": x}, followed by x
+        small_int_tag = 0x80
+    };
+
+    // Keys and string values used by the serialization of the game state, the requests and the responses.
+    // Entries are only ever appended, since clients and servers of different versions rely on the indices.
+    constexpr auto known_strings = std::to_array<const char*>({
+            "id", "value", "type", "req_id", "player_id", "game_id", "success", "err", "state_json", "diff_json",
+            "players", "player_name", "nof_tricks", "nof_predicted", "scores", "has_left_game", "hand", "cards",
+            "nof_cards", "card", "player", "color", "deck", "all_cards", "remaining_cards", "trick", "last_trick",
+            "trick_color", "trump_color", "cards_from", "is_finished", "is_started", "is_estimation_phase",
+            "round_number", "trick_number", "starting_player_idx", "trick_starting_player_idx", "current_player_idx",
+            "trump_card_value", "trick_estimate_sum", "version", "base_version", "player_diffs", "card_id",
+            "estimate_tricks",
+            // request and response types
+            "join_game", "start_game", "play_card", "leave_game", "resync",
+            "req_response", "state_diff_msg", "full_state_msg",
+            ""
+    });
+
+    constexpr size_t max_known_string_length = []() {
+        size_t res = 0;
+        for (const char* str : known_strings) {
+            res = std::max(res, std::char_traits<char>::length(str));
+        }
+        return res;
+    }();
+
+    constexpr int max_depth = 64;
+
+    void write_varint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    int hex_value(char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    bool is_value_object(const rapidjson::Value& value) {
+        return value.IsObject() && value.MemberCount() == 1
+               && std::strcmp(value.MemberBegin()->name.GetString(), "value") == 0
+               && value.MemberBegin()->name.GetStringLength() == 5;
+    }
+
+    // Reads an encoded message. Every read is bounds checked, since the data comes from the network.
+    class reader {
+    private:
+        const uint8_t* _pos;
+        const uint8_t* _end;
+        rapidjson::Document::AllocatorType& _allocator;
+        std::vector<rapidjson::Value> _table;
+
+        static void fail(const char* what) {
+            throw WizardException(std::string("Failed to decode binary message: ") + what);
+        }
+
+        uint8_t read_byte() {
+            if (_pos >= _end) {
+                fail("unexpected end of message");
+            }
+            return *_pos++;
+        }
+
+        uint64_t read_varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t byte = read_byte();
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            fail("invalid varint");
+            return 0;
+        }
+
+        size_t read_size() {
+            const uint64_t size = read_varint();
+            if (size > static_cast<uint64_t>(_end - _pos)) {
+                fail("size exceeds message");
+            }
+            return static_cast<size_t>(size);
+        }
+
+        rapidjson::Value read_string_data(uint8_t t) {
+            if (t == string_tag) {
+                const size_t length = read_size();
+                rapidjson::Value str(reinterpret_cast<const char*>(_pos), static_cast<rapidjson::SizeType>(length),
+                                     _allocator);
+                _pos += length;
+                return str;
+            }
+            if (t == uuid_tag) {
+                if (_end - _pos < 16) {
+                    fail("unexpected end of uuid");
+                }
+                static const char* digits = "0123456789abcdef";
+                char uuid[36];
+                int out = 0;
+                for (int i = 0; i < 16; i++) {
+                    if (out == 8 || out == 13 || out == 18 || out == 23) {
+                        uuid[out++] = '-';
+                    }
+                    uuid[out++] = digits[_pos[i] >> 4];
+                    uuid[out++] = digits[_pos[i] & 0x0f];
+                }
+                _pos += 16;
+                return {uuid, 36, _allocator};
+            }
+            fail("invalid string");
+            return {};
+        }
+
+        rapidjson::Value read_key() {
+            const uint64_t index = read_varint();
+            if (index == 0) {
+                return read_string_data(string_tag);
+            }
+            if (index > known_strings.size()) {
+                fail("unknown key");
+            }
+            return rapidjson::Value(rapidjson::StringRef(known_strings[index - 1]));
+        }
+
+    public:
+        reader(const char* data, size_t size, rapidjson::Document::AllocatorType& allocator) :
+                _pos(reinterpret_cast<const uint8_t*>(data)),
+                _end(reinterpret_cast<const uint8_t*>(data) + size),
+                _allocator(allocator)
+        { }
+
+        void read_table() {
+            const size_t nof_strings = read_size();
+            _table.reserve(nof_strings);
+            for (size_t i = 0; i < nof_strings; i++) {
+                _table.push_back(read_string_data(read_byte()));
+            }
+        }
+
+        rapidjson::Value read_value(int depth) {
+            if (depth > max_depth) {
+                fail("nested too deeply");
+            }
+            const uint8_t t = read_byte();
+            if (t >= small_int_tag) {
+                return rapidjson::Value(static_cast<int64_t>(t - small_int_tag));
+            }
+            switch (t) {
+                case null_tag:
+                    return rapidjson::Value(rapidjson::kNullType);
+                case false_tag:
+                    return rapidjson::Value(false);
+                case true_tag:
+                    return rapidjson::Value(true);
+                case int_tag: {
+                    const uint64_t zigzag = read_varint();
+                    return rapidjson::Value(static_cast<int64_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1)));
+                }
+                case uint64_tag:
+                    return rapidjson::Value(read_varint());
+                case double_tag: {
+                    uint64_t bits = 0;
+                    for (int i = 0; i < 8; i++) {
+                        bits |= static_cast<uint64_t>(read_byte()) << (8 * i);
+                    }
+                    double d;
+                    std::memcpy(&d, &bits, sizeof(d));
+                    return rapidjson::Value(d);
+                }
+                case string_tag:
+                case uuid_tag:
+                    return read_string_data(t);
+                case table_string_tag: {
+                    const uint64_t index = read_varint();
+                    if (index >= _table.size()) {
+                        fail("invalid string table index");
+                    }
+                    return {_table[index], _allocator};
+                }
+                case known_string_tag: {
+                    const uint64_t index = read_varint();
+                    if (index >= known_strings.size()) {
+                        fail("unknown string");
+                    }
+                    return rapidjson::Value(rapidjson::StringRef(known_strings[index]));
+                }
+                case object_tag: {
+                    const size_t nof_members = read_size();
+                    rapidjson::Value obj(rapidjson::kObjectType);
+                    obj.MemberReserve(static_cast<rapidjson::SizeType>(nof_members), _allocator);
+                    for (size_t i = 0; i < nof_members; i++) {
+                        rapidjson::Value key = read_key();
+                        rapidjson::Value val = read_value(depth + 1);
+                        obj.AddMember(key, val, _allocator);
+                    }
+                    return obj;
+                }
+                case array_tag: {
+                    const size_t nof_elements = read_size();
+                    rapidjson::Value arr(rapidjson::kArrayType);
+                    arr.Reserve(static_cast<rapidjson::SizeType>(nof_elements), _allocator);
+                    for (size_t i = 0; i < nof_elements; i++) {
+                        rapidjson::Value val = read_value(depth + 1);
+                        arr.PushBack(val, _allocator);
+                    }
+                    return arr;
+                }
+                case value_object_tag: {
+                    rapidjson::Value obj(rapidjson::kObjectType);
+                    rapidjson::Value val = read_value(depth + 1);
+                    obj.AddMember("value", val, _allocator);
+                    return obj;
+                }
+                default:
+                    fail("unknown type tag");
+                    return {};
+            }
+        }
+
+        [[nodiscard]] bool at_end() const {
+            return _pos == _end;
+        }
+    };
+
+    // collects the string values that could be interned, in order of their occurrence
+    void collect_strings(const rapidjson::Value& value, std::vector<std::pair<std::string_view, uint32_t>>& strings) {
+        if (value.IsString()) {
+            const std::string_view str(value.GetString(), value.GetStringLength());
+            if (str.size() > 2 && binary_codec::find_known_string(str) < 0) {
+                strings.emplace_back(str, static_cast<uint32_t>(strings.size()));
+            }
+        } else if (value.IsObject()) {
+            for (auto& member : value.GetObject()) {
+                collect_strings(member.value, strings);
+            }
+        } else if (value.IsArray()) {
+            for (auto& element : value.GetArray()) {
+                collect_strings(element, strings);
+            }
+        }
+    }
+}
+
+int binary_codec::find_known_string(std::string_view str) {
+    if (str.size() > max_known_string_length) {
+        return -1;
+    }
+    static const std::unordered_map<std::string_view, int> index = []() {
+        std::unordered_map<std::string_view, int> res;
+        for (int i = 0; i < static_cast<int>(known_strings.size()); i++) {
+            res.emplace(known_strings[i], i);
+        }
+        return res;
+    }();
+    const auto it = index.find(str);
+    return it == index.end() ? -1 : it->second;
+}
+
+bool binary_codec::is_uuid(std::string_view str) {
+    if (str.size() != 36) {
+        return false;
+    }
+    for (size_t i = 0; i < str.size(); i++) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (str[i] != '-') {
+                return false;
+            }
+        } else if (hex_value(str[i]) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+binary_codec::encoder::encoder(const rapidjson::Value& message) {
+    // sorting the strings groups equal strings, messages are too small for a hash map to pay off
+    std::vector<std::pair<std::string_view, uint32_t>> strings;
+    collect_strings(message, strings);
+    std::sort(strings.begin(), strings.end());
+
+    // strings that occur more than once, by their first occurrence
+    std::vector<std::pair<uint32_t, std::string_view>> repeated;
+    for (size_t i = 0; i < strings.size(); ) {
+        size_t j = i + 1;
+        while (j < strings.size() && strings[j].first == strings[i].first) {
+            j++;
+        }
+        if (j - i > 1) {
+            repeated.emplace_back(strings[i].second, strings[i].first);
+        }
+        i = j;
+    }
+    std::sort(repeated.begin(), repeated.end());
+
+    _table.reserve(repeated.size());
+    _table_index.reserve(repeated.size());
+    for (const auto& [first_occurrence, str] : repeated) {
+        _table_index.emplace_back(str, static_cast<uint32_t>(_table.size()));
+        _table.push_back(str);
+    }
+    std::sort(_table_index.begin(), _table_index.end());
+}
+
+void binary_codec::encoder::write_string(std::string& out, std::string_view str, bool use_table) const {
+    const int known = find_known_string(str);
+    if (known >= 0) {
+        out.push_back(static_cast<char>(known_string_tag));
+        write_varint(out, known);
+        return;
+    }
+    if (use_table && !_table_index.empty()) {
+        const auto it = std::lower_bound(_table_index.begin(), _table_index.end(), str,
+                                         [](const auto& entry, std::string_view s) { return entry.first < s; });
+        if (it != _table_index.end() && it->first == str) {
+            out.push_back(static_cast<char>(table_string_tag));
+            write_varint(out, it->second);
+            return;
+        }
+    }
+    if (is_uuid(str)) {
+        out.push_back(static_cast<char>(uuid_tag));
+        uint8_t byte = 0;
+        bool high = true;
+        for (char c : str) {
+            if (c == '-') {
+                continue;
+            }
+            if (high) {
+                byte = static_cast<uint8_t>(hex_value(c) << 4);
+            } else {
+                out.push_back(static_cast<char>(byte | hex_value(c)));
+            }
+            high = !high;
+        }
+        return;
+    }
+    out.push_back(static_cast<char>(string_tag));
+    write_varint(out, str.size());
+    out.append(str);
+}
+
+void binary_codec::encoder::write_key(std::string& out, std::string_view key) const {
+    const int known = find_known_string(key);
+    if (known >= 0) {
+        write_varint(out, known + 1);
+    } else {
+        write_varint(out, 0);
+        write_varint(out, key.size());
+        out.append(key);
+    }
+}
+
+void binary_codec::encoder::write_value(std::string& out, const rapidjson::Value& value) const {
+    switch (value.GetType()) {
+        case rapidjson::kNullType:
+            out.push_back(static_cast<char>(null_tag));
+            break;
+        case rapidjson::kFalseType:
+            out.push_back(static_cast<char>(false_tag));
+            break;
+        case rapidjson::kTrueType:
+            out.push_back(static_cast<char>(true_tag));
+            break;
+        case rapidjson::kNumberType:
+            if (value.IsInt64()) {
+                const int64_t i = value.GetInt64();
+                if (i >= 0 && i < 0x80) {
+                    out.push_back(static_cast<char>(small_int_tag + i));
+                } else {
+                    out.push_back(static_cast<char>(int_tag));
+                    write_varint(out, (static_cast<uint64_t>(i) << 1) ^ static_cast<uint64_t>(i >> 63));
+                }
+            } else if (value.IsUint64()) {
+                out.push_back(static_cast<char>(uint64_tag));
+                write_varint(out, value.GetUint64());
+            } else {
+                out.push_back(static_cast<char>(double_tag));
+                uint64_t bits;
+                const double d = value.GetDouble();
+                std::memcpy(&bits, &d, sizeof(bits));
+                for (int i = 0; i < 8; i++) {
+                    out.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+                }
+            }
+            break;
+        case rapidjson::kStringType:
+            write_string(out, std::string_view(value.GetString(), value.GetStringLength()), true);
+            break;
+        case rapidjson::kObjectType:
+            if (is_value_object(value)) {
+                out.push_back(static_cast<char>(value_object_tag));
+                write_value(out, value.MemberBegin()->value);
+            } else {
+                out.push_back(static_cast<char>(object_tag));
+                write_varint(out, value.MemberCount());
+                for (auto& member : value.GetObject()) {
+                    write_key(out, std::string_view(member.name.GetString(), member.name.GetStringLength()));
+                    write_value(out, member.value);
+                }
+            }
+            break;
+        case rapidjson::kArrayType:
+            out.push_back(static_cast<char>(array_tag));
+            write_varint(out, value.Size());
+            for (auto& element : value.GetArray()) {
+                write_value(out, element);
+            }
+            break;
+    }
+}
+
+std::string binary_codec::encoder::encode_message(const rapidjson::Value& message) const {
+    std::string out;
+    out.reserve(512);
+    write_varint(out, _table.size());
+    for (const auto& str : _table) {
+        write_string(out, str, false);
+    }
+    write_value(out, message);
+    return out;
+}
+
+std::string binary_codec::encoder::encode_value(const rapidjson::Value& value) const {
+    std::string out;
+    write_value(out, value);
+    return out;
+}
+
+std::string binary_codec::encode(const rapidjson::Value& json) {
+    return encoder(json).encode_message(json);
+}
+
+void binary_codec::decode(const char* data, size_t size, rapidjson::Document& json) {
+    decode(data, size, json, json.GetAllocator());
+}
+
+void binary_codec::decode(const char* data, size_t size, rapidjson::Value& json,
+                          rapidjson::Document::AllocatorType& allocator) {
+    reader r(data, size, allocator);
+    r.read_table();
+    rapidjson::Value root = r.read_value(0);
+    if (!r.at_end()) {
+        throw WizardException("Failed to decode binary message: unexpected data after message");
+    }
+    json = root;
+}
@@ -0,0 +1,68 @@
+//
+// Compact binary encoding of the json messages exchanged between client and server.
+//
+// Every client_request and server_response is first written into a rapidjson document (see serializable). Instead of
+// printing that document as json text, the binary_codec encodes the same document more compactly:
+//   - integers are zigzag varints, small non-negative integers fit into the type tag itself
+//   - {"value": x} wrappers (which older versions wrote for every serializable_value) are encoded as a single tag
+//     followed by x
+//   - object keys and well-known strings (e.g. request types) are indices into a fixed dictionary
+//   - uuids (all ids of cards, players, games, ...) are sent as their 16 raw bytes
+//   - strings that occur more than once in a message are interned in a table at the start of the message
+// Decoding restores an identical rapidjson document, so all from_json() functions work unchanged.
+
+#ifndef WIZARD_BINARY_CODEC_H
+#define WIZARD_BINARY_CODEC_H
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../../rapidjson/include/rapidjson/document.h"
+
+class binary_codec {
+public:
+
+    /*
+     * Encodes one message. The string table is built from the whole message when the encoder is constructed, so that
+     * parts of the message (e.g. a player's hand in a state_view) can be encoded separately and spliced into the
+     * encoded message. Parts encoded this way must not contain strings that are not part of the message more than once.
+     */
+    class encoder {
+    private:
+        std::vector<std::string_view> _table;                                   // interned strings of the message
+        std::vector<std::pair<std::string_view, uint32_t>> _table_index;        // table indices, sorted by string
+
+        void write_value(std::string& out, const rapidjson::Value& value) const;
+        void write_string(std::string& out, std::string_view str, bool use_table) const;
+        void write_key(std::string& out, std::string_view key) const;
+
+    public:
+        // 'message' must outlive the encoder
+        explicit encoder(const rapidjson::Value& message);
+
+        // encodes the string table followed by 'message'
+        std::string encode_message(const rapidjson::Value& message) const;
+
+        // encodes a value of the message without the string table
+        std::string encode_value(const rapidjson::Value& value) const;
+    };
+
+    static std::string encode(const rapidjson::Value& json);
+
+    // throws a WizardException if 'data' is not a valid encoded message
+    static void decode(const char* data, size_t size, rapidjson::Document& json);
+
+    // same as above, with all values of the message allocated by 'allocator'
+    static void decode(const char* data, size_t size, rapidjson::Value& json,
+                       rapidjson::Document::AllocatorType& allocator);
+
+    // the index of 'str' in the dictionary of well-known strings, or -1
+    static int find_known_string(std::string_view str);
+
+    // whether 'str' is a lower case uuid as created by the uuid_generator
+    static bool is_uuid(std::string_view str);
+};
+
+#endif //WIZARD_BINARY_CODEC_H
@@ -0,0 +1,136 @@
+//
+// Compact identifier of the objects of the game state (see entity_id.h).
+//
+
+#include "entity_id.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "../game_state/random_generator.h"
+
+namespace {
+    constexpr char hex_digits[] = "0123456789abcdef";
+
+    // the texts of all interned ids, which are never removed
+    struct intern_table {
+        std::shared_mutex lock;
+        std::deque<std::string> texts;      // the strings do not move, so the keys of 'numbers' stay valid
+        std::unordered_map<std::string_view, uint64_t> numbers;
+    };
+
+    intern_table& get_intern_table() {
+        static intern_table table;
+        return table;
+    }
+
+    int hex_value(const char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    // parses a lower case uuid xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+    bool try_parse_uuid(const std::string_view text, entity_id& id) {
+        if (text.size() != 36) {
+            return false;
+        }
+        uint64_t halves[2] = {0, 0};
+        int digit = 0;
+        for (size_t pos = 0; pos < 36; pos++) {
+            if (pos == 8 || pos == 13 || pos == 18 || pos == 23) {
+                if (text[pos] != '-') {
+                    return false;
+                }
+                continue;
+            }
+            const int value = hex_value(text[pos]);
+            if (value < 0) {
+                return false;
+            }
+            halves[digit / 16] = (halves[digit / 16] << 4) | static_cast<uint64_t>(value);
+            digit++;
+        }
+        // of the uuids starting with 16 zeros, only card indices are valid, all others are interned
+        const entity_id parsed {halves[0], halves[1]};
+        if (parsed.high == 0 && !parsed.is_index()) {
+            return false;
+        }
+        id = parsed;
+        return true;
+    }
+}
+
+entity_id entity_id::generate() {
+    random_generator& rng = random_generator::thread_instance();
+    entity_id id {rng.next(), rng.next()};
+    // format xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx, where y is one of 8, 9, a, b (the version 4 makes 'high' non-zero)
+    id.high = (id.high & ~uint64_t(0xf000)) | 0x4000;
+    id.low = (id.low & ~(uint64_t(0xc) << 60)) | (uint64_t(0x8) << 60);
+    return id;
+}
+
+bool entity_id::try_parse(const std::string_view text, entity_id& id) {
+    if (text.empty()) {
+        id = {};
+        return true;
+    }
+    if (try_parse_uuid(text, id)) {
+        return true;
+    }
+    intern_table& table = get_intern_table();
+    std::shared_lock<std::shared_mutex> guard(table.lock);
+    const auto it = table.numbers.find(text);
+    if (it == table.numbers.end()) {
+        return false;
+    }
+    id = {0, interned_tag | it->second};
+    return true;
+}
+
+entity_id entity_id::from_string(const std::string_view text) {
+    entity_id id;
+    if (try_parse(text, id)) {
+        return id;
+    }
+    intern_table& table = get_intern_table();
+    std::lock_guard<std::shared_mutex> guard(table.lock);
+    auto it = table.numbers.find(text);     // the text may have been interned since try_parse
+    if (it == table.numbers.end()) {
+        const std::string& interned = table.texts.emplace_back(text);
+        it = table.numbers.emplace(interned, table.texts.size() - 1).first;
+    }
+    return {0, interned_tag | it->second};
+}
+
+std::string_view entity_id::to_string_view(text_buffer& buffer) const {
+    if (is_nil()) {
+        return {};
+    }
+    if (high == 0 && (low & interned_tag)) {
+        // the interned strings never change or move, so the view stays valid without the lock
+        intern_table& table = get_intern_table();
+        std::shared_lock<std::shared_mutex> guard(table.lock);
+        return table.texts[low & ~interned_tag];
+    }
+    const uint64_t halves[2] = {high, low};
+    size_t pos = 0;
+    for (int digit = 0; digit < 32; digit++) {
+        if (digit == 8 || digit == 12 || digit == 16 || digit == 20) {
+            buffer[pos++] = '-';
+        }
+        buffer[pos++] = hex_digits[(halves[digit / 16] >> (60 - 4 * (digit % 16))) & 0xf];
+    }
+    return {buffer.data(), buffer.size()};
+}
+
+std::string entity_id::to_string() const {
+    text_buffer buffer;
+    return std::string(to_string_view(buffer));
+}
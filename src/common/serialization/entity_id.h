@@ -0,0 +1,72 @@
+//
+// Compact identifier of the objects of the game state (see unique_serializable).
+// Players, games, hands, tricks, etc. get a random 128 bit id, whose text is a version 4 uuid. The cards of a deck are
+// numbered instead, the text of their id is a uuid starting with 16 zeros and ending with the number, so that the
+// messages (and the binary_codec) see the same kind of ids as before. Ids are only converted from and to text at the
+// edge of the protocol (i.e. when they are serialized or read from a request), comparing and hashing them never touches
+// any text. Other texts (e.g. ids chosen by tests) are interned: they are stored once in a global table, and the id
+// refers to the table entry. The empty text is the nil id.
+//
+
+#ifndef WIZARD_ENTITY_ID_H
+#define WIZARD_ENTITY_ID_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+struct entity_id {
+    uint64_t high = 0;      // the first half of a uuid, 0 for all other ids
+    uint64_t low = 0;       // the second half of a uuid, or the tag and the number of all other ids
+
+    // the storage for the text of an id, large enough for every id that is not interned
+    using text_buffer = std::array<char, 36>;
+
+    // A new random id, drawn from the calling thread's random_generator.
+    static entity_id generate();
+
+    // The id of the card with the given index in its deck.
+    static constexpr entity_id from_index(uint32_t index) { return {0, index_tag | index}; }
+
+    // Parses 'text' into 'id' without interning it. Returns false if 'text' is neither a lower case uuid nor an
+    // interned text, in which case no object has this id.
+    static bool try_parse(std::string_view text, entity_id& id);
+
+    // Parses 'text', which is interned if necessary.
+    static entity_id from_string(std::string_view text);
+
+    // The text of the id. It is written into 'buffer' unless the id is interned, so it is valid as long as 'buffer'.
+    std::string_view to_string_view(text_buffer& buffer) const;
+    std::string to_string() const;
+
+    [[nodiscard]] bool is_nil() const { return high == 0 && low == 0; }
+
+    // Whether the id is a card index (see from_index()), and the index.
+    [[nodiscard]] bool is_index() const { return high == 0 && (low & ~uint64_t(0xffffffff)) == index_tag; }
+    [[nodiscard]] uint32_t get_index() const { return static_cast<uint32_t>(low); }
+
+    friend bool operator==(const entity_id& a, const entity_id& b) = default;
+
+    static constexpr uint64_t index_tag = uint64_t(1) << 62;
+    static constexpr uint64_t interned_tag = uint64_t(1) << 63;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const entity_id& id) {
+    entity_id::text_buffer buffer;
+    return os << id.to_string_view(buffer);
+}
+
+template<>
+struct std::hash<entity_id> {
+    size_t operator()(const entity_id& id) const noexcept {
+        // the bits of random ids are evenly distributed, card indices and interned ids only differ in their low bits
+        const uint64_t h = id.high ^ (id.low * 0x9e3779b97f4a7c15);
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+#endif //WIZARD_ENTITY_ID_H
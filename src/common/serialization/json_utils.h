@@ -11,6 +11,7 @@
 #include "../../rapidjson/include/rapidjson/writer.h"
 #include "../../rapidjson/include/rapidjson/document.h"
 #include "../../rapidjson/include/rapidjson/stringbuffer.h"
+#include "serializable.h"
 
 
 class json_utils {
@@ -23,6 +24,14 @@ public:
         return buffer.GetString();
     }
 
+    // Same as to_string(obj.to_json()), but written straight from the object (see serializable::write_into_writer())
+    static std::string to_string(const serializable& obj) {
+        rapidjson::StringBuffer buffer;
+        json_writer writer(buffer);
+        obj.write_into_writer(writer);
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
     // In case you need to create a rapidjson::Document on the heap (pointer) based on a value extracted from a json.
     static rapidjson::Document* clone_value(const rapidjson::Value& val) {
         rapidjson::Document* state_json = new rapidjson::Document(rapidjson::kObjectType);
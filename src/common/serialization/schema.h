@@ -0,0 +1,214 @@
+//
+// Compile-time description of the scalar members of a serializable class.
+//
+// A class lists its serializable_value members once, each with its json name:
+//
+//     static constexpr schema::fields value_fields {
+//             schema::value_field {"round_number", &game_state::_round_number},
+//             schema::value_field {"is_started", &game_state::_is_started}};
+//
+// and the code that writes them (as plain json values, e.g. "round_number":3), writes only the changed ones into a
+// state diff, reads them back and tracks whether they changed is generated from this list. Members that are objects
+// or arrays (players, hands, cards) are still written by their class, which reads its json object with one
+// member_reader: every member of the object is visited once and handed to the field of the same name, the class
+// handles the members the reader does not know.
+//
+
+#ifndef WIZARD_SCHEMA_H
+#define WIZARD_SCHEMA_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "serializable.h"
+#include "serializable_value.h"
+#include "../exceptions/WizardException.h"
+#include "../../../rapidjson/include/rapidjson/document.h"
+
+namespace schema {
+
+    // the name of a member of a json object
+    inline std::string_view name_of(const rapidjson::Value::Member& member) {
+        return {member.name.GetString(), member.name.GetStringLength()};
+    }
+
+    // The members a class reads itself (ids, arrays and objects) are checked like the fields: a member of the wrong
+    // type throws a WizardException instead of failing rapidjson's assertions. 'name' is only used for the message.
+    template<typename V>
+    V get(const rapidjson::Value& value, const std::string_view name) {
+        if (!value.Is<V>()) {
+            throw WizardException("Could not parse json. '" + std::string(name) + "' has the wrong type.");
+        }
+        return value.Get<V>();
+    }
+
+    inline rapidjson::Value::ConstArray get_array(const rapidjson::Value& value, const std::string_view name) {
+        if (!value.IsArray()) {
+            throw WizardException("Could not parse json. '" + std::string(name) + "' is not an array.");
+        }
+        return value.GetArray();
+    }
+
+    inline rapidjson::Value::ConstObject get_object(const rapidjson::Value& value, const std::string_view name) {
+        if (!value.IsObject()) {
+            throw WizardException("Could not parse json. '" + std::string(name) + "' is not an object.");
+        }
+        return value.GetObject();
+    }
+
+    // the member of an object, which has to exist
+    inline const rapidjson::Value& get_member(const rapidjson::Value& object, const char* name) {
+        const auto obj = get_object(object, name);
+        const auto member = obj.FindMember(name);
+        if (member == obj.MemberEnd()) {
+            throw WizardException("Could not parse json. '" + std::string(name) + "' is missing.");
+        }
+        return member->value;
+    }
+
+    // a member of 'Owner' stored as a serializable_value<T>
+    template<typename Owner, typename T>
+    struct value_field {
+        std::string_view name;
+        serializable_value<T> Owner::* member;
+    };
+
+    template<typename Owner, typename... T>
+    class fields {
+    private:
+        std::tuple<value_field<Owner, T>...> _fields;
+        std::array<std::string_view, sizeof...(T)> _names;
+
+        static_assert(sizeof...(T) <= 64, "the fields that were read are tracked in a 64 bit mask");
+
+        // calls f(field) for every field, in the order of the list
+        template<typename F>
+        constexpr void for_each(F&& f) const {
+            std::apply([&f](const auto&... field) { (f(field), ...); }, _fields);
+        }
+
+        // reads 'value' into the field with the given index
+        template<size_t... I>
+        void read_field(Owner& owner, const size_t index, const rapidjson::Value& value,
+                        std::index_sequence<I...>) const {
+            ((index == I ? read_value(owner, std::get<I>(_fields), value) : void()), ...);
+        }
+
+        template<typename V>
+        static void read_value(Owner& owner, const value_field<Owner, V>& field, const rapidjson::Value& value) {
+            if (!value.Is<V>()) {
+                throw WizardException("Could not parse json. '" + std::string(field.name) + "' has the wrong type.");
+            }
+            (owner.*field.member).set_value(value.Get<V>());
+        }
+
+        template<typename V>
+        static void add_member(const Owner& owner, const value_field<Owner, V>& field, rapidjson::Value& json,
+                               rapidjson::Document::AllocatorType& allocator) {
+            // the names are string literals, so they are not copied
+            json.AddMember(rapidjson::Value(rapidjson::StringRef(field.name.data(),
+                                                                 static_cast<rapidjson::SizeType>(field.name.size()))),
+                           value_type_helpers::get_json_value<V>((owner.*field.member).get_value(), allocator),
+                           allocator);
+        }
+
+        template<typename V>
+        static void write_member(const Owner& owner, const value_field<Owner, V>& field, json_writer& writer) {
+            writer.Key(field.name.data(), static_cast<rapidjson::SizeType>(field.name.size()));
+            value_type_helpers::write_json_value(writer, (owner.*field.member).get_value());
+        }
+
+    public:
+        constexpr explicit fields(value_field<Owner, T>... field) : _fields(field...), _names {field.name...} { }
+
+        // Reads the members of one json object, see the header comment. The members are expected in the order of the
+        // fields (the order they are written in), so each one is usually found by a single comparison.
+        class member_reader {
+        private:
+            const fields& _fields;
+            Owner& _owner;
+            size_t _next = 0;       // the field that is expected next
+            uint64_t _read = 0;     // the fields that were read
+
+        public:
+            member_reader(const fields& fields, Owner& owner) : _fields(fields), _owner(owner) { }
+
+            // Reads the member into the field of the same name. Returns false if there is no such field.
+            bool read(const rapidjson::Value::Member& member) {
+                const std::string_view name = name_of(member);
+                size_t index = _next;
+                if (index >= sizeof...(T) || _fields._names[index] != name) {
+                    index = 0;
+                    while (index < sizeof...(T) && _fields._names[index] != name) {
+                        index++;
+                    }
+                    if (index == sizeof...(T)) {
+                        return false;
+                    }
+                }
+                _fields.read_field(_owner, index, member.value, std::index_sequence_for<T...>());
+                _read |= uint64_t(1) << index;
+                _next = index + 1;
+                return true;
+            }
+
+            // Whether every field was read (i.e. the object was complete).
+            [[nodiscard]] bool has_read_all() const {
+                return _read == (sizeof...(T) == 64 ? ~uint64_t(0) : (uint64_t(1) << sizeof...(T)) - 1);
+            }
+        };
+
+        // Returns a reader that reads the fields of 'owner'.
+        member_reader reader(Owner& owner) const { return member_reader(*this, owner); }
+
+        // Writes all fields into 'json'.
+        void write_into_json(const Owner& owner, rapidjson::Value& json,
+                             rapidjson::Document::AllocatorType& allocator) const {
+            for_each([&](const auto& field) { add_member(owner, field, json, allocator); });
+        }
+
+        // Writes the same json as write_into_json() to 'writer'.
+        void write_into_writer(const Owner& owner, json_writer& writer) const {
+            for_each([&](const auto& field) { write_member(owner, field, writer); });
+        }
+
+        // Writes the fields that changed since the last call to clear_dirty() into 'json'.
+        void write_dirty_into_json(const Owner& owner, rapidjson::Value& json,
+                                   rapidjson::Document::AllocatorType& allocator) const {
+            for_each([&](const auto& field) {
+                if ((owner.*field.member).is_dirty()) {
+                    add_member(owner, field, json, allocator);
+                }
+            });
+        }
+
+        // Writes the same json as write_dirty_into_json() to 'writer'.
+        void write_dirty_into_writer(const Owner& owner, json_writer& writer) const {
+            for_each([&](const auto& field) {
+                if ((owner.*field.member).is_dirty()) {
+                    write_member(owner, field, writer);
+                }
+            });
+        }
+
+        // Whether any field changed since the last call to clear_dirty().
+        bool is_dirty(const Owner& owner) const {
+            bool dirty = false;
+            for_each([&](const auto& field) { dirty = dirty || (owner.*field.member).is_dirty(); });
+            return dirty;
+        }
+
+        void clear_dirty(Owner& owner) const {
+            for_each([&](const auto& field) { (owner.*field.member).clear_dirty(); });
+        }
+    };
+
+    template<typename Owner, typename... T>
+    fields(value_field<Owner, T>...) -> fields<Owner, T...>;
+}
+
+#endif //WIZARD_SCHEMA_H
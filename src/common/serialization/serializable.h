@@ -7,6 +7,11 @@
 #define WIZARD_SERIALIZABLE_H
 
 #include "../../rapidjson/include/rapidjson/document.h"
+#include "../../rapidjson/include/rapidjson/stringbuffer.h"
+#include "../../rapidjson/include/rapidjson/writer.h"
+
+// writes json text as a stream of events (StartObject(), Key(), Int(), ...) straight into its buffer
+using json_writer = rapidjson::Writer<rapidjson::StringBuffer>;
 
 class serializable {
 public:
@@ -20,6 +25,15 @@ public:
     }
 
     virtual void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const = 0;
+
+    // Writes the same json as write_into_json() to 'writer', member by member, without building a document. The
+    // objects that are sent most often (the game state and its parts, the server responses) override it, all other
+    // objects build their document and write it.
+    virtual void write_into_writer(json_writer& writer) const {
+        rapidjson::Document json(rapidjson::kObjectType);
+        write_into_json(json, json.GetAllocator());
+        json.Accept(writer);
+    }
 };
 
 #endif //WIZARD_SERIALIZABLE_H
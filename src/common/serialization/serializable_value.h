@@ -10,6 +10,9 @@
 //  float
 //  double
 //  string
+//
+// The value is stored inline in its owner. It is written as a plain json value under the name of the member, see
+// schema.h.
 
 #ifndef WIZARD_SERIALIZABLE_VALUE_H
 #define WIZARD_SERIALIZABLE_VALUE_H
@@ -18,42 +21,38 @@
 #include <vector>
 #include <iostream>
 #include <functional>
+#include <utility>
 
 #include "unique_serializable.h"
 #include "value_type_helpers.h"
+#include "../exceptions/WizardException.h"
 #include "../../../rapidjson/include/rapidjson/document.h"
 
 template <class T>
-class serializable_value : public serializable {
+class serializable_value {
 
 private:
     T _value;
+    bool _dirty = true;     // set whenever the value changes, cleared once the change was sent to the clients
 
 
 public:
 
-    serializable_value(T val) : serializable(), _value(val) { }
+    serializable_value(T val) : _value(std::move(val)) { }
 
     T get_value() const { return this->_value; }
 
     void set_value(T val) {
         if (this->_value != val) {
-            this->_value = val;
+            this->_value = std::move(val);
+            this->_dirty = true;
         }
     }
 
-// serializable interface
-    virtual void write_into_json(rapidjson::Value& json, rapidjson::Document::AllocatorType& allocator) const override {
-        json.AddMember("value", value_type_helpers::get_json_value<decltype(_value)>(_value, allocator), allocator);
-    }
+    // Returns whether the value changed since the last call to clear_dirty(). New values are always dirty.
+    bool is_dirty() const { return this->_dirty; }
 
-    static serializable_value<T>* from_json(const rapidjson::Value& json) {
-        if (json.HasMember("value")) {
-            T val = json["value"].Get<T>();
-            return new serializable_value<T>(val);
-        }
-        return nullptr;
-    }
+    void clear_dirty() { this->_dirty = false; }
 };
 
 
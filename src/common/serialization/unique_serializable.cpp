@@ -5,25 +5,41 @@
 
 #include "unique_serializable.h"
 
-#include "uuid_generator.h"
 #include "../exceptions/WizardException.h"
 
 
 unique_serializable::unique_serializable()
-    : _id(uuid_generator::generate_uuid_v4())
+    : _id(entity_id::generate())
 { }
 
-unique_serializable::unique_serializable(std::string id)
+unique_serializable::unique_serializable(const std::string& id)
+    : _id(entity_id::from_string(id))
+{ }
+
+unique_serializable::unique_serializable(const entity_id id)
     : _id(id)
 { }
 
 std::string unique_serializable::get_id() const {
+    return this->_id.to_string();
+}
+
+const entity_id& unique_serializable::get_entity_id() const {
     return this->_id;
 }
 
 void unique_serializable::write_into_json(rapidjson::Value &json,
                                           rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> &allocator) const {
-    rapidjson::Value id_val(_id.c_str(), allocator);
+    entity_id::text_buffer buffer;
+    const std::string_view id = _id.to_string_view(buffer);
+    rapidjson::Value id_val(id.data(), static_cast<rapidjson::SizeType>(id.size()), allocator);
     json.AddMember("id", id_val, allocator);
 
 }
+
+void unique_serializable::write_id_into_writer(json_writer& writer) const {
+    entity_id::text_buffer buffer;
+    const std::string_view id = _id.to_string_view(buffer);
+    writer.Key("id");
+    writer.String(id.data(), static_cast<rapidjson::SizeType>(id.size()));
+}
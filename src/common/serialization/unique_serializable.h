@@ -2,24 +2,33 @@
 // Created by Manuel on 03.02.2021.
 //
 // Used to serialize game_state objects that need to be identifiable by a unique id.
+// The id is stored as a compact entity_id, its text is only created when the object is serialized.
 
 #ifndef WIZARD_UNIQUE_SERIALIZABLE_H
 #define WIZARD_UNIQUE_SERIALIZABLE_H
 
 
 #include "serializable.h"
+#include "entity_id.h"
 
 class unique_serializable : public serializable {
 protected:
 
-    std::string _id;       // unique identifier
+    entity_id _id;       // unique identifier
 
     unique_serializable();
-    unique_serializable(std::string id);
+    unique_serializable(const std::string& id);
+    unique_serializable(entity_id id);
+
+    // writes the "id" member, as write_into_json() does, to an object that is being written to 'writer'
+    void write_id_into_writer(json_writer& writer) const;
 
 public:
 // accessors
+    // the text of the id, as it is written into messages
     std::string get_id() const;
+    // the id itself, which is cheaper to compare than its text
+    const entity_id& get_entity_id() const;
 
 // serializable interface
     virtual void write_into_json(rapidjson::Value& json,
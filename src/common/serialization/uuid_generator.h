@@ -2,13 +2,14 @@
 // Created by Manuel on 27.01.2021.
 //
 // Helper class to generate unique ids.
-// from https://stackoverflow.com/questions/24365331/how-can-i-generate-uuid-in-c-without-using-boost-library
+// The text of a new random entity_id, i.e. a version 4 uuid whose 122 random bits are drawn from the calling thread's
+// random_generator.
 
 #ifndef UUID_GENERATOR_H
 #define UUID_GENERATOR_H
 
-#include <random>
-#include <sstream>
+#include <string>
+#include "entity_id.h"
 
 class uuid_generator {
 
@@ -16,35 +17,7 @@ private:
 
 public:
     static std::string generate_uuid_v4() {
-        std::stringstream ss;
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, 15);
-        std::uniform_int_distribution<> dis2(8, 11);
-
-        int i;
-        ss << std::hex;
-        for (i = 0; i < 8; i++) {
-            ss << dis(gen);
-        }
-        ss << "-";
-        for (i = 0; i < 4; i++) {
-            ss << dis(gen);
-        }
-        ss << "-4";
-        for (i = 0; i < 3; i++) {
-            ss << dis(gen);
-        }
-        ss << "-";
-        ss << dis2(gen);
-        for (i = 0; i < 3; i++) {
-            ss << dis(gen);
-        }
-        ss << "-";
-        for (i = 0; i < 12; i++) {
-            ss << dis(gen);
-        };
-        return ss.str();
+        return entity_id::generate().to_string();
     }
 };
 
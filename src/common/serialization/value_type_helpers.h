@@ -104,6 +104,31 @@ namespace value_type_helpers {
     }
 
 
+    // for serialization without a document, writes the same json value as get_json_value() to 'writer'
+    template<typename Writer>
+    static void write_json_value(Writer& writer, bool val) { writer.Bool(val); }
+
+    template<typename Writer>
+    static void write_json_value(Writer& writer, int val) { writer.Int(val); }
+
+    template<typename Writer>
+    static void write_json_value(Writer& writer, unsigned int val) { writer.Uint(val); }
+
+    template<typename Writer>
+    static void write_json_value(Writer& writer, int64_t val) { writer.Int64(val); }
+
+    template<typename Writer>
+    static void write_json_value(Writer& writer, uint64_t val) { writer.Uint64(val); }
+
+    template<typename Writer>
+    static void write_json_value(Writer& writer, double val) { writer.Double(val); }
+
+    template<typename Writer>
+    static void write_json_value(Writer& writer, const std::string& val) {
+        writer.String(val.c_str());
+    }
+
+
     template<>
     rapidjson::Value
     get_json_value_type<bool>(bool val, rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> &allocator) {
@@ -33,6 +33,19 @@ namespace vector_utils {
         return arr_val;
     }
 
+    template<class T>
+    // writes the same json as serialize_vector() to 'writer'
+    static void write_vector(const std::vector<T*>& serializables, json_writer& writer) {
+        derived_from<T,serializable>(); // ensure T derives from serializable
+        writer.StartArray();
+        for (const T* elem : serializables) {
+            elem->write_into_writer(writer);
+        }
+        writer.EndArray();
+    }
+
+    // A played card is written with the id of the player who played it, the player itself is part of the game state
+    // and is resolved by its id on decode (see trick::from_json())
     static rapidjson::Value serialize_cards_vector(
     const std::vector<std::pair<card*, player*>>& cards,
     rapidjson::Document::AllocatorType& allocator) {
@@ -40,20 +53,38 @@ namespace vector_utils {
         for (const auto& pair : cards) {
             rapidjson::Value obj(rapidjson::kObjectType);
 
-            // Serialize the pair componentsss
             rapidjson::Value card_val(rapidjson::kObjectType);
             pair.first->write_into_json(card_val, allocator);
             obj.AddMember("card", card_val, allocator);
 
-            rapidjson::Value player_val(rapidjson::kObjectType);
-            pair.second->write_into_json(player_val, allocator);
-            obj.AddMember("player", player_val, allocator);
+            entity_id::text_buffer id_buffer;
+            const std::string_view player_id = pair.second->get_entity_id().to_string_view(id_buffer);
+            rapidjson::Value player_id_val(player_id.data(), static_cast<rapidjson::SizeType>(player_id.size()), allocator);
+            obj.AddMember("player_id", player_id_val, allocator);
 
             arr_val.PushBack(obj, allocator);
         }
         return arr_val;
     }
 
+    // writes the same json as serialize_cards_vector() to 'writer'
+    template<class Cards>
+    static void write_cards_vector(const Cards& cards, json_writer& writer) {
+        writer.StartArray();
+        for (const auto& pair : cards) {
+            writer.StartObject();
+            writer.Key("card");
+            pair.first->write_into_writer(writer);
+
+            entity_id::text_buffer id_buffer;
+            const std::string_view player_id = pair.second->get_entity_id().to_string_view(id_buffer);
+            writer.Key("player_id");
+            writer.String(player_id.data(), static_cast<rapidjson::SizeType>(player_id.size()));
+            writer.EndObject();
+        }
+        writer.EndArray();
+    }
+
 }
 
 #endif //WIZARD_VECTOR_UTILS_H
@@ -6,14 +6,21 @@
 
 #include "game_instance.h"
 
+#include <algorithm>
+#include <iostream>
+
 #include "server_network_manager.h"
-#include "../common/network/responses/full_state_response.h"
+#include "../common/network/responses/state_diff_response.h"
 
 
-game_instance::game_instance() {
+game_instance::game_instance() : _mailbox(std::make_shared<mailbox>(worker_pool::get_instance())) {
     _game_state = new game_state();
 }
 
+void game_instance::post(mailbox::command cmd) {
+    _mailbox->post(std::move(cmd));
+}
+
 game_state *game_instance::get_game_state() {
     return _game_state;
 }
@@ -22,6 +29,10 @@ std::string game_instance::get_id() {
     return _game_state->get_id();
 }
 
+const entity_id& game_instance::get_entity_id() const {
+    return _game_state->get_entity_id();
+}
+
 bool game_instance::is_full() {
     return _game_state->is_full();
 }
@@ -34,53 +45,86 @@ bool game_instance::is_finished() {
     return _game_state->is_finished();
 }
 
+bool game_instance::is_joinable() const {
+    return _is_joinable;
+}
+
+rapidjson::Document* game_instance::get_state_json(const player* viewer) {
+    rapidjson::Document* state_json = new rapidjson::Document();
+    state_json->SetObject();
+    _game_state->write_view_into_json(*state_json, state_json->GetAllocator(), viewer);
+    return state_json;
+}
+
+// sends the changes of the last state update to all players (except 'exclude') and marks them as sent;
+// the diff is serialized once, every player only gets their own hand spliced in
+void game_instance::broadcast_state_diff(const player* exclude) {
+    state_diff_response state_update_msg = state_diff_response(this->get_id(), *_game_state);
+    state_view view = state_view(state_update_msg, _game_state->get_players());
+    _game_state->clear_dirty();
+    _state_cache.clear();   // the cached full state belongs to the previous version
+    _is_joinable = !_game_state->is_full() && !_game_state->is_started() && !_game_state->is_finished();
+    server_network_manager::broadcast_message(view, _game_state->get_players(), exclude);
+}
+
+// the full state is serialized once per version, all players who join or resync at that version share it
+void game_instance::send_full_state(player* receiver) {
+    const std::shared_ptr<const state_view> view = _state_cache.get_view(*_game_state);
+    server_network_manager::broadcast_message(*view, {receiver}, nullptr);
+}
 
-bool game_instance::play_card(player *player, const std::string& card_id, std::string& err) {
-    modification_lock.lock();
+void game_instance::log_cache_stats() {
+    std::cout << "State cache of game " << get_id() << ": " << _state_cache.get_nof_hits() << " hits, "
+              << _state_cache.get_nof_misses() << " misses (hit rate " << 100.0 * _state_cache.get_hit_rate()
+              << "%, " << state_cache::get_total_hits() << " hits and " << state_cache::get_total_misses()
+              << " misses over all games)" << std::endl;
+}
+
+
+bool game_instance::play_card(player *player, const entity_id& card_id, std::string& err) {
     if (_game_state->play_card(player, card_id, err)) {
-        full_state_response state_update_msg = full_state_response(this->get_id(), *_game_state);
-        server_network_manager::broadcast_message(state_update_msg, _game_state->get_players(), player);
-        modification_lock.unlock();
+        broadcast_state_diff(nullptr);
+        if (_game_state->is_finished()) {
+            log_cache_stats();
+        }
         return true;
     }
-    modification_lock.unlock();
     return false;
 }
 
 bool game_instance::estimate_tricks(player *player, std::string& err, int nof_tricks){
-    modification_lock.lock();
     if (_game_state->estimate_tricks(player, err, nof_tricks)) {
-        full_state_response state_update_msg = full_state_response(this->get_id(), *_game_state);
-        server_network_manager::broadcast_message(state_update_msg, _game_state->get_players(), player);
-        modification_lock.unlock();
+        broadcast_state_diff(nullptr);
         return true;
     }
-    modification_lock.unlock();
     return false;
 }
 
 
 bool game_instance::start_game(player* player, std::string &err) {
-    modification_lock.lock();
     if (_game_state->start_game(err)) {
+        // the seed and the players' moves reproduce the game exactly
+        std::cout << "Started game " << get_id() << " with seed " << _game_state->get_seed() << std::endl;
         // send state update to all other players
-        full_state_response state_update_msg = full_state_response(this->get_id(), *_game_state);
-        server_network_manager::broadcast_message(state_update_msg, _game_state->get_players(), player); // issue here
-        modification_lock.unlock();
+        broadcast_state_diff(nullptr);
         return true;
     }
-    modification_lock.unlock();
     return false;
 }
 
 bool game_instance::try_remove_player(player *player, std::string &err) {
-    modification_lock.lock();
     if(_game_state->remove_player(player, err))
     {
         // player->set_game_id("");
-        full_state_response state_update_msg = full_state_response(this->get_id(), *_game_state);
-        server_network_manager::broadcast_message(state_update_msg, _game_state->get_players(), player);
-        modification_lock.unlock();
+        // a player who left before the start is no longer referenced by the game state
+        const std::vector<::player*>& players = _game_state->get_players();
+        if (std::find(players.begin(), players.end(), player) == players.end()) {
+            std::erase_if(_members, [player](const std::shared_ptr<::player>& p) { return p.get() == player; });
+        }
+        broadcast_state_diff(player);
+        if (_game_state->is_finished()) {
+            log_cache_stats();
+        }
         return true;
     }
     /*
@@ -89,7 +133,6 @@ bool game_instance::try_remove_player(player *player, std::string &err) {
         _game_state->finish_game(err);
         full_state_response state_update_msg = full_state_response(this->get_id(), *_game_state);
         server_network_manager::broadcast_message(state_update_msg, _game_state->get_players(), player);
-        modification_lock.unlock();
         return true;
     */
     //}// else if (_game_state->remove_player(player, err)){
@@ -100,21 +143,19 @@ bool game_instance::try_remove_player(player *player, std::string &err) {
         //modification_lock.unlock();
         //return true;
     //}
-    modification_lock.unlock();
     return false;
 }
 
-bool game_instance::try_add_player(player *new_player, std::string &err) {
-    modification_lock.lock();
-    if (_game_state->add_player(new_player, err)) {
-        new_player->set_game_id(get_id());
+bool game_instance::try_add_player(const std::shared_ptr<player>& new_player, std::string &err) {
+    if (_game_state->add_player(new_player.get(), err)) {
+        _members.push_back(new_player);
+        new_player->set_game_id(get_entity_id());
         // send state update to all other players
-        full_state_response state_update_msg = full_state_response(this->get_id(), *_game_state);
-        server_network_manager::broadcast_message(state_update_msg, _game_state->get_players(), new_player);
-        modification_lock.unlock();
+        broadcast_state_diff(new_player.get());
+        // the new player gets the full state, before any later state diff
+        send_full_state(new_player.get());
         return true;
     }
-    modification_lock.unlock();
     return false;
 }
 
@@ -1,24 +1,47 @@
 #ifndef WIZARD_GAME_H
 #define WIZARD_GAME_H
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <string>
-#include <mutex>
 
 #include "../common/game_state/player/player.h"
 #include "../common/game_state/game_state.h"
+#include "mailbox.h"
+#include "state_cache.h"
 
 /**
  * @class game_instance
  * @brief Class that modifies game state based on content received from client.
  * The game instance functionalities are called by the request handler via the game instance manager.
  * It handles the final step of interacting with the game instance (and the actual game logic).
+ *
+ * Every game has a mailbox for the requests that concern it (see post()). They are executed one after another on the
+ * worker_pool, so the game state is never locked and games never wait for each other. Except for the constructor and
+ * post(), the functions of a game instance that is registered with the game_instance_manager must only be called from
+ * commands posted to its mailbox.
  */
 class game_instance {
 
 private:
     game_state* _game_state; ///< Game state that is modified.
-    inline static std::mutex modification_lock; ///< Mutex which makes sure that game state is only modified by one player at a time.
+    state_cache _state_cache; ///< The full game state, serialized once per version for all players who receive it.
+    std::vector<std::shared_ptr<player>> _members; ///< Keeps the players referenced by the game state alive until the game is deleted.
+    std::shared_ptr<mailbox> _mailbox; ///< The commands that modify the game state, executed one at a time.
+    std::atomic<bool> _is_joinable {true}; ///< Whether the game is neither full, started nor finished, read by any thread.
+
+    /**
+     * @brief Broadcasts the changes of the last game state update as state diff and marks them as sent.
+     * Every update of the game state ends with this function, which also updates whether the game is joinable.
+     * @param exclude Player who does not receive the diff (e.g. a joining player, who receives the full state instead).
+     */
+    void broadcast_state_diff(const player* exclude);
+
+    /**
+     * @brief Logs how often the full state could be taken from the state cache.
+     */
+    void log_cache_stats();
 
 public:
     /**
@@ -26,7 +49,8 @@ public:
      */
     game_instance();
     /**
-     * @brief Destructs game instance object
+     * @brief Destructs game instance object.
+     * The players of the game are released after the game state, and deleted if they also left the player_manager.
      */
     ~game_instance() {
         if (_game_state != nullptr) {
@@ -35,16 +59,41 @@ public:
         _game_state = nullptr;
     }
 
+    /**
+     * @brief Queues a command in the mailbox of the game. Called by any thread.
+     * @param cmd The command. It is executed on the worker_pool after all commands posted to this game before it,
+     * and never at the same time as another command of this game.
+     */
+    void post(mailbox::command cmd);
+
     /**
      * @brief Accessor of game instance id.
      * @return id of game instance
      */
     std::string get_id();
+    /**
+     * @brief Accessor of the compact game instance id, which is used as key by the server's registries.
+     * @return id of game instance
+     */
+    [[nodiscard]] const entity_id& get_entity_id() const;
     /**
      * @brief Accessor of current game state.
      * @return Current game state.
      */
     game_state* get_game_state();
+    /**
+     * @brief Serializes the full game state, as seen by a player.
+     * @param viewer The player the state is sent to. The hands of all other players are redacted.
+     * @return The serialized game state, which also contains the state version the next diff will be based on.
+     */
+    rapidjson::Document* get_state_json(const player* viewer);
+    /**
+     * @brief Sends the full game state to a player (e.g. a player who missed a state diff) as full_state_response.
+     * The full state is only sent to players that join or resynchronize, all other players receive state diffs. It is
+     * serialized at most once per version of the game state (see state_cache).
+     * @param receiver The player the state is sent to. The hands of all other players are redacted.
+     */
+    void send_full_state(player* receiver);
 
     /**
      * @brief Checks whether game is already full.
@@ -62,6 +111,12 @@ public:
      * @return Boolean that states whether game is finished.
      */
     bool is_finished();
+    /**
+     * @brief Checks whether players can join the game, i.e. it is neither full, started nor finished.
+     * Unlike the other accessors, it can be called by any thread, e.g. to find a game for a joining player.
+     * @return Boolean that states whether the game is joinable.
+     */
+    [[nodiscard]] bool is_joinable() const;
 
     // game update functions
     /**
@@ -72,16 +127,16 @@ public:
      */
     bool start_game(player* player, std::string& err);
     /**
-     * @brief Attempts to add player to the game.
-     * @param new_player Pointer to player that wants to join the game.
+     * @brief Attempts to add player to the game. The joined player is sent the full game state.
+     * @param new_player Pointer to player that wants to join the game. The game keeps a reference to the player.
      * @param err Contains error message that possibly states what went wrong while joining the game.
      * @return Boolean which states whether player could successfully join the game.
      */
-    bool try_add_player(player* new_player, std::string& err);
+    bool try_add_player(const std::shared_ptr<player>& new_player, std::string& err);
     /**
      * @brief Attempts to remove player from the game.
      * If the game hasn't started yet, the player can be easily removed from the game.
-     * If the game has already started it is finished immediately.
+     * If the game has already started it is finished immediately, and the player stays part of the finished game state.
      * @param player Pointer to player that leaves the game.
      * @param err Error message which states if the reason why the player couldn't leave the game if something went wrong.
      * @return Boolean which states whether the player successfully left the game.
@@ -94,7 +149,7 @@ public:
      * @param err Error message which contains possible errors.
      * @return Boolean which states whether card could be played successfully.
      */
-    bool play_card(player* player, const std::string& card_id, std::string& err);
+    bool play_card(player* player, const entity_id& card_id, std::string& err);
     /**
      * @brief Attempts to estimate tricks.
      * @param player Pointer to player who estimates tricks.
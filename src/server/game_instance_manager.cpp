@@ -4,115 +4,112 @@
 // The game_instance_manager only exists on the server side. It stores all currently active games and offers
 // functionality to retrieve game instances by id and adding players to games.
 // If a new player requests to join a game but no valid game_instance is available, then this class
-// will generate a new game_instance and add it to the unordered_map of (active) game instances.
+// will generate a new game_instance and add it to the sharded_map of (active) game instances.
+// Games that can still be joined are kept in a queue of open lobbies, so that a player joins the oldest open game
+// without looking at any of the games that are already running.
+// The games are reference counted: a finished game is deleted once it is removed from the sharded_map and the last
+// request that still uses it has been handled.
 
 #include "game_instance_manager.h"
 
 #include "player_manager.h"
 #include "server_network_manager.h"
 
-// Initialize static map
-std::unordered_map<std::string, game_instance*> game_instance_manager::games_lut = {};
-
-game_instance *game_instance_manager::find_joinable_game_instance() {
-    std::vector<std::string> to_remove;
-    game_instance* res = nullptr;
-    games_lut_lock.lock_shared();
-    for (auto it = games_lut.begin(); it != games_lut.end(); it++) {
-        if (it->second->is_finished()) {    // also check if there are any finished games that can be removed
-            to_remove.push_back(it->first);
-        } else if (!it->second->is_full() && !it->second->is_started()) {
-            res = it->second; // found a non-full, non-started game
-            break;
-        }
-    }
-    games_lut_lock.unlock_shared();
-
-    if (res == nullptr) {
-        // couldn't find a non-full, non-started game -> create a new one
-        res = create_new_game();
+std::shared_ptr<game_instance> game_instance_manager::find_joinable_game_instance() {
+    // remove all games that finished since the last join, each is deleted with its last reference
+    for (auto& game_id : finished_games) {
+        games_lut.erase(game_id);
     }
+    finished_games.clear();
 
-    // remove all finished games
-    if (to_remove.size() > 0) {
-        games_lut_lock.lock();
-        for (auto& game_id : to_remove) {
-            games_lut.erase(game_id);
+    // games that filled up or started since they were queued are only dropped once they reach the front
+    while (!open_lobbies.empty()) {
+        const std::shared_ptr<game_instance>& front = open_lobbies.front();
+        if (front->is_joinable()) {
+            return front;   // found a non-full, non-started game
         }
-        games_lut_lock.unlock();
+        lobby_members.erase(front.get());
+        open_lobbies.pop_front();
     }
+
+    // couldn't find a non-full, non-started game -> create a new one
+    std::shared_ptr<game_instance> res = create_new_game();
+    open_lobbies.push_back(res);
+    lobby_members.insert(res.get());
     return res;
 }
 
-game_instance* game_instance_manager::create_new_game() {
-    game_instance* new_game = new game_instance();
-    games_lut_lock.lock();  // exclusive
-    game_instance_manager::games_lut.insert({new_game->get_id(), new_game});
-    games_lut_lock.unlock();
+std::shared_ptr<game_instance> game_instance_manager::create_new_game() {
+    std::shared_ptr<game_instance> new_game = std::make_shared<game_instance>();
+    games_lut.try_insert(new_game->get_entity_id(), new_game);
     return new_game;
 }
 
+void game_instance_manager::reopen_lobby(const std::shared_ptr<game_instance>& game_instance_ptr) {
+    std::lock_guard<std::mutex> guard(lobby_lock);
+    if (game_instance_ptr->is_joinable() && lobby_members.insert(game_instance_ptr.get()).second) {
+        open_lobbies.push_back(game_instance_ptr);
+    }
+}
 
-bool game_instance_manager::try_get_game_instance(const std::string& game_id, game_instance *&game_instance_ptr) {
-    game_instance_ptr = nullptr;
-    games_lut_lock.lock_shared();
-    auto it = game_instance_manager::games_lut.find(game_id);
-    if (it != games_lut.end()) {
-        game_instance_ptr = it->second;
+void game_instance_manager::retire_game(game_instance* game_instance_ptr) {
+    std::lock_guard<std::mutex> guard(lobby_lock);
+    finished_games.push_back(game_instance_ptr->get_entity_id());
+}
+
+std::shared_ptr<game_instance> game_instance_manager::route_request(const entity_id& player_id, bool is_join,
+                                                                    const entity_id& game_id) {
+    std::shared_ptr<game_instance> game_instance_ptr;
+    entity_id routed_game_id;
+    if (player_routes.try_get(player_id, routed_game_id) && try_get_game_instance(routed_game_id, game_instance_ptr)) {
+        return game_instance_ptr;   // the player already joined a game, every request goes to that game
+    }
+    if (!is_join) {
+        return nullptr;
+    }
+    if (game_id.is_nil()) {
+        std::lock_guard<std::mutex> guard(lobby_lock);
+        game_instance_ptr = find_joinable_game_instance();
+    } else if (!try_get_game_instance(game_id, game_instance_ptr)) {
+        return nullptr;
     }
-    games_lut_lock.unlock_shared();
-    return game_instance_ptr != nullptr;
+    player_routes.assign(player_id, game_instance_ptr->get_entity_id());
+    return game_instance_ptr;
+}
+
+void game_instance_manager::forget_route(const entity_id& player_id) {
+    player_routes.erase(player_id);
+}
+
+size_t game_instance_manager::get_nof_games() {
+    return games_lut.size();
+}
+
+
+bool game_instance_manager::try_get_game_instance(const entity_id& game_id, std::shared_ptr<game_instance>& game_instance_ptr) {
+    game_instance_ptr = nullptr;
+    return games_lut.try_get(game_id, game_instance_ptr);
 }
 
 bool
-game_instance_manager::try_get_player_and_game_instance(const std::string& player_id, player *&player, game_instance *&game_instance_ptr, std::string& err) {
+game_instance_manager::try_get_player_and_game_instance(const entity_id& player_id, std::shared_ptr<player>& player, std::shared_ptr<game_instance>& game_instance_ptr, std::string& err) {
     if (player_manager::try_get_player(player_id, player)) {
         if (game_instance_manager::try_get_game_instance(player->get_game_id(), game_instance_ptr)) {
             return true;
         } else {
-            err = "Could not find game_id" + player->get_game_id() + " associated with this player";
+            err = "Could not find game_id" + player->get_game_id().to_string() + " associated with this player";
         }
     } else {
-        err = "Could not find requested player " + player_id + " in database.";
+        err = "Could not find requested player " + player_id.to_string() + " in database.";
     }
     return false;
 }
 
 
-bool game_instance_manager::try_add_player_to_any_game(player *player, game_instance*& game_instance_ptr, std::string& err) {
-
-    // check that player is not already subscribed to another game
-    if (player->get_game_id() != "") {
-        if (game_instance_ptr != nullptr && player->get_game_id() != game_instance_ptr->get_id()) {
-            err = "Could not join game with id " + game_instance_ptr->get_id() + ". Player is already active in a different game with id " + player->get_game_id();
-        } else {
-            err = "Could not join game. Player is already active in a game";
-        }
-        return false;
-    }
-
-    if (game_instance_ptr == nullptr) {
-        // Join any non-full, non-started game
-        for (int i = 0; i < 10; i++) {
-            // make at most 10 attempts of joining a src (due to concurrency, the game could already be full or started by the time
-            // try_add_player_to_any_game() is invoked) But with only few concurrent requests it should succeed in the first iteration.
-            game_instance_ptr = find_joinable_game_instance();
-            if (try_add_player(player, game_instance_ptr, err)) {
-                return true;
-            }
-        }
-        return false;
-    }
-    else {
-        return try_add_player(player, game_instance_ptr, err);
-    }
-}
-
-
-bool game_instance_manager::try_add_player(player *player, game_instance *&game_instance_ptr, std::string& err) {
-    if (player->get_game_id() != "") {
-        if (player->get_game_id() != game_instance_ptr->get_id()) {
-            err = "Player is already active in a different src with id " + player->get_game_id();
+bool game_instance_manager::try_add_player(const std::shared_ptr<player>& player, std::shared_ptr<game_instance>& game_instance_ptr, std::string& err) {
+    if (!player->get_game_id().is_nil()) {
+        if (player->get_game_id() != game_instance_ptr->get_entity_id()) {
+            err = "Player is already active in a different src with id " + player->get_game_id().to_string();
         } else {
             err = "Player is already active in this src";
         }
@@ -120,36 +117,22 @@ bool game_instance_manager::try_add_player(player *player, game_instance *&game_
     }
 
     if (game_instance_ptr->try_add_player(player, err)) {
-        player->set_game_id(game_instance_ptr->get_id());   // mark that this player is playing in a src
+        player->set_game_id(game_instance_ptr->get_entity_id());   // mark that this player is playing in a src
         return true;
     } else {
         return false;
     }
 }
 
-bool game_instance_manager::try_remove_player(player *player, const std::string& game_id, std::string &err) {
-    game_instance* game_instance_ptr = nullptr;
-
-    //Case 1: player is in a game --> remove the player from that game
-    if (try_get_game_instance(game_id, game_instance_ptr)) {
-        // addition 14.11
-        return try_remove_player(player, game_instance_ptr, err);
-
+bool game_instance_manager::try_remove_player(const std::shared_ptr<player>& player, std::shared_ptr<game_instance>& game_instance_ptr, std::string &err) {
+    if (!game_instance_ptr->try_remove_player(player.get(), err)) {
+        return false;
     }
-    // SHOULD be handled by request_handler bcs player is removed from table by player_manager afterwards
-    // Case 2: player is not in game, but already in player manager
-    //else if (player_manager::try_get_player(player->get_id(), player)) {
-        //err = "Player is not currently in a game but exists in the system. No game to leave.";
-        //return false;
-    //}
-
-    // Case 3: player doesn't exist in any game or in the player LUT of player_manager
-    err = "The requested src could not be found or there was a problem removing the player / deleting the finished game instances. Requested src id was " + game_id;
-    return false;
-
-}
-
-bool game_instance_manager::try_remove_player(player *player, game_instance *&game_instance_ptr, std::string &err) {
-    return game_instance_ptr->try_remove_player(player, err);
+    if (game_instance_ptr->is_finished()) {
+        retire_game(game_instance_ptr.get());
+    } else {
+        reopen_lobby(game_instance_ptr);
+    }
+    return true;
 }
 
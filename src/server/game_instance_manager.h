@@ -4,45 +4,76 @@
 // The game_instance_manager only exists on the server side. It stores all currently active games and offers
 // functionality to retrieve game instances by id and adding players to games.
 // If a new player requests to join a game but no valid game_instance is available, then this class
-// will generate a new game_instance and add it to the unordered_map of (active) game instances.
+// will generate a new game_instance and add it to the sharded_map of (active) game instances.
+// Games that can still be joined are kept in a queue of open lobbies, so that a player joins the oldest open game
+// without looking at any of the games that are already running.
+// The games are reference counted: a finished game is deleted once it is removed from the sharded_map and the last
+// request that still uses it has been handled.
 
 #ifndef WIZARD_GAME_INSTANCE_MANAGER_H
 #define WIZARD_GAME_INSTANCE_MANAGER_H
 
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <shared_mutex>
-#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "game_instance.h"
+#include "sharded_map.h"
 
 class game_instance_manager {
 
 private:
 
-    inline static std::shared_mutex games_lut_lock;
-    static std::unordered_map<std::string, game_instance*> games_lut;
+    inline static sharded_map<entity_id, std::shared_ptr<game_instance>> games_lut;
+    inline static sharded_map<entity_id, entity_id> player_routes;  // the game of every player, as of their last join
 
-    static game_instance* create_new_game();
-    static game_instance* find_joinable_game_instance();
+    inline static std::mutex lobby_lock;    // protects open_lobbies, lobby_members and finished_games
+    inline static std::deque<std::shared_ptr<game_instance>> open_lobbies; // games that may still be joined, oldest first
+    inline static std::unordered_set<game_instance*> lobby_members;        // the games in open_lobbies
+    inline static std::vector<entity_id> finished_games;                   // removed from games_lut by the next join
+
+    static std::shared_ptr<game_instance> create_new_game();
+    // must be called while holding the lobby_lock
+    static std::shared_ptr<game_instance> find_joinable_game_instance();
+    // puts a game back into the queue of open lobbies if it can be joined again (e.g. after a player left the lobby)
+    static void reopen_lobby(const std::shared_ptr<game_instance>& game_instance_ptr);
+
+    // Joining and leaving change the game, so they are only called by the request_handler, from a command of the
+    // mailbox of 'game_instance_ptr' (see request_handler::handle_request). The join request was routed to that game
+    // before (see route_request).
+    friend class request_handler;
+
+    // Try to add 'player' to the provided 'game_instance_ptr'. Returns true if success and false otherwise.
+    static bool try_add_player(const std::shared_ptr<player>& player, std::shared_ptr<game_instance>& game_instance_ptr, std::string& err);
+    static bool try_remove_player(const std::shared_ptr<player>& player, std::shared_ptr<game_instance>& game_instance_ptr, std::string& err);
 
 public:
 
     // returns true if the desired game_instance 'game_id' was found or false otherwise.
     // The found game instance is written into game_instance_ptr.
-    static bool try_get_game_instance(const std::string& game_id, game_instance*& game_instance_ptr);
+    static bool try_get_game_instance(const entity_id& game_id, std::shared_ptr<game_instance>& game_instance_ptr);
     // returns true if the desired player 'player_id' was found and is connected to a game_instance.
     // The found player and game_instance will be written into 'player' and 'game_instance_ptr'
-    static bool try_get_player_and_game_instance(const std::string& player_id, player*& player, game_instance*& game_instance_ptr, std::string& err);
+    static bool try_get_player_and_game_instance(const entity_id& player_id, std::shared_ptr<player>& player, std::shared_ptr<game_instance>& game_instance_ptr, std::string& err);
 
-    // Try to add 'player' to any game. Returns true if 'player' is successfully added to a game_instance.
-    // The joined game_instance will be written into 'game_instance_ptr'.
-    static bool try_add_player_to_any_game(player* player, game_instance*& game_instance_ptr, std::string& err);
-    // Try to add 'player' to the provided 'game_instance_ptr'. Returns true if success and false otherwise.
-    static bool try_add_player(player* player, game_instance*& game_instance_ptr, std::string& err);
+    // Returns the game whose mailbox executes a request of 'player_id' (see request_handler::dispatch_request), or
+    // nullptr if the request does not concern any game. Every request of a player who joined a game goes to that game.
+    // Otherwise, a join request goes to the requested game 'game_id', or to the oldest open game if 'game_id' is
+    // nil, and the player's later requests follow it there, even before the join was executed.
+    static std::shared_ptr<game_instance> route_request(const entity_id& player_id, bool is_join,
+                                                        const entity_id& game_id);
+    // Forgets the game of a player who left the server.
+    static void forget_route(const entity_id& player_id);
 
+    // Marks a finished game to be removed. It can still be looked up until the next player joins any game, and it is
+    // deleted once no request uses it anymore.
+    static void retire_game(game_instance* game_instance_ptr);
 
-    static bool try_remove_player(player* player, const std::string& game_id, std::string& err);
-    static bool try_remove_player(player* player, game_instance*& game_instance_ptr, std::string& err);
+    // The number of registered games, including finished games that were not removed yet.
+    static size_t get_nof_games();
 
 };
 
@@ -0,0 +1,398 @@
+//
+// The io_reactor is an event-driven alternative to the thread-per-connection model of the server_network_manager.
+// A small, fixed set of I/O threads multiplexes all client sockets with epoll, performs non-blocking reads and writes,
+// and hands every complete frame (see wire_format) to the message handler of the server_network_manager.
+//
+
+#include "io_reactor.h"
+
+#include <iostream>
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// State of one client connection. 'reader' and the socket are only touched by the owning I/O thread. Frames are
+// queued from any thread; 'out_lock' guards the write interest of the connection in epoll and 'closed', so that the
+// interest is never changed for a descriptor that got closed (and possibly reused by another connection).
+struct io_reactor::connection {
+    sockpp::tcp_socket socket;
+    sockpp::inet_address peer;
+    std::string address;
+    int fd;
+    worker* owner;
+
+    frame_reader reader;
+    request_decoder decoder;
+
+    send_queue out_queue;
+    std::mutex out_lock;
+    bool write_armed = false;
+    bool closed = false;
+
+    connection(sockpp::tcp_socket sock, worker* w, const send_queue::limits& queue_limits) :
+            socket(std::move(sock)),
+            peer(socket.peer_address()),
+            address(peer.to_string()),
+            fd(socket.handle()),
+            owner(w),
+            out_queue(queue_limits)
+    { }
+};
+
+// One I/O thread with its own epoll instance. The eventfd 'wake_fd' is used to interrupt epoll_wait() on shutdown.
+struct io_reactor::worker {
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::thread thread;
+
+    std::mutex connections_lock;
+    std::unordered_map<int, std::shared_ptr<connection>> connections;  // by file descriptor
+};
+
+io_reactor::io_reactor(unsigned int nof_threads, message_handler handler, send_queue::limits queue_limits,
+                       close_handler on_close) :
+        _handler(std::move(handler)),
+        _on_close(std::move(on_close)),
+        _queue_limits(queue_limits)
+{
+    if (nof_threads == 0) {
+        nof_threads = 1;
+    }
+    for (unsigned int i = 0; i < nof_threads; i++) {
+        auto w = std::make_unique<worker>();
+        w->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        w->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (w->epoll_fd < 0 || w->wake_fd < 0) {
+            throw std::runtime_error("Could not create epoll instance for io_reactor");
+        }
+        epoll_event ev {};
+        ev.events = EPOLLIN;
+        ev.data.fd = w->wake_fd;
+        epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, w->wake_fd, &ev);
+        _workers.push_back(std::move(w));
+    }
+    for (auto& w : _workers) {
+        w->thread = std::thread(&io_reactor::run, this, w.get());
+    }
+}
+
+io_reactor::~io_reactor() {
+    _running = false;
+    for (auto& w : _workers) {
+        uint64_t one = 1;
+        ssize_t ignored = write(w->wake_fd, &one, sizeof(one));
+        (void) ignored;
+    }
+    for (auto& w : _workers) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+        for (auto& entry : w->connections) {
+            std::lock_guard<std::mutex> out_guard(entry.second->out_lock);
+            entry.second->closed = true;
+            entry.second->out_queue.close();
+            entry.second->socket.close();
+        }
+        close(w->wake_fd);
+        close(w->epoll_fd);
+    }
+}
+
+bool io_reactor::is_supported() {
+    return true;
+}
+
+bool io_reactor::add_connection(sockpp::tcp_socket socket) {
+    if (!socket.set_non_blocking(true)) {
+        std::cerr << "Could not switch socket to non-blocking mode: " << socket.last_error_str() << std::endl;
+        return false;
+    }
+
+    worker* w = _workers[_next_worker++ % _workers.size()].get();
+    auto conn = std::make_shared<connection>(std::move(socket), w, _queue_limits);
+
+    _connections_lock.lock();
+    _connections[conn->address] = conn;
+    _connections_lock.unlock();
+
+    w->connections_lock.lock();
+    w->connections[conn->fd] = conn;
+    w->connections_lock.unlock();
+
+    epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = conn->fd;
+    if (epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, conn->fd, &ev) < 0) {
+        std::cerr << "Could not register connection to " << conn->address << " with epoll" << std::endl;
+        close_connection(conn);
+        return false;
+    }
+    return true;
+}
+
+ssize_t io_reactor::send(const std::string& address, send_queue::frame_ptr frame) {
+    std::shared_ptr<connection> conn;
+    _connections_lock.lock_shared();
+    auto it = _connections.find(address);
+    if (it != _connections.end()) {
+        conn = it->second;
+    }
+    _connections_lock.unlock_shared();
+    if (conn == nullptr) {
+        return -1;
+    }
+
+    const auto size = static_cast<ssize_t>(frame->size());
+    switch (conn->out_queue.push(std::move(frame))) {
+        case send_queue::push_result::queued:
+            break;
+        case send_queue::push_result::evicted:
+            evict(conn);
+            return -1;
+        case send_queue::push_result::closed:
+            return -1;
+    }
+
+    if (std::this_thread::get_id() == conn->owner->thread.get_id()) {
+        // the I/O thread of the connection writes the frame right away
+        if (!on_writable(conn)) {
+            evict(conn);
+            return -1;
+        }
+    } else {
+        // wake up the I/O thread of the connection; checking the queue after pushing and under the same lock as
+        // on_writable() ensures that the write interest is never removed while frames are waiting
+        std::lock_guard<std::mutex> out_guard(conn->out_lock);
+        if (!conn->closed && !conn->write_armed && !conn->out_queue.is_empty()) {
+            conn->write_armed = true;
+            set_write_interest(*conn, true);
+        }
+    }
+    return size;
+}
+
+void io_reactor::evict(const std::shared_ptr<connection>& conn) {
+    std::lock_guard<std::mutex> out_guard(conn->out_lock);
+    if (!conn->closed) {
+        if (conn->out_queue.is_evicted()) {
+            std::cerr << "Evicting slow client " << conn->address << std::endl;
+        }
+        ::shutdown(conn->fd, SHUT_RDWR);
+    }
+}
+
+size_t io_reactor::get_nof_connections() const {
+    std::shared_lock<std::shared_mutex> guard(_connections_lock);
+    return _connections.size();
+}
+
+void io_reactor::run(worker* w) {
+    const int max_events = 64;
+    epoll_event events[max_events];
+
+    while (_running) {
+        int n = epoll_wait(w->epoll_fd, events, max_events, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait failed: " << errno << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == w->wake_fd) {
+                uint64_t value;
+                ssize_t ignored = read(w->wake_fd, &value, sizeof(value));
+                (void) ignored;
+                continue;
+            }
+
+            std::shared_ptr<connection> conn;
+            w->connections_lock.lock();
+            auto it = w->connections.find(fd);
+            if (it != w->connections.end()) {
+                conn = it->second;
+            }
+            w->connections_lock.unlock();
+            if (conn == nullptr) {
+                continue;   // already closed earlier in this batch
+            }
+
+            uint32_t flags = events[i].events;
+            bool open = true;
+            if (flags & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                // a read also surfaces errors and hang-ups of the peer
+                open = on_readable(conn);
+            }
+            if (open && (flags & EPOLLOUT)) {
+                open = on_writable(conn);
+            }
+            if (!open) {
+                close_connection(conn);
+            }
+        }
+    }
+}
+
+bool io_reactor::on_readable(const std::shared_ptr<connection>& conn) {
+    while (true) {
+        size_t available = 0;
+        char* buffer = conn->reader.prepare(available);
+        ssize_t count = recv(conn->fd, buffer, available, 0);
+        if (count > 0) {
+            conn->reader.commit(count);
+        } else if (count == 0) {
+            return false;   // orderly shutdown by the peer
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        } else {
+            std::cout << "Read error [" << errno << "] on connection to " << conn->address << std::endl;
+            return false;
+        }
+
+        // dispatch all complete frames before the buffer is reused by the next read
+        frame_reader::frame f;
+        wire_format::frame_status status;
+        while ((status = conn->reader.next_frame(f)) == wire_format::frame_status::complete) {
+            try {
+                _handler(f, conn->decoder, conn->peer);
+            } catch (std::exception& e) { // Make sure the connection isn't torn down only because of a handler error
+                std::cerr << "Error while handling message from " << conn->address << std::endl << e.what() << std::endl;
+            }
+        }
+        if (status == wire_format::frame_status::malformed) {
+            std::cerr << "Received malformed message header from " << conn->address << std::endl;
+            return false;
+        }
+    }
+}
+
+bool io_reactor::on_writable(const std::shared_ptr<connection>& conn) {
+    // no lock is held while writing, the I/O thread is the only thread that writes to the socket
+    send_queue::frame_ptr frame;
+    size_t offset = 0;
+    while (true) {
+        conn->out_queue.front(frame, offset);
+        if (frame == nullptr) {
+            break;
+        }
+        ssize_t count = ::send(conn->fd, frame->data() + offset, frame->size() - offset, MSG_NOSIGNAL);
+        if (count > 0) {
+            conn->out_queue.consume(count);
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    // wait for the socket to become writable only while frames are left
+    std::lock_guard<std::mutex> out_guard(conn->out_lock);
+    const bool pending = !conn->out_queue.is_empty();
+    if (!conn->closed && pending != conn->write_armed) {
+        conn->write_armed = pending;
+        set_write_interest(*conn, pending);
+    }
+    return true;
+}
+
+void io_reactor::close_connection(const std::shared_ptr<connection>& conn) {
+    std::cout << "Closing connection to " << conn->address << std::endl;
+
+    epoll_ctl(conn->owner->epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+
+    conn->owner->connections_lock.lock();
+    conn->owner->connections.erase(conn->fd);
+    conn->owner->connections_lock.unlock();
+
+    bool was_registered = false;
+    _connections_lock.lock();
+    auto it = _connections.find(conn->address);
+    if (it != _connections.end() && it->second == conn) {
+        _connections.erase(it);
+        was_registered = true;
+    }
+    _connections_lock.unlock();
+
+    {
+        // senders check 'closed' under the same lock, so no thread writes to the descriptor after it got closed
+        std::lock_guard<std::mutex> out_guard(conn->out_lock);
+        conn->closed = true;
+        conn->out_queue.close();
+        conn->socket.shutdown();
+        conn->socket.close();
+    }
+
+    // a connection that was replaced by a newer one with the same address must not remove the state of the newer one
+    if (was_registered && _on_close) {
+        _on_close(conn->address);
+    }
+}
+
+void io_reactor::set_write_interest(const connection& conn, bool enabled) const {
+    epoll_event ev {};
+    ev.events = EPOLLIN | (enabled ? EPOLLOUT : 0u);
+    ev.data.fd = conn.fd;
+    epoll_ctl(conn.owner->epoll_fd, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+#else
+
+// epoll is Linux-only, the server_network_manager falls back to thread-per-connection on other platforms.
+struct io_reactor::connection { };
+struct io_reactor::worker { };
+
+io_reactor::io_reactor(unsigned int nof_threads, message_handler handler, send_queue::limits queue_limits,
+                       close_handler on_close) :
+        _handler(std::move(handler)),
+        _on_close(std::move(on_close)),
+        _queue_limits(queue_limits)
+{
+    throw std::runtime_error("io_reactor is not supported on this platform");
+}
+
+io_reactor::~io_reactor() = default;
+
+bool io_reactor::is_supported() {
+    return false;
+}
+
+bool io_reactor::add_connection(sockpp::tcp_socket socket) {
+    return false;
+}
+
+ssize_t io_reactor::send(const std::string& address, send_queue::frame_ptr frame) {
+    return -1;
+}
+
+size_t io_reactor::get_nof_connections() const {
+    return 0;
+}
+
+void io_reactor::run(worker* w) { }
+
+bool io_reactor::on_readable(const std::shared_ptr<connection>& conn) {
+    return false;
+}
+
+bool io_reactor::on_writable(const std::shared_ptr<connection>& conn) {
+    return false;
+}
+
+void io_reactor::evict(const std::shared_ptr<connection>& conn) { }
+
+void io_reactor::close_connection(const std::shared_ptr<connection>& conn) { }
+
+void io_reactor::set_write_interest(const connection& conn, bool enabled) const { }
+
+#endif
@@ -0,0 +1,156 @@
+//
+// The io_reactor is an event-driven alternative to the thread-per-connection model of the server_network_manager.
+// A small, fixed set of I/O threads multiplexes all client sockets with epoll, performs non-blocking reads and writes,
+// and hands every complete frame (see wire_format) to the message handler of the server_network_manager.
+//
+
+#ifndef WIZARD_IO_REACTOR_H
+#define WIZARD_IO_REACTOR_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "sockpp/tcp_socket.h"
+
+#include "request_decoder.h"
+#include "send_queue.h"
+#include "../common/network/frame_reader.h"
+
+/**
+ * @class io_reactor
+ * @brief Multiplexes many client connections over a fixed number of I/O threads.
+ *
+ * Every accepted socket is switched to non-blocking mode and assigned to one of the I/O threads (round robin). Each
+ * I/O thread owns an epoll instance and waits for readiness events of its sockets. Incoming bytes are accumulated per
+ * connection (see frame_reader) until a complete frame is available, which is then passed to the message handler on
+ * the I/O thread without being copied, together with the request_decoder of the connection.
+ * Outgoing frames are put into the bounded send_queue of the connection and written by the connection's I/O thread,
+ * which is the only thread that ever writes to the socket. Frames sent from the I/O thread itself (e.g. the response
+ * to a request) are written right away, frames sent from other threads wake the I/O thread up. Whatever the kernel
+ * does not take is written once the socket becomes writable again, so a slow client never blocks the sending thread,
+ * and a client whose queue overflows is disconnected (see send_queue::overflow_policy).
+ *
+ * The reactor is only available on Linux. On other platforms, is_supported() returns false and the server falls back
+ * to the thread-per-connection model.
+ */
+class io_reactor {
+
+public:
+    using message_handler = std::function<void(const frame_reader::frame&, request_decoder&,
+                                               const sockpp::tcp_socket::addr_t&)>;
+    using close_handler = std::function<void(const std::string&)>;
+
+    /**
+     * @brief Constructs the reactor and starts its I/O threads.
+     * @param nof_threads The number of I/O threads (at least one thread is started).
+     * @param handler The function called with every complete frame, the request decoder of the connection and the
+     * address of the sending peer. The payload of the frame is only valid during the call.
+     * @param queue_limits The limits of the send queue of every connection.
+     * @param on_close The function called with the address of every connection after it was closed, may be empty.
+     */
+    io_reactor(unsigned int nof_threads, message_handler handler, send_queue::limits queue_limits = {},
+               close_handler on_close = {});
+
+    /**
+     * @brief Stops the I/O threads and closes all connections.
+     */
+    ~io_reactor();
+
+    io_reactor(const io_reactor&) = delete;
+    io_reactor& operator=(const io_reactor&) = delete;
+
+    /**
+     * @brief Checks whether the reactor can be used on this platform.
+     * @return A boolean indicating whether epoll is available.
+     */
+    static bool is_supported();
+
+    /**
+     * @brief Hands a newly accepted socket over to the reactor.
+     * @param socket The accepted socket. The reactor takes ownership of it.
+     * @return A boolean indicating whether the socket could be registered.
+     */
+    bool add_connection(sockpp::tcp_socket socket);
+
+    /**
+     * @brief Sends an already framed message to the peer with the given address.
+     * @param address The peer address as returned by sockpp::inet_address::to_string().
+     * @param frame The complete frame including the length prefix, which may be shared with other connections.
+     * @return The number of bytes queued, or -1 if there is no such connection or the connection was evicted.
+     *
+     * This function never blocks on the socket (it only waits for room in the send queue if the overflow policy is
+     * send_queue::overflow_policy::backpressure). It may be called from any thread.
+     */
+    ssize_t send(const std::string& address, send_queue::frame_ptr frame);
+
+    /**
+     * @brief Gets the number of currently open connections.
+     * @return The number of open connections.
+     */
+    [[nodiscard]] size_t get_nof_connections() const;
+
+private:
+    struct connection;
+    struct worker;
+
+    /**
+     * @brief Event loop of one I/O thread.
+     * @param w The worker whose epoll instance is served.
+     */
+    void run(worker* w);
+
+    /**
+     * @brief Reads everything available on a connection and dispatches all complete frames.
+     * @param conn The readable connection.
+     * @return A boolean indicating whether the connection is still open.
+     */
+    bool on_readable(const std::shared_ptr<connection>& conn);
+
+    /**
+     * @brief Writes the queued frames of a connection until the queue is empty or the socket would block. Must only be
+     * called on the I/O thread of the connection.
+     * @param conn The writable connection.
+     * @return A boolean indicating whether the connection is still open.
+     */
+    bool on_writable(const std::shared_ptr<connection>& conn);
+
+    /**
+     * @brief Shuts down a connection whose client could not keep up with its messages. The I/O thread of the
+     * connection then notices the hang-up and closes it.
+     * @param conn The connection to evict.
+     */
+    void evict(const std::shared_ptr<connection>& conn);
+
+    /**
+     * @brief Removes a connection from its epoll instance and from the address lookup table, and closes its socket.
+     * The close handler is called once the connection is closed.
+     * @param conn The connection to close.
+     */
+    void close_connection(const std::shared_ptr<connection>& conn);
+
+    /**
+     * @brief Enables or disables write-readiness notifications for a connection.
+     * @param conn The connection.
+     * @param enabled Whether the I/O thread should be woken up once the socket is writable.
+     */
+    void set_write_interest(const connection& conn, bool enabled) const;
+
+    message_handler _handler;                                   ///< Called with every complete incoming frame.
+    close_handler _on_close;                                    ///< Called with the address of a closed connection.
+    send_queue::limits _queue_limits;                           ///< Limits of the send queue of every connection.
+    std::vector<std::unique_ptr<worker>> _workers;              ///< The I/O threads and their epoll instances.
+    std::atomic<unsigned int> _next_worker {0};                 ///< Round-robin counter used to assign connections.
+    std::atomic<bool> _running {true};                          ///< Cleared to stop the I/O threads.
+
+    mutable std::shared_mutex _connections_lock;                ///< Protects _connections.
+    std::unordered_map<std::string, std::shared_ptr<connection>> _connections;  ///< Open connections by peer address.
+};
+
+#endif //WIZARD_IO_REACTOR_H
@@ -0,0 +1,43 @@
+//
+// A mailbox queues the commands of one game and executes them serially on the worker_pool (see mailbox.h).
+//
+
+#include "mailbox.h"
+
+#include <iostream>
+
+mailbox::mailbox(worker_pool& pool) : _pool(pool) { }
+
+void mailbox::post(command cmd) {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _commands.push_back(std::move(cmd));
+        if (_scheduled) {
+            return;     // the task that drains the mailbox also executes this command
+        }
+        _scheduled = true;
+    }
+    _pool.submit([self = shared_from_this()] { self->drain(); });
+}
+
+void mailbox::drain() {
+    for (size_t i = 0; i < max_batch; i++) {
+        command cmd;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            if (_commands.empty()) {
+                _scheduled = false;
+                return;
+            }
+            cmd = std::move(_commands.front());
+            _commands.pop_front();
+        }
+        try {
+            cmd();
+        } catch (const std::exception& e) {
+            std::cerr << "Error while executing a command of a game" << std::endl << e.what() << std::endl;
+        }
+    }
+    // more commands are waiting, they are executed after the tasks that were queued in the meantime
+    _pool.submit([self = shared_from_this()] { self->drain(); });
+}
@@ -0,0 +1,57 @@
+//
+// A mailbox queues the commands of one game (see game_instance::post). The commands are executed one after another on
+// the worker_pool, in the order they were posted, so the game state is only ever modified by one thread at a time
+// without being locked, and the games do not wait for each other.
+//
+
+#ifndef WIZARD_MAILBOX_H
+#define WIZARD_MAILBOX_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "worker_pool.h"
+
+/**
+ * @class mailbox
+ * @brief Queue of commands that are executed serially on a worker_pool.
+ *
+ * At most one task of the pool drains a mailbox at any time. Posting to an idle mailbox submits such a task, posting
+ * to a mailbox that is already scheduled only queues the command. After a batch of commands, a mailbox that still has
+ * commands waiting is submitted to the pool again, so one busy game cannot hold on to a worker while other games wait.
+ * Only the queue itself is protected by a lock, which is never held while a command is executed.
+ */
+class mailbox : public std::enable_shared_from_this<mailbox> {
+
+public:
+    using command = std::function<void()>;
+
+    /**
+     * @brief Constructs an empty mailbox.
+     * @param pool The pool that executes the commands. It must outlive the mailbox.
+     */
+    explicit mailbox(worker_pool& pool);
+
+    mailbox(const mailbox&) = delete;
+    mailbox& operator=(const mailbox&) = delete;
+
+    /**
+     * @brief Queues a command. Called by any thread, the mailbox must be owned by a shared_ptr.
+     * @param cmd The command. Exceptions thrown by it are logged and otherwise ignored.
+     */
+    void post(command cmd);
+
+private:
+    static constexpr size_t max_batch = 16;     // commands executed before other mailboxes get a turn
+
+    worker_pool& _pool;
+    std::mutex _lock;                           // protects _commands and _scheduled
+    std::deque<command> _commands;
+    bool _scheduled = false;                    // whether a task of the pool is draining the mailbox
+
+    void drain();
+};
+
+#endif //WIZARD_MAILBOX_H
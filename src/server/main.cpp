@@ -2,10 +2,78 @@
 // Created by manuel on 17.03.21.
 //
 
+#include <iostream>
+#include <string>
+
 #include "server_network_manager.h"
+#include "worker_pool.h"
+
+int main(int argc, char* argv[]) {
+    // optional command line arguments:
+    //   --io=threads|reactor   how client connections are served (default: threads)
+    //   --io-threads=<n>       number of I/O threads in reactor mode (default: number of hardware threads)
+    //   --workers=<n>          number of worker threads that execute the requests of all games
+    //                          (default: number of hardware threads)
+    //   --send-queue-kb=<n>    outgoing kilobytes queued per client before it counts as slow (default: 1024)
+    //   --slow-clients=evict|backpressure[:<ms>]
+    //                          disconnect a slow client at once, or first wait up to <ms> milliseconds (default: 100)
+    //                          for it to catch up (default: evict)
+    server_network_manager::io_mode mode = server_network_manager::io_mode::thread_per_connection;
+    unsigned int nof_io_threads = 0;
+    send_queue::limits send_limits;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--io=threads") {
+            mode = server_network_manager::io_mode::thread_per_connection;
+        } else if (arg == "--io=reactor") {
+            mode = server_network_manager::io_mode::reactor;
+        } else if (arg.rfind("--io-threads=", 0) == 0) {
+            try {
+                nof_io_threads = std::stoul(arg.substr(std::string("--io-threads=").size()));
+            } catch (std::exception& e) {
+                std::cerr << "Invalid number of I/O threads: " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--workers=", 0) == 0) {
+            try {
+                worker_pool::set_default_nof_threads(std::stoul(arg.substr(std::string("--workers=").size())));
+            } catch (std::exception& e) {
+                std::cerr << "Invalid number of worker threads: " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--send-queue-kb=", 0) == 0) {
+            try {
+                send_limits.max_bytes = std::stoul(arg.substr(std::string("--send-queue-kb=").size())) * 1024;
+            } catch (std::exception& e) {
+                std::cerr << "Invalid send queue size: " << arg << std::endl;
+                return 1;
+            }
+        } else if (arg == "--slow-clients=evict") {
+            send_limits.policy = send_queue::overflow_policy::evict;
+        } else if (arg.rfind("--slow-clients=backpressure", 0) == 0) {
+            send_limits.policy = send_queue::overflow_policy::backpressure;
+            const std::string wait = arg.substr(std::string("--slow-clients=backpressure").size());
+            if (!wait.empty()) {
+                try {
+                    if (wait[0] != ':') {
+                        throw std::invalid_argument(wait);
+                    }
+                    send_limits.max_wait = std::chrono::milliseconds(std::stoul(wait.substr(1)));
+                } catch (std::exception& e) {
+                    std::cerr << "Invalid backpressure wait: " << arg << std::endl;
+                    return 1;
+                }
+            }
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl
+                      << "Usage: " << argv[0] << " [--io=threads|reactor] [--io-threads=<n>] [--workers=<n>] [--send-queue-kb=<n>]"
+                      << " [--slow-clients=evict|backpressure[:<ms>]]" << std::endl;
+            return 1;
+        }
+    }
 
-int main() {
     // create server_network_manager, which listens endlessly for new connections
-    server_network_manager server;
+    server_network_manager server(mode, nof_io_threads, send_limits);
     return 0;
-}
\ No newline at end of file
+}
@@ -3,40 +3,30 @@
 //
 // The player_manager only exists on the server side. It stores all connected users since starting the server. It offers
 // functionality to retrieve players by id or adding players when they first connect to the server.
+// The players are stored in a sharded_map, so that requests of different players do not contend for the same lock.
+// The players are reference counted: a removed player is deleted once neither a request nor a game uses it anymore.
 //
 
 #include "player_manager.h"
 
-// Initialize static map
-std::unordered_map<std::string, player*> player_manager::_players_lut = {};
-
-bool player_manager::try_get_player(const std::string& player_id, player *&player_ptr) {
+bool player_manager::try_get_player(const entity_id& player_id, std::shared_ptr<player>& player_ptr) {
     player_ptr = nullptr;
-    _rw_lock.lock_shared();
-    auto it = player_manager::_players_lut.find(player_id);
-    if (it != _players_lut.end()) {
-        player_ptr = it->second;
-    }
-    _rw_lock.unlock_shared();
-    return player_ptr;
+    return _players_lut.try_get(player_id, player_ptr);
 }
 
-bool player_manager::add_or_get_player(std::string name, const std::string& player_id, player *&player_ptr) {
+bool player_manager::add_or_get_player(std::string name, const entity_id& player_id, std::shared_ptr<player>& player_ptr) {
     if (try_get_player(player_id, player_ptr)) {
         return true;
     }
-    player_ptr = new player(player_id, name);
-    _rw_lock.lock();    // exclusive
-    player_manager::_players_lut.insert({player_id, player_ptr});
-    _rw_lock.unlock();
+    // if the same player was added concurrently, player_ptr is set to that player and the new one is deleted
+    player_ptr = std::make_shared<player>(player_id, name);
+    _players_lut.try_insert(player_id, player_ptr);
     return true;
 }
 
-bool player_manager::remove_player(const std::string& player_id, player *&player) {
+bool player_manager::remove_player(const entity_id& player_id, std::shared_ptr<player>& player) {
     if (try_get_player(player_id, player)) {
-        _rw_lock.lock();    // exclusive
-        player_manager::_players_lut.erase(player_id);
-        _rw_lock.unlock();
+        _players_lut.erase(player_id);
         return true;
     }
     return false;
@@ -3,28 +3,29 @@
 //
 // The player_manager only exists on the server side. It stores all connected users since starting the server. It offers
 // functionality to retrieve players by id or adding players when they first connect to the server.
+// The players are stored in a sharded_map, so that requests of different players do not contend for the same lock.
+// The players are reference counted: a removed player is deleted once neither a request nor a game uses it anymore.
 //
 
 #ifndef WIZARD_PLAYER_MANAGER_H
 #define WIZARD_PLAYER_MANAGER_H
 
+#include <memory>
 #include <string>
-#include <shared_mutex>
-#include <unordered_map>
 
+#include "sharded_map.h"
 #include "../common/game_state/player/player.h"
 
 class player_manager {
 
 private:
 
-    inline static std::shared_mutex _rw_lock;
-    static std::unordered_map<std::string, player*> _players_lut;
+    inline static sharded_map<entity_id, std::shared_ptr<player>> _players_lut;
 
 public:
-    static bool try_get_player(const std::string& player_id, player*& player_ptr);
-    static bool add_or_get_player(std::string name, const std::string& player_id, player*& player_ptr);
-    static bool remove_player(const std::string& player_id, player*& player);  // not implemented
+    static bool try_get_player(const entity_id& player_id, std::shared_ptr<player>& player_ptr);
+    static bool add_or_get_player(std::string name, const entity_id& player_id, std::shared_ptr<player>& player_ptr);
+    static bool remove_player(const entity_id& player_id, std::shared_ptr<player>& player);
 };
 
 
@@ -0,0 +1,36 @@
+//
+// The request_decoder turns the payload of a received frame into a request_view without heap allocations.
+//
+
+#include "request_decoder.h"
+
+#include "../common/serialization/binary_codec.h"
+
+request_decoder::request_decoder() :
+        _value_allocator(_value_buffer, value_buffer_size),
+        _parse_allocator(_parse_buffer, parse_buffer_size),
+        _document(&_value_allocator, parse_buffer_size / 2, &_parse_allocator)
+{ }
+
+const request_view& request_decoder::decode(const frame_reader::frame& f) {
+    // nothing in the pools is referenced anymore once the document is reset
+    _document.SetNull();
+    _value_allocator.Clear();
+    _parse_allocator.Clear();
+
+    if (f.encoding == wire_format::encoding::binary) {
+        binary_codec::decode(f.data, f.size, _document, _document.GetAllocator());
+    } else {
+        _document.ParseInsitu(f.data);
+        if (_document.HasParseError()) {
+            throw WizardException("Failed to parse json message");
+        }
+    }
+
+    request_view::from_json(_document, _view);
+    return _view;
+}
+
+const request_decoder::pooled_document& request_decoder::get_json() const {
+    return _document;
+}
@@ -0,0 +1,62 @@
+//
+// The request_decoder turns the payload of a received frame into a request_view without heap allocations.
+//
+
+#ifndef WIZARD_REQUEST_DECODER_H
+#define WIZARD_REQUEST_DECODER_H
+
+#include "../common/network/frame_reader.h"
+#include "../common/network/requests/request_view.h"
+
+/**
+ * @class request_decoder
+ * @brief Decodes the requests of one connection, reusing the same memory for every request.
+ *
+ * Json payloads are parsed in situ (see frame_reader), so the strings of the parsed document point into the frame
+ * buffer. The values of the document and rapidjson's parse stack are placed in memory pools whose first chunk is a
+ * buffer inside the decoder; both pools are reset before every request. As long as a request fits into these buffers,
+ * which all regular requests do, decoding does not allocate any memory. Larger requests make the pools allocate
+ * additional chunks, which are freed again with the next request.
+ *
+ * Every connection owns a decoder, since the returned view is only valid until the next request is decoded.
+ */
+class request_decoder {
+
+public:
+    /// A json document that also takes rapidjson's parse stack from a memory pool.
+    using pooled_document = rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>,
+                                                       rapidjson::MemoryPoolAllocator<>>;
+
+private:
+    static constexpr size_t value_buffer_size = 2048;   ///< Values and (binary encoded) strings of a request.
+    static constexpr size_t parse_buffer_size = 1024;   ///< The parse stack of rapidjson.
+
+    alignas(8) char _value_buffer[value_buffer_size];
+    alignas(8) char _parse_buffer[parse_buffer_size];
+    rapidjson::MemoryPoolAllocator<> _value_allocator;
+    rapidjson::MemoryPoolAllocator<> _parse_allocator;
+    pooled_document _document;
+    request_view _view;
+
+public:
+    request_decoder();
+
+    request_decoder(const request_decoder&) = delete;
+    request_decoder& operator=(const request_decoder&) = delete;
+
+    /**
+     * @brief Decodes the request contained in a frame.
+     * @param f The received frame. Its payload may be modified.
+     * @return The decoded request, valid until the next call and as long as the payload of the frame is valid.
+     * Throws a WizardException if the payload is not a valid request.
+     */
+    const request_view& decode(const frame_reader::frame& f);
+
+    /**
+     * @brief Gets the json document of the last decoded request.
+     * @return The json document, valid until the next call of decode().
+     */
+    [[nodiscard]] const pooled_document& get_json() const;
+};
+
+#endif //WIZARD_REQUEST_DECODER_H
@@ -10,74 +10,147 @@
 #include "player_manager.h"
 #include "game_instance_manager.h"
 #include "game_instance.h"
+#include "server_network_manager.h"
+#include "worker_pool.h"
+
+// how often a join request is routed to another open game, if its game was filled or started in the meantime
+static constexpr int max_join_attempts = 10;
+
+
+request_command::request_command(const request_view& req)
+        : type(req.type),
+          req_id(req.req_id),
+          player_id(req.player_id),
+          game_id(req.game_id),
+          player_name(req.player_name),
+          card_id(req.card_id),
+          trick_estimate(req.trick_estimate)
+{ }
+
+request_view request_command::view() const {
+    request_view req;
+    req.type = type;
+    req.req_id = req_id;
+    req.player_id = player_id;
+    req.game_id = game_id;
+    req.player_name = player_name;
+    req.card_id = card_id;
+    req.trick_estimate = trick_estimate;
+    return req;
+}
+
+
+void request_handler::dispatch_request(const request_view& req, reply_function reply) {
+    dispatch_command(std::make_shared<request_command>(req), std::move(reply));
+}
+
+void request_handler::dispatch_command(std::shared_ptr<request_command> cmd, reply_function reply) {
+    // a request with an invalid id is not routed to any game, handle_request answers it with an error
+    entity_id player_id;
+    entity_id game_id;
+    std::shared_ptr<game_instance> game_instance_ptr;
+    if (entity_id::try_parse(cmd->player_id, player_id) && entity_id::try_parse(cmd->game_id, game_id)) {
+        game_instance_ptr = game_instance_manager::route_request(player_id, cmd->type == RequestType::join_game,
+                                                                 game_id);
+    }
+
+    auto execute = [cmd, reply = std::move(reply), game_instance_ptr]() {
+        request_response* res = handle_request(cmd->view(), game_instance_ptr);
+        if (res == nullptr) {
+            // the game was filled or started before the player could join, try the next open game
+            if (++cmd->nof_join_attempts < max_join_attempts) {
+                dispatch_command(cmd, reply);
+                return;
+            }
+            res = new request_response("", cmd->req_id, false, nullptr, "Could not join any game.");
+        }
+        reply(*res);
+        delete res;
+    };
+
+    if (game_instance_ptr != nullptr) {
+        game_instance_ptr->post(std::move(execute));
+    } else {
+        worker_pool::get_instance().submit(std::move(execute));
+    }
+}
 
-#include "../common/network/requests/join_game_request.h"
-#include "../common/network/requests/estimate_tricks_request.h"
-#include "../common/network/requests/play_card_request.h"
-#include "../common/network/requests/leave_game_request.h"
+// Looks up the player of a request and their game, which must be the game the request was routed to, so that a game
+// is only ever modified by the commands of its own mailbox.
+static bool try_get_player_and_routed_game(const entity_id& player_id,
+                                           const std::shared_ptr<game_instance>& routed_game,
+                                           std::shared_ptr<player>& player,
+                                           std::shared_ptr<game_instance>& game_instance_ptr, std::string& err) {
+    if (!game_instance_manager::try_get_player_and_game_instance(player_id, player, game_instance_ptr, err)) {
+        return false;
+    }
+    if (game_instance_ptr != routed_game) {
+        err = "The request of player " + player_id.to_string() + " did not reach the game of the player.";
+        return false;
+    }
+    return true;
+}
 
 
-request_response* request_handler::handle_request(const client_request* const req)
+request_response* request_handler::handle_request(const request_view& req,
+                                                  const std::shared_ptr<game_instance>& routed_game)
 {
     // Prepare variables that are used by every request type
-    player* player;
+    // (the player and the game are kept alive until the request is handled, even if they are removed meanwhile)
+    std::shared_ptr<player> player;
     std::string err;
-    game_instance* game_instance_ptr = nullptr;
+    std::shared_ptr<game_instance> game_instance_ptr;
 
 
     // Get common properties of requests
-    RequestType type = req->get_type();
-    std::string req_id = req->get_req_id();
-    std::string game_id = req->get_game_id();
-    std::string player_id = req->get_player_id();
+    RequestType type = req.type;
+    std::string req_id(req.req_id);
+
+    // the ids are only converted from text here, any id that no player or game can have is rejected
+    entity_id game_id;
+    entity_id player_id;
+    if (!entity_id::try_parse(req.game_id, game_id) || !entity_id::try_parse(req.player_id, player_id)
+        || player_id.is_nil()) {
+        return new request_response("", req_id, false, nullptr, "Invalid player or game id.");
+    }
 
 
     // Switch behavior according to request type
     switch(type) {
         // #################### JOIN GAME #####################  //
         case RequestType::join_game: {
-                std::string player_name = ((join_game_request *) req)->get_player_name();
+                std::string player_name(req.player_name);
 
                 // Create new player or get existing one with that name
                 player_manager::add_or_get_player(player_name, player_id, player);
 
-                if (game_id.empty()) {
-                    // join any game
-                    if (game_instance_manager::try_add_player_to_any_game(player, game_instance_ptr, err)) {
-                        // game_instance_ptr got updated to the joined game
-
-                        // return response with full game_state attached
-                        return new request_response(game_instance_ptr->get_id(), req_id, true,
-                                                    game_instance_ptr->get_game_state()->to_json(), err);
-                    } else {
-                        // failed to find game to join
-                        return new request_response("", req_id, false, nullptr, err);
-                    }
-                } else {
-                    // join a specific game denoted by req->get_game_id()
-                    if (game_instance_manager::try_get_game_instance(game_id, game_instance_ptr)) {
-                        if (game_instance_manager::try_add_player(player, game_instance_ptr, err)) {
-                            // return response with full game_state attached
-                            return new request_response(game_id, req_id, true,
-                                                        game_instance_ptr->get_game_state()->to_json(), err);
-                        } else {
-                            // failed to join requested game
-                            return new request_response("", req_id, false, nullptr, err);
-                        }
-                    } else {
-                        // failed to find requested game
-                        return new request_response("", req_id, false, nullptr, "Requested game could not be found.");
+                game_instance_ptr = routed_game;
+                if (game_instance_ptr == nullptr) {
+                    // failed to find requested game
+                    return new request_response("", req_id, false, nullptr, "Requested game could not be found.");
+                }
+                if (game_instance_manager::try_add_player(player, game_instance_ptr, err)) {
+                    // the full game_state was already sent to the player
+                    return new request_response(game_instance_ptr->get_id(), req_id, true, nullptr, err);
+                }
+                if (player->get_game_id().is_nil()) {
+                    // the player did not join this game, so their later requests must not go there
+                    game_instance_manager::forget_route(player_id);
+                    if (game_id.is_nil() && !game_instance_ptr->is_joinable()) {
+                        return nullptr;     // join any other game instead
                     }
                 }
+                // failed to join the game
+                return new request_response("", req_id, false, nullptr, err);
         }
 
 
             // ##################### START GAME ##################### //
         case RequestType::start_game: {
-                if (game_instance_manager::try_get_player_and_game_instance(player_id, player, game_instance_ptr, err)) {
-                    if (game_instance_ptr->start_game(player, err)) {
-                        return new request_response(game_instance_ptr->get_id(), req_id, true,
-                                                    game_instance_ptr->get_game_state()->to_json(), err);
+                if (try_get_player_and_routed_game(player_id, routed_game, player, game_instance_ptr, err)) {
+                    if (game_instance_ptr->start_game(player.get(), err)) {
+                        // the state change was already broadcast to all players as state diff
+                        return new request_response(game_instance_ptr->get_id(), req_id, true, nullptr, err);
                     }
                 }
                 return new request_response("", req_id, false, nullptr, err);
@@ -86,12 +159,16 @@ request_response* request_handler::handle_request(const client_request* const re
 
             // ##################### PLAY CARD ##################### //
         case RequestType::play_card: {
-                if (game_instance_manager::try_get_player_and_game_instance(player_id, player, game_instance_ptr, err)) {
-                    card *drawn_card;
-                    std::string card_id = ((play_card_request *) req)->get_card_id();
-                    if (game_instance_ptr->play_card(player, card_id, err)) {
-                        return new request_response(game_instance_ptr->get_id(), req_id, true,
-                                                    game_instance_ptr->get_game_state()->to_json(), err);
+                if (try_get_player_and_routed_game(player_id, routed_game, player, game_instance_ptr, err)) {
+                    entity_id card_id;
+                    if (!entity_id::try_parse(req.card_id, card_id)) {
+                        err = "This card is not in your hand.";
+                    } else if (game_instance_ptr->play_card(player.get(), card_id, err)) {
+                        if (game_instance_ptr->is_finished()) {
+                            game_instance_manager::retire_game(game_instance_ptr.get());
+                        }
+                        // the state change was already broadcast to all players as state diff
+                        return new request_response(game_instance_ptr->get_id(), req_id, true, nullptr, err);
                     }
                 }
                 return new request_response("", req_id, false, nullptr, err);
@@ -101,37 +178,54 @@ request_response* request_handler::handle_request(const client_request* const re
 
             // ##################### ESTIMATE TRICKS #####################  //
         case RequestType:: estimate_tricks: {
-                if (game_instance_manager::try_get_player_and_game_instance(player_id, player, game_instance_ptr, err)) {
-                    int nof_tricks = ((estimate_tricks_request* )req)->get_trick_estimate(); //create pointer to instance of estimate_tricks_request, then call getter function
-                    if (game_instance_ptr->estimate_tricks(player, err, nof_tricks)) { // not implemented yet in game_state.cpp
-                        return new request_response(game_instance_ptr->get_id(), req_id, true,
-                                                    game_instance_ptr->get_game_state()->to_json(), err);
+                if (try_get_player_and_routed_game(player_id, routed_game, player, game_instance_ptr, err)) {
+                    int nof_tricks = req.trick_estimate;
+                    if (game_instance_ptr->estimate_tricks(player.get(), err, nof_tricks)) { // not implemented yet in game_state.cpp
+                        // the state change was already broadcast to all players as state diff
+                        return new request_response(game_instance_ptr->get_id(), req_id, true, nullptr, err);
                     }
                 }
                 return new request_response("", req_id, false, nullptr, err);
         }
+
+
+            // ##################### RESYNC ##################### //
+        case RequestType::resync: {
+                // the client missed a state diff, so it gets the full state again
+                if (try_get_player_and_routed_game(player_id, routed_game, player, game_instance_ptr, err)) {
+                    game_instance_ptr->send_full_state(player.get());
+                    return new request_response(game_instance_ptr->get_id(), req_id, true, nullptr, err);
+                }
+                return new request_response("", req_id, false, nullptr, err);
+        }
+
+
         case RequestType::leave_game:
             {
                 // Case 1: player is in a game
                 //remove player from game via game instance manager -> game instance -> game state
-                if (game_instance_manager::try_get_player_and_game_instance(player_id, player, game_instance_ptr, err)) {
-                    if (game_instance_manager::try_remove_player(player, game_id, err)) {
+                if (try_get_player_and_routed_game(player_id, routed_game, player, game_instance_ptr, err)) {
+                    if (game_instance_manager::try_remove_player(player, game_instance_ptr, err)) {
                         std::cout << "Player successfully removed from the game " << std::endl;
                         if (player_manager::remove_player(player_id, player)){
+                            game_instance_manager::forget_route(player_id);
+                            server_network_manager::on_player_left(player_id);
                             return new request_response(game_instance_ptr->get_id(), req_id, true,
-                                                        game_instance_ptr->get_game_state()->to_json(), err);
+                                                        game_instance_ptr->get_state_json(nullptr), err);
                         }
-
                     }
+                    return new request_response("", req_id, false, nullptr, err);
                 } // Case 2: player not in game yet but already in LUT
                 else if(player_manager::remove_player(player_id, player)) {
-                    return new request_response(game_instance_ptr->get_id(), req_id, true,
-                                                        game_instance_ptr->get_game_state()->to_json(), err);
+                    game_instance_manager::forget_route(player_id);
+                    server_network_manager::on_player_left(player_id);
+                    return new request_response("", req_id, true, nullptr, err);
                 } else {
                     err = "Player or game instance were not found.";
                     return new request_response("", req_id, false, nullptr, err);
                 }
             }
+
         // ##################### UNKNOWN REQUEST ##################### //
     default:
             return new request_response("", req_id, false, nullptr, "Unknown RequestType " + std::to_string(type));
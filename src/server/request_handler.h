@@ -5,12 +5,49 @@
 #ifndef WIZARD_REQUEST_HANDLER_H
 #define WIZARD_REQUEST_HANDLER_H
 
+#include <functional>
+#include <memory>
+#include <string>
+
 #include "../common/network/responses/server_response.h"
-#include "../common/network/requests/client_request.h"
+#include "../common/network/requests/request_view.h"
 #include "../common/network/responses/request_response.h"
 
+class game_instance;
+
+// An owned copy of a request, which can be executed after the frame it was decoded from is gone.
+struct request_command {
+    RequestType type;
+    std::string req_id;
+    std::string player_id;
+    std::string game_id;
+    std::string player_name;
+    std::string card_id;
+    int trick_estimate;
+    int nof_join_attempts = 0;      // how often a join request found its game full or started in the meantime
+
+    explicit request_command(const request_view& req);
+    // A view of the request, valid as long as the command exists.
+    [[nodiscard]] request_view view() const;
+};
+
 class request_handler {
 public:
-    static request_response* handle_request(const client_request* const req);
+    // Called with the response of a dispatched request, on the worker that executed it.
+    using reply_function = std::function<void(const request_response& res)>;
+
+    // Queues the request in the mailbox of the game it concerns (see game_instance_manager::route_request) and
+    // returns right away. The request is executed on the worker_pool after all earlier requests of that game, and
+    // 'reply' is called with its response. Requests that do not concern any game are executed on any worker.
+    static void dispatch_request(const request_view& req, reply_function reply);
+
+    // Executes a request and returns its response. Must be called from a command of the mailbox of 'game_instance_ptr',
+    // the game the request was routed to (or nullptr if it does not concern any game). Returns nullptr if the request
+    // has to be routed again, because it should join any game but its game was filled or started in the meantime.
+    static request_response* handle_request(const request_view& req,
+                                            const std::shared_ptr<game_instance>& game_instance_ptr);
+
+private:
+    static void dispatch_command(std::shared_ptr<request_command> cmd, reply_function reply);
 };
 #endif //WIZARD_REQUEST_HANDLER_H
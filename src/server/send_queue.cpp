@@ -0,0 +1,93 @@
+//
+// The send_queue holds the frames that are waiting to be written to one client connection (see send_queue.h).
+//
+
+#include "send_queue.h"
+
+send_queue::send_queue(limits lim) : _limits(lim) { }
+
+send_queue::push_result send_queue::push(frame_ptr frame) {
+    std::unique_lock<std::mutex> guard(_lock);
+    if (_closed) {
+        return push_result::closed;
+    }
+    // a frame larger than the whole limit is still accepted into an empty queue, it could never be sent otherwise
+    const auto fits = [this, &frame] {
+        return _closed || _nof_bytes == 0 || _nof_bytes + frame->size() <= _limits.max_bytes;
+    };
+    if (!fits() && _limits.policy == overflow_policy::backpressure) {
+        _space.wait_for(guard, _limits.max_wait, fits);
+        if (_closed) {
+            return push_result::closed;
+        }
+    }
+    if (!fits()) {
+        _evicted = true;
+        _closed = true;
+        _frames.clear();
+        _nof_bytes = 0;
+        _ready.notify_all();
+        _space.notify_all();
+        return push_result::evicted;
+    }
+    _nof_bytes += frame->size();
+    _frames.push_back(std::move(frame));
+    _ready.notify_one();
+    return push_result::queued;
+}
+
+void send_queue::front(frame_ptr& frame, size_t& offset) {
+    std::lock_guard<std::mutex> guard(_lock);
+    frame = _frames.empty() ? nullptr : _frames.front();
+    offset = _front_offset;
+}
+
+void send_queue::wait_front(frame_ptr& frame, size_t& offset) {
+    std::unique_lock<std::mutex> guard(_lock);
+    _ready.wait(guard, [this] { return _closed || !_frames.empty(); });
+    frame = _closed ? nullptr : _frames.front();
+    offset = _front_offset;
+}
+
+void send_queue::consume(const size_t count) {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_frames.empty()) {
+        return;     // closed in the meantime
+    }
+    _front_offset += count;
+    _nof_bytes -= count;
+    if (_front_offset >= _frames.front()->size()) {
+        _frames.pop_front();
+        _front_offset = 0;
+    }
+    _space.notify_all();
+}
+
+void send_queue::close() {
+    std::lock_guard<std::mutex> guard(_lock);
+    _closed = true;
+    _frames.clear();
+    _nof_bytes = 0;
+    _ready.notify_all();
+    _space.notify_all();
+}
+
+bool send_queue::is_empty() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _frames.empty();
+}
+
+bool send_queue::is_closed() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _closed;
+}
+
+bool send_queue::is_evicted() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _evicted;
+}
+
+size_t send_queue::get_nof_bytes() const {
+    std::lock_guard<std::mutex> guard(_lock);
+    return _nof_bytes;
+}
@@ -0,0 +1,120 @@
+//
+// The send_queue holds the frames that are waiting to be written to one client connection. Frames are shared,
+// immutable buffers, so a broadcast encodes a message once and enqueues the same buffer for every receiver. The queue
+// is bounded: a client that does not read its messages fast enough is evicted instead of letting its messages pile up
+// in the server or stalling the threads that send to it.
+//
+
+#ifndef WIZARD_SEND_QUEUE_H
+#define WIZARD_SEND_QUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * @class send_queue
+ * @brief Bounded queue of outgoing frames of one connection, filled by any thread and drained by one writer.
+ *
+ * Producers only take the queue's own lock to enqueue a frame, never a lock around socket I/O. The writer (a writer
+ * thread per connection, or the I/O thread of the io_reactor) takes the frame at the front, writes it without holding
+ * any lock, and then reports the number of bytes written with consume(), so partially written frames are continued
+ * where they stopped.
+ *
+ * If a frame does not fit into the queue anymore, the overflow policy decides what happens: the connection is either
+ * evicted right away, or the producer waits for the writer to make room (backpressure) for a limited time, after
+ * which the connection is evicted. An evicted queue is closed and the owner of the connection has to shut it down.
+ */
+class send_queue {
+
+public:
+    using frame_ptr = std::shared_ptr<const std::string>;
+
+    // What happens when a frame does not fit into a full queue
+    enum class overflow_policy {
+        evict,          // the slow consumer is disconnected at once
+        backpressure    // the producer waits up to max_wait for room, then the slow consumer is disconnected
+    };
+
+    struct limits {
+        size_t max_bytes = 1 << 20;                                 // queued bytes per connection
+        overflow_policy policy = overflow_policy::evict;
+        std::chrono::milliseconds max_wait {100};                   // only used with overflow_policy::backpressure
+    };
+
+    enum class push_result {
+        queued,         // the frame will be written
+        evicted,        // the frame did not fit, the queue is closed and the connection must be shut down
+        closed          // the queue was already closed, the frame is dropped
+    };
+
+    explicit send_queue(limits lim);
+
+    send_queue(const send_queue&) = delete;
+    send_queue& operator=(const send_queue&) = delete;
+
+    /**
+     * @brief Enqueues a frame. Called by any thread.
+     * @param frame The complete frame including the length prefix. The buffer must not be modified afterwards.
+     * @return Whether the frame was queued, or why not.
+     */
+    push_result push(frame_ptr frame);
+
+    /**
+     * @brief Gets the unwritten part of the frame at the front of the queue, without removing it.
+     * @param frame Set to the front frame, or to nullptr if the queue is empty.
+     * @param offset Set to the number of bytes of the front frame that were already written.
+     */
+    void front(frame_ptr& frame, size_t& offset);
+
+    /**
+     * @brief Waits until a frame can be written or the queue is closed, then behaves like front().
+     * @param frame Set to the front frame, or to nullptr if the queue got closed.
+     * @param offset Set to the number of bytes of the front frame that were already written.
+     */
+    void wait_front(frame_ptr& frame, size_t& offset);
+
+    /**
+     * @brief Marks bytes of the front frame as written and removes the frame once it is written completely.
+     * @param count The number of bytes written, at most the unwritten size of the front frame.
+     */
+    void consume(size_t count);
+
+    /**
+     * @brief Closes the queue: pending frames are dropped, waiting producers and the writer return.
+     */
+    void close();
+
+    [[nodiscard]] bool is_empty() const;
+
+    [[nodiscard]] bool is_closed() const;
+
+    /**
+     * @brief Checks whether the queue was closed because the client could not keep up.
+     * @return A boolean indicating whether the connection was evicted.
+     */
+    [[nodiscard]] bool is_evicted() const;
+
+    /**
+     * @brief Gets the number of bytes waiting to be written.
+     * @return The number of queued bytes, including the unwritten rest of a partially written frame.
+     */
+    [[nodiscard]] size_t get_nof_bytes() const;
+
+private:
+    const limits _limits;
+
+    mutable std::mutex _lock;
+    std::condition_variable _ready;         ///< Signaled when a frame was queued or the queue got closed.
+    std::condition_variable _space;         ///< Signaled when frames were written or the queue got closed.
+    std::deque<frame_ptr> _frames;
+    size_t _front_offset = 0;               ///< Bytes of the front frame that were already written.
+    size_t _nof_bytes = 0;                  ///< Unwritten bytes of all queued frames.
+    bool _closed = false;
+    bool _evicted = false;
+};
+
+#endif //WIZARD_SEND_QUEUE_H
@@ -7,20 +7,47 @@
 #include "server_network_manager.h"
 #include "request_handler.h"
 
+#include <algorithm>
+#include <csignal>
+#include <netinet/tcp.h>
+#include <tuple>
+
 // include server address configurations
 #include "../common/network/default.conf"
 #include "../common/network/responses/request_response.h"
 
 
-server_network_manager::server_network_manager() {
+server_network_manager::server_network_manager(io_mode mode, unsigned int nof_io_threads,
+                                               send_queue::limits send_limits) {
     if (_instance == nullptr) {
         _instance = this;
     }
+    _send_limits = send_limits;
     sockpp::socket_initializer socket_initializer; // Required to initialise sockpp
+#ifdef SIGPIPE
+    // a client that disconnects while we write to it must not terminate the server
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    if (mode == io_mode::reactor) {
+        if (io_reactor::is_supported()) {
+            if (nof_io_threads == 0) {
+                nof_io_threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            _reactor = new io_reactor(nof_io_threads, handle_incoming_message, _send_limits,
+                                      [](const std::string& address) { on_connection_closed(address); });
+            std::cout << "Serving connections with " << nof_io_threads << " I/O threads" << std::endl;
+        } else {
+            std::cerr << "The reactor I/O mode is not supported on this platform, "
+                         "falling back to one thread per connection" << std::endl;
+        }
+    }
     this->connect(default_server_host, default_port);   // variables from "default.conf"
 }
 
-server_network_manager::~server_network_manager() = default;
+server_network_manager::~server_network_manager() {
+    delete _reactor;
+    _reactor = nullptr;
+}
 
 void server_network_manager::connect(const std::string &url, const uint16_t port) {
     this->_acc = sockpp::tcp_acceptor(port);
@@ -46,16 +73,34 @@ void server_network_manager::listener_loop() {
         if (!sock) {
             std::cerr << "Error accepting incoming connection: "
                       << _acc.last_error_str() << std::endl;
+            continue;
+        }
+        // a request can be answered with several frames (e.g. the full state and the response), which must not wait
+        // for the acknowledgement of the previous one
+        sock.set_option(IPPROTO_TCP, TCP_NODELAY, 1);
+
+        if (_reactor != nullptr) {
+            // the reactor takes over the socket, incoming messages will be passed to handle_incoming_message()
+            _reactor->add_connection(std::move(sock));
         } else {
+            auto queue = std::make_shared<send_queue>(_send_limits);
             _rw_lock.lock();
-            _address_to_socket.emplace(sock.peer_address().to_string(), std::move(sock.clone()));
+            _address_to_queue[sock.peer_address().to_string()] = queue;
             _rw_lock.unlock();
+            // Create a writer thread that drains the send queue of the connection, so that no sender ever blocks
+            // on the socket.
+            std::thread writer(
+                    write_messages,
+                    sockpp::tcp_socket(sock.clone()),
+                    queue);
+            writer.detach();
             // Create a listener thread and transfer the new stream to it.
             // Incoming messages will be passed to handle_incoming_message().
             std::thread listener(
                     read_message,
                     std::move(sock),
-                    handle_incoming_message);
+                    handle_incoming_message,
+                    queue);
 
             listener.detach();
         }
@@ -63,48 +108,38 @@ void server_network_manager::listener_loop() {
 }
 
 // Runs in a thread and reads anything coming in on the 'socket'.
-// Once a message is fully received, the string is passed on to the 'handle_incoming_message()' function
-void server_network_manager::read_message(sockpp::tcp_socket socket, const std::function<void(const std::string&,
-                                                                                              const sockpp::tcp_socket::addr_t &)> &message_handler) {
+// Once a frame is fully received, its payload is passed on to the 'handle_incoming_message()' function
+void server_network_manager::read_message(sockpp::tcp_socket socket, const io_reactor::message_handler& message_handler,
+                                          std::shared_ptr<send_queue> queue) {
     sockpp::socket_initializer sockInit;    // initializes socket framework underneath
 
-    char buffer[512]; // 512 bytes
+    frame_reader reader;
+    request_decoder decoder;
     ssize_t count = 0;
-    ssize_t msg_bytes_read = 0;
-    ssize_t msg_length = 0;
-
-    while ((count = socket.read(buffer, sizeof(buffer))) > 0) {
-        try {
-            int i = 0;
-            std::stringstream ss_msg_length;
-            while (buffer[i] != ':' && i < count) {
-                ss_msg_length << buffer[i];
-                i++;
-            }
-            msg_length = std::stoi(ss_msg_length.str());
-            std::cout << "Expecting message of length " << msg_length << std::endl;
-
-            // put everything after the message length declaration into a stringstream
-            std::stringstream ss_msg;
-            ss_msg.write(&buffer[i+1], count - (i + 1));
-            msg_bytes_read = count - (i + 1);
-
-            // read the remaining packages
-            while (msg_bytes_read < msg_length && count > 0) {
-                count = socket.read(buffer, sizeof(buffer));
-                msg_bytes_read += count;
-                ss_msg.write(buffer, count);
-            }
+    // the address the queue was registered with, the peer address can no longer be read once the peer is gone
+    const std::string address = socket.peer_address().to_string();
 
-            if (msg_bytes_read == msg_length) {
-                // sanity check that really all bytes got read (possibility that count was <= 0, indicating a read error)
-                std::string msg = ss_msg.str();
-                message_handler(msg, socket.peer_address());    // attempt to parse client_request from 'msg'
-            } else {
-                std::cerr << "Could not read entire message. TCP stream ended before. Difference is " << msg_length - msg_bytes_read << std::endl;
+    while (true) {
+        size_t available = 0;
+        char* buffer = reader.prepare(available);   // read directly into the reader's buffer
+        if ((count = socket.read(buffer, available)) <= 0) {
+            break;
+        }
+        reader.commit(count);
+
+        // handle all complete frames, a read may contain several frames or only a part of one
+        frame_reader::frame f;
+        wire_format::frame_status status;
+        while ((status = reader.next_frame(f)) == wire_format::frame_status::complete) {
+            try {
+                message_handler(f, decoder, socket.peer_address());    // attempt to parse client_request from the payload
+            } catch (std::exception& e) { // Make sure the connection isn't torn down only because of a read error
+                std::cerr << "Error while reading message from " << socket.peer_address() << std::endl << e.what() << std::endl;
             }
-        } catch (std::exception& e) { // Make sure the connection isn't torn down only because of a read error
-            std::cerr << "Error while reading message from " << socket.peer_address() << std::endl << e.what() << std::endl;
+        }
+        if (status == wire_format::frame_status::malformed) {
+            std::cerr << "Received malformed message header from " << socket.peer_address() << std::endl;
+            break;
         }
     }
     if (count <= 0) {
@@ -112,99 +147,201 @@ void server_network_manager::read_message(sockpp::tcp_socket socket, const std::
                   << socket.last_error_str() << std::endl;
     }
 
-    std::cout << "Closing connection to " << socket.peer_address() << std::endl;
+    std::cout << "Closing connection to " << address << std::endl;
+    queue->close();     // stops the writer thread
+    socket.shutdown();
+    on_connection_closed(address, queue.get());
+}
+
+// Runs in a thread and writes the frames queued for the 'socket' in order. No lock is held while writing, so a
+// client that reads slowly only delays its own messages.
+void server_network_manager::write_messages(sockpp::tcp_socket socket, std::shared_ptr<send_queue> queue) {
+    sockpp::socket_initializer sockInit;    // initializes socket framework underneath
+
+    send_queue::frame_ptr frame;
+    size_t offset = 0;
+    while (true) {
+        queue->wait_front(frame, offset);
+        if (frame == nullptr) {
+            break;      // the queue was closed
+        }
+        ssize_t count = socket.write(frame->data() + offset, frame->size() - offset);
+        if (count <= 0) {
+            queue->close();
+            break;
+        }
+        queue->consume(count);
+    }
+    if (queue->is_evicted()) {
+        std::cerr << "Evicting slow client " << socket.peer_address() << std::endl;
+    }
+    // also ends the blocking read of the listener thread
     socket.shutdown();
 }
 
 
-void server_network_manager::handle_incoming_message(const std::string& msg, const sockpp::tcp_socket::addr_t& peer_address) {
+void server_network_manager::handle_incoming_message(const frame_reader::frame& msg, request_decoder& decoder,
+                                                     const sockpp::tcp_socket::addr_t& peer_address) {
+    const wire_format::encoding enc = msg.encoding;
+#ifdef PRINT_NETWORK_MESSAGES
+    // the payload is modified by parsing it in situ, so it is copied for the error output
+    const std::string content = enc == wire_format::encoding::json ? std::string(msg.payload()) : "(binary message)";
+#endif
     try {
-        // try to parse a json from the 'msg'
-        rapidjson::Document req_json;
-        req_json.Parse(msg.c_str());
-        // try to parse a client_request from the json
-        client_request* req = client_request::from_json(req_json);
-
-        // check if this is a connection to a new player
-        std::string player_id = req->get_player_id();
+        // try to parse a client_request from the 'msg'
+        const request_view& req = decoder.decode(msg);
+
+        // check if this is a connection to a new player (requests with an invalid player id are answered with an
+        // error by the request_handler)
+        entity_id player_id;
+        const bool is_valid_player_id = entity_id::try_parse(req.player_id, player_id) && !player_id.is_nil();
+        std::string address = peer_address.to_string();
         _rw_lock.lock_shared();
-        if (_player_id_to_address.find(player_id) == _player_id_to_address.end()) {
+        if (is_valid_player_id && _player_id_to_address.find(player_id) == _player_id_to_address.end()) {
             // save connection to this client
             _rw_lock.unlock_shared();
             std::cout << "New client with id " << player_id << std::endl;
             _rw_lock.lock();
-            _player_id_to_address.emplace(player_id, peer_address.to_string());
+            _player_id_to_address.emplace(player_id, address);
+            _address_to_encoding[address] = enc;
+            _rw_lock.unlock();
+        } else if (get_encoding(address) != enc) {
+            // the client switched its encoding
+            _rw_lock.unlock_shared();
+            _rw_lock.lock();
+            _address_to_encoding[address] = enc;
             _rw_lock.unlock();
         } else {
             _rw_lock.unlock_shared();
         }
 #ifdef PRINT_NETWORK_MESSAGES
-        std::cout << "Received valid request : " << msg << std::endl;
+        std::cout << "Received valid request : " << json_utils::to_string(&decoder.get_json()) << std::endl;
 #endif
-        // execute client request
-        server_response* res = request_handler::handle_request(req);
-        delete req;
-
-        // transform response into a json
-        rapidjson::Document* res_json = res->to_json();
-        delete res;
-
-        // transform json to string
-        std::string res_msg = json_utils::to_string(res_json);
+        // queue the request in the mailbox of its game, the response is sent by the worker that executes it
+        request_handler::dispatch_request(req, [address, enc](const request_response& res) {
+            // serialize the response into a frame in the encoding of the request
+            auto res_frame = std::make_shared<const std::string>(wire_format::make_frame(res, enc));
 
 #ifdef PRINT_NETWORK_MESSAGES
-        std::cout << "Sending response : " << res_msg << std::endl;
+            std::cout << "Sending response : " << json_utils::to_string(res) << std::endl;
 #endif
 
-        // send response back to client
-        send_message(res_msg, peer_address.to_string());
-        delete res_json;
+            // send response back to client
+            send_message(std::move(res_frame), address);
+        });
     } catch (const std::exception& e) {
-        std::cerr << "Failed to execute client request. Content was :\n"
-                  << msg << std::endl
+        std::cerr << "Failed to execute client request from " << peer_address << std::endl
+#ifdef PRINT_NETWORK_MESSAGES
+                  << "Content was :\n" << content << std::endl
+#endif
                   << "Error was " << e.what() << std::endl;
     }
 }
 
 
-void server_network_manager::on_player_left(std::string player_id) {
+void server_network_manager::on_connection_closed(const std::string& address, const send_queue* queue) {
+    _rw_lock.lock();
+    auto it = _address_to_queue.find(address);
+    if (queue == nullptr || (it != _address_to_queue.end() && it->second.get() == queue)) {
+        if (it != _address_to_queue.end()) {
+            _address_to_queue.erase(it);
+        }
+        _address_to_encoding.erase(address);
+    }
+    _rw_lock.unlock();
+}
+
+void server_network_manager::on_player_left(const entity_id& player_id) {
+    // the response to the leave request is still sent over the connection of the player
     _rw_lock.lock();
-    std::string address = _player_id_to_address[player_id];
     _player_id_to_address.erase(player_id);
-    _address_to_socket.erase(address);
     _rw_lock.unlock();
 }
 
-ssize_t server_network_manager::send_message(const std::string &msg, const std::string& address) {
+// must be called while holding the _rw_lock
+wire_format::encoding server_network_manager::get_encoding(const std::string& address) {
+    const auto it = _address_to_encoding.find(address);
+    return it == _address_to_encoding.end() ? wire_format::encoding::json : it->second;
+}
+
+ssize_t server_network_manager::send_message(send_queue::frame_ptr frame, const std::string& address) {
+    if (_reactor != nullptr) {
+        return _reactor->send(address, std::move(frame));   // never blocks on the socket
+    }
 
-    std::stringstream ss_msg;
-    ss_msg << std::to_string(msg.size()) << ':' << msg; // prepend message length
-    return _address_to_socket.at(address).write(ss_msg.str());
+    std::shared_ptr<send_queue> queue;
+    _rw_lock.lock_shared();
+    auto it = _address_to_queue.find(address);
+    if (it != _address_to_queue.end()) {
+        queue = it->second;
+    }
+    _rw_lock.unlock_shared();
+    if (queue == nullptr) {
+        return -1;
+    }
+    const auto size = static_cast<ssize_t>(frame->size());
+    // an evicted queue is closed, its writer thread then shuts the connection down
+    return queue->push(std::move(frame)) == send_queue::push_result::queued ? size : -1;
 }
 
 void server_network_manager::broadcast_message(server_response &msg, const std::vector<player *> &players,
                                                const player *exclude) {
-    rapidjson::Document* msg_json = msg.to_json();  // write to JSON format
-    std::string msg_string = json_utils::to_string(msg_json);   // convert to string
+    // encode the message at most once per encoding, the frames are shared by all receivers
+    send_queue::frame_ptr frames[2];
 
 #ifdef PRINT_NETWORK_MESSAGES
-    std::cout << "Broadcasting message : " << msg_string << std::endl;
+    std::cout << "Broadcasting message : " << json_utils::to_string(msg) << std::endl;
 #endif
 
+    // look up the receivers under the lock, but release it before any message is queued
+    std::vector<std::pair<std::string, wire_format::encoding>> receivers;
+    receivers.reserve(players.size());
     _rw_lock.lock_shared();
-    // send object_diff to all requested players
     try {
         for(auto& player : players) {
             if (player != exclude) {
-                int nof_bytes_written = send_message(msg_string, _player_id_to_address.at(player->get_id())); // issue here
+                const std::string& address = _player_id_to_address.at(player->get_entity_id());
+                receivers.emplace_back(address, get_encoding(address));
             }
         }
     } catch (std::exception& e) {
         std::cerr << "Encountered error when sending state update: " << e.what() << std::endl;
     }
     _rw_lock.unlock_shared();
-    delete msg_json;
+
+    // send object_diff to all requested players
+    for (auto& [address, enc] : receivers) {
+        const int i = static_cast<int>(enc);
+        if (frames[i] == nullptr) {
+            frames[i] = std::make_shared<const std::string>(wire_format::make_frame(msg, enc));
+        }
+        send_message(frames[i], address);
+    }
 }
 
+void server_network_manager::broadcast_message(const state_view& view, const std::vector<player*>& players,
+                                               const player* exclude) {
+#ifdef PRINT_NETWORK_MESSAGES
+    std::cout << "Broadcasting message : " << view.get_shared_message() << std::endl;
+#endif
 
+    // look up the receivers under the lock, but release it before any message is queued
+    std::vector<std::tuple<const player*, std::string, wire_format::encoding>> receivers;
+    receivers.reserve(players.size());
+    _rw_lock.lock_shared();
+    try {
+        for (auto& player : players) {
+            if (player != exclude) {
+                const std::string& address = _player_id_to_address.at(player->get_entity_id());
+                receivers.emplace_back(player, address, get_encoding(address));
+            }
+        }
+    } catch (std::exception& e) {
+        std::cerr << "Encountered error when sending state update: " << e.what() << std::endl;
+    }
+    _rw_lock.unlock_shared();
 
+    for (auto& [player, address, enc] : receivers) {
+        send_message(std::make_shared<const std::string>(view.get_frame(player, enc)), address);
+    }
+}
@@ -16,36 +16,72 @@
 #include "sockpp/tcp_connector.h"
 #include "sockpp/tcp_acceptor.h"
 
+#include "io_reactor.h"
+#include "send_queue.h"
+#include "state_view.h"
+
+#include "../common/network/wire_format.h"
 #include "../common/network/requests/client_request.h"
 #include "../common/network/responses/server_response.h"
 #include "../common/game_state/player/player.h"
 #include "../common/game_state/game_state.h"
 
 class server_network_manager {
+public:
+    // Selects how client connections are served: one blocking reader thread per connection, or a fixed set of I/O
+    // threads multiplexing all connections with epoll (see io_reactor).
+    enum class io_mode {
+        thread_per_connection,
+        reactor
+    };
+
 private:
 
     inline static server_network_manager* _instance;
     inline static std::shared_mutex _rw_lock;
     inline static sockpp::tcp_acceptor _acc;
 
-    inline static std::unordered_map<std::string, std::string> _player_id_to_address;
-    inline static std::unordered_map<std::string, sockpp::tcp_socket> _address_to_socket;
+    inline static std::unordered_map<entity_id, std::string> _player_id_to_address;
+    // outgoing frames of every client in io_mode::thread_per_connection, each drained by a writer thread
+    inline static std::unordered_map<std::string, std::shared_ptr<send_queue>> _address_to_queue;
+    // every client is answered in the wire encoding of its requests
+    inline static std::unordered_map<std::string, wire_format::encoding> _address_to_encoding;
+
+    // only set in io_mode::reactor, in which case the reactor owns all client sockets and their send queues
+    inline static io_reactor* _reactor = nullptr;
+    inline static send_queue::limits _send_limits;
 
     void connect(const std::string& url, const uint16_t  port);
 
     static void listener_loop();
-    static void read_message(sockpp::tcp_socket socket,
-                             const std::function<void(const std::string&, const sockpp::tcp_socket::addr_t&)>& message_handler);
-    static void handle_incoming_message(const std::string& msg, const sockpp::tcp_socket::addr_t& peer_address);
-    static ssize_t send_message(const std::string& msg, const std::string& address);
+    static void read_message(sockpp::tcp_socket socket, const io_reactor::message_handler& message_handler,
+                             std::shared_ptr<send_queue> queue);
+    static void write_messages(sockpp::tcp_socket socket, std::shared_ptr<send_queue> queue);
+    // Forgets the send queue and the encoding of a closed connection. In io_mode::thread_per_connection, 'queue' is the
+    // queue of the closed connection, nothing is removed if the address was taken over by a newer connection.
+    static void on_connection_closed(const std::string& address, const send_queue* queue = nullptr);
+    static void handle_incoming_message(const frame_reader::frame& msg, request_decoder& decoder,
+                                        const sockpp::tcp_socket::addr_t& peer_address);
+    // Enqueues the 'frame' for the client at 'address'. Must be called without holding the _rw_lock.
+    static ssize_t send_message(send_queue::frame_ptr frame, const std::string& address);
+    static wire_format::encoding get_encoding(const std::string& address);
 public:
-    server_network_manager();
+    // 'nof_io_threads' is only used in io_mode::reactor. If it is 0, one I/O thread per hardware thread is started.
+    // 'send_limits' bounds the outgoing messages queued for every client (see send_queue).
+    explicit server_network_manager(io_mode mode = io_mode::thread_per_connection, unsigned int nof_io_threads = 0,
+                                    send_queue::limits send_limits = {});
     ~server_network_manager();
 
-    // Used to broadcast a server_response (e.g. a full_state_response) to all 'players' except 'exclude'
+    // Used to broadcast a server_response (e.g. a full_state_response) to all 'players' except 'exclude'. The message
+    // is encoded once per encoding and the same buffer is queued for every receiver.
     static void broadcast_message(server_response& msg, const std::vector<player*>& players, const player* exclude);
 
-    static void on_player_left(std::string player_id);
+    // Used to broadcast a state update to all 'players' except 'exclude'. Every player receives the shared message of
+    // the 'view' with their own hand spliced in.
+    static void broadcast_message(const state_view& view, const std::vector<player*>& players, const player* exclude);
+
+    // Forgets the address of a player who left the server. Their connection is cleaned up once it is closed.
+    static void on_player_left(const entity_id& player_id);
 };
 
 
@@ -0,0 +1,86 @@
+//
+// The sharded_map is a concurrent lookup table from ids to values, used by the registries of the server (see
+// game_instance_manager and player_manager), whose keys are entity_ids. The ids are spread over a fixed number of shards
+// by their hash, and every shard has its own lock, so lookups of different ids rarely contend for the same lock.
+//
+
+#ifndef WIZARD_SHARDED_MAP_H
+#define WIZARD_SHARDED_MAP_H
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+template<typename Key, typename T, size_t nof_shards = 64>
+class sharded_map {
+
+private:
+    // every shard is placed on its own cache lines, so that taking the lock of one shard does not slow down the others
+    struct alignas(64) shard {
+        mutable std::shared_mutex lock;
+        std::unordered_map<Key, T> values;
+    };
+
+    std::array<shard, nof_shards> _shards;
+
+    shard& get_shard(const Key& key) {
+        return _shards[std::hash<Key>{}(key) % nof_shards];
+    }
+
+    const shard& get_shard(const Key& key) const {
+        return _shards[std::hash<Key>{}(key) % nof_shards];
+    }
+
+public:
+    // Writes the value stored for 'key' into 'value'. Returns false if there is no such key.
+    bool try_get(const Key& key, T& value) const {
+        const shard& s = get_shard(key);
+        std::shared_lock<std::shared_mutex> guard(s.lock);
+        auto it = s.values.find(key);
+        if (it == s.values.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    // Stores 'value' for 'key' unless the key already exists, in which case the stored value is written into 'value'.
+    // Returns true if 'value' was inserted.
+    bool try_insert(const Key& key, T& value) {
+        shard& s = get_shard(key);
+        std::lock_guard<std::shared_mutex> guard(s.lock);
+        auto result = s.values.emplace(key, value);
+        if (!result.second) {
+            value = result.first->second;
+        }
+        return result.second;
+    }
+
+    // Stores 'value' for 'key', replacing the value stored before.
+    void assign(const Key& key, const T& value) {
+        shard& s = get_shard(key);
+        std::lock_guard<std::shared_mutex> guard(s.lock);
+        s.values.insert_or_assign(key, value);
+    }
+
+    // Removes 'key' and returns whether it existed.
+    bool erase(const Key& key) {
+        shard& s = get_shard(key);
+        std::lock_guard<std::shared_mutex> guard(s.lock);
+        return s.values.erase(key) > 0;
+    }
+
+    // The number of stored values. Not a consistent snapshot while other threads insert or erase.
+    size_t size() const {
+        size_t result = 0;
+        for (const shard& s : _shards) {
+            std::shared_lock<std::shared_mutex> guard(s.lock);
+            result += s.values.size();
+        }
+        return result;
+    }
+};
+
+#endif //WIZARD_SHARDED_MAP_H
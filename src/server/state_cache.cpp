@@ -0,0 +1,48 @@
+//
+// The state_cache keeps the full game state of a game serialized for its current version, so that all players who
+// join or resynchronize at the same version are sent the same serialized state.
+//
+
+#include "state_cache.h"
+
+#include "../common/network/responses/full_state_response.h"
+
+std::shared_ptr<const state_view> state_cache::get_view(game_state& state) {
+    if (_view != nullptr && _version == state.get_version()) {
+        _nof_hits++;
+        _total_hits++;
+        return _view;
+    }
+    _nof_misses++;
+    _total_misses++;
+    const full_state_response msg = full_state_response(state.get_id(), state);
+    _view = std::make_shared<const state_view>(msg, state.get_players());
+    _version = state.get_version();
+    return _view;
+}
+
+void state_cache::clear() {
+    _view = nullptr;
+    _version = -1;
+}
+
+uint64_t state_cache::get_nof_hits() const {
+    return _nof_hits;
+}
+
+uint64_t state_cache::get_nof_misses() const {
+    return _nof_misses;
+}
+
+double state_cache::get_hit_rate() const {
+    const uint64_t nof_lookups = _nof_hits + _nof_misses;
+    return nof_lookups == 0 ? 0.0 : static_cast<double>(_nof_hits) / static_cast<double>(nof_lookups);
+}
+
+uint64_t state_cache::get_total_hits() {
+    return _total_hits;
+}
+
+uint64_t state_cache::get_total_misses() {
+    return _total_misses;
+}
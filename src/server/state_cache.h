@@ -0,0 +1,74 @@
+//
+// The state_cache keeps the full game state of a game serialized for its current version, so that all players who
+// join or resynchronize at the same version are sent the same serialized state.
+//
+
+#ifndef WIZARD_STATE_CACHE_H
+#define WIZARD_STATE_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "state_view.h"
+#include "../common/game_state/game_state.h"
+
+/**
+ * @class state_cache
+ * @brief Serializes the full game state once per version of the game state.
+ *
+ * The full state is serialized as a full_state_response with the hands of all players redacted (see state_view), so
+ * the cached view serves every player. The game state advances its version whenever its changes are broadcast (see
+ * game_state::clear_dirty()), so the cached view is valid until the next state diff was sent.
+ *
+ * Hits and misses are counted per cache and over all caches of the server.
+ */
+class state_cache {
+
+private:
+    int _version = -1;                              ///< The version of the game state the view was created for.
+    std::shared_ptr<const state_view> _view;        ///< The serialized full state, shared with pending senders.
+    uint64_t _nof_hits = 0;                         ///< Number of lookups answered by the cached view.
+    uint64_t _nof_misses = 0;                       ///< Number of lookups that serialized the state.
+
+    inline static std::atomic<uint64_t> _total_hits {0};
+    inline static std::atomic<uint64_t> _total_misses {0};
+
+public:
+    /**
+     * @brief Gets the full state of the given game state, serializing it only if its version changed.
+     * @param state The game state. Must not be modified during the call.
+     * @return The serialized full state of the current version of the game state.
+     */
+    std::shared_ptr<const state_view> get_view(game_state& state);
+
+    /**
+     * @brief Drops the cached view, e.g. once the game state advanced to a new version and the view cannot be used
+     * anymore. Senders that still hold the view keep it alive until they are done.
+     */
+    void clear();
+
+    [[nodiscard]] uint64_t get_nof_hits() const;
+
+    [[nodiscard]] uint64_t get_nof_misses() const;
+
+    /**
+     * @brief Gets the share of lookups of this cache that did not serialize the state.
+     * @return The hit rate between 0 and 1, or 0 if there were no lookups yet.
+     */
+    [[nodiscard]] double get_hit_rate() const;
+
+    /**
+     * @brief Gets the number of hits of all state caches of the server.
+     * @return The number of hits.
+     */
+    static uint64_t get_total_hits();
+
+    /**
+     * @brief Gets the number of misses of all state caches of the server.
+     * @return The number of misses.
+     */
+    static uint64_t get_total_misses();
+};
+
+#endif //WIZARD_STATE_CACHE_H
@@ -0,0 +1,93 @@
+//
+// The state_view turns a server_response that contains the game state with the hands of all players redacted into the
+// individual messages the players receive: every player gets the same message, with only their own hand spliced in.
+//
+
+#include "state_view.h"
+
+#include "../common/serialization/binary_codec.h"
+
+// writes the json of 'write' into 'buffer', which is reused for all parts of the view
+template<typename F>
+static std::string write_json(rapidjson::StringBuffer& buffer, F write) {
+    buffer.Clear();
+    json_writer writer(buffer);
+    write(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+state_view::state_view(const server_response& msg, const std::vector<player*>& players) {
+    rapidjson::StringBuffer buffer;
+    _json.shared_message = write_json(buffer, [&msg](json_writer& writer) { msg.write_into_writer(writer); });
+
+    rapidjson::Document* msg_json = msg.to_json();
+    const binary_codec::encoder encoder(*msg_json);
+    _binary.shared_message = encoder.encode_message(*msg_json);
+
+    for (const auto& p : players) {
+        // the redacted hand is serialized the same way as within the message, and since hand ids are unique and trick
+        // entries do not contain hands, it is found exactly once (or not at all, if the hand is not part of a diff)
+        const hand* h = p->get_hand();
+        _json.add_hand_fragment(p->get_entity_id(),
+                                write_json(buffer, [h](json_writer& writer) { h->write_redacted_into_writer(writer); }),
+                                write_json(buffer, [h](json_writer& writer) { h->write_into_writer(writer); }));
+
+        rapidjson::Document redacted_hand(rapidjson::kObjectType);
+        h->write_redacted_into_json(redacted_hand, redacted_hand.GetAllocator());
+        rapidjson::Document* hand_json = h->to_json();
+        _binary.add_hand_fragment(p->get_entity_id(), encoder.encode_value(redacted_hand),
+                                  encoder.encode_value(*hand_json));
+        delete hand_json;
+    }
+    delete msg_json;
+}
+
+void state_view::encoded_message::add_hand_fragment(const entity_id& player_id, const std::string& redacted_hand,
+                                                    std::string full_hand) {
+    const size_t pos = shared_message.find(redacted_hand);
+    if (pos != std::string::npos) {
+        hand_fragments.emplace(player_id, hand_fragment {pos, redacted_hand.size(), std::move(full_hand)});
+    }
+}
+
+void state_view::encoded_message::append_message(std::string& out, const entity_id& player_id) const {
+    const auto it = hand_fragments.find(player_id);
+    if (it == hand_fragments.end()) {
+        out.append(shared_message);
+        return;
+    }
+    const hand_fragment& fragment = it->second;
+    out.append(shared_message, 0, fragment.pos);
+    out.append(fragment.hand);
+    out.append(shared_message, fragment.pos + fragment.length, std::string::npos);
+}
+
+size_t state_view::encoded_message::get_message_size(const entity_id& player_id) const {
+    const auto it = hand_fragments.find(player_id);
+    if (it == hand_fragments.end()) {
+        return shared_message.size();
+    }
+    return shared_message.size() - it->second.length + it->second.hand.size();
+}
+
+std::string state_view::get_message(const player* p, wire_format::encoding enc) const {
+    const encoded_message& view = enc == wire_format::encoding::binary ? _binary : _json;
+    std::string message;
+    message.reserve(view.get_message_size(p->get_entity_id()));
+    view.append_message(message, p->get_entity_id());
+    return message;
+}
+
+std::string state_view::get_frame(const player* p, wire_format::encoding enc) const {
+    const encoded_message& view = enc == wire_format::encoding::binary ? _binary : _json;
+    const size_t size = view.get_message_size(p->get_entity_id());
+    std::string frame;
+    frame.reserve(wire_format::max_header_size + size);
+    wire_format::append_header(frame, size, enc);
+    view.append_message(frame, p->get_entity_id());
+    return frame;
+}
+
+const std::string& state_view::get_shared_message() const {
+    return _json.shared_message;
+}
@@ -0,0 +1,108 @@
+//
+// The state_view turns a server_response that contains the game state with the hands of all players redacted into the
+// individual messages the players receive: every player gets the same message, with only their own hand spliced in.
+//
+
+#ifndef WIZARD_STATE_VIEW_H
+#define WIZARD_STATE_VIEW_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../common/network/responses/server_response.h"
+#include "../common/network/wire_format.h"
+#include "../common/game_state/player/player.h"
+
+/**
+ * @class state_view
+ * @brief Serializes a state update once and projects it onto the view of each player.
+ *
+ * The message is serialized a single time per wire encoding with the hands of all players redacted (see
+ * hand::write_redacted_into_json()). For every player whose redacted hand is part of the message, the position of that
+ * hand in the serialized message is looked up once, together with the serialized full hand. get_message() then only
+ * has to copy the shared parts of the message around the player's own hand, so neither the game state nor the message
+ * is serialized once per player.
+ *
+ * The json text is written straight from the game state (see serializable::write_into_writer()). Only the binary
+ * encoding builds the json document of the message, since the binary_codec needs the whole message for its string
+ * table.
+ */
+class state_view {
+
+private:
+    /**
+     * @brief The part of the shared message that is replaced for one player.
+     */
+    struct hand_fragment {
+        size_t pos;             ///< Position of the redacted hand in the shared message.
+        size_t length;          ///< Length of the redacted hand in the shared message.
+        std::string hand;       ///< The serialized full hand that replaces the redacted one.
+    };
+
+    /**
+     * @brief The message serialized in one wire encoding.
+     */
+    struct encoded_message {
+        std::string shared_message;                                     ///< The message with all hands redacted.
+        std::unordered_map<entity_id, hand_fragment> hand_fragments;    ///< The hands to splice in, by player id.
+
+        /**
+         * @brief Looks up the position of a player's redacted hand and stores the full hand to splice in.
+         * @param player_id The id of the player.
+         * @param redacted_hand The redacted hand, serialized the same way as in the shared message.
+         * @param full_hand The full hand, serialized the same way as in the shared message.
+         */
+        void add_hand_fragment(const entity_id& player_id, const std::string& redacted_hand, std::string full_hand);
+
+        /**
+         * @brief Appends the message as seen by a player to 'out'.
+         * @param out The string the message is appended to.
+         * @param player_id The id of the receiving player.
+         */
+        void append_message(std::string& out, const entity_id& player_id) const;
+
+        /**
+         * @brief Gets the size of the message as seen by a player.
+         * @param player_id The id of the receiving player.
+         * @return The size of the message in bytes.
+         */
+        [[nodiscard]] size_t get_message_size(const entity_id& player_id) const;
+    };
+
+    encoded_message _json;      ///< The message as json text.
+    encoded_message _binary;    ///< The message encoded by the binary_codec.
+
+public:
+    /**
+     * @brief Serializes the message and the hands of the given players.
+     * @param msg The message containing the game state (or a state diff) with the hands of all players redacted.
+     * @param players The players that receive the message.
+     * Must be called while the game state cannot be modified.
+     */
+    state_view(const server_response& msg, const std::vector<player*>& players);
+
+    /**
+     * @brief Gets the message as seen by a player.
+     * @param p The receiving player.
+     * @param enc The wire encoding used by the receiving player.
+     * @return The serialized message, in which the redacted hand of the player is replaced by their full hand.
+     */
+    [[nodiscard]] std::string get_message(const player* p, wire_format::encoding enc) const;
+
+    /**
+     * @brief Gets the frame with the message as seen by a player.
+     * @param p The receiving player.
+     * @param enc The wire encoding used by the receiving player.
+     * @return The frame header followed by the message of get_message(), created without copying the message twice.
+     */
+    [[nodiscard]] std::string get_frame(const player* p, wire_format::encoding enc) const;
+
+    /**
+     * @brief Gets the message with the hands of all players redacted.
+     * @return The message as json text, as it is shared by all players.
+     */
+    [[nodiscard]] const std::string& get_shared_message() const;
+};
+
+#endif //WIZARD_STATE_VIEW_H
@@ -0,0 +1,115 @@
+//
+// The worker_pool executes the commands of all games on a fixed set of threads (see worker_pool.h).
+//
+
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    // the pool and the worker the current thread belongs to, if it is a worker thread
+    thread_local const void* current_pool = nullptr;
+    thread_local void* current_worker = nullptr;
+}
+
+worker_pool::worker_pool(unsigned int nof_threads) {
+    nof_threads = std::max(1u, nof_threads);
+    for (unsigned int i = 0; i < nof_threads; i++) {
+        _workers.push_back(std::make_unique<worker>());
+        _workers.back()->index = i;
+    }
+    // the threads are only started once all workers exist, because they steal from each other
+    for (auto& w : _workers) {
+        w->thread = std::thread(&worker_pool::run, this, w.get());
+    }
+}
+
+worker_pool::~worker_pool() {
+    {
+        std::lock_guard<std::mutex> guard(_idle_lock);
+        _stopping = true;
+    }
+    _idle.notify_all();
+    for (auto& w : _workers) {
+        w->thread.join();
+    }
+}
+
+unsigned int worker_pool::get_nof_threads() const {
+    return static_cast<unsigned int>(_workers.size());
+}
+
+void worker_pool::set_default_nof_threads(unsigned int nof_threads) {
+    default_nof_threads = nof_threads;
+}
+
+worker_pool& worker_pool::get_instance() {
+    static worker_pool instance(default_nof_threads > 0 ? default_nof_threads.load()
+                                                        : std::thread::hardware_concurrency());
+    return instance;
+}
+
+void worker_pool::submit(task t) {
+    worker* w = current_pool == this ? static_cast<worker*>(current_worker)
+                                     : _workers[_next_worker++ % _workers.size()].get();
+    {
+        std::lock_guard<std::mutex> guard(w->lock);
+        w->tasks.push_back(std::move(t));
+    }
+    // a worker that is about to sleep increments _nof_sleeping before it checks _nof_queued, so either it sees the
+    // new task or the task is announced to it
+    _nof_queued++;
+    if (_nof_sleeping > 0) {
+        std::lock_guard<std::mutex> guard(_idle_lock);
+        _idle.notify_one();
+    }
+}
+
+bool worker_pool::try_take(worker* self, task& t) {
+    {
+        std::lock_guard<std::mutex> guard(self->lock);
+        if (!self->tasks.empty()) {
+            t = std::move(self->tasks.front());
+            self->tasks.pop_front();
+            return true;
+        }
+    }
+    // steal the most recently queued task of another worker, the owner keeps working on its oldest tasks
+    for (size_t i = 1; i < _workers.size(); i++) {
+        worker* victim = _workers[(self->index + i) % _workers.size()].get();
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if (!victim->tasks.empty()) {
+            t = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void worker_pool::run(worker* self) {
+    current_pool = this;
+    current_worker = self;
+    task t;
+    while (true) {
+        if (try_take(self, t)) {
+            _nof_queued--;
+            try {
+                t();
+            } catch (const std::exception& e) {
+                std::cerr << "Error while executing a task of the worker pool" << std::endl << e.what() << std::endl;
+            }
+            t = nullptr;    // releases whatever the task captured
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(_idle_lock);
+        _nof_sleeping++;
+        _idle.wait(guard, [this] { return _stopping || _nof_queued > 0; });
+        _nof_sleeping--;
+        if (_stopping && _nof_queued == 0) {
+            return;
+        }
+    }
+}
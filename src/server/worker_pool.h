@@ -0,0 +1,94 @@
+//
+// The worker_pool is a fixed set of worker threads that executes the commands of all games (see mailbox). Every worker
+// has its own task queue, and a worker that runs out of tasks steals tasks from the other workers, so the load is
+// spread over all workers without a single queue that every thread contends for.
+//
+
+#ifndef WIZARD_WORKER_POOL_H
+#define WIZARD_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class worker_pool
+ * @brief Executes tasks on a fixed number of threads with work stealing.
+ *
+ * A task submitted by a worker of the pool is queued at that worker, other tasks are spread over the workers round
+ * robin. A worker executes its own tasks in the order they were queued and, once its queue is empty, steals the most
+ * recently queued task of another worker. Idle workers sleep until a task is submitted.
+ */
+class worker_pool {
+
+public:
+    using task = std::function<void()>;
+
+    /**
+     * @brief Constructs the pool and starts its threads.
+     * @param nof_threads The number of worker threads (at least one thread is started).
+     */
+    explicit worker_pool(unsigned int nof_threads);
+
+    /**
+     * @brief Executes the remaining tasks and stops the worker threads.
+     */
+    ~worker_pool();
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    /**
+     * @brief Queues a task for execution. Called by any thread.
+     * @param t The task. Exceptions thrown by the task are logged and otherwise ignored.
+     */
+    void submit(task t);
+
+    /**
+     * @brief Gets the number of worker threads.
+     */
+    [[nodiscard]] unsigned int get_nof_threads() const;
+
+    /**
+     * @brief Sets the number of worker threads of the server's pool. Only has an effect before get_instance() is
+     * called for the first time.
+     * @param nof_threads The number of worker threads, or 0 for the number of hardware threads.
+     */
+    static void set_default_nof_threads(unsigned int nof_threads);
+
+    /**
+     * @brief Gets the pool that executes the commands of all games of the server. It is started on first use.
+     */
+    static worker_pool& get_instance();
+
+private:
+    // every worker is placed on its own cache lines, so that queueing at one worker does not slow down the others
+    struct alignas(64) worker {
+        std::mutex lock;            // protects tasks
+        std::deque<task> tasks;
+        std::thread thread;
+        size_t index = 0;           // position in _workers
+    };
+
+    std::vector<std::unique_ptr<worker>> _workers;
+    std::atomic<size_t> _next_worker {0};       // round robin counter for tasks submitted from other threads
+
+    std::atomic<size_t> _nof_queued {0};        // tasks in all queues, sleeping workers wait for it to become non-zero
+    std::atomic<size_t> _nof_sleeping {0};
+    std::mutex _idle_lock;                      // protects _stopping, and the sleeping of the workers
+    std::condition_variable _idle;
+    bool _stopping = false;
+
+    inline static std::atomic<unsigned int> default_nof_threads {0};
+
+    // takes the next task of 'self', or steals one from another worker
+    bool try_take(worker* self, task& t);
+    void run(worker* self);
+};
+
+#endif //WIZARD_WORKER_POOL_H
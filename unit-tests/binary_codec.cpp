@@ -0,0 +1,143 @@
+//
+// Tests of the binary wire encoding and the message framing.
+//
+
+#include "gtest/gtest.h"
+#include "../src/common/exceptions/WizardException.h"
+#include "../src/common/game_state/game_state.h"
+#include "../src/common/network/requests/play_card_request.h"
+#include "../src/common/network/wire_format.h"
+#include "../src/common/serialization/binary_codec.h"
+#include "../src/common/serialization/json_utils.h"
+#include "../src/common/serialization/uuid_generator.h"
+
+
+// encodes a json document and decodes it again, returning the decoded document as json text
+static std::string round_trip(const rapidjson::Value& json)
+{
+    const std::string encoded = binary_codec::encode(json);
+    rapidjson::Document decoded;
+    binary_codec::decode(encoded.data(), encoded.size(), decoded);
+    return json_utils::to_string(&decoded);
+}
+
+// all kinds of values survive the round trip unchanged
+TEST(BinaryCodecTest, RoundTripValues)
+{
+    const std::string json_text = R"({"a":null,"b":true,"c":false,"d":0,"e":127,"f":128,"g":-1,"h":-2147483648,)"
+                                  R"("i":9223372036854775807,"j":18446744073709551615,"k":-9223372036854775808,)"
+                                  R"("l":1.5,"m":-0.25,"n":"","o":"x","p":"some text","q":[],"r":{},)"
+                                  R"("s":[1,[2,[3,{"value":4}]],{"value":"x","other":1}],"type":"play_card",)"
+                                  R"("t":"9F1D0A6E-1C2B-4E3D-8A5F-0B1C2D3E4F50","u":"some text"})";
+    rapidjson::Document json;
+    json.Parse(json_text.c_str());
+    ASSERT_FALSE(json.HasParseError());
+
+    EXPECT_EQ(round_trip(json), json_text);
+}
+
+// the binary encoding of a game state decodes to exactly the same json and is considerably smaller
+TEST(BinaryCodecTest, RoundTripGameState)
+{
+    game_state state = game_state();
+    std::string err;
+    state.add_player(new player("player1"), err);
+    state.add_player(new player("player2"), err);
+    state.add_player(new player("player3"), err);
+    ASSERT_TRUE(state.start_game(err));
+
+    rapidjson::Document json(rapidjson::kObjectType);
+    state.write_into_json(json, json.GetAllocator());
+    const std::string json_text = json_utils::to_string(&json);
+
+    EXPECT_EQ(round_trip(json), json_text);
+    EXPECT_LT(binary_codec::encode(json).size() * 3, json_text.size());
+
+    rapidjson::Document decoded;
+    const std::string encoded = binary_codec::encode(json);
+    binary_codec::decode(encoded.data(), encoded.size(), decoded);
+    game_state* decoded_state = game_state::from_json(decoded);
+    EXPECT_EQ(decoded_state->get_id(), state.get_id());
+    EXPECT_EQ(decoded_state->get_players().size(), 3);
+    EXPECT_EQ(decoded_state->get_round_number(), state.get_round_number());
+    delete decoded_state;
+}
+
+// requests round trip as well, their ids are sent as 16 raw bytes
+TEST(BinaryCodecTest, RoundTripRequest)
+{
+    const std::string game_id = uuid_generator::generate_uuid_v4();
+    const std::string player_id = uuid_generator::generate_uuid_v4();
+    const std::string card_id = uuid_generator::generate_uuid_v4();
+    rapidjson::Document* json = play_card_request(game_id, player_id, card_id).to_json();
+    const std::string json_text = json_utils::to_string(json);
+
+    EXPECT_TRUE(binary_codec::is_uuid(game_id));
+    EXPECT_EQ(round_trip(*json), json_text);
+    EXPECT_LT(binary_codec::encode(*json).size() * 2, json_text.size());
+    delete json;
+}
+
+// only lower case uuids are compacted, anything else is kept as a string
+TEST(BinaryCodecTest, IsUuid)
+{
+    EXPECT_TRUE(binary_codec::is_uuid("9f1d0a6e-1c2b-4e3d-8a5f-0b1c2d3e4f50"));
+    EXPECT_FALSE(binary_codec::is_uuid("9F1D0A6E-1C2B-4E3D-8A5F-0B1C2D3E4F50"));
+    EXPECT_FALSE(binary_codec::is_uuid("9f1d0a6e-1c2b-4e3d-8a5f-0b1c2d3e4f5"));
+    EXPECT_FALSE(binary_codec::is_uuid("9f1d0a6e11c2b-4e3d-8a5f-0b1c2d3e4f50"));
+    EXPECT_FALSE(binary_codec::is_uuid("player1"));
+}
+
+// invalid input is rejected with an exception instead of reading out of bounds
+TEST(BinaryCodecTest, MalformedInputThrows)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"type":"play_card","card_id":"9f1d0a6e-1c2b-4e3d-8a5f-0b1c2d3e4f50","values":[1,2,3]})");
+    const std::string encoded = binary_codec::encode(json);
+
+    rapidjson::Document decoded;
+    EXPECT_THROW(binary_codec::decode(encoded.data(), 0, decoded), WizardException);
+    for (size_t size = 1; size < encoded.size(); size++) {
+        EXPECT_THROW(binary_codec::decode(encoded.data(), size, decoded), WizardException);
+    }
+    const std::string trailing = encoded + '\0';
+    EXPECT_THROW(binary_codec::decode(trailing.data(), trailing.size(), decoded), WizardException);
+    const std::string garbage = "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff";
+    EXPECT_THROW(binary_codec::decode(garbage.data(), garbage.size(), decoded), WizardException);
+}
+
+// frames of both encodings are found, also when they arrive in parts
+TEST(WireFormatTest, FindFrame)
+{
+    for (const auto enc : {wire_format::encoding::json, wire_format::encoding::binary}) {
+        const std::string payload = "payload:123";
+        const std::string frame = wire_format::make_frame(payload, enc);
+        const std::string two_frames = frame + frame;
+
+        wire_format::encoding found_enc;
+        size_t offset = 0;
+        size_t size = 0;
+        for (size_t i = 0; i < frame.size(); i++) {
+            EXPECT_EQ(wire_format::find_frame(frame.data(), i, found_enc, offset, size),
+                      wire_format::frame_status::incomplete);
+        }
+        ASSERT_EQ(wire_format::find_frame(two_frames.data(), two_frames.size(), found_enc, offset, size),
+                  wire_format::frame_status::complete);
+        EXPECT_EQ(found_enc, enc);
+        EXPECT_EQ(two_frames.substr(offset, size), payload);
+        EXPECT_EQ(offset + size, frame.size());
+    }
+}
+
+// frame headers that cannot be valid are reported as malformed
+TEST(WireFormatTest, MalformedFrame)
+{
+    wire_format::encoding enc;
+    size_t offset = 0;
+    size_t size = 0;
+    EXPECT_EQ(wire_format::find_frame(":abc", 4, enc, offset, size), wire_format::frame_status::malformed);
+    EXPECT_EQ(wire_format::find_frame("12a:abc", 7, enc, offset, size), wire_format::frame_status::malformed);
+    EXPECT_EQ(wire_format::find_frame("12345678901:", 12, enc, offset, size), wire_format::frame_status::malformed);
+    EXPECT_EQ(wire_format::find_frame("\xb1\xff\xff\xff\xff", 5, enc, offset, size),
+              wire_format::frame_status::malformed);
+}
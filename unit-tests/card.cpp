@@ -41,7 +41,7 @@ TEST_F(CardTest, MakeCardGetMembers) {
 
 // Serialization and subsequent deserialization must yield the same object
 TEST_F(CardTest, SerializationEquality) {
-    card card_send(1,1);
+    const card& card_send = *card::get_card(0);
     rapidjson::Document* json_send = card_send.to_json();
     std::string message = json_utils::to_string(json_send);
     delete json_send;
@@ -53,9 +53,7 @@ TEST_F(CardTest, SerializationEquality) {
     EXPECT_EQ(card_send.get_id(), card_recv->get_id());
     EXPECT_EQ(card_send.get_value(), card_recv->get_value());
     EXPECT_EQ(card_send.get_color(), card_recv->get_color());
-    delete card_recv;
-
-
+    EXPECT_EQ(&card_send, card_recv);
 }
 
 // Deserializing an invalid string must throw a WizardException
@@ -64,3 +62,40 @@ TEST_F(CardTest, SerializationException) {
     json.Parse("not json");
     EXPECT_THROW(card::from_json(json), WizardException);
 }
+
+// The cards of a new deck are the cards of the shared card table, and deserializing them yields the same objects
+TEST_F(CardTest, CardTableIsShared) {
+    deck deck_1;
+    deck deck_2;
+    rapidjson::Document* json = deck_1.to_json();
+    const auto& cards = (*json)["all_cards"];
+    ASSERT_EQ(cards.Size(), card::nof_cards);
+    for (unsigned int i = 0; i < card::nof_cards; i++) {
+        card* table_card = card::get_card(i);
+        EXPECT_EQ(table_card->get_index(), static_cast<int>(i));
+        card* card_recv = card::from_json(cards[i]);
+        EXPECT_EQ(card_recv, table_card);
+    }
+    EXPECT_EQ(deck_1.draw_trump(), deck_2.draw_trump());
+    delete json;
+
+    // a card with the same value and color that is not part of the table has no index
+    card other(card::get_card(0)->get_value(), card::get_card(0)->get_color());
+    EXPECT_EQ(other.get_index(), -1);
+}
+
+// Deserializing a card that is not part of the card table must throw, since it would not be owned by anything
+TEST_F(CardTest, UnknownIdException) {
+    card other(1, 1);
+    rapidjson::Document* json = other.to_json();
+    EXPECT_THROW(card::from_json(*json), WizardException);
+    delete json;
+}
+
+// Deserializing a card whose value or color does not match the card table entry of its id must throw
+TEST_F(CardTest, CardTableMismatchException) {
+    rapidjson::Document* json = card::get_card(0)->to_json();
+    (*json)["value"].SetInt(13);
+    EXPECT_THROW(card::from_json(*json), WizardException);
+    delete json;
+}
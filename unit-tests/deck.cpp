@@ -74,13 +74,40 @@ TEST(DeckTest, Setup) {
     std::string err;
     mydeck.draw_cards(player1, 60, err);
 
-    mydeck.setup_round();
+    random_generator rng(1);
+    mydeck.setup_round(rng);
 
     ASSERT_EQ(mydeck.get_number_of_remaining_cards(), 60);
 
 
 }
 
+// decks shuffled with the same seed deal the same cards, and every card exactly once
+TEST(DeckTest, SeededShuffle) {
+    deck deck1;
+    deck deck2;
+    random_generator rng1(42);
+    random_generator rng2(42);
+    deck1.setup_round(rng1);
+    deck2.setup_round(rng2);
+
+    player* player1 = new player("player1");
+    player* player2 = new player("player2");
+    std::string err;
+    ASSERT_TRUE(deck1.draw_cards(player1, 60, err));
+    ASSERT_TRUE(deck2.draw_cards(player2, 60, err));
+
+    const std::vector<card*> cards1 = player1->get_hand()->get_cards();
+    const std::vector<card*> cards2 = player2->get_hand()->get_cards();
+    for (int i = 0; i < 60; i++) {
+        EXPECT_EQ(cards1[i]->get_value(), cards2[i]->get_value());
+        EXPECT_EQ(cards1[i]->get_color(), cards2[i]->get_color());
+    }
+    EXPECT_EQ(player1->get_hand()->get_mask(), card_mask::all);
+    delete player1;
+    delete player2;
+}
+
 // Serialization and subsequent deserialization must yield the same object
 TEST(DeckTest, SerializationEquality) {
     deck deck_send;
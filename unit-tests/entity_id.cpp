@@ -0,0 +1,81 @@
+//
+// Tests of the compact ids of the game state objects and their text at the protocol edge.
+//
+
+#include <string>
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+#include "../src/common/serialization/entity_id.h"
+#include "../src/common/game_state/cards/deck.h"
+
+
+// a random id is written as a lower case version 4 uuid and parsed back into the same id
+TEST(EntityIdTest, RandomIdRoundTrip) {
+    std::unordered_set<entity_id> ids;
+    for (int i = 0; i < 1000; i++) {
+        const entity_id id = entity_id::generate();
+        const std::string text = id.to_string();
+        ASSERT_EQ(text.size(), 36);
+        EXPECT_EQ(text[14], '4');
+        EXPECT_NE(std::string("89ab").find(text[19]), std::string::npos);
+
+        entity_id parsed;
+        ASSERT_TRUE(entity_id::try_parse(text, parsed));
+        EXPECT_EQ(parsed, id);
+        EXPECT_EQ(std::hash<entity_id>{}(parsed), std::hash<entity_id>{}(id));
+        ids.insert(id);
+    }
+    EXPECT_EQ(ids.size(), 1000);
+}
+
+// card indices are written as uuids starting with 16 zeros
+TEST(EntityIdTest, CardIndexRoundTrip) {
+    const entity_id id = entity_id::from_index(59);
+    EXPECT_EQ(id.to_string(), "00000000-0000-0000-4000-00000000003b");
+    entity_id parsed;
+    ASSERT_TRUE(entity_id::try_parse("00000000-0000-0000-4000-00000000003b", parsed));
+    EXPECT_EQ(parsed, id);
+    EXPECT_NE(entity_id::from_index(0), entity_id());
+}
+
+// any other text is only accepted once it is interned, and keeps its text
+TEST(EntityIdTest, OtherTextsAreInterned) {
+    entity_id id;
+    EXPECT_FALSE(entity_id::try_parse("entity-id-test-text", id));
+    EXPECT_FALSE(entity_id::try_parse("00000000-0000-0000-0000-000000000000", id));
+    EXPECT_FALSE(entity_id::try_parse("6F9619FF-8B86-D011-B42D-00C04FC964FF", id));   // upper case
+
+    const entity_id interned = entity_id::from_string("entity-id-test-text");
+    EXPECT_EQ(interned.to_string(), "entity-id-test-text");
+    EXPECT_EQ(entity_id::from_string("entity-id-test-text"), interned);
+    ASSERT_TRUE(entity_id::try_parse("entity-id-test-text", id));
+    EXPECT_EQ(id, interned);
+
+    const entity_id nil_uuid = entity_id::from_string("00000000-0000-0000-0000-000000000000");
+    EXPECT_EQ(nil_uuid.to_string(), "00000000-0000-0000-0000-000000000000");
+    EXPECT_NE(nil_uuid, interned);
+}
+
+// the empty text is the nil id
+TEST(EntityIdTest, EmptyTextIsNil) {
+    entity_id id = entity_id::generate();
+    ASSERT_TRUE(entity_id::try_parse("", id));
+    EXPECT_TRUE(id.is_nil());
+    EXPECT_EQ(id.to_string(), "");
+    EXPECT_FALSE(entity_id::generate().is_nil());
+}
+
+// the cards of a deck are numbered, and their ids are written as text only when the deck is serialized
+TEST(EntityIdTest, DeckNumbersItsCards) {
+    deck test_deck;
+    rapidjson::Document* json = test_deck.to_json();
+    const auto& cards = (*json)["all_cards"];
+    ASSERT_EQ(cards.Size(), 60);
+    for (rapidjson::SizeType i = 0; i < cards.Size(); i++) {
+        entity_id parsed;
+        ASSERT_TRUE(entity_id::try_parse(cards[i]["id"].GetString(), parsed));
+        EXPECT_EQ(parsed, entity_id::from_index(i));
+    }
+    delete json;
+}
@@ -0,0 +1,102 @@
+//
+// Tests of splitting the received byte stream into frames.
+//
+
+#include <algorithm>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "../src/common/network/frame_reader.h"
+
+
+// writes 'data' into the reader as if it had been received in chunks of 'chunk_size' bytes, collecting all frames
+static std::vector<std::string> receive(frame_reader& reader, const std::string& data, size_t chunk_size)
+{
+    std::vector<std::string> payloads;
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t available = 0;
+        char* buffer = reader.prepare(available);
+        const size_t count = std::min({chunk_size, available, data.size() - pos});
+        std::memcpy(buffer, data.data() + pos, count);
+        reader.commit(count);
+        pos += count;
+
+        frame_reader::frame f;
+        wire_format::frame_status status;
+        while ((status = reader.next_frame(f)) == wire_format::frame_status::complete) {
+            payloads.emplace_back(f.payload());
+        }
+        EXPECT_NE(status, wire_format::frame_status::malformed);
+    }
+    return payloads;
+}
+
+// pipelined frames of both encodings are split correctly, however the stream is chunked
+TEST(FrameReaderTest, PipelinedFrames)
+{
+    std::vector<std::string> payloads;
+    std::string stream;
+    for (int i = 0; i < 50; i++) {
+        payloads.push_back(std::string(i * 37, static_cast<char>('a' + i % 26)) + ":" + std::to_string(i));
+        const auto enc = i % 2 == 0 ? wire_format::encoding::json : wire_format::encoding::binary;
+        stream += wire_format::make_frame(payloads.back(), enc);
+    }
+
+    for (size_t chunk_size : {1, 3, 7, 100, 4096, 100000}) {
+        frame_reader reader;
+        EXPECT_EQ(receive(reader, stream, chunk_size), payloads);
+        EXPECT_EQ(reader.get_nof_pending_bytes(), 0);
+    }
+}
+
+// a frame larger than the buffer makes the buffer grow to fit the whole frame
+TEST(FrameReaderTest, GrowsForLargeFrames)
+{
+    const std::string payload(100000, 'x');
+    const std::string frame = wire_format::make_frame(payload, wire_format::encoding::binary);
+
+    frame_reader reader;
+    const std::vector<std::string> received = receive(reader, frame + frame, 1500);
+    ASSERT_EQ(received.size(), 2);
+    EXPECT_EQ(received[0], payload);
+    EXPECT_EQ(received[1], payload);
+    EXPECT_GE(reader.get_capacity(), frame.size());
+}
+
+// a malformed header is reported instead of being skipped
+TEST(FrameReaderTest, MalformedHeader)
+{
+    const std::string stream = wire_format::make_frame("ok", wire_format::encoding::json) + "x5:hello";
+    frame_reader reader;
+    size_t available = 0;
+    char* buffer = reader.prepare(available);
+    std::memcpy(buffer, stream.data(), stream.size());
+    reader.commit(stream.size());
+
+    frame_reader::frame f;
+    ASSERT_EQ(reader.next_frame(f), wire_format::frame_status::complete);
+    EXPECT_EQ(f.payload(), "ok");
+    EXPECT_EQ(reader.next_frame(f), wire_format::frame_status::malformed);
+}
+
+// payloads are terminated and may be modified in place without affecting the following frames
+TEST(FrameReaderTest, TerminatedPayloads)
+{
+    const std::string stream = wire_format::make_frame("first", wire_format::encoding::json)
+                               + wire_format::make_frame("second", wire_format::encoding::binary);
+    frame_reader reader;
+    size_t available = 0;
+    char* buffer = reader.prepare(available);
+    std::memcpy(buffer, stream.data(), stream.size());
+    reader.commit(stream.size());
+
+    frame_reader::frame f;
+    ASSERT_EQ(reader.next_frame(f), wire_format::frame_status::complete);
+    EXPECT_EQ(std::string(f.data), "first");
+    f.data[0] = 'F';
+
+    ASSERT_EQ(reader.next_frame(f), wire_format::frame_status::complete);
+    EXPECT_EQ(std::string(f.data), "second");
+    EXPECT_EQ(f.encoding, wire_format::encoding::binary);
+}
@@ -0,0 +1,114 @@
+//
+// Tests of the reclamation of finished games and departed players by the server's registries.
+//
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../src/common/serialization/entity_id.h"
+#include "../src/server/game_instance_manager.h"
+#include "../src/server/player_manager.h"
+#include "../src/server/request_handler.h"
+
+// sends a request of a player like a client does, and waits until it was executed in the mailbox of its game
+static bool send_request(RequestType type, const entity_id& player_id, std::string& err) {
+    const std::string id = player_id.to_string();
+    request_view req;
+    req.type = type;
+    req.req_id = id;
+    req.player_id = id;
+    req.player_name = "player";
+    std::promise<bool> success;
+    request_handler::dispatch_request(req, [&success, &err](const request_response& res) {
+        rapidjson::Document* json = res.to_json();
+        err = (*json)["err"].GetString();
+        success.set_value((*json)["success"].GetBool());
+        delete json;
+    });
+    return success.get_future().get();
+}
+
+// lets a new player join any game with a join request
+static std::shared_ptr<game_instance> join_any_game(std::shared_ptr<player>& p) {
+    const entity_id player_id = entity_id::generate();
+    std::shared_ptr<game_instance> game;
+    std::string err;
+    EXPECT_TRUE(send_request(RequestType::join_game, player_id, err)) << err;
+    EXPECT_TRUE(game_instance_manager::try_get_player_and_game_instance(player_id, p, game, err)) << err;
+    return game;
+}
+
+// lets a player leave their game and the server with a leave request
+static void leave_server(const entity_id& player_id) {
+    std::string err;
+    ASSERT_TRUE(send_request(RequestType::leave_game, player_id, err)) << err;
+}
+
+// waits until the commands posted to the mailbox of a game so far were executed and released
+static void flush_mailbox(const std::shared_ptr<game_instance>& game) {
+    std::promise<void> flushed;
+    game->post([&flushed]() { flushed.set_value(); });
+    flushed.get_future().get();
+}
+
+// a finished game and its players are deleted once all players left and the game is removed by the next join
+TEST(GameInstanceManagerTest, FinishedGameIsDeleted) {
+    std::vector<entity_id> player_ids;
+    std::vector<std::weak_ptr<player>> players;
+    std::weak_ptr<game_instance> game;
+    {
+        std::shared_ptr<game_instance> joined;
+        for (int i = 0; i < 3; i++) {
+            std::shared_ptr<player> p;
+            joined = join_any_game(p);
+            player_ids.push_back(p->get_entity_id());
+            players.push_back(p);
+        }
+        std::string err;
+        ASSERT_TRUE(send_request(RequestType::start_game, player_ids.front(), err)) << err;
+        game = joined;
+    }
+
+    for (const entity_id& id : player_ids) {
+        leave_server(id);
+    }
+    // the command of the last leave request refers to the game until it returned
+    flush_mailbox(game.lock());
+    EXPECT_TRUE(game.lock()->is_finished());
+
+    // the next join removes the finished game from the registry, which deletes it together with its players
+    std::shared_ptr<player> next;
+    std::shared_ptr<game_instance> next_game = join_any_game(next);
+    EXPECT_TRUE(game.expired());
+    for (const std::weak_ptr<player>& p : players) {
+        EXPECT_TRUE(p.expired());
+    }
+    leave_server(next->get_entity_id());
+}
+
+// a player who leaves a game before it started is deleted right away, the game stays open for other players
+TEST(GameInstanceManagerTest, LobbyLeaverIsDeleted) {
+    std::shared_ptr<player> staying;
+    std::shared_ptr<game_instance> game = join_any_game(staying);
+    std::weak_ptr<player> leaving;
+    entity_id leaving_id;
+    {
+        std::shared_ptr<player> p;
+        EXPECT_EQ(join_any_game(p), game);
+        leaving = p;
+        leaving_id = p->get_entity_id();
+    }
+
+    leave_server(leaving_id);
+    EXPECT_TRUE(leaving.expired());
+    EXPECT_EQ(game->get_game_state()->get_players().size(), 1);
+
+    // the game can still be joined
+    std::shared_ptr<player> p;
+    EXPECT_EQ(join_any_game(p), game);
+    leave_server(p->get_entity_id());
+    leave_server(staying->get_entity_id());
+}
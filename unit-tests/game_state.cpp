@@ -9,6 +9,11 @@
 #include "../src/common/serialization/vector_utils.h"
 #include "../src/common/serialization/serializable_value.h"
 #include "../src/common/serialization/unique_serializable.h"
+#include "../src/common/network/responses/full_state_response.h"
+#include "../src/common/network/responses/request_response.h"
+#include "../src/common/network/responses/state_diff_response.h"
+#include "../src/common/network/wire_format.h"
+#include "../src/server/state_view.h"
 
 
 // ########################## Some basic test ########################## //
@@ -93,6 +98,41 @@ TEST(GameStateTest, GetMaxRoundNumber)
     ASSERT_EQ(test_game_state.get_max_round_number(), 15);
 }
 
+// games with the same seed deal the same cards and trump colors
+TEST(GameStateTest, SeedReplaysGame)
+{
+    game_state game1(1234);
+    game_state game2(1234);
+    ASSERT_EQ(game1.get_seed(), 1234);
+    std::string error;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(game1.add_player(new player("player" + std::to_string(i)), error));
+        ASSERT_TRUE(game2.add_player(new player("player" + std::to_string(i)), error));
+    }
+
+    for (game_state* game : {&game1, &game2}) {
+        ASSERT_TRUE(game->start_game(error));
+        // play the first round so that the second round is dealt as well
+        while (game->get_round_number() == 0) {
+            if (game->is_estimation_phase()) {
+                game->estimate_tricks(game->get_current_player(), error, 0);
+            } else {
+                player* current = game->get_current_player();
+                game->play_card(current, current->get_hand()->get_cards()[0]->get_id(), error);
+            }
+        }
+    }
+
+    EXPECT_EQ(game1.get_trump_color(), game2.get_trump_color());
+    EXPECT_EQ(game1.get_trump_card_value(), game2.get_trump_card_value());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(game1.get_players()[i]->get_hand()->get_mask(), game2.get_players()[i]->get_hand()->get_mask());
+        EXPECT_EQ(game1.get_players()[i]->get_scores(), game2.get_players()[i]->get_scores());
+        delete game1.get_players()[i];
+        delete game2.get_players()[i];
+    }
+}
+
 TEST(GameStateTest, Serialization)
 {
     auto test_game_state = game_state();
@@ -345,60 +385,37 @@ void create_json(rapidjson::Value &json, rapidjson::MemoryPoolAllocator<rapidjso
     json.AddMember("last_trick", last_trick_val, allocator);
 
     // is finished
-    rapidjson::Value is_finished_val(rapidjson::kObjectType);
-    test_is_finished->write_into_json(is_finished_val, allocator);
-    json.AddMember("is_finished", is_finished_val, allocator);
+    json.AddMember("is_finished", test_is_finished->get_value(), allocator);
 
     // is started
-    rapidjson::Value is_started_val(rapidjson::kObjectType);
-    test_is_started->write_into_json(is_started_val, allocator);
-    json.AddMember("is_started", is_started_val, allocator);
+    json.AddMember("is_started", test_is_started->get_value(), allocator);
 
     // is estimation-phase
-    rapidjson::Value is_estimation_phase_val(rapidjson::kObjectType);
-    test_is_estimation_phase->write_into_json(is_estimation_phase_val, allocator);
-    json.AddMember("is_estimation_phase", is_estimation_phase_val, allocator);
+    json.AddMember("is_estimation_phase", test_is_estimation_phase->get_value(), allocator);
 
     // round number
-    rapidjson::Value round_number_val(rapidjson::kObjectType);
-    test_round_number->write_into_json(round_number_val, allocator);
-    json.AddMember("round_number", round_number_val, allocator);
+    json.AddMember("round_number", test_round_number->get_value(), allocator);
 
     // trick number
-    rapidjson::Value trick_number_val(rapidjson::kObjectType);
-    test_trick_number->write_into_json(trick_number_val, allocator);
-    json.AddMember("trick_number", trick_number_val, allocator);
+    json.AddMember("trick_number", test_trick_number->get_value(), allocator);
 
     // starting player index
-    rapidjson::Value starting_player_idx_val(rapidjson::kObjectType);
-    test_starting_player_idx->write_into_json(starting_player_idx_val, allocator);
-    json.AddMember("starting_player_idx", starting_player_idx_val, allocator);
+    json.AddMember("starting_player_idx", test_starting_player_idx->get_value(), allocator);
 
     // trick starting player index
-    rapidjson::Value trick_starting_player_idx_val(rapidjson::kObjectType);
-    test_trick_starting_player_idx->write_into_json(trick_starting_player_idx_val, allocator);
-    json.AddMember("trick_starting_player_idx", trick_starting_player_idx_val, allocator);
+    json.AddMember("trick_starting_player_idx", test_trick_starting_player_idx->get_value(), allocator);
 
     // current player index
-    rapidjson::Value current_player_idx_val(rapidjson::kObjectType);
-    test_current_player_idx->write_into_json(current_player_idx_val, allocator);
-    json.AddMember("current_player_idx", current_player_idx_val, allocator);
+    json.AddMember("current_player_idx", test_current_player_idx->get_value(), allocator);
 
     // trump color
-    rapidjson::Value trump_color_val(rapidjson::kObjectType);
-    test_trump_color->write_into_json(trump_color_val, allocator);
-    json.AddMember("trump_color", trump_color_val, allocator);
+    json.AddMember("trump_color", test_trump_color->get_value(), allocator);
 
     // trump card value
-    rapidjson::Value trump_card_value_val(rapidjson::kObjectType);
-    test_trump_card_value->write_into_json(trump_card_value_val, allocator);
-    json.AddMember("trump_card_value", trump_card_value_val, allocator);
+    json.AddMember("trump_card_value", test_trump_card_value->get_value(), allocator);
 
     // trick estimate sum
-    rapidjson::Value trick_estimate_sum_val(rapidjson::kObjectType);
-    test_trick_estimate_sum->write_into_json(trick_estimate_sum_val, allocator);
-    json.AddMember("trick_estimate_sum", trick_estimate_sum_val, allocator);
-
+    json.AddMember("trick_estimate_sum", test_trick_estimate_sum->get_value(), allocator);
 }
 
 TEST(GameStateJson, CreateJson)
@@ -739,3 +756,304 @@ TEST_F(GameStatePlayGameTest, ThreePlayers)
     ASSERT_EQ(test_game_state->get_round_number(), 1);
     ASSERT_TRUE(test_game_state->is_estimation_phase());
 }
+
+
+// ########################## State Diffs ########################## //
+
+// serializes the parts of a game state that are part of state diffs (i.e. everything except the deck and the tricks,
+// whose players are snapshots on the client side)
+static std::string diffable_state_to_string(const game_state& state)
+{
+    rapidjson::Document* json = state.to_json();
+    json->RemoveMember("deck");
+    json->RemoveMember("trick");
+    json->RemoveMember("last_trick");
+    std::string res = json_utils::to_string(json);
+    delete json;
+    return res;
+}
+
+static void expect_same_trick(const trick* server_trick, const trick* client_trick)
+{
+    EXPECT_EQ(server_trick->get_id(), client_trick->get_id());
+    EXPECT_EQ(server_trick->get_trick_color(), client_trick->get_trick_color());
+    EXPECT_EQ(server_trick->get_trump_color(), client_trick->get_trump_color());
+    auto server_cards = server_trick->get_cards_and_players();
+    auto client_cards = client_trick->get_cards_and_players();
+    ASSERT_EQ(server_cards.size(), client_cards.size());
+    for (int i = 0; i < server_cards.size(); i++) {
+        EXPECT_EQ(server_cards[i].first->get_id(), client_cards[i].first->get_id());
+        EXPECT_EQ(server_cards[i].second->get_id(), client_cards[i].second->get_id());
+    }
+}
+
+// sends the diff of the last state update to the client state and returns the size of the diff in bytes
+static size_t send_diff(game_state& server_state, game_state& client_state)
+{
+    rapidjson::Document diff(rapidjson::kObjectType);
+    server_state.write_diff_into_json(diff, diff.GetAllocator());
+    server_state.clear_dirty();
+
+    // send it over the "network"
+    std::string message = json_utils::to_string(&diff);
+    rapidjson::Document received_diff;
+    received_diff.Parse(message.c_str());
+    EXPECT_EQ(received_diff["base_version"].GetInt(), client_state.get_version());
+    client_state.apply_diff(received_diff);
+    return message.size();
+}
+
+// plays two whole rounds while keeping a client copy of the game state up to date using only state diffs
+TEST_F(GameStatePlayGameTest, DiffsKeepClientStateInSync)
+{
+    test_game_state->clear_dirty();
+    rapidjson::Document* full_json = test_game_state->to_json();
+    const size_t full_state_size = json_utils::to_string(full_json).size();
+    game_state* client_state = game_state::from_json(*full_json);
+    delete full_json;
+    ASSERT_EQ(client_state->get_version(), test_game_state->get_version());
+
+    size_t max_play_diff_size = 0;
+    while (test_game_state->get_round_number() < 2) {
+        player* current = test_game_state->get_current_player();
+        if (test_game_state->is_estimation_phase()) {
+            // the last player must not make the sum of estimates add up to the number of cards
+            if (!test_game_state->estimate_tricks(current, error, 0)) {
+                ASSERT_TRUE(test_game_state->estimate_tricks(current, error, 1));
+            }
+            send_diff(*test_game_state, *client_state);
+        } else {
+            // play the first card that can be played
+            bool played = false;
+            for (const auto & c : current->get_hand()->get_cards()) {
+                if (test_game_state->play_card(current, c->get_id(), error)) {
+                    played = true;
+                    break;
+                }
+            }
+            ASSERT_TRUE(played);
+            const size_t diff_size = send_diff(*test_game_state, *client_state);
+            // moves that end a trick also send the previous trick and possibly the hands of the next round
+            if (!test_game_state->get_trick()->get_cards_and_players().empty()) {
+                max_play_diff_size = std::max(max_play_diff_size, diff_size);
+            }
+        }
+
+        EXPECT_EQ(client_state->get_version(), test_game_state->get_version());
+        EXPECT_EQ(diffable_state_to_string(*client_state), diffable_state_to_string(*test_game_state));
+        expect_same_trick(test_game_state->get_trick(), client_state->get_trick());
+        expect_same_trick(test_game_state->get_last_trick(), client_state->get_last_trick());
+    }
+
+    // playing a card within a trick sends an order of magnitude less than the full state
+    EXPECT_GT(max_play_diff_size, 0);
+    EXPECT_LT(max_play_diff_size * 10, full_state_size);
+    delete client_state;
+}
+
+// a copy is written as the same json, has its own players, and can be kept up to date with state diffs
+TEST_F(GameStatePlayGameTest, CopyIsIndependent)
+{
+    // one card is on the trick pile
+    for (int i = 0; i < 3; i++) {
+        if (!test_game_state->estimate_tricks(test_game_state->get_current_player(), error, 0)) {
+            ASSERT_TRUE(test_game_state->estimate_tricks(test_game_state->get_current_player(), error, 1));
+        }
+    }
+    player* current = test_game_state->get_current_player();
+    ASSERT_TRUE(test_game_state->play_card(current, current->get_hand()->get_cards().at(0)->get_id(), error));
+    test_game_state->clear_dirty();
+
+    game_state* copy = test_game_state->copy();
+    rapidjson::Document* json = test_game_state->to_json();
+    rapidjson::Document* copy_json = copy->to_json();
+    EXPECT_EQ(*copy_json, *json);
+    delete copy_json;
+    delete json;
+
+    ASSERT_EQ(copy->get_players().size(), 3);
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_NE(copy->get_players()[i], test_game_state->get_players()[i]);
+        EXPECT_EQ(copy->get_players()[i]->get_id(), test_game_state->get_players()[i]->get_id());
+    }
+    // the cards on the trick pile refer to the players of the copy
+    EXPECT_EQ(copy->get_trick()->get_cards_and_players().at(0).second, copy->get_players()[0]);
+
+    current = test_game_state->get_current_player();
+    ASSERT_TRUE(test_game_state->play_card(current, current->get_hand()->get_cards().at(0)->get_id(), error));
+    send_diff(*test_game_state, *copy);
+    EXPECT_EQ(diffable_state_to_string(*copy), diffable_state_to_string(*test_game_state));
+    expect_same_trick(test_game_state->get_trick(), copy->get_trick());
+
+    for (const player* p : copy->get_players()) {
+        delete p;
+    }
+    delete copy;
+}
+
+// players joining the game are sent as a whole, unchanged values are not part of the diff
+TEST(GameStateDiffTest, JoiningPlayersAreSentCompletely)
+{
+    auto test_game_state = game_state();
+    std::string error = "error message";
+    ASSERT_TRUE(test_game_state.add_player(new player("player1"), error));
+    test_game_state.clear_dirty();
+
+    ASSERT_TRUE(test_game_state.add_player(new player("player2"), error));
+    rapidjson::Document diff(rapidjson::kObjectType);
+    test_game_state.write_diff_into_json(diff, diff.GetAllocator());
+
+    EXPECT_EQ(diff["id"].GetString(), test_game_state.get_id());
+    EXPECT_EQ(diff["base_version"].GetInt(), 1);
+    EXPECT_EQ(diff["version"].GetInt(), 2);
+    EXPECT_EQ(diff["players"].Size(), 2);
+    EXPECT_FALSE(diff.HasMember("player_diffs"));
+    EXPECT_FALSE(diff.HasMember("deck"));
+    EXPECT_FALSE(diff.HasMember("trick"));
+    EXPECT_FALSE(diff.HasMember("round_number"));
+}
+
+
+// ########################## State Views ########################## //
+
+// a player only sees their own cards, the other hands are redacted and the deck is left out
+TEST_F(GameStatePlayGameTest, ViewOnlyRevealsOwnHand)
+{
+    rapidjson::Document view(rapidjson::kObjectType);
+    test_game_state->write_view_into_json(view, view.GetAllocator(), test_player1);
+    EXPECT_FALSE(view.HasMember("deck"));
+
+    const rapidjson::Value& players = view["players"];
+    ASSERT_EQ(players.Size(), 3);
+    EXPECT_EQ(players[0]["hand"]["cards"].Size(), 1);
+    EXPECT_FALSE(players[1]["hand"].HasMember("cards"));
+    EXPECT_EQ(players[1]["hand"]["nof_cards"].GetUint(), 1);
+    EXPECT_FALSE(players[2]["hand"].HasMember("cards"));
+
+    // the client can deserialize the view
+    game_state* client_state = game_state::from_json(view);
+    EXPECT_EQ(client_state->get_players()[0]->get_hand()->get_cards().size(), 1);
+    EXPECT_EQ(client_state->get_players()[1]->get_nof_cards(), 1);
+    EXPECT_TRUE(client_state->get_players()[1]->get_hand()->get_cards().empty());
+    delete client_state;
+}
+
+// splicing the own hand into the shared message gives the same message as serializing the diff for each player
+TEST_F(GameStatePlayGameTest, SplicedViewsMatchPlayerViews)
+{
+    // the diff after starting the game contains all players with their hands
+    for (const auto & p : test_game_state->get_players()) {
+        rapidjson::Document diff(rapidjson::kObjectType);
+        test_game_state->write_diff_view_into_json(diff, diff.GetAllocator(), p);
+        const std::string expected_diff = json_utils::to_string(&diff);
+
+        state_diff_response msg = state_diff_response(test_game_state->get_id(), *test_game_state);
+        state_view view = state_view(msg, test_game_state->get_players());
+        for (const auto enc : {wire_format::encoding::json, wire_format::encoding::binary}) {
+            const std::string message = view.get_message(p, enc);
+            rapidjson::Document received;
+            wire_format::decode(message.data(), message.size(), enc, received);
+            EXPECT_EQ(json_utils::to_string(&received["diff_json"]), expected_diff);
+        }
+
+        // nobody else's cards are part of the message
+        const std::string message = view.get_message(p, wire_format::encoding::json);
+        for (const auto & other : test_game_state->get_players()) {
+            for (const auto & c : other->get_hand()->get_cards()) {
+                EXPECT_EQ(message.find(c->get_id()) != std::string::npos, other == p);
+            }
+        }
+    }
+}
+
+
+// ########################## Json Writer ########################## //
+
+// writes the json of 'write' with a json writer
+template<typename F>
+static std::string write_json(F write)
+{
+    rapidjson::StringBuffer buffer;
+    json_writer writer(buffer);
+    write(writer);
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+// the json text written straight from the game state is the same as the text of its json document
+static void expect_same_json_as_document(game_state& state)
+{
+    rapidjson::Document* json = state.to_json();
+    EXPECT_EQ(json_utils::to_string(state), json_utils::to_string(json));
+    delete json;
+
+    std::vector<const player*> viewers(state.get_players().begin(), state.get_players().end());
+    viewers.push_back(nullptr);
+    for (const player* viewer : viewers) {
+        rapidjson::Document view(rapidjson::kObjectType);
+        state.write_view_into_json(view, view.GetAllocator(), viewer);
+        EXPECT_EQ(write_json([&](json_writer& writer) { state.write_view_into_writer(writer, viewer); }),
+                  json_utils::to_string(&view));
+
+        rapidjson::Document diff_view(rapidjson::kObjectType);
+        state.write_diff_view_into_json(diff_view, diff_view.GetAllocator(), viewer);
+        EXPECT_EQ(write_json([&](json_writer& writer) { state.write_diff_view_into_writer(writer, viewer); }),
+                  json_utils::to_string(&diff_view));
+    }
+
+    rapidjson::Document diff(rapidjson::kObjectType);
+    state.write_diff_into_json(diff, diff.GetAllocator());
+    EXPECT_EQ(write_json([&](json_writer& writer) { state.write_diff_into_writer(writer); }),
+              json_utils::to_string(&diff));
+
+    // the frames of the responses are the same as the frames of their json documents
+    const full_state_response full_state = full_state_response(state.get_id(), state);
+    const state_diff_response state_diff = state_diff_response(state.get_id(), state);
+    const request_response response = request_response(state.get_id(), "req", true, state.to_json(), "");
+    const std::vector<const server_response*> messages = {&full_state, &state_diff, &response};
+    for (const server_response* msg : messages) {
+        rapidjson::Document* msg_json = msg->to_json();
+        EXPECT_EQ(wire_format::make_frame(*msg, wire_format::encoding::json),
+                  wire_format::make_frame(wire_format::encode(*msg_json, wire_format::encoding::json),
+                                          wire_format::encoding::json));
+        delete msg_json;
+    }
+}
+
+// the json writer produces the same bytes as the json documents, in the lobby and throughout two rounds
+TEST(GameStateJsonWriterTest, SameJsonAsDocument)
+{
+    auto test_game_state = game_state();
+    std::string error = "error message";
+    ASSERT_TRUE(test_game_state.add_player(new player("player1"), error));
+    ASSERT_TRUE(test_game_state.add_player(new player("player \"2\"\n"), error));   // escaped characters
+    expect_same_json_as_document(test_game_state);
+    test_game_state.clear_dirty();
+
+    ASSERT_TRUE(test_game_state.add_player(new player("player3"), error));
+    ASSERT_TRUE(test_game_state.start_game(error));
+    expect_same_json_as_document(test_game_state);
+    test_game_state.clear_dirty();
+
+    while (test_game_state.get_round_number() < 2) {
+        player* current = test_game_state.get_current_player();
+        if (test_game_state.is_estimation_phase()) {
+            if (!test_game_state.estimate_tricks(current, error, 0)) {
+                ASSERT_TRUE(test_game_state.estimate_tricks(current, error, 1));
+            }
+        } else {
+            const uint64_t playable = test_game_state.get_playable_mask();
+            for (const card* c : current->get_hand()->get_card_span()) {
+                if (card_mask::contains(playable, c->get_value(), c->get_color())) {
+                    ASSERT_TRUE(test_game_state.play_card(current, c->get_entity_id(), error));
+                    break;
+                }
+            }
+        }
+        expect_same_json_as_document(test_game_state);
+        test_game_state.clear_dirty();
+    }
+
+    for (player* p : test_game_state.get_players()) {
+        delete p;
+    }
+}
@@ -66,6 +66,55 @@ TEST_F(HandTest, RemoveExistingCard) {
 
 }
 
+// adding and removing cards marks the hand as changed until its changes were sent
+TEST_F(HandTest, DirtyTracking) {
+    card* card1 = new card(14, 0);
+    card* card2 = new card(2, 2);
+    cards = {card1, card2};
+    test_hand = new hand("test_hand_id", cards);
+
+    // a new hand was never sent
+    EXPECT_TRUE(test_hand->is_dirty());
+    test_hand->clear_dirty();
+    EXPECT_FALSE(test_hand->is_dirty());
+
+    // removing a card that is not in the hand does not change it
+    card* card3 = new card(4, 3);
+    EXPECT_FALSE(test_hand->remove_card(card3->get_id(), err));
+    EXPECT_FALSE(test_hand->is_dirty());
+
+    EXPECT_TRUE(test_hand->remove_card(card1->get_id(), err));
+    EXPECT_TRUE(test_hand->is_dirty());
+    test_hand->clear_dirty();
+
+    test_hand->add_card(card3, err);
+    EXPECT_TRUE(test_hand->is_dirty());
+    cards.push_back(card3);
+}
+
+// a redacted hand only reveals the number of cards and stays redacted when it is passed on
+TEST_F(HandTest, RedactedSerialization) {
+    card* card1 = new card(14, 0);
+    card* card2 = new card(2, 2);
+    cards = {card1, card2};
+    test_hand = new hand("test_hand_id", cards);
+
+    rapidjson::Document redacted_json(rapidjson::kObjectType);
+    test_hand->write_redacted_into_json(redacted_json, redacted_json.GetAllocator());
+    EXPECT_FALSE(redacted_json.HasMember("cards"));
+    EXPECT_EQ(redacted_json["nof_cards"].GetUint(), 2);
+
+    hand* redacted_hand = hand::from_json(redacted_json);
+    EXPECT_EQ(redacted_hand->get_id(), "test_hand_id");
+    EXPECT_EQ(redacted_hand->get_nof_cards(), 2);
+    EXPECT_TRUE(redacted_hand->get_cards().empty());
+
+    rapidjson::Document* json = redacted_hand->to_json();
+    EXPECT_EQ(json_utils::to_string(json), json_utils::to_string(&redacted_json));
+    delete json;
+    delete redacted_hand;
+}
+
 // remove card that is not in hand
 TEST_F(HandTest, RemoveNonExistentCard) {
     card* card1 = new card(14, 0);
@@ -109,12 +158,64 @@ TEST_F(HandTest, TryGetCards) {
 
 
 
+// the card mask follows the cards in the hand, wizards and jesters are counted
+TEST_F(HandTest, CardMask) {
+    card* wizard1 = new card(14, 0);
+    card* wizard2 = new card(14, 0);
+    card* jester = new card(0, 0);
+    card* red_two = new card(2, 2);
+    cards = {wizard1, wizard2, jester, red_two};
+    test_hand = new hand("test_hand_id", cards);
+
+    EXPECT_EQ(card_mask::size(test_hand->get_mask()), 4);
+    EXPECT_EQ(card_mask::size(test_hand->get_mask() & card_mask::wizards), 2);
+    EXPECT_TRUE(card_mask::contains(test_hand->get_mask(), 2, 2));
+    EXPECT_FALSE(card_mask::contains(test_hand->get_mask(), 2, 3));
+    EXPECT_TRUE(test_hand->has_color(2));
+    EXPECT_FALSE(test_hand->has_color(1));
+
+    test_hand->remove_card(wizard1->get_id(), err);
+    EXPECT_EQ(card_mask::size(test_hand->get_mask() & card_mask::wizards), 1);
+    test_hand->remove_card(wizard2->get_id(), err);
+    test_hand->remove_card(red_two->get_id(), err);
+    EXPECT_EQ(test_hand->get_mask(), uint64_t{1} << 56);    // the lowest of the jester bits
+    EXPECT_FALSE(test_hand->has_color(2));
+}
+
+// only cards of the trick color, wizards and jesters can be played if the hand holds the trick color
+TEST_F(HandTest, PlayableCards) {
+    card* wizard = new card(14, 0);
+    card* jester = new card(0, 0);
+    card* red_two = new card(2, 2);
+    card* red_twelve = new card(12, 2);
+    card* green_five = new card(5, 3);
+    cards = {wizard, jester, red_two, red_twelve, green_five};
+    test_hand = new hand("test_hand_id", cards);
+
+    // no trick color yet, or the trick was started with a wizard
+    EXPECT_EQ(test_hand->get_playable_mask(0), test_hand->get_mask());
+    EXPECT_EQ(test_hand->get_playable_mask(-1), test_hand->get_mask());
+
+    const uint64_t red_playable = test_hand->get_playable_mask(2);
+    EXPECT_EQ(card_mask::size(red_playable), 4);
+    EXPECT_FALSE(card_mask::contains(red_playable, 5, 3));
+    EXPECT_TRUE(test_hand->can_play(red_twelve, 2));
+    EXPECT_TRUE(test_hand->can_play(wizard, 2));
+    EXPECT_TRUE(test_hand->can_play(jester, 2));
+    EXPECT_FALSE(test_hand->can_play(green_five, 2));
+
+    // without cards of the trick color, every card can be played
+    EXPECT_EQ(test_hand->get_playable_mask(1), test_hand->get_mask());
+    EXPECT_TRUE(test_hand->can_play(green_five, 1));
+}
+
 // Serialization and subsequent deserialization must yield the same object
 TEST_F(HandTest, SerializationEquality) {
-    card* card1 = new card(14, 0);
-    card* card2 = new card(2, 2);
-    card* card3 = new card(4, 3);
-    card* card4 = new card(11, 1);
+    // only the cards of the card table can be deserialized
+    card* card1 = card::get_card(52);   // wizard
+    card* card2 = card::get_card(5);    // 2 of color 2
+    card* card3 = card::get_card(14);   // 4 of color 3
+    card* card4 = card::get_card(40);   // 11 of color 1
     test_hand = new hand("test_hand_id");
     test_hand->add_card(card1, err);
     test_hand->add_card(card2, err);
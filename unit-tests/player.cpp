@@ -38,7 +38,7 @@ TEST_F(PlayerTest, CreatePlayer)
     int score = 7;
     test_player.set_scores(score);
     //EXPECT_EQ(test_player.get_scores().size(), 1);
-    //EXPECT_EQ(test_player.get_scores()[0]->get_value(), score);
+    //EXPECT_EQ(test_player.get_scores()[0], score);
 
 
 }
@@ -163,11 +163,11 @@ TEST_F(PlayerTest, WrapUpRoundBadPrediction)
     test_player.set_scores(20);
     test_player.set_nof_tricks(2);
     test_player.set_nof_predicted(4);
-    int previous_score = test_player.get_scores().back()->get_value();
+    int previous_score = test_player.get_scores().back();
 
     test_player.wrap_up_round();
-    std::vector<serializable_value<int>*> scores = test_player.get_scores();
-    int new_score = scores.back()->get_value();
+    std::vector<int> scores = test_player.get_scores();
+    int new_score = scores.back();
     //since two tricks off (2 made, 4 predicted) --> subtract 2 * 10 from previous score
     EXPECT_EQ(new_score, 0);
 
@@ -187,16 +187,16 @@ TEST_F(PlayerTest, WrapUpRoundGoodGameplay)
     test_player.set_scores(20);
     test_player.set_nof_tricks(2);
     test_player.set_nof_predicted(2);
-    int previous_score = test_player.get_scores().back()->get_value();
+    int previous_score = test_player.get_scores().back();
 
 
     // compute score
     test_player.wrap_up_round();
-    std::vector<serializable_value<int>*> scores = test_player.get_scores();
-    int new_score = scores.back()->get_value();
+    std::vector<int> scores = test_player.get_scores();
+    int new_score = scores.back();
     //since two tricks off (2 made, 2 predicted) --> add 2 * 10 + 20 to previous score
     EXPECT_EQ(new_score, 60);
-    int collected_points = scores.back()->get_value();
+    int collected_points = scores.back();
 
     //made 40 points in this round
     EXPECT_EQ(std::abs(new_score - previous_score), 40);
@@ -225,7 +225,7 @@ TEST_F(PlayerTest, SerializationEquality) {
     EXPECT_EQ(player_send.get_nof_predicted(), player_received->get_nof_predicted());
     EXPECT_EQ(player_send.get_nof_tricks(), player_received->get_nof_tricks());
     EXPECT_EQ(player_send.get_player_name(), player_received->get_player_name());
-    EXPECT_EQ(player_send.get_scores()[0]->get_value(), player_received->get_scores()[0]->get_value());
+    EXPECT_EQ(player_send.get_scores()[0], player_received->get_scores()[0]);
     auto card_sent = player_send.get_hand()->get_cards();
     auto card_received = player_received->get_hand()->get_cards();
     EXPECT_EQ(card_sent, card_received); //can't compare hands since operator== not overloaded
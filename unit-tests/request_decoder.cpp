@@ -0,0 +1,110 @@
+//
+// Tests of decoding requests into request_views.
+//
+
+#include "gtest/gtest.h"
+#include "../src/common/exceptions/WizardException.h"
+#include "../src/common/network/requests/estimate_tricks_request.h"
+#include "../src/common/network/requests/join_game_request.h"
+#include "../src/common/network/requests/leave_game_request.h"
+#include "../src/common/network/requests/play_card_request.h"
+#include "../src/common/network/requests/resync_request.h"
+#include "../src/common/network/requests/start_game_request.h"
+#include "../src/server/request_decoder.h"
+
+
+class RequestDecoderTest : public ::testing::TestWithParam<wire_format::encoding> {
+
+protected:
+    request_decoder decoder;
+    std::string payload;
+
+    // encodes the request like the client does, and decodes it like the server does
+    const request_view& decode(const client_request& request)
+    {
+        rapidjson::Document* json = request.to_json();
+        payload = wire_format::encode(*json, GetParam());
+        delete json;
+        return decode_payload();
+    }
+
+    const request_view& decode_payload()
+    {
+        // the payload of a frame is always followed by a '\0' (see frame_reader)
+        frame_reader::frame f {GetParam(), payload.data(), payload.size()};
+        return decoder.decode(f);
+    }
+};
+
+// the fields of all request types are decoded
+TEST_P(RequestDecoderTest, AllRequestTypes)
+{
+    const join_game_request join = join_game_request("game", "player", "name");
+    const request_view& join_view = decode(join);
+    EXPECT_EQ(join_view.type, RequestType::join_game);
+    EXPECT_EQ(join_view.req_id, join.get_req_id());
+    EXPECT_EQ(join_view.game_id, "game");
+    EXPECT_EQ(join_view.player_id, "player");
+    EXPECT_EQ(join_view.player_name, "name");
+
+    const request_view& start_view = decode(start_game_request("game", "player"));
+    EXPECT_EQ(start_view.type, RequestType::start_game);
+    EXPECT_EQ(start_view.player_name, "");
+
+    const std::string card_id = uuid_generator::generate_uuid_v4();
+    const request_view& play_view = decode(play_card_request("game", "player", card_id));
+    EXPECT_EQ(play_view.type, RequestType::play_card);
+    EXPECT_EQ(play_view.card_id, card_id);
+
+    const request_view& estimate_view = decode(estimate_tricks_request("game", "player", 3));
+    EXPECT_EQ(estimate_view.type, RequestType::estimate_tricks);
+    EXPECT_EQ(estimate_view.trick_estimate, 3);
+    EXPECT_EQ(estimate_view.card_id, "");
+
+    const request_view& leave_view = decode(leave_game_request("game", "player", "name"));
+    EXPECT_EQ(leave_view.type, RequestType::leave_game);
+    EXPECT_EQ(leave_view.player_name, "name");
+
+    const request_view& resync_view = decode(resync_request("game", "player"));
+    EXPECT_EQ(resync_view.type, RequestType::resync);
+    EXPECT_EQ(resync_view.game_id, "game");
+}
+
+// requests that do not fit into the buffers of the decoder are decoded as well
+TEST_P(RequestDecoderTest, LargeRequest)
+{
+    const std::string long_name(10000, 'x');
+    EXPECT_EQ(decode(join_game_request("game", "player", long_name)).player_name, long_name);
+    EXPECT_EQ(decode(join_game_request("game", "player", "name")).player_name, "name");
+}
+
+// invalid requests are rejected with an exception
+TEST_P(RequestDecoderTest, InvalidRequests)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"type":"play_card","player_id":"player","game_id":"game","req_id":"req"})");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    json.Parse(R"({"type":"unknown","player_id":"player","game_id":"game","req_id":"req"})");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    json.Parse(R"({"type":"estimate_tricks","player_id":"player","game_id":"game","req_id":"req","estimate_tricks":"1"})");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    json.Parse(R"({"type":"start_game","player_id":1,"game_id":"game","req_id":"req"})");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    json.Parse(R"([1,2,3])");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    payload = "{\"type\":";
+    EXPECT_THROW(decode_payload(), WizardException);
+}
+
+INSTANTIATE_TEST_SUITE_P(Encodings, RequestDecoderTest,
+                         ::testing::Values(wire_format::encoding::json, wire_format::encoding::binary));
@@ -0,0 +1,171 @@
+//
+// Tests of decoding the responses of the server into the game states of a client.
+//
+
+#include "gtest/gtest.h"
+#include "test_game.h"
+#include "../src/common/exceptions/WizardException.h"
+#include "../src/common/network/response_decoder.h"
+#include "../src/common/network/responses/full_state_response.h"
+#include "../src/common/network/responses/request_response.h"
+#include "../src/common/network/responses/state_diff_response.h"
+
+
+class ResponseDecoderTest : public ::testing::TestWithParam<wire_format::encoding> {
+
+protected:
+    response_decoder decoder;
+    std::string payload;
+    game_state* state = nullptr;
+    std::string err;
+
+    void SetUp() override
+    {
+        state = create_started_game(7);
+        state->clear_dirty();
+    }
+
+    void TearDown() override
+    {
+        delete_game(state);
+    }
+
+    // encodes the response like the server does
+    std::string encode(const server_response& response)
+    {
+        rapidjson::Document* json = response.to_json();
+        std::string encoded = wire_format::encode(*json, GetParam());
+        delete json;
+        return encoded;
+    }
+
+    // decodes the payload like the client does
+    response_decoder::update decode_payload()
+    {
+        // the payload of a frame is always followed by a '\0' (see frame_reader)
+        frame_reader::frame f {GetParam(), payload.data(), payload.size()};
+        return decoder.decode(f);
+    }
+
+    response_decoder::update decode(const server_response& response)
+    {
+        payload = encode(response);
+        return decode_payload();
+    }
+
+    // sends the changes of the game state since the last update
+    response_decoder::update send_diff()
+    {
+        response_decoder::update update = decode(state_diff_response(state->get_id(), *state));
+        state->clear_dirty();
+        return update;
+    }
+};
+
+// full states replace the game state of the decoder, diffs are applied to it, and a separate copy is handed out
+TEST_P(ResponseDecoderTest, FullStateAndDiffs)
+{
+    response_decoder::update update = decode(full_state_response(state->get_id(), *state));
+    ASSERT_NE(update.state, nullptr);
+    ASSERT_NE(decoder.get_state(), nullptr);
+    EXPECT_NE(update.state, decoder.get_state());
+    EXPECT_EQ(update.state->get_id(), state->get_id());
+    EXPECT_EQ(update.state->get_version(), state->get_version());
+    EXPECT_EQ(update.state->get_players().size(), 3);
+    EXPECT_FALSE(update.resync);
+    delete_game(update.state);
+
+    player* current = state->get_current_player();
+    ASSERT_TRUE(state->estimate_tricks(current, err, 1));
+    update = send_diff();
+    ASSERT_NE(update.state, nullptr);
+    EXPECT_EQ(update.state->get_version(), state->get_version());
+    EXPECT_EQ(update.state->get_trick_estimate_sum(), 1);
+    EXPECT_EQ(update.state->get_current_player()->get_id(), state->get_current_player()->get_id());
+    EXPECT_EQ(decoder.get_state()->get_trick_estimate_sum(), 1);
+
+    // changing the handed out state does not change the one of the decoder
+    update.state->get_current_player()->set_nof_tricks(5);
+    EXPECT_EQ(decoder.get_state()->get_current_player()->get_nof_tricks(), 0);
+    delete_game(update.state);
+
+    // a diff that arrives after a full state that already contains it is ignored
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    const std::string diff = encode(state_diff_response(state->get_id(), *state));
+    state->clear_dirty();
+    update = decode(full_state_response(state->get_id(), *state));
+    delete_game(update.state);
+    payload = diff;
+    EXPECT_TRUE(decode_payload().is_empty());
+    EXPECT_EQ(decoder.get_state()->get_version(), state->get_version());
+}
+
+// diffs before the first full state are ignored, diffs after a missed update ask for the full state once
+TEST_P(ResponseDecoderTest, MissedUpdates)
+{
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    EXPECT_TRUE(send_diff().is_empty());
+    EXPECT_EQ(decoder.get_state(), nullptr);
+
+    response_decoder::update update = decode(full_state_response(state->get_id(), *state));
+    delete_game(update.state);
+
+    // the diff of the next estimate is lost
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    state->clear_dirty();
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    update = send_diff();
+    EXPECT_TRUE(update.resync);
+    EXPECT_EQ(update.state, nullptr);
+    EXPECT_EQ(decoder.get_state(), nullptr);
+
+    // the full state is only requested once, the diffs before it arrives are ignored
+    player* current = state->get_current_player();
+    ASSERT_TRUE(state->play_card(current, current->get_hand()->get_cards().at(0)->get_id(), err));
+    EXPECT_TRUE(send_diff().is_empty());
+    EXPECT_EQ(decoder.get_state(), nullptr);
+
+    update = decode(full_state_response(state->get_id(), *state));
+    ASSERT_NE(decoder.get_state(), nullptr);
+    EXPECT_EQ(decoder.get_state()->get_version(), state->get_version());
+    delete_game(update.state);
+}
+
+// failed requests hand out their error, successful ones without a state do not change anything
+TEST_P(ResponseDecoderTest, RequestResponses)
+{
+    response_decoder::update update = decode(request_response(state->get_id(), "req", false, nullptr,
+                                                              "It is not your turn"));
+    EXPECT_EQ(update.error, "It is not your turn");
+    EXPECT_EQ(update.state, nullptr);
+
+    EXPECT_TRUE(decode(request_response(state->get_id(), "req", true, nullptr, "")).is_empty());
+}
+
+// invalid responses are rejected with an exception
+TEST_P(ResponseDecoderTest, InvalidResponses)
+{
+    rapidjson::Document json;
+    json.Parse(R"({"type":"unknown","game_id":"game"})");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    json.Parse(R"({"type":"full_state_msg","game_id":"game"})");
+    payload = wire_format::encode(json, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+
+    // the members of a diff are checked before it is compared to the game state of the decoder
+    delete_game(decode(full_state_response(state->get_id(), *state)).state);
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    rapidjson::Document* diff = state_diff_response(state->get_id(), *state).to_json();
+    (*diff)["diff_json"].RemoveMember("version");
+    payload = wire_format::encode(*diff, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+    (*diff)["diff_json"].AddMember("version", "1", diff->GetAllocator());
+    payload = wire_format::encode(*diff, GetParam());
+    EXPECT_THROW(decode_payload(), WizardException);
+    delete diff;
+}
+
+INSTANTIATE_TEST_SUITE_P(Encodings, ResponseDecoderTest,
+                         ::testing::Values(wire_format::encoding::json, wire_format::encoding::binary));
@@ -0,0 +1,175 @@
+//
+// Tests of the serialization generated from the schemas of the game state objects (see schema.h).
+//
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_game.h"
+#include "../src/common/exceptions/WizardException.h"
+
+// copies 'json' with its members in reverse order
+static rapidjson::Document reversed(const rapidjson::Value& json) {
+    rapidjson::Document copy(rapidjson::kObjectType);
+    std::vector<const rapidjson::Value::Member*> members;
+    for (const auto& member : json.GetObject()) {
+        members.push_back(&member);
+    }
+    std::reverse(members.begin(), members.end());
+    for (const auto* member : members) {
+        copy.AddMember(rapidjson::Value(member->name, copy.GetAllocator()),
+                       rapidjson::Value(member->value, copy.GetAllocator()), copy.GetAllocator());
+    }
+    return copy;
+}
+
+// scalar members are written as plain json values, not wrapped in objects
+TEST(SchemaTest, ScalarsAreFlat) {
+    game_state* state = create_started_game(42);
+    rapidjson::Document* json = state->to_json();
+
+    EXPECT_TRUE((*json)["is_started"].IsBool());
+    EXPECT_EQ((*json)["round_number"].GetInt(), 0);
+    EXPECT_EQ((*json)["trump_color"].GetInt(), state->get_trump_color());
+    const rapidjson::Value& first_player = (*json)["players"][0];
+    EXPECT_STREQ(first_player["player_name"].GetString(), "player1");
+    EXPECT_EQ(first_player["nof_predicted"].GetInt(), -1);
+    EXPECT_EQ(first_player["scores"][0].GetInt(), 0);
+    EXPECT_TRUE(first_player["hand"]["cards"][0]["value"].IsInt());
+    EXPECT_TRUE((*json)["trick"]["trick_color"].IsInt());
+
+    delete json;
+    delete_game(state);
+}
+
+// objects are read in one pass over their members, in any order
+TEST(SchemaTest, MembersInAnyOrder) {
+    game_state* state = create_started_game(42);
+    rapidjson::Document* json = state->to_json();
+    rapidjson::Document reversed_json = reversed(*json);
+    for (auto& p : reversed_json["players"].GetArray()) {
+        rapidjson::Document reversed_player = reversed(p);
+        p.CopyFrom(reversed_player, reversed_json.GetAllocator());
+    }
+
+    game_state* copy = game_state::from_json(reversed_json);
+    EXPECT_EQ(copy->get_id(), state->get_id());
+    EXPECT_EQ(copy->is_started(), state->is_started());
+    EXPECT_EQ(copy->get_trump_color(), state->get_trump_color());
+    EXPECT_EQ(copy->get_current_player()->get_id(), state->get_current_player()->get_id());
+    ASSERT_EQ(copy->get_players().size(), 3);
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(copy->get_players()[i]->get_player_name(), state->get_players()[i]->get_player_name());
+        EXPECT_EQ(copy->get_players()[i]->get_nof_predicted(), -1);
+        EXPECT_EQ(copy->get_players()[i]->get_scores(), state->get_players()[i]->get_scores());
+        EXPECT_EQ(copy->get_players()[i]->get_nof_cards(), 1);
+    }
+
+    // writing the copy gives the json of the original again
+    rapidjson::Document* copy_json = copy->to_json();
+    EXPECT_EQ(*copy_json, *json);
+
+    delete copy_json;
+    delete_game(copy);
+    delete json;
+    delete_game(state);
+}
+
+// a missing or mistyped member is reported instead of being read as a default value
+TEST(SchemaTest, MissingOrMistypedMember) {
+    game_state* state = create_started_game(42);
+
+    rapidjson::Document* json = state->to_json();
+    json->RemoveMember("trick_number");
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    json = state->to_json();
+    (*json)["round_number"].SetString("0");
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    json = state->to_json();
+    (*json)["players"][1].RemoveMember("has_left_game");
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    delete_game(state);
+}
+
+// the members a class reads itself (ids, arrays and objects) are checked like the scalar members
+TEST(SchemaTest, MistypedNonSchemaMember) {
+    game_state* state = create_started_game(42);
+
+    rapidjson::Document* json = state->to_json();
+    (*json)["id"].SetInt(5);
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    json = state->to_json();
+    (*json)["players"].SetObject();
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    json = state->to_json();
+    (*json)["players"][0]["id"].SetBool(true);
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    json = state->to_json();
+    (*json)["trick"]["cards"].SetString("none");
+    EXPECT_THROW(game_state::from_json(*json), WizardException);
+    delete json;
+
+    // the ids in a state diff, which is applied to a copy of the game state
+    json = state->to_json();
+    game_state* copy = game_state::from_json(*json);
+    state->clear_dirty();
+    std::string err;
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 1));
+    rapidjson::Document diff(rapidjson::kObjectType);
+    state->write_diff_into_json(diff, diff.GetAllocator());
+    ASSERT_TRUE(diff.HasMember("player_diffs"));
+    diff["player_diffs"][0]["id"].SetInt(5);
+    EXPECT_THROW(copy->apply_diff(diff), WizardException);
+    diff["player_diffs"][0].RemoveMember("id");
+    EXPECT_THROW(copy->apply_diff(diff), WizardException);
+
+    delete_game(copy);
+    delete json;
+    delete_game(state);
+}
+
+// a state diff only contains the scalar members that changed, and applying it updates them
+TEST(SchemaTest, DiffContainsChangedScalars) {
+    game_state* state = create_started_game(42);
+    rapidjson::Document* json = state->to_json();
+    state->clear_dirty();
+
+    std::string err;
+    player* estimating_player = state->get_current_player();
+    const std::vector<player*>& players = state->get_players();
+    const size_t estimating_idx = std::find(players.begin(), players.end(), estimating_player) - players.begin();
+    ASSERT_TRUE(state->estimate_tricks(estimating_player, err, 1));
+    rapidjson::Document diff(rapidjson::kObjectType);
+    state->write_diff_into_json(diff, diff.GetAllocator());
+    EXPECT_TRUE(diff.HasMember("current_player_idx"));
+    EXPECT_TRUE(diff.HasMember("trick_estimate_sum"));
+    EXPECT_FALSE(diff.HasMember("round_number"));
+    EXPECT_FALSE(diff.HasMember("trump_color"));
+    ASSERT_TRUE(diff.HasMember("player_diffs"));
+    EXPECT_EQ(diff["player_diffs"][0]["nof_predicted"].GetInt(), 1);
+    EXPECT_FALSE(diff["player_diffs"][0].HasMember("player_name"));
+
+    game_state* copy = game_state::from_json(*json);
+    copy->apply_diff(diff);
+    EXPECT_EQ(copy->get_trick_estimate_sum(), 1);
+    EXPECT_EQ(copy->get_current_player()->get_id(), state->get_current_player()->get_id());
+    EXPECT_EQ(copy->get_players()[estimating_idx]->get_nof_predicted(), 1);
+
+    delete_game(copy);
+    delete json;
+    delete_game(state);
+}
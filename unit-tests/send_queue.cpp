@@ -0,0 +1,148 @@
+//
+// Tests of the bounded outgoing message queue of a connection.
+//
+
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "../src/server/send_queue.h"
+
+
+static send_queue::frame_ptr make_frame(size_t size, char c = 'x') {
+    return std::make_shared<const std::string>(size, c);
+}
+
+static send_queue::limits make_limits(size_t max_bytes, send_queue::overflow_policy policy,
+                                      std::chrono::milliseconds max_wait = std::chrono::milliseconds(100)) {
+    send_queue::limits lim;
+    lim.max_bytes = max_bytes;
+    lim.policy = policy;
+    lim.max_wait = max_wait;
+    return lim;
+}
+
+// frames are handed to the writer in the order they were queued
+TEST(SendQueueTest, FramesInOrder) {
+    send_queue queue(make_limits(100, send_queue::overflow_policy::evict));
+    EXPECT_TRUE(queue.is_empty());
+    EXPECT_EQ(queue.push(make_frame(3, 'a')), send_queue::push_result::queued);
+    EXPECT_EQ(queue.push(make_frame(4, 'b')), send_queue::push_result::queued);
+    EXPECT_EQ(queue.get_nof_bytes(), 7);
+
+    send_queue::frame_ptr frame;
+    size_t offset = 1;
+    queue.front(frame, offset);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(*frame, "aaa");
+    EXPECT_EQ(offset, 0);
+    queue.consume(3);
+
+    queue.wait_front(frame, offset);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(*frame, "bbbb");
+    queue.consume(4);
+
+    queue.front(frame, offset);
+    EXPECT_EQ(frame, nullptr);
+    EXPECT_TRUE(queue.is_empty());
+    EXPECT_EQ(queue.get_nof_bytes(), 0);
+}
+
+// a partially written frame is continued where it stopped
+TEST(SendQueueTest, PartialWrite) {
+    send_queue queue(make_limits(100, send_queue::overflow_policy::evict));
+    queue.push(make_frame(10));
+
+    send_queue::frame_ptr frame;
+    size_t offset = 0;
+    queue.consume(4);
+    queue.front(frame, offset);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(offset, 4);
+    EXPECT_EQ(queue.get_nof_bytes(), 6);
+
+    queue.consume(6);
+    queue.front(frame, offset);
+    EXPECT_EQ(frame, nullptr);
+    EXPECT_EQ(offset, 0);
+}
+
+// the receivers of a broadcast share the same buffer
+TEST(SendQueueTest, SharedFrames) {
+    send_queue first(make_limits(100, send_queue::overflow_policy::evict));
+    send_queue second(make_limits(100, send_queue::overflow_policy::evict));
+    send_queue::frame_ptr frame = make_frame(8);
+    first.push(frame);
+    second.push(frame);
+
+    send_queue::frame_ptr first_frame, second_frame;
+    size_t offset;
+    first.front(first_frame, offset);
+    second.front(second_frame, offset);
+    EXPECT_EQ(first_frame.get(), frame.get());
+    EXPECT_EQ(second_frame.get(), frame.get());
+}
+
+// a client that does not keep up is evicted once its queue is full
+TEST(SendQueueTest, EvictWhenFull) {
+    send_queue queue(make_limits(10, send_queue::overflow_policy::evict));
+    EXPECT_EQ(queue.push(make_frame(6)), send_queue::push_result::queued);
+    EXPECT_EQ(queue.push(make_frame(4)), send_queue::push_result::queued);
+    EXPECT_EQ(queue.push(make_frame(1)), send_queue::push_result::evicted);
+    EXPECT_TRUE(queue.is_closed());
+    EXPECT_TRUE(queue.is_evicted());
+    EXPECT_TRUE(queue.is_empty());
+
+    // the writer stops and later messages are dropped
+    send_queue::frame_ptr frame;
+    size_t offset;
+    queue.wait_front(frame, offset);
+    EXPECT_EQ(frame, nullptr);
+    EXPECT_EQ(queue.push(make_frame(1)), send_queue::push_result::closed);
+}
+
+// a single frame larger than the limit is still sent if nothing else is waiting
+TEST(SendQueueTest, LargeFrameIntoEmptyQueue) {
+    send_queue queue(make_limits(10, send_queue::overflow_policy::evict));
+    EXPECT_EQ(queue.push(make_frame(50)), send_queue::push_result::queued);
+    EXPECT_EQ(queue.push(make_frame(1)), send_queue::push_result::evicted);
+}
+
+// with backpressure, the producer waits until the writer made room
+TEST(SendQueueTest, BackpressureWaitsForWriter) {
+    send_queue queue(make_limits(10, send_queue::overflow_policy::backpressure, std::chrono::seconds(10)));
+    queue.push(make_frame(10));
+
+    std::thread writer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.consume(10);
+    });
+    EXPECT_EQ(queue.push(make_frame(5)), send_queue::push_result::queued);
+    writer.join();
+    EXPECT_FALSE(queue.is_evicted());
+    EXPECT_EQ(queue.get_nof_bytes(), 5);
+}
+
+// with backpressure, a client that does not catch up in time is evicted
+TEST(SendQueueTest, BackpressureEvictsAfterWait) {
+    send_queue queue(make_limits(10, send_queue::overflow_policy::backpressure, std::chrono::milliseconds(10)));
+    queue.push(make_frame(10));
+    EXPECT_EQ(queue.push(make_frame(5)), send_queue::push_result::evicted);
+    EXPECT_TRUE(queue.is_evicted());
+}
+
+// closing the queue drops pending frames and wakes up the writer
+TEST(SendQueueTest, CloseWakesWriter) {
+    send_queue queue(make_limits(10, send_queue::overflow_policy::evict));
+    send_queue::frame_ptr frame = make_frame(1);
+    size_t offset;
+    std::thread writer([&queue, &frame, &offset] {
+        queue.wait_front(frame, offset);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.close();
+    writer.join();
+    EXPECT_EQ(frame, nullptr);
+    EXPECT_FALSE(queue.is_evicted());
+    EXPECT_EQ(queue.push(make_frame(1)), send_queue::push_result::closed);
+}
@@ -0,0 +1,59 @@
+//
+// Tests of the concurrent lookup table used by the server's registries.
+//
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../src/server/sharded_map.h"
+
+
+// values can be looked up, are not overwritten by a second insert, and can be removed
+TEST(ShardedMapTest, InsertGetErase) {
+    sharded_map<std::string, int> map;
+    int value = 1;
+    EXPECT_FALSE(map.try_get("a", value));
+    EXPECT_TRUE(map.try_insert("a", value));
+
+    value = 2;
+    EXPECT_FALSE(map.try_insert("a", value));
+    EXPECT_EQ(value, 1);    // the existing value is returned
+
+    int found = 0;
+    EXPECT_TRUE(map.try_get("a", found));
+    EXPECT_EQ(found, 1);
+    EXPECT_EQ(map.size(), 1);
+
+    EXPECT_TRUE(map.erase("a"));
+    EXPECT_FALSE(map.erase("a"));
+    EXPECT_FALSE(map.try_get("a", found));
+    EXPECT_EQ(map.size(), 0);
+}
+
+// keys spread over all shards are all found again, also when inserted from several threads
+TEST(ShardedMapTest, ConcurrentInserts) {
+    sharded_map<std::string, int, 8> map;
+    const int nof_threads = 4;
+    const int nof_keys = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nof_threads; t++) {
+        threads.emplace_back([&map, t] {
+            for (int i = t; i < nof_keys; i += nof_threads) {
+                int value = i;
+                map.try_insert("key" + std::to_string(i), value);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(map.size(), nof_keys);
+    for (int i = 0; i < nof_keys; i++) {
+        int value = -1;
+        ASSERT_TRUE(map.try_get("key" + std::to_string(i), value));
+        EXPECT_EQ(value, i);
+    }
+}
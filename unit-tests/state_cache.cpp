@@ -0,0 +1,81 @@
+//
+// Tests of the per-version cache of the serialized full game state.
+//
+
+#include "gtest/gtest.h"
+#include "test_game.h"
+#include "../src/common/serialization/json_utils.h"
+#include "../src/common/network/wire_format.h"
+#include "../src/server/state_cache.h"
+
+
+class StateCacheTest : public ::testing::Test {
+
+protected:
+    void SetUp() override
+    {
+        test_game_state->clear_dirty();
+    }
+
+    void TearDown() override
+    {
+        delete_game(test_game_state);
+    }
+
+    game_state* test_game_state = create_started_game(1);
+    state_cache cache;
+    std::string error;
+};
+
+// the state is serialized once per version, all lookups of the same version share the view
+TEST_F(StateCacheTest, SerializesOncePerVersion)
+{
+    std::shared_ptr<const state_view> first = cache.get_view(*test_game_state);
+    std::shared_ptr<const state_view> second = cache.get_view(*test_game_state);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(cache.get_nof_misses(), 1);
+    EXPECT_EQ(cache.get_nof_hits(), 1);
+    EXPECT_DOUBLE_EQ(cache.get_hit_rate(), 0.5);
+
+    // broadcasting a change advances the version
+    player* p = test_game_state->get_current_player();
+    ASSERT_TRUE(test_game_state->estimate_tricks(p, error, 0));
+    test_game_state->clear_dirty();
+    std::shared_ptr<const state_view> third = cache.get_view(*test_game_state);
+    EXPECT_NE(third.get(), first.get());
+    EXPECT_EQ(cache.get_nof_misses(), 2);
+
+    // a view that is still referenced stays valid after the cache moved on
+    EXPECT_FALSE(first->get_shared_message().empty());
+}
+
+// every player receives the full state with only their own hand visible
+TEST_F(StateCacheTest, ViewMatchesPlayerState)
+{
+    std::shared_ptr<const state_view> view = cache.get_view(*test_game_state);
+    for (const auto & p : test_game_state->get_players()) {
+        rapidjson::Document expected(rapidjson::kObjectType);
+        test_game_state->write_view_into_json(expected, expected.GetAllocator(), p);
+
+        for (const auto enc : {wire_format::encoding::json, wire_format::encoding::binary}) {
+            const std::string message = view->get_message(p, enc);
+            rapidjson::Document received;
+            wire_format::decode(message.data(), message.size(), enc, received);
+            EXPECT_EQ(std::string(received["type"].GetString()), "full_state_msg");
+            EXPECT_EQ(json_utils::to_string(&received["state_json"]), json_utils::to_string(&expected));
+        }
+    }
+}
+
+// the counters over all caches include the lookups of every cache
+TEST_F(StateCacheTest, TotalCounters)
+{
+    const uint64_t hits = state_cache::get_total_hits();
+    const uint64_t misses = state_cache::get_total_misses();
+    state_cache other;
+    cache.get_view(*test_game_state);
+    other.get_view(*test_game_state);
+    other.get_view(*test_game_state);
+    EXPECT_EQ(state_cache::get_total_misses() - misses, 2);
+    EXPECT_EQ(state_cache::get_total_hits() - hits, 1);
+}
@@ -0,0 +1,32 @@
+//
+// The started game shared by the tests that serialize, cache or send a game state.
+//
+
+#ifndef WIZARD_TEST_GAME_H
+#define WIZARD_TEST_GAME_H
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "../src/common/game_state/game_state.h"
+
+// a started game of the players "player1" to "player3", shuffled with 'seed'
+inline game_state* create_started_game(uint64_t seed) {
+    auto* state = new game_state(seed);
+    std::string err;
+    for (int i = 1; i <= 3; i++) {
+        EXPECT_TRUE(state->add_player(new player(entity_id::generate(), "player" + std::to_string(i)), err));
+    }
+    EXPECT_TRUE(state->start_game(err));
+    return state;
+}
+
+// deletes the game state together with its players, which the game state does not own
+inline void delete_game(game_state* state) {
+    for (const player* p : state->get_players()) {
+        delete p;
+    }
+    delete state;
+}
+
+#endif //WIZARD_TEST_GAME_H
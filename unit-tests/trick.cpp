@@ -12,8 +12,8 @@
 class TrickTest : public ::testing::Test
 {
 protected:
-    serializable_value<int>* trick_color = nullptr;
-    serializable_value<int>* trump_color = nullptr;
+    int trick_color = 0;
+    int trump_color = 0;
     trick* test_trick = nullptr;
     std::vector<std::pair<card*, player*>> cards_and_players;
 
@@ -34,8 +34,8 @@ protected:
 //note about trick color setup: if trick color == 0, it means the trick color has not been set yet. if first card is a wizard, it's set to -1
 //
 TEST_F(TrickTest, CreateAndChangeTrick) {
-    trick_color = new serializable_value<int>(2); //trick color is 2
-    trump_color = new serializable_value<int>(3);
+    trick_color = 2; //trick color is 2
+    trump_color = 3;
 
     card* test_card = new card(2, 4);
     player* test_player = new player("vatkruidvat");
@@ -62,8 +62,8 @@ TEST_F(TrickTest, CreateAndChangeTrick) {
 // have any card be a wizard --> wins
 TEST_F(TrickTest, OneWizard)
 {
-    trick_color = new serializable_value<int>(0); // trick color is 0
-    trump_color = new serializable_value<int>(3);// trump color is 3
+    trick_color = 0; // trick color is 0
+    trump_color = 3;// trump color is 3
     //if a wizard is played, then the other players may play any card they wish (of any suit)
     card* card1 = new card(14, 0); //winning wizard card
     card* card2 = new card(2, 2);
@@ -93,8 +93,8 @@ TEST_F(TrickTest, OneWizard)
 //first wizard card wins
 TEST_F(TrickTest, AllWizards)
 {
-    trick_color = new serializable_value<int>(0); // trick color is 0
-    trump_color = new serializable_value<int>(3); // trump color is 3
+    trick_color = 0; // trick color is 0
+    trump_color = 3; // trump color is 3
 
     card* card1 = new card(14, 0); //winning wizard card
     card* card2 = new card(14, 0);
@@ -125,8 +125,8 @@ TEST_F(TrickTest, AllWizards)
 //first card is a jester --> wins only if everyone plays a jester, otherwise the jester looses
 TEST_F(TrickTest, OneJesterHighestCard)
 {
-    trick_color = new serializable_value<int>(2); // trick color is 2
-    trump_color = new serializable_value<int>(4);// trump color is 4
+    trick_color = 2; // trick color is 2
+    trump_color = 4;// trump color is 4
     //jester has color 0, value 0
     card* card1 = new card(0, 0); //jester looses
     card* card2 = new card(2, 2); //first number card --> decides trick color
@@ -155,8 +155,8 @@ TEST_F(TrickTest, OneJesterHighestCard)
 //first card is a jester, trump card wins
 TEST_F(TrickTest, OneJesterWithTrump)
 {
-    trick_color = new serializable_value<int>(2); // trick color is 2
-    trump_color = new serializable_value<int>(4);// trump color is 4
+    trick_color = 2; // trick color is 2
+    trump_color = 4;// trump color is 4
     //jester has color 0, value 0
     card* card1 = new card(0, 0); //jester looses
     card* card2 = new card(2, 2); //first number card --> decides trick color
@@ -188,8 +188,8 @@ TEST_F(TrickTest, OneJesterWithTrump)
 //first card is a jester, wizard card wins
 TEST_F(TrickTest, OneJesterWithWizard)
 {
-    trick_color = new serializable_value<int>(0); // trick color is 0
-    trump_color = new serializable_value<int>(4);// trump color is 4
+    trick_color = 0; // trick color is 0
+    trump_color = 4;// trump color is 4
     //jester has color 0, value 0
     card* card1 = new card(0, 0); //jester looses
     card* card2 = new card(14, 0); //wizard card wins
@@ -219,8 +219,8 @@ TEST_F(TrickTest, OneJesterWithWizard)
 //first card is a jester, wizard card wins
 TEST_F(TrickTest, OneJesterWithWizardAndTrump)
 {
-    trick_color = new serializable_value<int>(2); // trick color is 2
-    trump_color = new serializable_value<int>(4);// trump color is 4
+    trick_color = 2; // trick color is 2
+    trump_color = 4;// trump color is 4
     //jester has color 0, value 0
     card* card1 = new card(0, 0); //jester looses
     card* card2 = new card(4, 2); //trick color 2
@@ -250,8 +250,8 @@ TEST_F(TrickTest, OneJesterWithWizardAndTrump)
 //all jesters
 TEST_F(TrickTest, AllJesters)
 {
-    trick_color = new serializable_value<int>(0); // trick color is 0
-    trump_color = new serializable_value<int>(4);// trump color for this trick is 4
+    trick_color = 0; // trick color is 0
+    trump_color = 4;// trump color for this trick is 4
     //jester has color 0, value 0
     card* card1 = new card(0, 0); //winning jester card
     card* card2 = new card(0, 0);
@@ -284,8 +284,8 @@ TEST_F(TrickTest, AllJesters)
 //highest trump card wins
 TEST_F(TrickTest, HighestTrump)
 {
-    trick_color = new serializable_value<int>(3); // trick color is 3
-    trump_color = new serializable_value<int>(2);// trump color is 2
+    trick_color = 3; // trick color is 3
+    trump_color = 2;// trump color is 2
 
 
     card* card1 = new card(2, 3); //decides trick color
@@ -317,8 +317,8 @@ TEST_F(TrickTest, HighestTrump)
 //only trump played -> highest trump card wins
 TEST_F(TrickTest, OnlyTrump)
 {
-    trick_color = new serializable_value<int>(1); // trick color is 1
-    trump_color = new serializable_value<int>(1);// trump color is 1
+    trick_color = 1; // trick color is 1
+    trump_color = 1;// trump color is 1
 
 
     card* card1 = new card(12, 1);
@@ -348,8 +348,8 @@ TEST_F(TrickTest, OnlyTrump)
 // if no trump is played, the highest card wins
 TEST_F(TrickTest, NoTrump)
 {
-    trick_color = new serializable_value<int>(1); // trick color is 1
-    trump_color = new serializable_value<int>(3);// trump color is 3
+    trick_color = 1; // trick color is 1
+    trump_color = 3;// trump color is 3
 
     card* card1 = new card(1, 1);
     card* card2 = new card(6, 2);
@@ -378,8 +378,8 @@ TEST_F(TrickTest, NoTrump)
 //check setup round
 TEST_F(TrickTest, SetupRound)
 {
-    trick_color = new serializable_value<int>(1); // trick color is 1
-    trump_color = new serializable_value<int>(3);// trump color is 3
+    trick_color = 1; // trick color is 1
+    trump_color = 3;// trump color is 3
 
 
     card* card1 = new card(1, 1);
@@ -431,6 +431,56 @@ TEST_F(TrickTest, AddCard)
 }
 
 
+// a trick diff only contains the newly played cards and is applied correctly to a copy of the trick
+TEST_F(TrickTest, DiffOnlyContainsNewCards)
+{
+    std::string err = "";
+    // only the cards of the card table can be deserialized
+    card* card1 = card::get_card(0);    // 1 of color 1
+    card* card2 = card::get_card(21);   // 6 of color 2
+    player* player1 = new player("Player_1");
+    player* player2 = new player("Player_2");
+
+    test_trick = new trick();
+    test_trick->set_up_round(3, err);
+    test_trick->add_card(card1, player1, err);
+
+    // the client received the trick with the first card
+    rapidjson::Document* json = test_trick->to_json();
+    trick* client_trick = trick::from_json(*json, {player1, player2});
+    delete json;
+    test_trick->clear_dirty();
+    EXPECT_FALSE(test_trick->is_dirty());
+
+    test_trick->add_card(card2, player2, err);
+    EXPECT_TRUE(test_trick->is_dirty());
+
+    rapidjson::Document diff(rapidjson::kObjectType);
+    test_trick->write_diff_into_json(diff, diff.GetAllocator());
+    EXPECT_EQ(diff["cards_from"].GetUint64(), 1);
+    EXPECT_EQ(diff["cards"].Size(), 1);
+    EXPECT_FALSE(diff.HasMember("trick_color")); // set by the first card, which was already sent
+    EXPECT_FALSE(diff.HasMember("trump_color"));
+
+    client_trick->apply_diff(diff, {player1, player2});
+    ASSERT_EQ(client_trick->get_cards_and_players().size(), 2);
+    EXPECT_EQ(client_trick->get_cards_and_players().at(1).first->get_id(), card2->get_id());
+    EXPECT_EQ(client_trick->get_cards_and_players().at(1).second, player2);
+    EXPECT_EQ(client_trick->get_trick_color(), 1);
+    test_trick->clear_dirty();
+
+    // setting up the next trick removes all cards
+    test_trick->set_up_round(4, err);
+    rapidjson::Document reset_diff(rapidjson::kObjectType);
+    test_trick->write_diff_into_json(reset_diff, reset_diff.GetAllocator());
+    EXPECT_EQ(reset_diff["cards_from"].GetUint64(), 0);
+    client_trick->apply_diff(reset_diff, {player1, player2});
+    EXPECT_EQ(client_trick->get_cards_and_players().size(), 0);
+    EXPECT_EQ(client_trick->get_trick_color(), 0);
+    EXPECT_EQ(client_trick->get_trump_color(), 4);
+    delete client_trick;
+}
+
 //test a full round
 TEST_F(TrickTest, EntireRound)
 {
@@ -484,10 +534,10 @@ TEST_F(TrickTest, EntireRound)
 
 // Serialization and subsequent deserialization must yield the same object
 TEST_F(TrickTest, SerializationEquality) {
-    trick_color = new serializable_value<int>(2); //trick color is 2
-    trump_color = new serializable_value<int>(3);
+    trick_color = 2; //trick color is 2
+    trump_color = 3;
 
-    card* test_card = new card(2, 4);
+    card* test_card = card::get_card(7);    // 2 of color 4, only the cards of the card table can be deserialized
     player* test_player = new player("vatkruidvat");
     cards_and_players.push_back(std::make_pair(test_card, test_player));
 
@@ -499,22 +549,35 @@ TEST_F(TrickTest, SerializationEquality) {
 
     rapidjson::Document json_received = rapidjson::Document(rapidjson::kObjectType);
     json_received.Parse(message.c_str());
-    trick* trick_received = trick::from_json(json_received);
+    trick* trick_received = trick::from_json(json_received, {test_player});
 
     EXPECT_EQ(test_trick->get_id(), trick_received->get_id());
     EXPECT_EQ(test_trick->get_trump_color(), trick_received->get_trump_color());
     EXPECT_EQ(test_trick->get_cards_and_players()[0].first->get_color(), trick_received->get_cards_and_players()[0].first->get_color());
     EXPECT_EQ(test_trick->get_cards_and_players()[0].first->get_value(), trick_received->get_cards_and_players()[0].first->get_value());
     EXPECT_EQ(test_trick->get_trick_color(), trick_received->get_trick_color());
+    // the player is resolved by id instead of being deserialized again
+    EXPECT_EQ(test_player, trick_received->get_cards_and_players()[0].second);
 
     delete trick_received;
 }
 
+// Deserializing a card played by a player that is not part of the game must throw a WizardException
+TEST_F(TrickTest, SerializationUnknownPlayer) {
+    player* test_player = new player("vatkruidvat");
+    cards_and_players.push_back(std::make_pair(new card(2, 4), test_player));
+    test_trick = new trick("test_trick_id", cards_and_players, 4, 3);
+
+    rapidjson::Document* json = test_trick->to_json();
+    EXPECT_THROW(trick::from_json(*json, {new player("someone_else")}), WizardException);
+    delete json;
+}
+
 // Deserializing an invalid string must throw a WizardException
 TEST_F(TrickTest, SerializationException) {
     rapidjson::Document json = rapidjson::Document(rapidjson::kObjectType);
     json.Parse("not json");
-    EXPECT_THROW(trick::from_json(json), WizardException);
+    EXPECT_THROW(trick::from_json(json, {}), WizardException);
 }
 
 //version 5.12 17:10
\ No newline at end of file
@@ -0,0 +1,164 @@
+//
+// Tests of coalescing the game states a client receives faster than it shows them.
+//
+
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "test_game.h"
+#include "../src/common/network/update_coalescer.h"
+
+
+class UpdateCoalescerTest : public ::testing::Test {
+
+protected:
+    update_coalescer coalescer;
+    game_state* state = nullptr;
+    std::string err;
+
+    void SetUp() override
+    {
+        state = create_started_game(11);
+    }
+
+    void TearDown() override
+    {
+        delete_game(state);
+    }
+
+    // the game state as received by a client
+    [[nodiscard]] response_decoder::update snapshot() const
+    {
+        rapidjson::Document* json = state->to_json();
+        response_decoder::update update;
+        update.state = game_state::from_json(*json);
+        delete json;
+        return update;
+    }
+
+    // plays the first card of the current player that can be played
+    void play_card()
+    {
+        player* current = state->get_current_player();
+        for (const auto& c : current->get_hand()->get_cards()) {
+            if (state->play_card(current, c->get_id(), err)) {
+                return;
+            }
+        }
+        FAIL() << "no card could be played";
+    }
+
+    // pops the next update and returns its state, which the caller has to delete
+    game_state* pop_state()
+    {
+        response_decoder::update update;
+        EXPECT_TRUE(coalescer.pop(update));
+        return update.state;
+    }
+};
+
+// states of the same trick replace each other, so only the latest one is shown
+TEST_F(UpdateCoalescerTest, LatestStateOfTrickWins)
+{
+    EXPECT_TRUE(coalescer.push(snapshot()));
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    EXPECT_FALSE(coalescer.push(snapshot()));
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    EXPECT_FALSE(coalescer.push(snapshot()));
+    EXPECT_EQ(coalescer.get_nof_pending(), 1);
+
+    game_state* shown = pop_state();
+    EXPECT_EQ(shown->get_trick_estimate_sum(), 0);
+    EXPECT_EQ(shown->get_current_player()->get_id(), state->get_current_player()->get_id());
+    response_decoder::delete_state(shown);
+
+    response_decoder::update update;
+    EXPECT_FALSE(coalescer.pop(update));
+    EXPECT_TRUE(coalescer.push(snapshot()));
+}
+
+// the last state of a trick is never replaced by a state of the next trick, which shows the completed trick
+TEST_F(UpdateCoalescerTest, TrickBoundariesArePreserved)
+{
+    // the first round has a single trick of one card per player
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    }
+    coalescer.push(snapshot());
+    play_card();
+    coalescer.push(snapshot());
+    play_card();
+    coalescer.push(snapshot());
+    play_card();
+    coalescer.push(snapshot());
+    ASSERT_EQ(state->get_round_number(), 1);
+    ASSERT_TRUE(state->estimate_tricks(state->get_current_player(), err, 0));
+    coalescer.push(snapshot());
+    ASSERT_EQ(coalescer.get_nof_pending(), 2);
+
+    // the state before the last card of the trick, with two cards in the trick
+    game_state* before = pop_state();
+    EXPECT_EQ(before->get_round_number(), 0);
+    EXPECT_EQ(before->get_trick()->get_cards_and_players().size(), 2);
+    response_decoder::delete_state(before);
+
+    // the latest state of the next round, whose last trick is the completed one
+    game_state* after = pop_state();
+    EXPECT_EQ(after->get_round_number(), 1);
+    EXPECT_EQ(after->get_trick_estimate_sum(), 0);
+    EXPECT_EQ(after->get_last_trick()->get_cards_and_players().size(), 3);
+    response_decoder::delete_state(after);
+}
+
+// resyncs and errors are queued in order and never replaced
+TEST_F(UpdateCoalescerTest, ResyncsAndErrorsAreKept)
+{
+    coalescer.push(snapshot());
+    response_decoder::update error;
+    error.error = "It is not your turn";
+    coalescer.push(error);
+    coalescer.push(snapshot());
+    response_decoder::update resync;
+    resync.resync = true;
+    coalescer.push(resync);
+    coalescer.push(snapshot());
+    EXPECT_EQ(coalescer.get_nof_pending(), 5);
+
+    response_decoder::update update;
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(coalescer.pop(update));
+        EXPECT_EQ(update.error.empty(), i != 1);
+        EXPECT_EQ(update.resync, i == 3);
+        response_decoder::delete_state(update.state);
+    }
+}
+
+// states pushed by one thread are popped by another one without losing the latest state
+TEST_F(UpdateCoalescerTest, ConcurrentPushAndPop)
+{
+    const int nof_updates = 200;
+    std::thread producer([this] {
+        for (int i = 0; i < nof_updates; i++) {
+            coalescer.push(snapshot());
+        }
+        response_decoder::update last;
+        last.error = "done";
+        coalescer.push(last);
+    });
+
+    int nof_states = 0;
+    response_decoder::update update;
+    while (update.error.empty()) {
+        if (coalescer.pop(update)) {
+            nof_states += update.state != nullptr;
+            response_decoder::delete_state(update.state);
+            update.state = nullptr;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_GE(nof_states, 1);
+    EXPECT_LE(nof_states, nof_updates);
+    EXPECT_EQ(coalescer.get_nof_pending(), 0);
+}
@@ -0,0 +1,84 @@
+//
+// Tests of the worker pool and the mailboxes that execute the commands of the games.
+//
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../src/server/mailbox.h"
+#include "../src/server/worker_pool.h"
+
+
+// all tasks are executed, also tasks submitted by other tasks, before the pool is destroyed
+TEST(WorkerPoolTest, ExecutesAllTasks) {
+    std::atomic<int> nof_executed {0};
+    {
+        worker_pool pool(4);
+        EXPECT_EQ(pool.get_nof_threads(), 4);
+        for (int i = 0; i < 100; i++) {
+            pool.submit([&pool, &nof_executed] {
+                for (int j = 0; j < 10; j++) {
+                    pool.submit([&nof_executed] { nof_executed++; });
+                }
+                nof_executed++;
+            });
+        }
+    }
+    EXPECT_EQ(nof_executed, 1100);
+}
+
+// sleeping workers wake up for new tasks, and a throwing task does not stop its worker
+TEST(WorkerPoolTest, WakesUpIdleWorkers) {
+    worker_pool pool(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));     // let the workers fall asleep
+    pool.submit([] { throw std::runtime_error("failed task"); });
+    std::atomic<bool> executed {false};
+    pool.submit([&executed] { executed = true; });
+    for (int i = 0; i < 1000 && !executed; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(executed);
+}
+
+// the commands of a mailbox never run at the same time, and the commands of every producer run in posting order
+TEST(MailboxTest, ExecutesCommandsSerially) {
+    const int nof_producers = 4;
+    const int nof_commands = 1000;
+    std::atomic<bool> running {false};
+    std::atomic<int> nof_overlaps {0};
+    std::vector<std::vector<int>> executed(nof_producers);  // only accessed by the commands
+    {
+        auto pool = std::make_unique<worker_pool>(4);
+        auto box = std::make_shared<mailbox>(*pool);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < nof_producers; p++) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < nof_commands; i++) {
+                    box->post([&, p, i] {
+                        if (running.exchange(true)) {
+                            nof_overlaps++;
+                        }
+                        executed[p].push_back(i);
+                        running = false;
+                    });
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        pool.reset();   // waits for all commands
+    }
+
+    EXPECT_EQ(nof_overlaps, 0);
+    for (const std::vector<int>& commands : executed) {
+        ASSERT_EQ(commands.size(), nof_commands);
+        for (int i = 0; i < nof_commands; i++) {
+            EXPECT_EQ(commands[i], i);
+        }
+    }
+}